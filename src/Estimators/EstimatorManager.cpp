@@ -50,7 +50,8 @@ enum {COLLECT=0,
       MANAGE,
       RECORD,
       POSTIRECV,
-      APPEND
+      APPEND,
+      ASYNCREDUCE
      };
 
 //initialize the name of the primary estimator
@@ -58,7 +59,7 @@ EstimatorManager::EstimatorManager(Communicate* c)
   : RecordCount(0),h_file(-1), FieldWidth(20)
   , MainEstimatorName("LocalEnergy"), Archive(0), DebugArchive(0)
   , myComm(0), MainEstimator(0), Collectables(0)
-  , max4ascii(8), pendingRequests(0)
+  , max4ascii(8), pendingRequests(0), ReductionInFlight(false)
 {
   setCommunicator(c);
 }
@@ -68,6 +69,7 @@ EstimatorManager::EstimatorManager(EstimatorManager& em)
   , MainEstimatorName(em.MainEstimatorName), Options(em.Options), Archive(0), DebugArchive(0)
   , myComm(0), MainEstimator(0), Collectables(0)
   , EstimatorMap(em.EstimatorMap), max4ascii(em.max4ascii), pendingRequests(0)
+  , ReductionInFlight(false)
 {
   //inherit communicator
   setCommunicator(em.myComm);
@@ -80,6 +82,7 @@ EstimatorManager::EstimatorManager(EstimatorManager& em)
 
 EstimatorManager::~EstimatorManager()
 {
+  waitBlockAverages();
   delete_iter(Estimators.begin(), Estimators.end());
   delete_iter(RemoteData.begin(), RemoteData.end());
   delete_iter(h5desc.begin(), h5desc.end());
@@ -104,6 +107,8 @@ void EstimatorManager::setCommunicator(Communicate* c)
     for(int i=0; i<myComm->size(); i++)
       RemoteData.push_back(new BufferType);
 #else
+    //packed data, reduced data and the reduced data of the previous block
+    RemoteData.push_back(new BufferType);
     RemoteData.push_back(new BufferType);
     RemoteData.push_back(new BufferType);
 #endif
@@ -122,6 +127,11 @@ void EstimatorManager::setCollectionMode(bool collect)
   //CollectSum = (myComm->size() == 1)? false:collect;
 }
 
+void EstimatorManager::setAsyncReduction(bool async)
+{
+  Options.set(ASYNCREDUCE,async);
+}
+
 /** reset names of the properties
  *
  * The number of estimators and their order can vary from the previous state.
@@ -165,6 +175,8 @@ void EstimatorManager::addHeader(std::ostream& o)
 
 void EstimatorManager::start(int blocks, bool record)
 {
+  //a reduction left by a previous run uses the buffers
+  waitBlockAverages();
   for(int i=0; i<Estimators.size(); i++)
     Estimators[i]->setNumberOfBlocks(blocks);
   reset();
@@ -181,7 +193,7 @@ void EstimatorManager::start(int blocks, bool record)
 #if defined(QMC_ASYNC_COLLECT)
   int sources=myComm->size();
 #else
-  int sources=2;
+  int sources=3;
 #endif
   //allocate buffer for data collection
   if(RemoteData.empty())
@@ -237,24 +249,7 @@ void EstimatorManager::start(int blocks, bool record)
 
 void EstimatorManager::stop(const std::vector<EstimatorManager*> est)
 {
-  int num_threads=est.size();
-  //normalize by the number of threads per node
-  RealType tnorm=1.0/static_cast<RealType>(num_threads);
-  //add averages and divide them by the number of threads
-  AverageCache=est[0]->AverageCache;
-  for(int i=1; i<num_threads; i++)
-    AverageCache+=est[i]->AverageCache;
-  AverageCache*=tnorm;
-  SquaredAverageCache=est[0]->SquaredAverageCache;
-  for(int i=1; i<num_threads; i++)
-    SquaredAverageCache+=est[i]->SquaredAverageCache;
-  SquaredAverageCache*=tnorm;
-  //add properties and divide them by the number of threads except for the weight
-  PropertyCache=est[0]->PropertyCache;
-  for(int i=1; i<num_threads; i++)
-    PropertyCache+=est[i]->PropertyCache;
-  for(int i=1; i<PropertyCache.size(); i++)
-    PropertyCache[i] *= tnorm;
+  mergeClones(est);
   stop();
 }
 
@@ -267,6 +262,8 @@ void EstimatorManager::stop(const std::vector<EstimatorManager*> est)
  */
 void EstimatorManager::stop()
 {
+  //write the last block
+  waitBlockAverages();
   //clean up pending messages
   if(pendingRequests)
   {
@@ -315,25 +312,53 @@ void EstimatorManager::stopBlock(RealType accept, bool collectall)
 
 void EstimatorManager::stopBlock(const std::vector<EstimatorManager*>& est)
 {
-  //normalized it by the thread
-  int num_threads=est.size();
-  RealType tnorm=1.0/num_threads;
-  AverageCache=est[0]->AverageCache;
-  for(int i=1; i<num_threads; i++)
-    AverageCache +=est[i]->AverageCache;
-  AverageCache *= tnorm;
-  SquaredAverageCache=est[0]->SquaredAverageCache;
-  for(int i=1; i<num_threads; i++)
-    SquaredAverageCache +=est[i]->SquaredAverageCache;
-  SquaredAverageCache *= tnorm;
-  PropertyCache=est[0]->PropertyCache;
-  for(int i=1; i<num_threads; i++)
-    PropertyCache+=est[i]->PropertyCache;
-  for(int i=1; i<PropertyCache.size(); i++)
-    PropertyCache[i] *= tnorm;
+  mergeClones(est);
   //for(int i=0; i<num_threads; ++i)
   //varAccumulator(est[i]->varAccumulator.mean());
-  collectBlockAverages(num_threads);
+  collectBlockAverages(est.size());
+}
+
+/** average the caches of the clones
+ * @param est estimators of the threads
+ *
+ * The threads may have advanced different numbers of walkers in a block.
+ * The averages and the other properties of each clone are weighted by its
+ * BlockWeight and a clone without a sample, whose averages are zero and
+ * whose acceptance ratio is undefined, is skipped. The weights are summed
+ * and the cpu times are averaged over the threads.
+ */
+void EstimatorManager::mergeClones(const std::vector<EstimatorManager*>& est)
+{
+  int num_threads=est.size();
+  RealType wtot=0.0;
+  RealType cpu=0.0;
+  for(int i=0; i<num_threads; i++)
+  {
+    wtot+=est[i]->PropertyCache[weightInd];
+    cpu+=est[i]->PropertyCache[cpuInd];
+  }
+  AverageCache.resize(est[0]->AverageCache.size());
+  SquaredAverageCache.resize(est[0]->SquaredAverageCache.size());
+  PropertyCache.resize(est[0]->PropertyCache.size());
+  AverageCache=0.0;
+  SquaredAverageCache=0.0;
+  PropertyCache=0.0;
+  for(int i=0; i<num_threads; i++)
+  {
+    RealType w=est[i]->PropertyCache[weightInd];
+    if(w<=0.0)
+      continue;
+    RealType wnorm=w/wtot;
+    for(int j=0; j<AverageCache.size(); j++)
+    {
+      AverageCache[j]+=wnorm*est[i]->AverageCache[j];
+      SquaredAverageCache[j]+=wnorm*est[i]->SquaredAverageCache[j];
+    }
+    for(int j=0; j<PropertyCache.size(); j++)
+      PropertyCache[j]+=wnorm*est[i]->PropertyCache[j];
+  }
+  PropertyCache[weightInd]=wtot;
+  PropertyCache[cpuInd]=cpu/static_cast<RealType>(num_threads);
 }
 
 
@@ -341,17 +366,9 @@ void EstimatorManager::collectBlockAverages(int num_threads)
 {
   if(Options[COLLECT])
   {
-    //copy cached data to RemoteData[0]
-    int n1=AverageCache.size();
-    int n2=n1+AverageCache.size();
-    int n3=n2+PropertyCache.size();
-    {
-      BufferType::iterator cur(RemoteData[0]->begin());
-      copy(AverageCache.begin(),AverageCache.end(),cur);
-      copy(SquaredAverageCache.begin(),SquaredAverageCache.end(),cur+n1);
-      copy(PropertyCache.begin(),PropertyCache.end(),cur+n2);
-    }
 #if defined(QMC_ASYNC_COLLECT)
+    //copy cached data to RemoteData[0]
+    packBlockAverages(*RemoteData[0]);
     if(Options[MANAGE])
     {
       //wait all the message but we can choose to wait one-by-one with a timer
@@ -362,22 +379,69 @@ void EstimatorManager::collectBlockAverages(int num_threads)
     else //not a master, pack and send the data
       myRequest[0]=myComm->isend(0,myComm->rank(),*RemoteData[0]);
 #else
+    if(Options[ASYNCREDUCE])
+    {
+      //complete the reduction of the previous block before its buffers are reused
+      bool previous=ReductionInFlight;
+      if(previous)
+      {
+        wait_all(1,&ReduceRequest);
+        std::swap(RemoteData[1],RemoteData[2]);
+      }
+      packBlockAverages(*RemoteData[0]);
+      ReduceRequest=myComm->ireduce(RemoteData[0]->data(),RemoteData[1]->data(),RemoteData[0]->size());
+      ReductionInFlight=true;
+      //the master writes the previous block, the others record their own data as before
+      if(Options[MANAGE])
+      {
+        if(previous)
+        {
+          unpackBlockAverages(*RemoteData[2]);
+          recordBlockAverages();
+        }
+      }
+      else
+        recordBlockAverages();
+      return;
+    }
+    packBlockAverages(*RemoteData[0]);
     myComm->reduce(*RemoteData[0]);
 #endif
     if(Options[MANAGE])
-    {
-      BufferType::iterator cur(RemoteData[0]->begin());
-      copy(cur,cur+n1, AverageCache.begin());
-      copy(cur+n1,cur+n2, SquaredAverageCache.begin());
-      copy(cur+n2,cur+n3, PropertyCache.begin());
-      RealType nth=1.0/static_cast<RealType>(myComm->size());
-      AverageCache *= nth;
-      SquaredAverageCache *= nth;
-      //do not weight weightInd
-      for(int i=1; i<PropertyCache.size(); i++)
-        PropertyCache[i] *= nth;
-    }
+      unpackBlockAverages(*RemoteData[0]);
   }
+  recordBlockAverages();
+}
+
+void EstimatorManager::packBlockAverages(BufferType& data)
+{
+  int n1=AverageCache.size();
+  int n2=n1+AverageCache.size();
+  BufferType::iterator cur(data.begin());
+  copy(AverageCache.begin(),AverageCache.end(),cur);
+  copy(SquaredAverageCache.begin(),SquaredAverageCache.end(),cur+n1);
+  copy(PropertyCache.begin(),PropertyCache.end(),cur+n2);
+}
+
+void EstimatorManager::unpackBlockAverages(const BufferType& data)
+{
+  int n1=AverageCache.size();
+  int n2=n1+AverageCache.size();
+  int n3=n2+PropertyCache.size();
+  BufferType::const_iterator cur(data.begin());
+  copy(cur,cur+n1, AverageCache.begin());
+  copy(cur+n1,cur+n2, SquaredAverageCache.begin());
+  copy(cur+n2,cur+n3, PropertyCache.begin());
+  RealType nth=1.0/static_cast<RealType>(myComm->size());
+  AverageCache *= nth;
+  SquaredAverageCache *= nth;
+  //do not weight weightInd
+  for(int i=1; i<PropertyCache.size(); i++)
+    PropertyCache[i] *= nth;
+}
+
+void EstimatorManager::recordBlockAverages()
+{
   //add the block average to summarize
   energyAccumulator(AverageCache[0]);
   varAccumulator(SquaredAverageCache[0]-AverageCache[0]*AverageCache[0]);
@@ -397,6 +461,23 @@ void EstimatorManager::collectBlockAverages(int num_threads)
   RecordCount++;
 }
 
+/** complete the nonblocking reduction of the last block
+ *
+ * The master writes the block. Called by stop and start.
+ */
+void EstimatorManager::waitBlockAverages()
+{
+  if(!ReductionInFlight)
+    return;
+  wait_all(1,&ReduceRequest);
+  ReductionInFlight=false;
+  if(Options[MANAGE])
+  {
+    unpackBlockAverages(*RemoteData[1]);
+    recordBlockAverages();
+  }
+}
+
 /** accumulate Local energies and collectables
  * @param W ensemble
  */
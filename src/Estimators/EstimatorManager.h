@@ -159,6 +159,11 @@ public:
   }
 
   void setCollectionMode(bool collect);
+
+  /** set the nonblocking reduction of the block averages
+   * @param async if true, the reduction of a block overlaps with the next block
+   */
+  void setAsyncReduction(bool async);
   //void setAccumulateMode (bool setAccum) {AccumulateBlocks = setAccum;};
 
   ///process xml tag associated with estimators
@@ -309,8 +314,22 @@ private:
   std::vector<BufferType*> RemoteData;
   //storage for MPI_Request
   std::vector<Communicate::request> myRequest;
+  ///true if the reduction of a block is in flight
+  bool ReductionInFlight;
+  ///request of the reduction in flight
+  Communicate::request ReduceRequest;
+  ///average the caches of the clones weighted by their BlockWeight
+  void mergeClones(const std::vector<EstimatorManager*>& est);
   ///collect data and write
   void collectBlockAverages(int num_threads);
+  ///copy the block averages to data
+  void packBlockAverages(BufferType& data);
+  ///copy the block averages summed over the tasks from data
+  void unpackBlockAverages(const BufferType& data);
+  ///accumulate the block averages and write them
+  void recordBlockAverages();
+  ///complete the reduction in flight and write its block
+  void waitBlockAverages();
   ///add header to an std::ostream
   void addHeader(std::ostream& o);
   size_t FieldWidth;
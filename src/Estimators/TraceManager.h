@@ -34,9 +34,14 @@
 #include <Utilities/IteratorUtility.h>
 #include <Message/Communicate.h>
 #include <io/hdf_archive.h>
+#include <Utilities/NewTimer.h>
 #include <map>
 #include <set>
+#include <deque>
 #include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #ifdef HAVE_ADIOS
 #include "ADIOS/ADIOSTrace.h"
@@ -1203,6 +1208,8 @@ struct TraceBuffer
   TraceSamples<std::complex<T> >* complex_samples;
   std::string type;
   Array<T,2> buffer;
+  //filled rows handed to the stream writer, only used when streaming
+  Array<T,2> standby;
   bool verbose;
 
   //hdf variables
@@ -1368,6 +1375,31 @@ struct TraceBuffer
   }
 
 
+  //streaming: allocate room for nrows in both halves of the double buffer
+  inline void reserve_rows(int nrows)
+  {
+    buffer.storage().reserve(nrows*buffer.size(1));
+    standby.storage().reserve(nrows*buffer.size(1));
+  }
+
+
+  inline bool full(int nrows) const
+  {
+    return buffer.size(0)>=nrows;
+  }
+
+
+  //streaming: move the filled rows to the standby buffer without reallocation
+  inline void swap_standby()
+  {
+    int nrows    = buffer.size(0);
+    int row_size = buffer.size(1);
+    buffer.storage().swap(standby.storage());
+    standby.resize(nrows,row_size);
+    buffer.resize(0,row_size);
+  }
+
+
   inline void write_summary( std::string pad="  ")
   {
     std::string pad2=pad+"  ";
@@ -1423,16 +1455,23 @@ struct TraceBuffer
 
 
   inline void write_hdf(hdf_archive& f,hsize_t& file_pointer)
+  {
+    write_hdf(f,file_pointer,buffer);
+  }
+
+
+  //append the rows of data, a new dataset is chunked by chunk_size rows and deflated if compression>0
+  inline void write_hdf(hdf_archive& f,hsize_t& file_pointer,Array<T,2>& data,hsize_t chunk_size=1,int compression=0)
   {
     if(verbose)
-      app_log()<<"TraceBuffer<"<<type<<">::write_hdf() "<<file_pointer<<" "<<buffer.size(0)<<" "<<buffer.size(1)<< std::endl;
-    dims[0] = buffer.size(0);
-    dims[1] = buffer.size(1);
+      app_log()<<"TraceBuffer<"<<type<<">::write_hdf() "<<file_pointer<<" "<<data.size(0)<<" "<<data.size(1)<< std::endl;
+    dims[0] = data.size(0);
+    dims[1] = data.size(1);
     if(dims[0]>0)
     {
       f.push(top);
       h5d_append(f.top(), "traces", file_pointer,
-                 buffer.dim(), dims, buffer.data());
+                 data.dim(), dims, data.data(), chunk_size, H5P_DEFAULT, compression);
       f.pop();
     }
     f.flush();
@@ -1602,13 +1641,39 @@ public:
 #endif
   xmlNodePtr adios_options;
 
+  //streaming mode
+  //  each clone fills at most stream_rows rows before handing them to the writer
+  //  a clone whose previous rows are still being written waits (backpressure)
+  //  without a thread-safe hdf5 the clone appends its rows itself, serialized by stream_mutex
+  bool stream;
+  int  stream_rows;
+  int  compression;
+  TraceManager* stream_master;
+  bool standby_busy;
+  double stall_time;
+  //writer state, master copy only
+  std::mutex stream_mutex;
+  std::condition_variable stream_cv;
+  std::deque<TraceManager*> stream_queue;
+  std::thread stream_writer;
+  bool stream_stop;
+  double stream_bytes;
+  double stream_time;
+  double stream_stall;
+  double stream_time_reported;
+  NewTimer* stream_write_timer;
+  NewTimer* stream_stall_timer;
+
   TraceManager(Communicate* comm=0)
-    : hdf_file(0),verbose(false)
+    : hdf_file(0),verbose(false),stream_master(0),standby_busy(false),stall_time(0.0),
+      stream_stop(false),stream_write_timer(0),stream_stall_timer(0)
   {
     reset_permissions();
     master_copy    = true;
     communicator   = comm;
     throttle       = 1;
+    stream_rows    = 1024;
+    compression    = 0;
     format         = "hdf";
     default_domain = "scalars";
     request.set_scalar_domain(default_domain);
@@ -1624,6 +1689,20 @@ public:
   }
 
 
+  ~TraceManager()
+  {
+    if(stream_writer.joinable())
+    {
+      {
+        std::lock_guard<std::mutex> lock(stream_mutex);
+        stream_stop = true;
+      }
+      stream_cv.notify_all();
+      stream_writer.join();
+    }
+  }
+
+
   inline TraceManager* makeClone()
   {
     if(verbose)
@@ -1632,6 +1711,7 @@ public:
       APP_ABORT("TraceManager::makeClone  only the master copy should call this function");
     TraceManager* tm = new TraceManager();
     tm->master_copy  = false;
+    tm->stream_master = this;
     tm->transfer_state_from(*this);
     tm->distribute();
     return tm;
@@ -1645,6 +1725,9 @@ public:
     streaming_traces     = tm.streaming_traces;
     writing_traces       = tm.writing_traces;
     throttle             = tm.throttle;
+    stream               = tm.stream;
+    stream_rows          = tm.stream_rows;
+    compression          = tm.compression;
     verbose              = tm.verbose;
     format               = tm.format;
     hdf_format           = tm.hdf_format;
@@ -1672,6 +1755,7 @@ public:
     method_allows_traces = false;
     streaming_traces     = false;
     writing_traces       = false;
+    stream               = false;
     verbose              = false;
     hdf_format           = false;
     adios_format         = false;
@@ -1703,6 +1787,7 @@ public:
       std::string scalar_defaults   = "yes";
       std::string array_defaults    = "yes";
       std::string verbose_write     = "no";
+      std::string stream_write      = "no";
       OhmmsAttributeSet attrib;
       attrib.add(writing,        "write"          );
       attrib.add(scalar,         "scalar"         );
@@ -1712,6 +1797,9 @@ public:
       attrib.add(format,         "format"         );
       attrib.add(throttle,       "throttle"       );
       attrib.add(verbose_write,  "verbose"        );
+      attrib.add(stream_write,   "stream"         );
+      attrib.add(stream_rows,    "buffer_rows"    );
+      attrib.add(compression,    "compression"    );
       attrib.add(array,          "particle"          );//legacy
       attrib.add(array_defaults, "particle_defaults" );//legacy
       attrib.put(cur);
@@ -1721,6 +1809,7 @@ public:
       bool use_scalar_defaults = scalar_defaults == "yes";
       bool use_array_defaults  = array_defaults  == "yes";
       verbose                  = verbose_write   == "yes";
+      stream                   = stream_write    == "yes";
       tolower(format);
       if(format=="hdf")
       {
@@ -1746,6 +1835,15 @@ public:
         APP_ABORT("TraceManager::put "+format+" is not a valid file format for traces\n  valid options is: hdf");
       }
 #endif
+      if(stream)
+      {
+        if(adios_format)
+          APP_ABORT("TraceManager::put  streaming traces are only supported with format=\"hdf\"");
+        if(stream_rows<1)
+          APP_ABORT("TraceManager::put  buffer_rows must be positive for streaming traces");
+        if(compression<0 || compression>9)
+          APP_ABORT("TraceManager::put  compression must be between 0 (none) and 9");
+      }
 
 
       //read scalar and array elements
@@ -2072,6 +2170,8 @@ public:
     {
       if(verbose)
         app_log()<<" TraceManager::buffer_sample() "<<master_copy<< std::endl;
+      if(stream && (int_buffer.full(stream_rows) || real_buffer.full(stream_rows)))
+        stream_buffers();
       int_buffer.collect_sample();
       real_buffer.collect_sample();
     }
@@ -2090,7 +2190,10 @@ public:
           app_log()<<"TraceManager::write_buffers "<<master_copy<< std::endl;
         if(hdf_format)
         {
-          write_buffers_hdf(clones);
+          if(stream)
+            write_buffers_stream(clones);
+          else
+            write_buffers_hdf(clones);
         }
         if(adios_format)
         {
@@ -2175,6 +2278,8 @@ public:
       initialize_traces();
       check_clones(clones);
       open_file(clones);
+      if(stream && writing_traces)
+        start_stream_writer(clones);
     }
     else
       APP_ABORT("TraceManager::startRun should not be called from non-master copy");
@@ -2187,6 +2292,8 @@ public:
       app_log()<<"TraceManager::stopRun "<<master_copy<< std::endl;
     if(master_copy)
     {
+      if(stream && writing_traces)
+        stop_stream_writer();
       close_file();
       finalize_traces();
     }
@@ -2219,6 +2326,7 @@ public:
     app_log()<<pad2<<"method_allows_traces    = "<<method_allows_traces     << std::endl;
     app_log()<<pad2<<"streaming_traces        = "<<streaming_traces         << std::endl;
     app_log()<<pad2<<"writing_traces          = "<<writing_traces           << std::endl;
+    app_log()<<pad2<<"stream                  = "<<stream                   << std::endl;
     app_log()<<pad2<<"format                  = "<<format                   << std::endl;
     app_log()<<pad2<<"hdf format              = "<<hdf_format               << std::endl;
     app_log()<<pad2<<"adios format            = "<<adios_format             << std::endl;
@@ -2298,6 +2406,151 @@ public:
   }
 
 
+  //streaming hdf output
+  //  with a thread-safe hdf5 library a background thread appends the standby rows of the clones,
+  //  otherwise each clone appends its filled rows synchronously when they reach stream_rows,
+  //  one clone at a time under stream_mutex, so that all the hdf5 calls are serialized
+  inline void start_stream_writer(std::vector<TraceManager*>& clones)
+  {
+    if(verbose)
+      app_log()<<"TraceManager::start_stream_writer "<<master_copy<< std::endl;
+    for(int ip=0; ip<clones.size(); ++ip)
+    {
+      TraceManager& tm = *clones[ip];
+      tm.stream_master = this;
+      tm.standby_busy  = false;
+      tm.stall_time    = 0.0;
+      tm.int_buffer.reserve_rows(stream_rows);
+      tm.real_buffer.reserve_rows(stream_rows);
+    }
+    stream_queue.clear();
+    stream_stop          = false;
+    stream_bytes         = 0.0;
+    stream_time          = 0.0;
+    stream_stall         = 0.0;
+    stream_time_reported = 0.0;
+    if(stream_write_timer==0)
+    {
+      stream_write_timer = TimerManager.createTimer("TraceManager::streamWrite",timer_level_coarse);
+      stream_stall_timer = TimerManager.createTimer("TraceManager::streamStall",timer_level_coarse);
+    }
+#if defined(H5_HAVE_THREADSAFE)
+    stream_writer = std::thread(&TraceManager::stream_writer_loop,this);
+#else
+    app_log()<<"  TraceManager: hdf5 is not thread-safe, streamed traces are written by the driver threads one at a time"<< std::endl;
+#endif
+  }
+
+
+  inline void stream_writer_loop()
+  {
+    std::unique_lock<std::mutex> lock(stream_mutex);
+    while(true)
+    {
+      stream_cv.wait(lock,[this] {return stream_stop || !stream_queue.empty();});
+      if(stream_queue.empty())
+        break;
+      TraceManager* tm = stream_queue.front();
+      lock.unlock();
+      double elapsed = write_standby(*tm);
+      lock.lock();
+      count_standby(*tm,elapsed);
+      //pop after the write so that an empty queue means all rows are on disk
+      stream_queue.pop_front();
+      tm->standby_busy = false;
+      stream_cv.notify_all();
+    }
+  }
+
+
+  //append the standby rows of a clone and return the time spent
+  inline double write_standby(TraceManager& tm)
+  {
+    double tstart = cpu_clock();
+    tm.int_buffer.write_hdf(*hdf_file,int_buffer.hdf_file_pointer,tm.int_buffer.standby,stream_rows,compression);
+    tm.real_buffer.write_hdf(*hdf_file,real_buffer.hdf_file_pointer,tm.real_buffer.standby,stream_rows,compression);
+    return cpu_clock()-tstart;
+  }
+
+
+  //called with stream_mutex held
+  inline void count_standby(TraceManager& tm,double elapsed)
+  {
+    stream_bytes += tm.int_buffer.standby.size()*sizeof(TraceInt)+tm.real_buffer.standby.size()*sizeof(TraceReal);
+    stream_time  += elapsed;
+  }
+
+
+  //clone: hand the filled rows to the writer, waiting while the previous rows are in flight
+  inline void stream_buffers()
+  {
+    TraceManager& m = *stream_master;
+    std::unique_lock<std::mutex> lock(m.stream_mutex);
+    double tstart = cpu_clock();
+    m.stream_cv.wait(lock,[this] {return !standby_busy;});
+    int_buffer.swap_standby();
+    real_buffer.swap_standby();
+    if(m.stream_writer.joinable())
+    {
+      standby_busy = true;
+      m.stream_queue.push_back(this);
+      m.stream_cv.notify_all();
+    }
+    else
+      m.count_standby(*this,m.write_standby(*this));
+    stall_time += cpu_clock()-tstart;
+  }
+
+
+  //block end: queue the partially filled buffers and report the writer activity to the timers
+  inline void write_buffers_stream(std::vector<TraceManager*>& clones)
+  {
+    if(verbose)
+      app_log()<<"TraceManager::write_buffers_stream "<<master_copy<< std::endl;
+    double stall = 0.0;
+    for(int ip=0; ip<clones.size(); ++ip)
+    {
+      TraceManager& tm = *clones[ip];
+      if(tm.int_buffer.buffer.size(0)>0 || tm.real_buffer.buffer.size(0)>0)
+        tm.stream_buffers();
+      stall += tm.stall_time;
+      tm.stall_time = 0.0;
+    }
+    double write_time;
+    {
+      std::lock_guard<std::mutex> lock(stream_mutex);
+      write_time = stream_time-stream_time_reported;
+      stream_time_reported = stream_time;
+    }
+    stream_stall += stall;
+    stream_write_timer->add_time(write_time);
+    stream_stall_timer->add_time(stall);
+  }
+
+
+  inline void stop_stream_writer()
+  {
+    if(verbose)
+      app_log()<<"TraceManager::stop_stream_writer "<<master_copy<< std::endl;
+    if(stream_writer.joinable())
+    {
+      {
+        std::lock_guard<std::mutex> lock(stream_mutex);
+        stream_stop = true;
+      }
+      stream_cv.notify_all();
+      stream_writer.join();
+    }
+    stream_write_timer->add_time(stream_time-stream_time_reported,0);
+    stream_time_reported = stream_time;
+    const double mb = stream_bytes/1048576.0;
+    app_log()<<"  TraceManager streamed "<<mb<<" MB of traces in "<<stream_time<<" s of writes";
+    if(stream_time>0.0)
+      app_log()<<" ("<<mb/stream_time<<" MB/s)";
+    app_log()<<", driver stalled for "<<stream_stall<<" s"<< std::endl;
+  }
+
+
 #ifdef HAVE_ADIOS /* Norbert's new code */
 
     template<typename TraceT, typename ADIOST>
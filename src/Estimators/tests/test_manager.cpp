@@ -19,10 +19,12 @@
 #include "QMCHamiltonians/QMCHamiltonian.h"
 #include "Estimators/EstimatorManager.h"
 #include "Estimators/ScalarEstimatorBase.h"
+#include "Estimators/LocalEnergyOnlyEstimator.h"
 
 
 #include <stdio.h>
 #include <sstream>
+#include <limits>
 
 namespace qmcplusplus
 {
@@ -72,4 +74,49 @@ TEST_CASE("EstimatorManager", "[estimators]")
 
 }
 
+TEST_CASE("EstimatorManager stopBlock with clones", "[estimators]")
+{
+  Communicate *c = OHMMS::Controller;
+
+  MCWalkerConfiguration W;
+  W.setName("electrons");
+  W.create(1);
+  W.createWalkers(4);
+  W.setGlobalNumWalkers(4);
+  for (int iw = 0; iw < 3; iw++)
+    W[iw]->Properties(LOCALENERGY) = 1.0;
+  W[3]->Properties(LOCALENERGY) = 9.0;
+
+  EstimatorManager em(c);
+  em.add(new LocalEnergyOnlyEstimator, "LocalEnergy");
+  em.start(1, false);
+
+  // the threads advance 3, 1 and no walkers in a block
+  std::vector<EstimatorManager*> clones(3);
+  // an empty clone has no acceptance ratio
+  EstimatorManager::RealType accept[] = {0.5, 0.9, std::numeric_limits<EstimatorManager::RealType>::quiet_NaN()};
+  int first[] = {0, 3, 4};
+  int last[] = {3, 4, 4};
+  for (int ip = 0; ip < clones.size(); ip++)
+  {
+    clones[ip] = new EstimatorManager(em);
+    clones[ip]->start(1, false);
+    clones[ip]->startBlock(1);
+    clones[ip]->accumulate(W, W.begin()+first[ip], W.begin()+last[ip]);
+    clones[ip]->stopBlock(accept[ip], false);
+  }
+
+  em.startBlock(1);
+  em.stopBlock(clones);
+
+  // the averages are weighted by the walkers of each clone
+  EstimatorManager::RealType e, w, var;
+  em.getEnergyAndWeight(e, w, var);
+  REQUIRE(e == Approx(3.0));
+  REQUIRE(em.getProperty(em.addProperty("BlockWeight")) == Approx(4.0));
+  REQUIRE(em.getProperty(em.addProperty("AcceptRatio")) == Approx(0.6));
+
+  delete_iter(clones.begin(), clones.end());
+}
+
 }
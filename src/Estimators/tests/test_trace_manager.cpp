@@ -0,0 +1,131 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "Message/Communicate.h"
+#include "OhmmsData/Libxml2Doc.h"
+#include "Utilities/OhmmsInfo.h"
+#include "Estimators/TraceManager.h"
+
+
+#include <stdio.h>
+#include <sstream>
+
+namespace qmcplusplus
+{
+
+/// read a 2D trace dataset of the traces file
+template<typename T>
+void read_traces(hid_t file, const char* name, std::vector<T>& data, hsize_t* dims)
+{
+  hid_t dset = H5Dopen(file, name);
+  REQUIRE(dset >= 0);
+  hid_t space = H5Dget_space(dset);
+  H5Sget_simple_extent_dims(space, dims, NULL);
+  data.resize(dims[0]*dims[1]);
+  T dummy(0);
+  H5Dread(dset, get_h5_datatype(dummy), H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data());
+  H5Sclose(space);
+  H5Dclose(dset);
+}
+
+TEST_CASE("TraceManager streaming", "[estimators][traces]")
+{
+  OHMMS::Controller->initialize(0, NULL);
+  Communicate *c = OHMMS::Controller;
+  OhmmsInfo("testlogfile");
+
+  // three rows per buffer, every clone streams several times per block
+  const char *traces_xml = "<traces stream=\"yes\" buffer_rows=\"3\" compression=\"1\"/>";
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(traces_xml);
+  REQUIRE(okay);
+
+  TraceManager tm(c);
+  tm.put(doc.getRoot(), true, "test_stream");
+  REQUIRE(tm.stream);
+
+  const int nclones = 2;
+  const int nblocks = 2;
+  const int nsteps = 4;
+  const int nw = 2;
+  std::vector<TraceManager*> clones(nclones);
+  std::vector<Array<TraceInt,1>*> ids(nclones);
+  std::vector<Array<TraceReal,1>*> weights(nclones);
+  for (int ip = 0; ip < nclones; ip++)
+  {
+    // emulate QMCHamiltonian::initialize_traces for two default scalars
+    TraceManager& clone = *(clones[ip] = tm.makeClone());
+    TraceRequest req;
+    req.contribute_scalar("id", true);
+    req.contribute_scalar("weight", true);
+    clone.request.incorporate(req);
+    clone.request.determine_stream_write();
+    clone.request.relay_stream_info(req);
+    clone.update_status();
+    ids[ip] = clone.checkout_int<1>("id");
+    weights[ip] = clone.checkout_real<1>("weight");
+    clone.screen_writes();
+    clone.initialize_traces();
+  }
+
+  long idsum = 0;
+  tm.startRun(nblocks, clones);
+  for (int block = 0; block < nblocks; block++)
+  {
+    for (int ip = 0; ip < nclones; ip++)
+      clones[ip]->startBlock(nsteps);
+    for (int step = 0; step < nsteps; step++)
+      for (int ip = 0; ip < nclones; ip++)
+        for (int iw = 0; iw < nw; iw++)
+        {
+          long id = 1000*ip + 100*block + 10*step + iw;
+          (*ids[ip])(0) = id;
+          (*weights[ip])(0) = id + 0.5;
+          clones[ip]->buffer_sample(step);
+          idsum += id;
+        }
+    tm.write_buffers(clones, block);
+  }
+  tm.stopRun();
+  for (int ip = 0; ip < nclones; ip++)
+  {
+    clones[ip]->finalize_traces();
+    delete ids[ip];
+    delete weights[ip];
+    delete clones[ip];
+  }
+
+  // every sample is on disk once, the int and real rows are written in lockstep
+  hid_t file = H5Fopen("test_stream.traces.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+  REQUIRE(file >= 0);
+  std::vector<TraceInt> id_data;
+  std::vector<TraceReal> weight_data;
+  hsize_t int_dims[2], real_dims[2];
+  read_traces(file, "int_data/traces", id_data, int_dims);
+  read_traces(file, "real_data/traces", weight_data, real_dims);
+  H5Fclose(file);
+  REQUIRE(int_dims[0] == nclones*nblocks*nsteps*nw);
+  REQUIRE(int_dims[1] == 1);
+  REQUIRE(real_dims[0] == int_dims[0]);
+  REQUIRE(real_dims[1] == 1);
+  long idsum_file = 0;
+  for (int i = 0; i < id_data.size(); i++)
+  {
+    REQUIRE(weight_data[i] == Approx(id_data[i] + 0.5));
+    idsum_file += id_data[i];
+  }
+  REQUIRE(idsum_file == idsum);
+}
+
+}
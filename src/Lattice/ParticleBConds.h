@@ -60,6 +60,7 @@ struct PowerOfN<N,0>
  * - apply_bc(dr,r,rinv): apply BC on displacements
  * - apply_bc(dr,r): apply BC without inversion calculations
  * - evaluate_rsq(dr,rr,n): apply BC on dr, and compute r*r
+ * - computeDistances(pos,R0,temp_r,temp_dr,first,last): SoA kernel used by SoaDistanceTableAA/BA
  */
 template<class T, unsigned D, int SC>
 struct DTD_BConds
@@ -107,6 +108,126 @@ struct DTD_BConds
     for(int i=0; i<n; ++i)
       rr[i]=dot(dr[i],dr[i]);
   }
+
+  /** compute the distances and the displacements with the SoA layout
+   * @param pos position of the target particle
+   * @param R0 SoA positions of the sources
+   * @param temp_r distances |R0[iat]-pos|
+   * @param temp_dr displacements R0[iat]-pos
+   * @param first index of the first source
+   * @param last index of the last source
+   */
+  template<typename PT, typename RSoA>
+  inline void computeDistances(const PT& pos, const RSoA& R0, T* restrict temp_r, RSoA& temp_dr
+                               , int first, int last) const
+  {
+    for(int iat=first; iat<last; ++iat)
+      temp_r[iat]=T();
+    for(unsigned d=0; d<D; ++d)
+    {
+      const T x0=pos[d];
+      const T* restrict px=R0.data(d);
+      T* restrict dx=temp_dr.data(d);
+      #pragma omp simd
+      for(int iat=first; iat<last; ++iat)
+      {
+        dx[iat]=px[iat]-x0;
+        temp_r[iat]+=dx[iat]*dx[iat];
+      }
+    }
+    for(int iat=first; iat<last; ++iat)
+      temp_r[iat]=std::sqrt(temp_r[iat]);
+  }
+};
+
+/** compute the SoA distances with the scalar apply_bc of a boundary condition
+ *
+ * Fallback of the general cells for the BGQPX build.
+ * The arguments are the same as those of DTD_BConds::computeDistances.
+ */
+template<typename BC, typename PT, typename T, typename RSoA>
+inline void computeDistancesByImage(const BC& bc, const PT& pos, const RSoA& R0, T* restrict temp_r, RSoA& temp_dr
+                                    , int first, int last)
+{
+  for(int iat=first; iat<last; ++iat)
+  {
+    PT displ=R0[iat]-pos;
+    temp_r[iat]=std::sqrt(bc.apply_bc(displ));
+    temp_dr.set(iat,displ);
+  }
+}
+
+/** image shifts of a general cell in the SoA layout
+ *
+ * The general cells put the displacements in the cell and search the images
+ * for the minimum distance. The search is a short inner loop so that the
+ * loop over the sources in searchMin vectorizes.
+ */
+template<typename T>
+struct ImageShiftsSoA
+{
+  std::vector<T> X, Y, Z;
+
+  /** copy the shifts [first,shifts.size()) */
+  template<typename PT>
+  inline void assign(const std::vector<PT>& shifts, int first)
+  {
+    const int n=shifts.size()-first;
+    X.resize(n);
+    Y.resize(n);
+    Z.resize(n);
+    for(int i=0; i<n; ++i)
+    {
+      X[i]=shifts[first+i][0];
+      Y[i]=shifts[first+i][1];
+      Z[i]=shifts[first+i][2];
+    }
+  }
+
+  /** replace the displacements in the cell by the minimum images
+   * @param temp_r minimum-image distances
+   * @param temp_dr displacements in the cell, replaced by the minimum images
+   * @param first index of the first source
+   * @param last index of the last source
+   */
+  template<typename RSoA>
+  inline void searchMin(T* restrict temp_r, RSoA& temp_dr, int first, int last) const
+  {
+    const int n=X.size();
+    const T* restrict cx=X.data();
+    const T* restrict cy=Y.data();
+    const T* restrict cz=Z.data();
+    T* restrict dx=temp_dr.data(0);
+    T* restrict dy=temp_dr.data(1);
+    T* restrict dz=temp_dr.data(2);
+    #pragma omp simd
+    for(int iat=first; iat<last; ++iat)
+    {
+      const T x=dx[iat];
+      const T y=dy[iat];
+      const T z=dz[iat];
+      T rmin2=x*x+y*y+z*z;
+      T sx=T(), sy=T(), sz=T();
+      for(int i=0; i<n; ++i)
+      {
+        const T tx=x+cx[i];
+        const T ty=y+cy[i];
+        const T tz=z+cz[i];
+        const T r2=tx*tx+ty*ty+tz*tz;
+        if(r2<rmin2)
+        {
+          rmin2=r2;
+          sx=cx[i];
+          sy=cy[i];
+          sz=cz[i];
+        }
+      }
+      dx[iat]=x+sx;
+      dy[iat]=y+sy;
+      dz[iat]=z+sz;
+      temp_r[iat]=std::sqrt(rmin2);
+    }
+  }
 };
 
 }
@@ -78,6 +78,32 @@ struct DTD_BConds<T,3,PPPO>
     for(int i=0; i<n; ++i)
       rr[i]=apply_bc(dr[i]);
   }
+
+  template<typename PT, typename RSoA>
+  inline void computeDistances(const PT& pos, const RSoA& R0, T* restrict temp_r, RSoA& temp_dr
+                               , int first, int last) const
+  {
+    const T x0=pos[0];
+    const T y0=pos[1];
+    const T z0=pos[2];
+    const T* restrict px=R0.data(0);
+    const T* restrict py=R0.data(1);
+    const T* restrict pz=R0.data(2);
+    T* restrict dx=temp_dr.data(0);
+    T* restrict dy=temp_dr.data(1);
+    T* restrict dz=temp_dr.data(2);
+    #pragma omp simd
+    for(int iat=first; iat<last; ++iat)
+    {
+      const T x=(px[iat]-x0)*Linv0;
+      const T y=(py[iat]-y0)*Linv1;
+      const T z=(pz[iat]-z0)*Linv2;
+      dx[iat]=L0*(x-round(x));
+      dy[iat]=L1*(y-round(y));
+      dz[iat]=L2*(z-round(z));
+      temp_r[iat]=std::sqrt(dx[iat]*dx[iat]+dy[iat]*dy[iat]+dz[iat]*dz[iat]);
+    }
+  }
 };
 
 /** specialization for a periodic 3D general cell with wigner-seitz==simulation cell
@@ -144,6 +170,38 @@ struct DTD_BConds<T,3,PPPS>
     for(int i=0; i<n; ++i)
       rr[i]=apply_bc(dr[i]);
   }
+
+  template<typename PT, typename RSoA>
+  inline void computeDistances(const PT& pos, const RSoA& R0, T* restrict temp_r, RSoA& temp_dr
+                               , int first, int last) const
+  {
+    const T x0=pos[0];
+    const T y0=pos[1];
+    const T z0=pos[2];
+    const T* restrict px=R0.data(0);
+    const T* restrict py=R0.data(1);
+    const T* restrict pz=R0.data(2);
+    T* restrict dx=temp_dr.data(0);
+    T* restrict dy=temp_dr.data(1);
+    T* restrict dz=temp_dr.data(2);
+    #pragma omp simd
+    for(int iat=first; iat<last; ++iat)
+    {
+      const T displ_0=px[iat]-x0;
+      const T displ_1=py[iat]-y0;
+      const T displ_2=pz[iat]-z0;
+      T ar_0=displ_0*g00+displ_1*g10+displ_2*g20;
+      T ar_1=displ_0*g01+displ_1*g11+displ_2*g21;
+      T ar_2=displ_0*g02+displ_1*g12+displ_2*g22;
+      ar_0-=round(ar_0);
+      ar_1-=round(ar_1);
+      ar_2-=round(ar_2);
+      dx[iat]=ar_0*r00+ar_1*r10+ar_2*r20;
+      dy[iat]=ar_0*r01+ar_1*r11+ar_2*r21;
+      dz[iat]=ar_0*r02+ar_1*r12+ar_2*r22;
+      temp_r[iat]=std::sqrt(dx[iat]*dx[iat]+dy[iat]*dy[iat]+dz[iat]*dz[iat]);
+    }
+  }
 };
 
 /** specialization for a periodic 3D general cell
@@ -164,6 +222,8 @@ struct DTD_BConds<T,3,PPPG>
 #endif
   TinyVector<TinyVector<T,3>,3> rb;
   std::vector<TinyVector<T,3> > corners;
+  ///corners other than the origin for the SoA image search
+  ImageShiftsSoA<T> images;
 
   DTD_BConds(const CrystalLattice<T,3>& lat)
   {
@@ -186,6 +246,7 @@ struct DTD_BConds<T,3,PPPG>
     corners[5]=minusone*(rb[0]+rb[2]);
     corners[6]=minusone*(rb[1]+rb[2]);
     corners[7]=minusone*(rb[0]+rb[1]+rb[2]);
+    images.assign(corners,1);
 
 #ifdef BGQPX
     g0[0]=g(0);
@@ -375,6 +436,39 @@ struct DTD_BConds<T,3,PPPG>
     for(int i=0; i<n; ++i)
       rr[i]=apply_bc(dr[i]);
   }
+
+  template<typename PT, typename RSoA>
+  inline void computeDistances(const PT& pos, const RSoA& R0, T* restrict temp_r, RSoA& temp_dr
+                               , int first, int last) const
+  {
+#ifdef BGQPX
+    computeDistancesByImage(*this,pos,R0,temp_r,temp_dr,first,last);
+#else
+    const T x0=pos[0];
+    const T y0=pos[1];
+    const T z0=pos[2];
+    const T* restrict px=R0.data(0);
+    const T* restrict py=R0.data(1);
+    const T* restrict pz=R0.data(2);
+    T* restrict dx=temp_dr.data(0);
+    T* restrict dy=temp_dr.data(1);
+    T* restrict dz=temp_dr.data(2);
+    #pragma omp simd
+    for(int iat=first; iat<last; ++iat)
+    {
+      const T displ_0=px[iat]-x0;
+      const T displ_1=py[iat]-y0;
+      const T displ_2=pz[iat]-z0;
+      const T ar_0=-std::floor(displ_0*g00+displ_1*g10+displ_2*g20);
+      const T ar_1=-std::floor(displ_0*g01+displ_1*g11+displ_2*g21);
+      const T ar_2=-std::floor(displ_0*g02+displ_1*g12+displ_2*g22);
+      dx[iat]=displ_0+ar_0*rb[0][0]+ar_1*rb[1][0]+ar_2*rb[2][0];
+      dy[iat]=displ_1+ar_0*rb[0][1]+ar_1*rb[1][1]+ar_2*rb[2][1];
+      dz[iat]=displ_2+ar_0*rb[0][2]+ar_1*rb[1][2]+ar_2*rb[2][2];
+    }
+    images.searchMin(temp_r,temp_dr,first,last);
+#endif
+  }
 };
 
 
@@ -386,6 +480,8 @@ struct DTD_BConds<T,3,PPNG>
   T g00,g10,g01,g11;
   TinyVector<TinyVector<T,3>,3> rb;
   std::vector<TinyVector<T,3> > corners;
+  ///corners other than the origin for the SoA image search
+  ImageShiftsSoA<T> images;
 
   DTD_BConds(const CrystalLattice<T,3>& lat)
   {
@@ -402,6 +498,7 @@ struct DTD_BConds<T,3,PPNG>
     corners[1]=minusone*(rb[0]);
     corners[2]=minusone*(rb[1]);
     corners[3]=minusone*(rb[0]+rb[1]);
+    images.assign(corners,1);
   }
 
   inline T apply_bc(TinyVector<T,3>& displ)  const
@@ -454,6 +551,36 @@ struct DTD_BConds<T,3,PPNG>
     for(int i=0; i<n; ++i)
       rr[i]=apply_bc(dr[i]);
   }
+
+  template<typename PT, typename RSoA>
+  inline void computeDistances(const PT& pos, const RSoA& R0, T* restrict temp_r, RSoA& temp_dr
+                               , int first, int last) const
+  {
+    const T x0=pos[0];
+    const T y0=pos[1];
+    const T z0=pos[2];
+    const T* restrict px=R0.data(0);
+    const T* restrict py=R0.data(1);
+    const T* restrict pz=R0.data(2);
+    T* restrict dx=temp_dr.data(0);
+    T* restrict dy=temp_dr.data(1);
+    T* restrict dz=temp_dr.data(2);
+    #pragma omp simd
+    for(int iat=first; iat<last; ++iat)
+    {
+      const T displ_0=px[iat]-x0;
+      const T displ_1=py[iat]-y0;
+      const T displ_2=pz[iat]-z0;
+      T ar_0=displ_0*g00+displ_1*g10;
+      T ar_1=displ_0*g01+displ_1*g11;
+      ar_0-=std::floor(ar_0);
+      ar_1-=std::floor(ar_1);
+      dx[iat]=displ_0+ar_0*rb[0][0]+ar_1*rb[1][0];
+      dy[iat]=displ_1+ar_0*rb[0][1]+ar_1*rb[1][1];
+      dz[iat]=displ_2+ar_0*rb[0][2]+ar_1*rb[1][2];
+    }
+    images.searchMin(temp_r,temp_dr,first,last);
+  }
 };
 
 /** specialization for a slab, orthorombic cell
@@ -507,6 +634,31 @@ struct DTD_BConds<T,3,PPNO>
     for(int i=0; i<n; ++i)
       rr[i]=apply_bc(dr[i]);
   }
+
+  template<typename PT, typename RSoA>
+  inline void computeDistances(const PT& pos, const RSoA& R0, T* restrict temp_r, RSoA& temp_dr
+                               , int first, int last) const
+  {
+    const T x0=pos[0];
+    const T y0=pos[1];
+    const T z0=pos[2];
+    const T* restrict px=R0.data(0);
+    const T* restrict py=R0.data(1);
+    const T* restrict pz=R0.data(2);
+    T* restrict dx=temp_dr.data(0);
+    T* restrict dy=temp_dr.data(1);
+    T* restrict dz=temp_dr.data(2);
+    #pragma omp simd
+    for(int iat=first; iat<last; ++iat)
+    {
+      const T x=(px[iat]-x0)*Linv0;
+      const T y=(py[iat]-y0)*Linv1;
+      dx[iat]=L0*(x-round(x));
+      dy[iat]=L1*(y-round(y));
+      dz[iat]=pz[iat]-z0;
+      temp_r[iat]=std::sqrt(dx[iat]*dx[iat]+dy[iat]*dy[iat]+dz[iat]*dz[iat]);
+    }
+  }
 };
 
 template<class T>
@@ -564,6 +716,35 @@ struct DTD_BConds<T,3,PPNS>
     for(int i=0; i<n; ++i)
       rr[i]=apply_bc(dr[i]);
   }
+
+  template<typename PT, typename RSoA>
+  inline void computeDistances(const PT& pos, const RSoA& R0, T* restrict temp_r, RSoA& temp_dr
+                               , int first, int last) const
+  {
+    const T x0=pos[0];
+    const T y0=pos[1];
+    const T z0=pos[2];
+    const T* restrict px=R0.data(0);
+    const T* restrict py=R0.data(1);
+    const T* restrict pz=R0.data(2);
+    T* restrict dx=temp_dr.data(0);
+    T* restrict dy=temp_dr.data(1);
+    T* restrict dz=temp_dr.data(2);
+    #pragma omp simd
+    for(int iat=first; iat<last; ++iat)
+    {
+      const T displ_0=px[iat]-x0;
+      const T displ_1=py[iat]-y0;
+      T ar_0=displ_0*g00+displ_1*g10;
+      T ar_1=displ_0*g01+displ_1*g11;
+      ar_0-=round(ar_0);
+      ar_1-=round(ar_1);
+      dx[iat]=ar_0*r00+ar_1*r10;
+      dy[iat]=ar_0*r01+ar_1*r11;
+      dz[iat]=pz[iat]-z0;
+      temp_r[iat]=std::sqrt(dx[iat]*dx[iat]+dy[iat]*dy[iat]+dz[iat]*dz[iat]);
+    }
+  }
 };
 
 
@@ -618,6 +799,30 @@ struct DTD_BConds<T,3,SUPERCELL_WIRE>
     for(int i=0; i<n; ++i)
       rr[i]=apply_bc(dr[i]);
   }
+
+  template<typename PT, typename RSoA>
+  inline void computeDistances(const PT& pos, const RSoA& R0, T* restrict temp_r, RSoA& temp_dr
+                               , int first, int last) const
+  {
+    const T x0=pos[0];
+    const T y0=pos[1];
+    const T z0=pos[2];
+    const T* restrict px=R0.data(0);
+    const T* restrict py=R0.data(1);
+    const T* restrict pz=R0.data(2);
+    T* restrict dx=temp_dr.data(0);
+    T* restrict dy=temp_dr.data(1);
+    T* restrict dz=temp_dr.data(2);
+    #pragma omp simd
+    for(int iat=first; iat<last; ++iat)
+    {
+      const T x=(px[iat]-x0)*Linv0;
+      dx[iat]=L0*(x-round(x));
+      dy[iat]=py[iat]-y0;
+      dz[iat]=pz[iat]-z0;
+      temp_r[iat]=std::sqrt(dx[iat]*dx[iat]+dy[iat]*dy[iat]+dz[iat]*dz[iat]);
+    }
+  }
 };
 
 /** specialization for a periodic 3D general cell
@@ -631,6 +836,8 @@ struct DTD_BConds<T,3,PPPX>
   T g00,g10,g20,g01,g11,g21,g02,g12,g22;
   T r2max;
   std::vector<TinyVector<T,3> > nextcells;
+  ///nextcells for the SoA image search
+  ImageShiftsSoA<T> images;
 
   DTD_BConds(const CrystalLattice<T,3>& lat)
     : r00(lat.R(0)),r10(lat.R(3)),r20(lat.R(6))
@@ -654,6 +861,7 @@ struct DTD_BConds<T,3,PPPX>
           nextcells[ic][2]=i*r02+j*r12+k*r22;
           ++ic;
         }
+    images.assign(nextcells,0);
   }
 
   /** evaluate the minimum distance
@@ -768,6 +976,38 @@ struct DTD_BConds<T,3,PPPX>
     for(int i=0; i<n; ++i)
       rr[i]=apply_bc(dr[i]);
   }
+
+  template<typename PT, typename RSoA>
+  inline void computeDistances(const PT& pos, const RSoA& R0, T* restrict temp_r, RSoA& temp_dr
+                               , int first, int last) const
+  {
+    const T x0=pos[0];
+    const T y0=pos[1];
+    const T z0=pos[2];
+    const T* restrict px=R0.data(0);
+    const T* restrict py=R0.data(1);
+    const T* restrict pz=R0.data(2);
+    T* restrict dx=temp_dr.data(0);
+    T* restrict dy=temp_dr.data(1);
+    T* restrict dz=temp_dr.data(2);
+    #pragma omp simd
+    for(int iat=first; iat<last; ++iat)
+    {
+      const T displ_0=px[iat]-x0;
+      const T displ_1=py[iat]-y0;
+      const T displ_2=pz[iat]-z0;
+      T ar_0=displ_0*g00+displ_1*g10+displ_2*g20;
+      T ar_1=displ_0*g01+displ_1*g11+displ_2*g21;
+      T ar_2=displ_0*g02+displ_1*g12+displ_2*g22;
+      ar_0-=round(ar_0);
+      ar_1-=round(ar_1);
+      ar_2-=round(ar_2);
+      dx[iat]=ar_0*r00+ar_1*r10+ar_2*r20;
+      dy[iat]=ar_0*r01+ar_1*r11+ar_2*r21;
+      dz[iat]=ar_0*r02+ar_1*r12+ar_2*r22;
+    }
+    images.searchMin(temp_r,temp_dr,first,last);
+  }
 };
 
 /** specialization for a slab, general cell
@@ -779,6 +1019,8 @@ struct DTD_BConds<T,3,PPNX>
   T g00,g10,g01,g11;
   T r2max;
   std::vector<TinyVector<T,3> > nextcells;
+  ///nextcells for the SoA image search
+  ImageShiftsSoA<T> images;
 
   DTD_BConds(const CrystalLattice<T,3>& lat)
     : r00(lat.R(0)),r10(lat.R(3))
@@ -799,6 +1041,7 @@ struct DTD_BConds<T,3,PPNX>
         nextcells[ic][2]=0;
         ++ic;
       }
+    images.assign(nextcells,0);
   }
 
   /** evaluate the minimum distance
@@ -876,6 +1119,36 @@ struct DTD_BConds<T,3,PPNX>
     for(int i=0; i<n; ++i)
       rr[i]=apply_bc(dr[i]);
   }
+
+  template<typename PT, typename RSoA>
+  inline void computeDistances(const PT& pos, const RSoA& R0, T* restrict temp_r, RSoA& temp_dr
+                               , int first, int last) const
+  {
+    const T x0=pos[0];
+    const T y0=pos[1];
+    const T z0=pos[2];
+    const T* restrict px=R0.data(0);
+    const T* restrict py=R0.data(1);
+    const T* restrict pz=R0.data(2);
+    T* restrict dx=temp_dr.data(0);
+    T* restrict dy=temp_dr.data(1);
+    T* restrict dz=temp_dr.data(2);
+    #pragma omp simd
+    for(int iat=first; iat<last; ++iat)
+    {
+      const T displ_0=px[iat]-x0;
+      const T displ_1=py[iat]-y0;
+      const T displ_2=pz[iat]-z0;
+      T ar_0=displ_0*g00+displ_1*g10;
+      T ar_1=displ_0*g01+displ_1*g11;
+      ar_0-=round(ar_0);
+      ar_1-=round(ar_1);
+      dx[iat]=ar_0*r00+ar_1*r10;
+      dy[iat]=ar_0*r01+ar_1*r11;
+      dz[iat]=displ_2;
+    }
+    images.searchMin(temp_r,temp_dr,first,last);
+  }
 };
 
 
@@ -322,6 +322,18 @@ KContainer::BuildKLists(ParticleLayout_t& lattice, bool useSphere)
   {
     minusk[ki] = hashToIndex[ GetHashOfVec(-1 * kpts[ki], numk) ];
   }
+  //SoA copies for the vectorized evaluation of exp(ik.r)
+  kpts_cart_soa.resize(numk);
+  kpts_cart_soa.copyIn(kpts_cart);
+  kpts_index.resize(numk);
+  for(int ki=0; ki<numk; ki++)
+    kpts_index.set(ki,kpts[ki]+mmax[DIM]);
+  for(int idim=0; idim<DIM; idim++)
+  {
+    PosType unit;
+    unit[idim]=1.0;
+    kunit_cart[idim]=lattice.k_cart(unit);
+  }
 }
 
 }
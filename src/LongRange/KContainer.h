@@ -22,6 +22,7 @@
 #include "Utilities/PooledData.h"
 #include "Utilities/IteratorUtility.h"
 #include "Utilities/OhmmsInfo.h"
+#include "OhmmsSoA/VectorSoaContainer.h"
 namespace qmcplusplus
 {
 
@@ -86,6 +87,15 @@ public:
   std::vector<int> minusk;
   /** kpts which belong to the ith-shell [kshell[i], kshell[i+1]) */
   std::vector<int> kshell;
+  /** K-vector in Cartesian coordinates in SoA layout
+   */
+  VectorSoaContainer<RealType,DIM> kpts_cart_soa;
+  /** kpts shifted by mmax[DIM], index of K-vector in the recursion tables of StructFact
+   */
+  VectorSoaContainer<int,DIM> kpts_index;
+  /** Cartesian reciprocal vectors of the unit translations, kpts_cart[k]=sum_d kpts[k][d]*kunit_cart[d]
+   */
+  TinyVector<PosType,DIM> kunit_cart;
 
   /** k points sorted by the |k|  excluding |k|=0
    *
@@ -71,6 +71,10 @@ void StructFact::resize(int ns, int nptcl, int nkpts)
 #endif
   int maxdim=KLists.mmax[DIM];
   C.resize(DIM,2*maxdim+1);
+#if defined(USE_REAL_STRUCT_FACTOR)
+  C_r.resize(DIM,2*maxdim+1);
+  C_i.resize(DIM,2*maxdim+1);
+#endif
 }
 
 
@@ -88,48 +92,21 @@ void
 StructFact::FillRhok(ParticleSet& P)
 {
   int npart = P.getTotalNum();
-#if defined(QMC_SK_USE_RECURSIVE)
-  rhok=0.0;
-  for(int i=0; i<npart; i++)
-  {
-    //operate with a reduced positon
-    PosType tau_red=P.LRBox.toUnit(P.R[i]);
-    for(int idim=0; idim<DIM; idim++)
-    {
-      RealType phi=TWOPI*tau_red[idim];
-      ComplexType ctemp(std::cos(phi),std::sin(phi));
-      C(idim,KLists.mmax[idim])=1.0;
-      for(int n=1; n<=KLists.mmax[idim]; n++)
-      {
-        C(idim,KLists.mmax[idim]+n) = ctemp*C(idim,KLists.mmax[idim]+n-1);
-        C(idim,KLists.mmax[idim]-n) = conj(C(idim,KLists.mmax[idim]+n));
-      }
-    }
-    ComplexType* restrict eikr_ref=eikr[i];
-    for(int ki=0; ki<KLists.numk; ki++)
-    {
-      eikr_ref[ki]=C(0,KLists.kpts[ki][0]+KLists.mmax[0]);
-      for(idim=1; idim<DIM; id++)
-        eikr_ref[ki] *= C(idim,KLists.kpts[ki][idim]+KLists.mmax[idim]);
-    }
-    accumulate_elements(eikr_ref,eikr_ref+KLists.numk,rhok[P.GroupID[i]]);
-  } //End particle loop
-#else
 #if defined(USE_REAL_STRUCT_FACTOR)
   rhok_r=0.0;
   rhok_i=0.0;
-  //algorithmA
   const int nk=KLists.numk;
   for(int i=0; i<npart; ++i)
   {
-    //defined in this file
-    simd::get_phase(nk,&(KLists.kpts_cart[0][0]), P.R[i].data(), phiV.data());
-    //get_phase simply encapsulate this
-    eval_e2iphi(nk, phiV.data(), eikr_r[i], eikr_i[i]);
+#if defined(QMC_SK_USE_RECURSIVE)
+    computeEikrRecursive(P.R[i],eikr_r[i],eikr_i[i]);
+#else
+    //recompute from scratch, this also removes the round-off error accumulated by the moves
+    computeEikrSinCos(P.R[i],eikr_r[i],eikr_i[i]);
+#endif
     simd::add(nk,eikr_r[i],rhok_r[P.GroupID[i]]);
     simd::add(nk,eikr_i[i],rhok_i[P.GroupID[i]]);
   }
-  //use dgemm: vtune shows algorithmA is better
 #else
   rhok=0.0;
   for(int i=0; i<npart; i++)
@@ -146,9 +123,80 @@ StructFact::FillRhok(ParticleSet& P)
     }
   }
 #endif
+}
+
+#if defined(USE_REAL_STRUCT_FACTOR)
+void StructFact::computeEikrRecursive(const PosType& pos, RealType* restrict e_r, RealType* restrict e_i)
+{
+  const int m0=KLists.mmax[DIM];
+  //exp(i n k_d.r) for n in [-mmax[d],mmax[d]] by the repeated product of exp(i k_d.r)
+  for(int idim=0; idim<DIM; idim++)
+  {
+    RealType* restrict c_r=C_r[idim]+m0;
+    RealType* restrict c_i=C_i[idim]+m0;
+    RealType s,c;
+    sincos(dot(KLists.kunit_cart[idim],pos),&s,&c);
+    c_r[0]=1.0;
+    c_i[0]=0.0;
+    for(int n=1; n<=KLists.mmax[idim]; n++)
+    {
+      c_r[n]=c*c_r[n-1]-s*c_i[n-1];
+      c_i[n]=s*c_r[n-1]+c*c_i[n-1];
+      c_r[-n]= c_r[n];
+      c_i[-n]=-c_i[n];
+    }
+  }
+  const int nk=KLists.numk;
+  const RealType* restrict cx_r=C_r[0];
+  const RealType* restrict cx_i=C_i[0];
+  const RealType* restrict cy_r=C_r[1];
+  const RealType* restrict cy_i=C_i[1];
+  const int* restrict kx=KLists.kpts_index.data(0);
+  const int* restrict ky=KLists.kpts_index.data(1);
+#if OHMMS_DIM==3
+  const RealType* restrict cz_r=C_r[2];
+  const RealType* restrict cz_i=C_i[2];
+  const int* restrict kz=KLists.kpts_index.data(2);
+  #pragma omp simd
+  for(int ki=0; ki<nk; ki++)
+  {
+    const RealType xy_r=cx_r[kx[ki]]*cy_r[ky[ki]]-cx_i[kx[ki]]*cy_i[ky[ki]];
+    const RealType xy_i=cx_r[kx[ki]]*cy_i[ky[ki]]+cx_i[kx[ki]]*cy_r[ky[ki]];
+    e_r[ki]=xy_r*cz_r[kz[ki]]-xy_i*cz_i[kz[ki]];
+    e_i[ki]=xy_r*cz_i[kz[ki]]+xy_i*cz_r[kz[ki]];
+  }
+#else
+  #pragma omp simd
+  for(int ki=0; ki<nk; ki++)
+  {
+    e_r[ki]=cx_r[kx[ki]]*cy_r[ky[ki]]-cx_i[kx[ki]]*cy_i[ky[ki]];
+    e_i[ki]=cx_r[kx[ki]]*cy_i[ky[ki]]+cx_i[kx[ki]]*cy_r[ky[ki]];
+  }
 #endif
 }
 
+void StructFact::computeEikrSinCos(const PosType& pos, RealType* restrict e_r, RealType* restrict e_i)
+{
+  const int nk=KLists.numk;
+  RealType* restrict phi=phiV.data();
+  const RealType* restrict kx=KLists.kpts_cart_soa.data(0);
+  const RealType* restrict ky=KLists.kpts_cart_soa.data(1);
+#if OHMMS_DIM==3
+  const RealType* restrict kz=KLists.kpts_cart_soa.data(2);
+  const RealType x=pos[0], y=pos[1], z=pos[2];
+  #pragma omp simd
+  for(int ki=0; ki<nk; ki++)
+    phi[ki]=x*kx[ki]+y*ky[ki]+z*kz[ki];
+#else
+  const RealType x=pos[0], y=pos[1];
+  #pragma omp simd
+  for(int ki=0; ki<nk; ki++)
+    phi[ki]=x*kx[ki]+y*ky[ki];
+#endif
+  eval_e2iphi(nk,phi,e_r,e_i);
+}
+#endif
+
 
 void
 StructFact::UpdateRhok(const PosType& rold,const PosType& rnew,int iat,int GroupID)
@@ -162,9 +210,7 @@ StructFact::UpdateRhok(const PosType& rold,const PosType& rnew,int iat,int Group
 void StructFact::makeMove(int active, const PosType& pos)
 {
 #if defined(USE_REAL_STRUCT_FACTOR)
-  for(int ki=0; ki<KLists.numk; ki++)
-    phiV[ki]=dot(KLists.kpts_cart[ki],pos);
-  eval_e2iphi(KLists.numk, phiV.data(), eikr_r_temp.data(), eikr_i_temp.data());
+  computeEikrRecursive(pos,eikr_r_temp.data(),eikr_i_temp.data());
 #else
   RealType s,c;//get sin and cos
   for(int ki=0; ki<KLists.numk; ++ki)
@@ -182,12 +228,15 @@ void StructFact::acceptMove(int active, int gid)
   RealType* restrict eikr_ptr_i=eikr_i[active];
   RealType* restrict rhok_ptr_r(rhok_r[gid]);
   RealType* restrict rhok_ptr_i(rhok_i[gid]);
+  const RealType* restrict eikr_new_r=eikr_r_temp.data();
+  const RealType* restrict eikr_new_i=eikr_i_temp.data();
+  #pragma omp simd
   for(int ki=0; ki<KLists.numk; ++ki)
   {
-    rhok_ptr_r[ki] += (eikr_r_temp[ki]-eikr_ptr_r[ki]);
-    rhok_ptr_i[ki] += (eikr_i_temp[ki]-eikr_ptr_i[ki]);
-    eikr_ptr_r[ki]=eikr_r_temp[ki];
-    eikr_ptr_i[ki]=eikr_i_temp[ki];
+    rhok_ptr_r[ki] += (eikr_new_r[ki]-eikr_ptr_r[ki]);
+    rhok_ptr_i[ki] += (eikr_new_i[ki]-eikr_ptr_i[ki]);
+    eikr_ptr_r[ki]=eikr_new_r[ki];
+    eikr_ptr_i[ki]=eikr_new_i[ki];
   }
 #else
   ComplexType* restrict eikr_ptr=eikr[active];
@@ -177,6 +177,24 @@ public:
 private:
   ///data for recursive evaluation for a given position
   Matrix<ComplexType> C;
+#if defined(USE_REAL_STRUCT_FACTOR)
+  ///real and imaginary parts of exp(i n k_d.r), [DIM][2*mmax[DIM]+1] for the recursive evaluation
+  Matrix<RealType> C_r, C_i;
+  /** evaluate exp(ik.r) of a position by the recursion over the unit translations
+   * @param pos position
+   * @param e_r real part of exp(ik.r)
+   * @param e_i imaginary part of exp(ik.r)
+   *
+   * One sincos per direction and numk complex multiplications.
+   */
+  void computeEikrRecursive(const PosType& pos, RealType* restrict e_r, RealType* restrict e_i);
+  /** evaluate exp(ik.r) of a position with a sincos per k-vector
+   * @param pos position
+   * @param e_r real part of exp(ik.r)
+   * @param e_i imaginary part of exp(ik.r)
+   */
+  void computeEikrSinCos(const PosType& pos, RealType* restrict e_r, RealType* restrict e_i);
+#endif
   ///Compute all rhok elements from the start
   void FillRhok(ParticleSet& P);
   ///Smart update of rhok for 1-particle move. Simply supply old+new position
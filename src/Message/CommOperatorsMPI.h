@@ -43,6 +43,13 @@ Communicate::reduce(T* restrict , T* restrict, int n)
   APP_ABORT("Need specialization for reduce(T* restrict , T* restrict, int n)");
 }
 
+template<typename T> inline Communicate::request
+Communicate::ireduce(T* restrict , T* restrict, int n)
+{
+  APP_ABORT("Need specialization for ireduce(T* restrict , T* restrict, int n)");
+  return MPI_REQUEST_NULL;
+}
+
 template<typename T> inline void
 Communicate::bcast(T& )
 {
@@ -469,6 +476,37 @@ Communicate::reduce(double* restrict g, double* restrict res, int n)
   MPI_Reduce(g, res, n, MPI_DOUBLE, MPI_SUM, 0, myMPI);
 }
 
+/** start the sum of g over the tasks into res of the root
+ *
+ * The buffers cannot be used before the request is completed. A blocking
+ * reduction is done with MPI-2 and the returned request is null.
+ */
+template<>
+inline Communicate::request
+Communicate::ireduce(double* restrict g, double* restrict res, int n)
+{
+  request r=MPI_REQUEST_NULL;
+#if MPI_VERSION >= 3
+  MPI_Ireduce(g, res, n, MPI_DOUBLE, MPI_SUM, 0, myMPI, &r);
+#else
+  MPI_Reduce(g, res, n, MPI_DOUBLE, MPI_SUM, 0, myMPI);
+#endif
+  return r;
+}
+
+template<>
+inline Communicate::request
+Communicate::ireduce(float* restrict g, float* restrict res, int n)
+{
+  request r=MPI_REQUEST_NULL;
+#if MPI_VERSION >= 3
+  MPI_Ireduce(g, res, n, MPI_FLOAT, MPI_SUM, 0, myMPI, &r);
+#else
+  MPI_Reduce(g, res, n, MPI_FLOAT, MPI_SUM, 0, myMPI);
+#endif
+  return r;
+}
+
 template<>
 inline void
 Communicate::bcast(int& g)
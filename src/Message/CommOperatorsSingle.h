@@ -28,6 +28,13 @@ template<typename T> inline void Communicate::reduce(T& ) { }
 template<typename T>
 inline void Communicate::reduce(T* restrict , T* restrict, int n) { }
 
+template<typename T> inline Communicate::request
+Communicate::ireduce(T* restrict g, T* restrict res, int n)
+{
+  std::copy(g,g+n,res);
+  return 1;
+}
+
 template<typename T> inline void Communicate::bcast(T& ) {  }
 
 template<typename T> inline void Communicate::bcast(T* restrict ,int n) { }
@@ -71,6 +71,8 @@ inline void bcast(T& a, Communicate* comm)
 #else
 namespace qmcplusplus
 {
+inline void wait_all(int n, Communicate::request* pending) { }
+
 template<typename CT>
 inline void cancel(CT& r) { }
 
@@ -213,6 +213,7 @@ public:
   template<typename T> void allreduce(T&);
   template<typename T> void reduce(T&);
   template<typename T> void reduce(T* restrict, T* restrict, int n);
+  template<typename T> request ireduce(T* restrict, T* restrict, int n);
   template<typename T> void bcast(T&);
   template<typename T> void bcast(T* restrict, int n);
   template<typename T> void send(int dest, int tag, T&);
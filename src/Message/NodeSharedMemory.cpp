@@ -0,0 +1,181 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Message/NodeSharedMemory.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#ifdef HAVE_MPI
+#if MPI_VERSION < 3
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#endif
+#endif
+
+#ifdef HAVE_MPI
+
+NodeSharedMemory::NodeSharedMemory(Communicate* comm)
+  : myComm(comm), NodeRank(0), NodeSize(1), HeadRank(-1), NumHeads(1), NumSegments(0)
+{
+  int myrank=myComm->rank();
+#if MPI_VERSION >= 3
+  MPI_Comm_split_type(myComm->getMPI(),MPI_COMM_TYPE_SHARED,myrank,MPI_INFO_NULL,&NodeComm);
+#else
+  //group the tasks by the host name, the lowest rank on a host is the color
+  char hostname[HOST_NAME_MAX];
+  gethostname(hostname,HOST_NAME_MAX);
+  hostname[HOST_NAME_MAX-1]='\0';
+  std::vector<char> hosts(myComm->size()*HOST_NAME_MAX);
+  MPI_Allgather(hostname,HOST_NAME_MAX,MPI_CHAR,hosts.data(),HOST_NAME_MAX,MPI_CHAR,myComm->getMPI());
+  int color=myrank;
+  for(int i=0; i<myrank; ++i)
+    if(strcmp(hostname,hosts.data()+i*HOST_NAME_MAX)==0)
+    {
+      color=i;
+      break;
+    }
+  MPI_Comm_split(myComm->getMPI(),color,myrank,&NodeComm);
+#endif
+  MPI_Comm_rank(NodeComm,&NodeRank);
+  MPI_Comm_size(NodeComm,&NodeSize);
+  MPI_Comm_split(myComm->getMPI(),(NodeRank==0)?0:MPI_UNDEFINED,myrank,&HeadComm);
+  if(HeadComm!=MPI_COMM_NULL)
+  {
+    MPI_Comm_rank(HeadComm,&HeadRank);
+    MPI_Comm_size(HeadComm,&NumHeads);
+  }
+  MPI_Bcast(&NumHeads,1,MPI_INT,0,NodeComm);
+}
+
+NodeSharedMemory::~NodeSharedMemory()
+{
+  int finalized=0;
+  MPI_Finalized(&finalized);
+  if(finalized)
+    return;
+  if(HeadComm!=MPI_COMM_NULL)
+    MPI_Comm_free(&HeadComm);
+  MPI_Comm_free(&NodeComm);
+}
+
+void* NodeSharedMemory::allocate(size_t nbytes)
+{
+  NumSegments++;
+#if MPI_VERSION >= 3
+  //the base of a window is not aligned for SIMD loads, e.g. by einspline
+  const size_t align=64;
+  MPI_Win win;
+  void* ptr=0;
+  MPI_Aint mysize=(NodeRank==0)?static_cast<MPI_Aint>(nbytes+align):0;
+  MPI_Win_allocate_shared(mysize,1,MPI_INFO_NULL,NodeComm,&ptr,&win);
+  if(NodeRank!=0)
+  {
+    MPI_Aint headsize;
+    int disp_unit;
+    MPI_Win_shared_query(win,0,&headsize,&disp_unit,&ptr);
+  }
+  size_t offset=(align-reinterpret_cast<size_t>(ptr)%align)%align;
+  ptr=static_cast<char*>(ptr)+offset;
+  //passive target epoch for the rest of the run, see barrier
+  MPI_Win_lock_all(MPI_MODE_NOCHECK,win);
+  Windows.push_back(win);
+  return ptr;
+#else
+  long headpid=static_cast<long>(getpid());
+  MPI_Bcast(&headpid,1,MPI_LONG,0,NodeComm);
+  char name[64];
+  sprintf(name,"/qmcpack.%ld.%d",headpid,NumSegments);
+  void* ptr=MAP_FAILED;
+  int fd=-1;
+  if(NodeRank==0)
+  {
+    fd=shm_open(name,O_CREAT|O_EXCL|O_RDWR,S_IRUSR|S_IWUSR);
+    if(fd>=0 && ftruncate(fd,nbytes)==0)
+      ptr=mmap(0,nbytes,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+  }
+  MPI_Barrier(NodeComm);
+  if(NodeRank!=0)
+  {
+    fd=shm_open(name,O_RDONLY,0);
+    if(fd>=0)
+      ptr=mmap(0,nbytes,PROT_READ,MAP_SHARED,fd,0);
+  }
+  MPI_Barrier(NodeComm);
+  if(NodeRank==0)
+    shm_unlink(name);
+  if(fd>=0)
+    close(fd);
+  if(ptr==MAP_FAILED)
+  {
+    std::cerr << "NodeSharedMemory::allocate failed to map " << name << " of " << nbytes << " bytes" << std::endl;
+    MPI_Abort(myComm->getMPI(),1);
+  }
+  return ptr;
+#endif
+}
+
+void NodeSharedMemory::bcast(void* buffer, size_t nbytes)
+{
+  bcastHeads(buffer,nbytes,0);
+  barrier();
+}
+
+void NodeSharedMemory::bcastHeads(void* buffer, size_t nbytes, int root)
+{
+  if(HeadComm==MPI_COMM_NULL || NumHeads==1)
+    return;
+  const size_t chunk_size=1<<30;
+  char* data=static_cast<char*>(buffer);
+  for(size_t offset=0; offset<nbytes; offset+=chunk_size)
+  {
+    int n=static_cast<int>(std::min(chunk_size,nbytes-offset));
+    MPI_Bcast(data+offset,n,MPI_BYTE,root,HeadComm);
+  }
+}
+
+void NodeSharedMemory::barrier()
+{
+#if MPI_VERSION >= 3
+  for(int i=0; i<Windows.size(); ++i)
+    MPI_Win_sync(Windows[i]);
+  MPI_Barrier(NodeComm);
+  for(int i=0; i<Windows.size(); ++i)
+    MPI_Win_sync(Windows[i]);
+#else
+  MPI_Barrier(NodeComm);
+#endif
+}
+
+#else
+
+NodeSharedMemory::NodeSharedMemory(Communicate* comm)
+  : myComm(comm), NodeRank(0), NodeSize(1), HeadRank(0), NumHeads(1), NumSegments(0)
+{ }
+
+NodeSharedMemory::~NodeSharedMemory() { }
+
+void* NodeSharedMemory::allocate(size_t nbytes)
+{
+  NumSegments++;
+  return malloc(nbytes);
+}
+
+void NodeSharedMemory::bcast(void* buffer, size_t nbytes) { }
+
+void NodeSharedMemory::bcastHeads(void* buffer, size_t nbytes, int root) { }
+
+void NodeSharedMemory::barrier() { }
+
+#endif
@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file NodeSharedMemory.h
+ * @brief memory segments shared by the MPI tasks on a node
+ */
+#ifndef QMCPLUSPLUS_NODE_SHARED_MEMORY_H
+#define QMCPLUSPLUS_NODE_SHARED_MEMORY_H
+#include "Message/Communicate.h"
+#include <vector>
+
+/** @class NodeSharedMemory
+ * @brief Manage large read-only tables shared by all the tasks of a node
+ *
+ * The tasks of a communicator are grouped by node. The head of each node,
+ * the lowest rank of the group, allocates and fills the segments which are
+ * mapped by all the other tasks of the node.
+ * - MPI-3: MPI_Comm_split_type and MPI_Win_allocate_shared
+ * - older MPI: POSIX shm segments among the tasks of the same host
+ * - serial: plain allocation
+ *
+ * The segments are meant for the tables which live until the end of a run
+ * and are not released.
+ */
+class NodeSharedMemory
+{
+public:
+
+  /** constructor
+   * @param comm communicator, collective over all its tasks
+   */
+  NodeSharedMemory(Communicate* comm);
+
+  ~NodeSharedMemory();
+
+  ///return true if more than one task of comm runs on this node
+  inline bool enabled() const
+  {
+    return NodeSize>1;
+  }
+
+  ///return true if this task fills the segments for its node
+  inline bool isHead() const
+  {
+    return NodeRank==0;
+  }
+
+  ///return the number of the tasks on this node
+  inline int nodeSize() const
+  {
+    return NodeSize;
+  }
+
+  ///return the rank among the heads, -1 if this task is not a head
+  inline int headRank() const
+  {
+    return HeadRank;
+  }
+
+  ///return the number of the nodes
+  inline int numHeads() const
+  {
+    return NumHeads;
+  }
+
+  /** allocate a segment shared by the tasks on a node, collective
+   * @param nbytes size of the segment in bytes
+   * @return the address of the segment in this task
+   *
+   * Only the head may write to the segment. With POSIX shm, the segment
+   * is mapped read-only by the other tasks.
+   */
+  void* allocate(size_t nbytes);
+
+  /** bcast a buffer from the root to the heads of the nodes and synchronize the nodes
+   * @param buffer address of the buffer in a segment
+   * @param nbytes size in bytes
+   *
+   * Collective over all the tasks. On return, the data written by the head
+   * of each node is visible to all the tasks on the node.
+   */
+  void bcast(void* buffer, size_t nbytes);
+
+  /** bcast a buffer among the heads of the nodes
+   * @param buffer address of the buffer
+   * @param nbytes size in bytes
+   * @param root headRank of the sender
+   *
+   * Collective over the heads only, nothing is done on the other tasks.
+   */
+  void bcastHeads(void* buffer, size_t nbytes, int root);
+
+  ///synchronize the tasks on a node and the memory of the segments
+  void barrier();
+
+private:
+  ///communicator
+  Communicate* myComm;
+  ///rank within the node
+  int NodeRank;
+  ///number of the tasks on the node
+  int NodeSize;
+  ///rank among the heads, -1 on the other tasks
+  int HeadRank;
+  ///number of the heads
+  int NumHeads;
+  ///number of the segments allocated so far
+  int NumSegments;
+#ifdef HAVE_MPI
+  ///communicator of the tasks on the node
+  MPI_Comm NodeComm;
+  ///communicator of the heads, MPI_COMM_NULL on the other tasks
+  MPI_Comm HeadComm;
+#if MPI_VERSION >= 3
+  ///windows of the segments
+  std::vector<MPI_Win> Windows;
+#endif
+#endif
+};
+#endif
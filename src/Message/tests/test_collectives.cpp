@@ -0,0 +1,54 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Message/catch_mpi_main.hpp"
+
+#include "Message/Communicate.h"
+#include "Message/CommOperators.h"
+#include "Message/CommUtilities.h"
+
+
+#include <stdio.h>
+#include <vector>
+
+
+namespace qmcplusplus
+{
+
+TEST_CASE("Communicate ireduce", "[message]")
+{
+  OHMMS::Controller->initialize(0, NULL);
+  Communicate *c = OHMMS::Controller;
+
+  const int n = 1000;
+  const int np = c->size();
+  std::vector<double> g(n), res(n, 0.0);
+  for (int i = 0; i < n; i++)
+    g[i] = (c->rank() + 1)*i;
+
+  Communicate::request r = c->ireduce(g.data(), res.data(), n);
+
+  // other collectives can run while the reduction is in flight
+  std::vector<double> other(1, 1.0);
+  c->allreduce(other);
+  REQUIRE(other[0] == Approx(np));
+
+  wait_all(1, &r);
+  if (c->rank() == 0)
+  {
+    double ranks = 0.5*np*(np+1);
+    for (int i = 0; i < n; i++)
+      REQUIRE(res[i] == Approx(ranks*i));
+  }
+}
+
+}
@@ -0,0 +1,88 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Message/catch_mpi_main.hpp"
+
+#include "Message/Communicate.h"
+#include "Message/NodeSharedMemory.h"
+
+
+#include <stdio.h>
+#include <vector>
+
+
+namespace qmcplusplus
+{
+
+TEST_CASE("NodeSharedMemory bcast", "[message]")
+{
+  OHMMS::Controller->initialize(0, NULL);
+  Communicate *c = OHMMS::Controller;
+
+  NodeSharedMemory node(c);
+  REQUIRE(node.nodeSize() >= 1);
+  REQUIRE(node.nodeSize() <= c->size());
+  if (c->rank() == 0)
+    REQUIRE(node.isHead());
+
+  // two tables, only the root fills them as the spline readers do
+  const size_t n1 = 1000;
+  const size_t n2 = 17;
+  double *t1 = static_cast<double*>(node.allocate(n1*sizeof(double)));
+  float *t2 = static_cast<float*>(node.allocate(n2*sizeof(float)));
+  REQUIRE(t1 != NULL);
+  REQUIRE(t2 != NULL);
+  // aligned for the SIMD loads of einspline
+  REQUIRE(reinterpret_cast<size_t>(t1) % 16 == 0);
+  REQUIRE(reinterpret_cast<size_t>(t2) % 16 == 0);
+  if (c->rank() == 0)
+  {
+    for (size_t i = 0; i < n1; i++)
+      t1[i] = 0.5*i;
+    for (size_t i = 0; i < n2; i++)
+      t2[i] = -1.0f*i;
+  }
+  node.bcast(t1, n1*sizeof(double));
+  node.bcast(t2, n2*sizeof(float));
+
+  for (size_t i = 0; i < n1; i++)
+    REQUIRE(t1[i] == Approx(0.5*i));
+  for (size_t i = 0; i < n2; i++)
+    REQUIRE(t2[i] == Approx(-1.0*i));
+  node.barrier();
+}
+
+TEST_CASE("NodeSharedMemory bcastHeads", "[message]")
+{
+  Communicate *c = OHMMS::Controller;
+
+  NodeSharedMemory node(c);
+  REQUIRE(node.numHeads() >= 1);
+  REQUIRE(node.numHeads() <= c->size());
+  REQUIRE(node.isHead() == (node.headRank() >= 0));
+  REQUIRE(node.headRank() < node.numHeads());
+
+  // the last head sends, as a spline reader does with its bands
+  const int root = node.numHeads()-1;
+  std::vector<double> band(100, 0.0);
+  if (node.headRank() == root)
+    for (int i = 0; i < band.size(); i++)
+      band[i] = 2.0*i+1.0;
+  node.bcastHeads(band.data(), band.size()*sizeof(double), root);
+
+  if (node.isHead())
+    for (int i = 0; i < band.size(); i++)
+      REQUIRE(band[i] == Approx(2.0*i+1.0));
+  node.barrier();
+}
+
+}
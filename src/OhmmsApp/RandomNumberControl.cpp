@@ -42,6 +42,7 @@ namespace qmcplusplus
 PrimeNumberSet<RandomGenerator_t::uint_type> RandomNumberControl::PrimeNumbers;
 std::vector<RandomGenerator_t*>  RandomNumberControl::Children;
 RandomGenerator_t::uint_type RandomNumberControl::Offset=11u;
+std::vector<RandomGenerator_t::uint_type> RandomNumberControl::StagedStates;
 
 /// constructors and destructors
 RandomNumberControl::RandomNumberControl(const char* aname)
@@ -113,6 +114,12 @@ void RandomNumberControl::make_children()
     int offset=baseoffset+ip;
     Children[ip]->init(rank,nprocs,myprimes[ip],offset);
   }
+#if defined(QMC_RNG_PHILOX)
+  //the walker streams share the key on all the ranks and threads
+  Random.set_key(Offset);
+  for(int ip=0; ip<nthreads; ip++)
+    Children[ip]->set_key(Offset);
+#endif
   if(nprocs<4)
   {
     std::ostringstream o;
@@ -261,7 +268,12 @@ void RandomNumberControl::read(const std::string& fname, Communicate* comm)
       {
         std::istringstream dims(pt.get<std::string>("random.dims"));
         dims >> shape[0] >> shape[1];
-        if(shape[0]==shape_now[0] && shape[1]==shape_now[1])
+#if defined(QMC_RNG_PHILOX)
+        const bool same_streams=true;
+#else
+        const bool same_streams=(shape[0]==shape_now[0]);
+#endif
+        if(same_streams && shape[1]==shape_now[1])
         {
           vt_tot.resize(shape[0]*shape[1]);
           std::istringstream v(pt.get<std::string>("random.states"));
@@ -289,6 +301,24 @@ void RandomNumberControl::read(const std::string& fname, Communicate* comm)
 
   mpi::bcast(*comm,shape);
 
+#if defined(QMC_RNG_PHILOX)
+  //only the key matters for the walker streams, any number of streams can restart
+  if(shape[0]>0 && shape[1]==shape_now[1] && shape[0]!=shape_now[0])
+  {
+    std::vector<int> key(2,0);
+    if(comm->rank()==0)
+    {
+      key[0]=static_cast<int>(vt_tot[0]);
+      key[1]=static_cast<int>(vt_tot[1]);
+    }
+    mpi::bcast(*comm,key);
+    Random.set_key(static_cast<uint_type>(key[0]),static_cast<uint_type>(key[1]));
+    for(int ip=0; ip<Children.size(); ip++)
+      Children[ip]->set_key(static_cast<uint_type>(key[0]),static_cast<uint_type>(key[1]));
+    app_log() << "  Restart the counter-based random streams with the key of the previous configuration." << std::endl;
+    return;
+  }
+#endif
   if(shape[0]!=shape_now[0] || shape[1] != shape_now[1])
   {
     app_log() << "Mismatched random number generators."
@@ -322,9 +352,26 @@ void RandomNumberControl::read(const std::string& fname, Communicate* comm)
 }
 
 void RandomNumberControl::write(const std::string& fname, Communicate* comm)
+{
+  std::vector<uint_type> vt_tot;
+  gather(vt_tot,comm);
+  write(vt_tot,fname,comm);
+}
+
+void RandomNumberControl::stage(Communicate* comm)
+{
+  gather(StagedStates,comm);
+}
+
+void RandomNumberControl::writeStaged(const std::string& fname, Communicate* comm)
+{
+  write(StagedStates,fname,comm);
+}
+
+void RandomNumberControl::gather(std::vector<uint_type>& vt_tot, Communicate* comm)
 {
   int nthreads=omp_get_max_threads();
-  std::vector<uint_type> vt, vt_tot;
+  std::vector<uint_type> vt;
   vt.reserve(nthreads*1024);
   if(nthreads>1)
     for(int ip=0; ip<nthreads; ++ip)
@@ -342,16 +389,20 @@ void RandomNumberControl::write(const std::string& fname, Communicate* comm)
   }
   else
     vt_tot=vt;
+}
 
+void RandomNumberControl::write(std::vector<uint_type>& vt_tot, const std::string& fname, Communicate* comm)
+{
   if(comm->rank()==0)
   {
+    const int nstreams=vt_tot.size()/Random.state_size();
 #if defined(HAVE_LIBBOOST)
     using boost::property_tree::ptree;
     ptree pt;
     std::ostringstream dims,vt_o;
-    dims<<comm->size()*nthreads << " " << Random.state_size();
+    dims<<nstreams << " " << Random.state_size();
     std::vector<uint_type>::iterator v=vt_tot.begin();
-    for(int i=0; i<comm->size()*nthreads; ++i)
+    for(int i=0; i<nstreams; ++i)
     {
       copy(v,v+Random.state_size(),std::ostream_iterator<uint_type>(vt_o," "));
       vt_o<< std::endl;
@@ -368,7 +419,7 @@ void RandomNumberControl::write(const std::string& fname, Communicate* comm)
     hout.create(h5name);
     hout.push(hdf::main_state);
     hout.push("random");
-    TinyVector<hsize_t,2> shape(comm->size()*nthreads,Random.state_size());
+    TinyVector<hsize_t,2> shape(nstreams,Random.state_size());
     hyperslab_proxy<std::vector<uint_type>,2> slab(vt_tot,shape);
     hout.write(slab,Random.EngineName);
     hout.close();
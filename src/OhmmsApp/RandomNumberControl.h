@@ -66,12 +66,31 @@ public:
    * @param comm communicator so that everyone writes its own data
    */
   static void write(const std::string& fname, Communicate* comm);
+  /** gather the random states to be written later by writeStaged
+   * @param comm communicator
+   */
+  static void stage(Communicate* comm);
+  /** write the random states gathered by the last stage
+   * @param fname file name
+   * @param comm communicator of stage
+   *
+   * Only the master writes. No communication is done, so that the states can
+   * be written by a helper thread together with the walkers of the same block.
+   */
+  static void writeStaged(const std::string& fname, Communicate* comm);
 
 private:
 
   bool NeverBeenInitialized;
   xmlNodePtr myCur;
   static uint_type Offset;
+  ///states gathered by stage
+  static std::vector<uint_type> StagedStates;
+
+  ///gather the states of the generators of all the tasks on the master
+  static void gather(std::vector<uint_type>& vt_tot, Communicate* comm);
+  ///write the gathered states on the master
+  static void write(std::vector<uint_type>& vt_tot, const std::string& fname, Communicate* comm);
 };
 }
 
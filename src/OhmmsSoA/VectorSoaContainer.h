@@ -0,0 +1,175 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/**@file VectorSoaContainer.h
+ * @brief Declaration of VectorSoaContainer, the structure-of-arrays storage of TinyVector<T,D>
+ */
+#ifndef QMCPLUSPLUS_VECTOR_SOA_CONTAINER_H
+#define QMCPLUSPLUS_VECTOR_SOA_CONTAINER_H
+
+#include "OhmmsPETE/TinyVector.h"
+#include "simd/allocator.hpp"
+#include <algorithm>
+
+namespace qmcplusplus
+{
+
+/** SoA adaptor of a vector of TinyVector<T,D>
+ *
+ * The D components are stored in D rows of a single aligned block.
+ * Each row holds size() elements and is padded to capacity() elements,
+ * so that data(d) is aligned to the cache line for every d.
+ * The padding is zero-initialized.
+ *
+ * The container can also be a view of an external block of D*capacity()
+ * elements, e.g. a slot of a walker buffer, set by attachReference.
+ * A copy always owns its storage, an assignment of the same capacity
+ * writes through the view.
+ */
+template<typename T, unsigned D>
+struct VectorSoaContainer
+{
+  typedef TinyVector<T,D> Type_t;
+
+  ///number of elements
+  int nLocal;
+  ///number of elements including the padding
+  int nGhosts;
+  ///storage of D padded rows
+  aligned_vector<T> myData;
+  ///first element of the rows, myData.data() or an external block
+  T* Base;
+
+  VectorSoaContainer(): nLocal(0), nGhosts(0), Base(nullptr) {}
+
+  explicit VectorSoaContainer(int n): nLocal(0), nGhosts(0), Base(nullptr)
+  {
+    resize(n);
+  }
+
+  VectorSoaContainer(const VectorSoaContainer& rhs)
+    : nLocal(rhs.nLocal), nGhosts(rhs.nGhosts), myData(rhs.Base,rhs.Base+rhs.nGhosts*D)
+  {
+    Base=myData.data();
+  }
+
+  VectorSoaContainer& operator=(const VectorSoaContainer& rhs)
+  {
+    if(this!=&rhs)
+    {
+      if(nGhosts!=rhs.nGhosts)
+        resize(rhs.nLocal);
+      nLocal=rhs.nLocal;
+      std::copy(rhs.Base,rhs.Base+rhs.nGhosts*D,Base);
+    }
+    return *this;
+  }
+
+  ///resize the container, the padding is reset to zero
+  inline void resize(int n)
+  {
+    nLocal=n;
+    nGhosts=getAlignedSize<T>(n);
+    myData.assign(nGhosts*D,T());
+    Base=myData.data();
+  }
+
+  /** use an external block as the storage of n elements
+   * @param n number of elements
+   * @param ref aligned block of D*getAlignedSize<T>(n) elements
+   *
+   * The own storage is released. resize() restores it.
+   */
+  inline void attachReference(int n, T* ref)
+  {
+    nLocal=n;
+    nGhosts=getAlignedSize<T>(n);
+    aligned_vector<T>().swap(myData);
+    Base=ref;
+  }
+
+  ///return true if the rows are in an external block
+  inline bool isAttached() const
+  {
+    return Base!=myData.data();
+  }
+
+  ///return the number of elements
+  inline int size() const
+  {
+    return nLocal;
+  }
+
+  ///return the padded size of each row
+  inline int capacity() const
+  {
+    return nGhosts;
+  }
+
+  ///return the number of the stored elements, D*capacity()
+  inline int ndata() const
+  {
+    return nGhosts*D;
+  }
+
+  ///return the pointer to the d-th component
+  inline T* data(int d)
+  {
+    return Base+d*nGhosts;
+  }
+
+  inline const T* data(int d) const
+  {
+    return Base+d*nGhosts;
+  }
+
+  ///return the i-th element as a TinyVector
+  inline Type_t operator[](int i) const
+  {
+    Type_t res;
+    for(unsigned d=0; d<D; ++d)
+      res[d]=Base[d*nGhosts+i];
+    return res;
+  }
+
+  ///assign the i-th element
+  inline void set(int i, const Type_t& v)
+  {
+    for(unsigned d=0; d<D; ++d)
+      Base[d*nGhosts+i]=v[d];
+  }
+
+  /** copy an array of TinyVector, e.g. ParticleSet::R, into the SoA storage
+   * @param in AoS container of size() elements
+   */
+  template<typename PA>
+  inline void copyIn(const PA& in)
+  {
+    for(int i=0; i<nLocal; ++i)
+      for(unsigned d=0; d<D; ++d)
+        Base[d*nGhosts+i]=in[i][d];
+  }
+
+  /** copy the SoA storage out to an array of TinyVector
+   * @param out AoS container of size() elements
+   */
+  template<typename PA>
+  inline void copyOut(PA& out) const
+  {
+    for(int i=0; i<nLocal; ++i)
+      for(unsigned d=0; d<D; ++d)
+        out[i][d]=Base[d*nGhosts+i];
+  }
+};
+
+}
+#endif
@@ -23,9 +23,38 @@
 #include "Lattice/ParticleBConds.h"
 #include "Particle/SymmetricDistanceTableData.h"
 #include "Particle/AsymmetricDistanceTableData.h"
+#include "Particle/SoaDistanceTableAA.h"
+#include "Particle/SoaDistanceTableBA.h"
 namespace qmcplusplus
 {
 
+/** create an AA table with the layout selected by ParticleSet::UseSoADistanceTables
+ * @param s source/target particle set
+ */
+template<typename T, unsigned D, int SC>
+inline DistanceTableData* createTableAA(ParticleSet& s)
+{
+#if OHMMS_DIM == 3
+  if(s.UseSoADistanceTables)
+    return new SoaDistanceTableAA<T,D,SC>(s);
+#endif
+  return new SymmetricDTD<T,D,SC>(s,s);
+}
+
+/** create an AB table with the layout selected by ParticleSet::UseSoADistanceTables of the target
+ * @param s source particle set
+ * @param t target particle set
+ */
+template<typename T, unsigned D, int SC>
+inline DistanceTableData* createTableAB(const ParticleSet& s, ParticleSet& t)
+{
+#if OHMMS_DIM == 3
+  if(t.UseSoADistanceTables)
+    return new SoaDistanceTableBA<T,D,SC>(s,t);
+#endif
+  return new AsymmetricDTD<T,D,SC>(s,t);
+}
+
 /** Adding SymmetricDTD to the list, e.g., el-el distance table
  *\param s source/target particle set
  *\return index of the distance table with the name
@@ -43,7 +72,7 @@ DistanceTableData* createDistanceTable(ParticleSet& s)
     if(s.Lattice.DiagonalOnly)
     {
       o << "    PBC=bulk Orthorhombic=yes Using SymmetricDTD<T,DIM,PPPO> " << PPPO << std::endl;
-      dt = new SymmetricDTD<RealType,DIM,PPPO>(s,s);
+      dt = createTableAA<RealType,DIM,PPPO>(s);
     }
     else
     {
@@ -51,14 +80,14 @@ DistanceTableData* createDistanceTable(ParticleSet& s)
       if(s.Lattice.WignerSeitzRadius>s.Lattice.SimulationCellRadius)
       {
         o << "  Using SymmetricDTD<T,D,PPPG> " << PPPG << std::endl;
-        dt = new  SymmetricDTD<RealType,DIM,PPPG>(s,s);
+        dt = createTableAA<RealType,DIM,PPPG>(s);
         //o << "    PBC=bulk Orthorhombic=no SymmetricDTD<T,DIM,PPPX> " << PPPX << std::endl;
         //dt = new  SymmetricDTD<RealType,DIM,PPPX>(s,s);
       }
       else
       {
         o << "  Using SymmetricDTD<T,D,PPPS> " << PPPS << std::endl;
-        dt = new  SymmetricDTD<RealType,DIM,PPPS>(s,s);
+        dt = createTableAA<RealType,DIM,PPPS>(s);
       }
       o << "\n    Setting Rmax = " << s.Lattice.SimulationCellRadius;
     }
@@ -68,33 +97,35 @@ DistanceTableData* createDistanceTable(ParticleSet& s)
     if(s.Lattice.DiagonalOnly)
     {
       o << "    PBC=slab Orthorhombic=yes Using SymmetricDTD<T,D,PPNO> " << PPNO << std::endl;
-      dt = new SymmetricDTD<RealType,DIM,PPNO>(s,s);
+      dt = createTableAA<RealType,DIM,PPNO>(s);
     }
     else
     {
       if(s.Lattice.WignerSeitzRadius>s.Lattice.SimulationCellRadius)
       {
         o << "    PBC=slab Orthorhombic=no Using SymmetricDTD<T,D,PPNX> " << PPNX << std::endl;
-        dt = new SymmetricDTD<RealType,DIM,PPNX>(s,s);
+        dt = createTableAA<RealType,DIM,PPNX>(s);
       }
       else
       {
         o << "    PBC=slab Orthorhombic=no Using SymmetricDTD<T,D,PPNS> " << PPNS << std::endl;
-        dt = new SymmetricDTD<RealType,DIM,PPNS>(s,s);
+        dt = createTableAA<RealType,DIM,PPNS>(s);
       }
     }
   }
   else if(sc == SUPERCELL_WIRE)
   {
     o << "    PBC=wire Orthorhombic=NA\n";
-    dt = new SymmetricDTD<RealType,DIM,SUPERCELL_WIRE>(s,s);
+    dt = createTableAA<RealType,DIM,SUPERCELL_WIRE>(s);
   }
   else  //open boundary condition
   {
     o << "    PBC=open Orthorhombic=NA\n";
-    dt = new SymmetricDTD<RealType,DIM,SUPERCELL_OPEN>(s,s);
+    dt = createTableAA<RealType,DIM,SUPERCELL_OPEN>(s);
   }
   dt->CellType=sc;
+  if(dt->DTType==DistanceTableData::DT_SOA)
+    o << "    Using structure-of-arrays layout\n";
   std::ostringstream p;
   p << s.getName() << "_" << s.getName();
   dt->Name=p.str();//assign the table name
@@ -128,7 +159,7 @@ DistanceTableData* createDistanceTable(const ParticleSet& s, ParticleSet& t)
     if(s.Lattice.DiagonalOnly)
     {
       o << "    PBC=bulk Orthorhombic=yes Using AsymmetricDTD<T,D,PPPO> " << PPPO << std::endl;
-      dt = new AsymmetricDTD<RealType,DIM,PPPO>(s,t);
+      dt = createTableAB<RealType,DIM,PPPO>(s,t);
     }
     else
     {
@@ -136,12 +167,12 @@ DistanceTableData* createDistanceTable(const ParticleSet& s, ParticleSet& t)
       if(s.Lattice.WignerSeitzRadius>s.Lattice.SimulationCellRadius)
       {
         o << " Using AsymmetricDTD<T,D,PPPG> " << PPPG << std::endl;
-        dt = new AsymmetricDTD<RealType,DIM,PPPG>(s,t);
+        dt = createTableAB<RealType,DIM,PPPG>(s,t);
       }
       else
       {
         o << " Using AsymmetricDTD<T,D,PPPS> " << PPPS << std::endl;
-        dt = new AsymmetricDTD<RealType,DIM,PPPS>(s,t);
+        dt = createTableAB<RealType,DIM,PPPS>(s,t);
       }
       o << "    Setting Rmax = " << s.Lattice.SimulationCellRadius;
     }
@@ -151,7 +182,7 @@ DistanceTableData* createDistanceTable(const ParticleSet& s, ParticleSet& t)
     if(s.Lattice.DiagonalOnly)
     {
       o << "    PBC=slab Orthorhombic=yes Using AsymmetricDTD<T,D,PPNO> " << PPNO << std::endl;
-      dt = new AsymmetricDTD<RealType,DIM,PPNO>(s,t);
+      dt = createTableAB<RealType,DIM,PPNO>(s,t);
     }
     else
     {
@@ -159,27 +190,29 @@ DistanceTableData* createDistanceTable(const ParticleSet& s, ParticleSet& t)
       if(s.Lattice.WignerSeitzRadius>s.Lattice.SimulationCellRadius)
       {
         o << " Using AsymmetricDTD<T,DIM,PPNX> " << PPNX << std::endl;
-        dt = new AsymmetricDTD<RealType,DIM,PPNX>(s,t);
+        dt = createTableAB<RealType,DIM,PPNX>(s,t);
       }
       else
       {
         o << " Using AsymmetricDTD<T,DIM,PPNS> " << PPNS << std::endl;
-        dt = new AsymmetricDTD<RealType,DIM,PPNS>(s,t);
+        dt = createTableAB<RealType,DIM,PPNS>(s,t);
       }
     }
   }
   else if(sc == SUPERCELL_WIRE)
   {
     o << "    PBC=wire Orthorhombic=NA\n";
-    dt = new AsymmetricDTD<RealType,DIM,SUPERCELL_WIRE>(s,t);
+    dt = createTableAB<RealType,DIM,SUPERCELL_WIRE>(s,t);
   }
   else  //open boundary condition
   {
     o << "    PBC=open Orthorhombic=NA\n";
-    dt = new AsymmetricDTD<RealType,DIM,SUPERCELL_OPEN>(s,t);
+    dt = createTableAB<RealType,DIM,SUPERCELL_OPEN>(s,t);
   }
 
   dt->CellType=sc;
+  if(dt->DTType==DistanceTableData::DT_SOA)
+    o << "    Using structure-of-arrays layout\n";
   std::ostringstream p;
   p << s.getName() << "_" << t.getName();
   dt->Name=p.str();//assign the table name
@@ -23,6 +23,7 @@
 #include "Utilities/PooledData.h"
 #include "OhmmsPETE/OhmmsVector.h"
 #include "OhmmsPETE/OhmmsMatrix.h"
+#include "OhmmsSoA/VectorSoaContainer.h"
 #include <limits>
 #include <bitset>
 
@@ -115,13 +116,20 @@ public:
    */
   enum {WalkerIndex=0, SourceIndex, VisitorIndex, PairIndex};
 
+  ///enum for the storage layout
+  enum {DT_AOS=0, DT_SOA};
+
   typedef std::vector<IndexType>         IndexVectorType;
   typedef TempDisplacement<RealType,DIM> TempDistType;
   typedef PooledData<RealType>           BufferType;
   typedef std::pair<RealType,IndexType>  ripair;
+  typedef aligned_vector<RealType>       RowContainer;
+  typedef VectorSoaContainer<RealType,DIM> DisplRow;
 
   ///type of cell
   int CellType;
+  ///storage layout, DT_AOS or DT_SOA
+  int DTType;
   ///ID of this table among many
   int ID;
   ///Index of the particle  with a trial move
@@ -175,11 +183,30 @@ public:
   std::vector<RealType> temp_r;
   std::vector<PosType> temp_dr;
 
+  /**@defgroup SoA data, valid only with DTType==DT_SOA
+   *
+   * Every target particle i owns a row, padded to the cache line, of the
+   * relations with all the source particles j. Unlike the AoS data, the
+   * displacement is source minus target, Displacements[i][j]=R_j-R_i.
+   * For the AA tables the self distance Distances[i][i] is set to
+   * std::numeric_limits<RealType>::max() so that cutoff functions vanish.
+   * @{
+   */
+  ///Distances[i][j] , [Targets][Sources]
+  std::vector<RowContainer> Distances;
+  ///Displacements[i][j] , [Targets][Sources]
+  std::vector<DisplRow> Displacements;
+  ///distances of the proposed move to the sources
+  RowContainer Temp_r;
+  ///displacements of the proposed move, R_j-rnew
+  DisplRow Temp_dr;
+  /**@}*/
+
   ///name of the table
   std::string Name;
   ///constructor using source and target ParticleSet
   DistanceTableData(const ParticleSet& source, const ParticleSet& target)
-    : Origin(&source), N(0), NeedDisplacement(false)//, Rmax(1e6), Rmax2(1e12)
+    : Origin(&source), DTType(DT_AOS), N(0), NeedDisplacement(false)//, Rmax(1e6), Rmax2(1e12)
   {  }
 
   ///virutal destructor
@@ -24,9 +24,11 @@
 #include "Utilities/IteratorUtility.h"
 #include "OhmmsData/FileUtility.h"
 #include "HDFVersion.h"
+#include "OhmmsApp/RandomNumberControl.h"
 #include <numeric>
 #include <iostream>
 #include <sstream>
+#include <cstdio>
 #include <Message/Communicate.h>
 #include <mpi/collectives.h>
 #include <io/hdf_hyperslab.h>
@@ -60,6 +62,7 @@ namespace qmcplusplus
 HDFWalkerOutput::HDFWalkerOutput(MCWalkerConfiguration& W, const std::string& aroot,Communicate* c)
   : appended_blocks(0), number_of_walkers(0), currentConfigNumber(0)
   , number_of_backups(0), max_number_of_backups(4), myComm(c), RootName(aroot)
+  , AsyncWrite(false), StagedBlock(-1)
 //       , fw_out(myComm)
 {
   number_of_particles=W.getTotalNum();
@@ -82,9 +85,27 @@ HDFWalkerOutput::HDFWalkerOutput(MCWalkerConfiguration& W, const std::string& ar
 HDFWalkerOutput::~HDFWalkerOutput()
 {
 //     fw_out.close();
+  wait();
   delete_iter(RemoteData.begin(),RemoteData.end());
 }
 
+void HDFWalkerOutput::setAsync(bool async)
+{
+#if defined(H5_HAVE_THREADSAFE)
+  AsyncWrite=async;
+#else
+  if(async)
+    app_log() << "  HDF5 is not thread-safe. The configurations are written synchronously." << std::endl;
+  AsyncWrite=false;
+#endif
+}
+
+void HDFWalkerOutput::wait()
+{
+  if(Writer.joinable())
+    Writer.join();
+}
+
 #ifdef HAVE_ADIOS
 uint64_t HDFWalkerOutput::get_group_size(MCWalkerConfiguration& W)
 {
@@ -97,6 +118,7 @@ bool HDFWalkerOutput::adios_checkpoint(MCWalkerConfiguration& W, int64_t adios_h
 {
   //Need 4 * 3 bytes for storing integers and then storage
   //for all the walkers
+  wait();
   if (RemoteData.empty())
     RemoteData.push_back(new BufferType);
   int walker_num =  W.getActiveWalkers();
@@ -158,6 +180,10 @@ void HDFWalkerOutput::adios_checkpoint_verify(MCWalkerConfiguration& W, ADIOS_FI
  *  - number_of_walkes (int)
  *  - walker_partition (int array)
  *  - walkers (nw,np,3)
+ *
+ * With setAsync(true), the walkers and the random states are gathered to
+ * the master and written to the files by a helper thread while the driver
+ * continues. The next dump, or the destructor, waits for the write to finish.
  */
 bool HDFWalkerOutput::dump(MCWalkerConfiguration& W, int nblock)
 {
@@ -170,6 +196,24 @@ bool HDFWalkerOutput::dump(MCWalkerConfiguration& W, int nblock)
   //  rename(prevFile.c_str(),o.str().c_str());
   //}
 
+  //the buffers are owned by the writer until it is done
+  wait();
+  if(AsyncWrite)
+  {
+    stage_configuration(W,nblock);
+    int buffer_id=gather_configuration(W);
+    number_of_walkers=W.WalkerOffsets[myComm->size()];
+    StagedBlock=nblock;
+    StagedOffsets=W.WalkerOffsets;
+    RandomNumberControl::stage(myComm);
+    //only the master writes, the file is complete when it is renamed
+    if(!myComm->rank())
+      Writer=std::thread(&HDFWalkerOutput::write_staged,this,FileName,buffer_id);
+    currentConfigNumber++;
+    prevFile=FileName;
+    return true;
+  }
+
   //try to use collective
   hdf_archive dump_file(myComm,true);
   dump_file.create(FileName);
@@ -188,13 +232,7 @@ bool HDFWalkerOutput::dump(MCWalkerConfiguration& W, int nblock)
 
 void HDFWalkerOutput::write_configuration(MCWalkerConfiguration& W, hdf_archive& hout, int nblock)
 {
-  const int wb=OHMMS_DIM*number_of_particles;
-  if(nblock > block)
-  {
-    RemoteData[0]->resize(wb*W.getActiveWalkers());
-    W.putConfigurations(RemoteData[0]->begin());
-    block = nblock;
-  }
+  stage_configuration(W,nblock);
 
   hout.write(W.WalkerOffsets,"walker_partition");
 
@@ -216,24 +254,76 @@ void HDFWalkerOutput::write_configuration(MCWalkerConfiguration& W, hdf_archive&
   }
   else
   { //gaterv to the master and master writes it, could use isend/irecv
-    if(myComm->size()>1)
-    {
-      std::vector<int> displ(myComm->size()), counts(myComm->size());
-      for (int i=0; i<myComm->size(); ++i)
-      {
-        counts[i]=wb*(W.WalkerOffsets[i+1]-W.WalkerOffsets[i]);
-        displ[i]=wb*W.WalkerOffsets[i];
-      }
-      if(!myComm->rank())
-        RemoteData[1]->resize(wb*W.WalkerOffsets[myComm->size()]);
-      mpi::gatherv(*myComm,*RemoteData[0],*RemoteData[1],counts,displ);
-    }
-    int buffer_id=(myComm->size()>1)?1:0;
+    int buffer_id=gather_configuration(W);
     hyperslab_proxy<BufferType,3> slab(*RemoteData[buffer_id],gcounts);
     hout.write(slab,hdf::walkers);
   }
 }
 
+void HDFWalkerOutput::stage_configuration(MCWalkerConfiguration& W, int nblock)
+{
+  if(nblock > block)
+  {
+    RemoteData[0]->resize(OHMMS_DIM*number_of_particles*W.getActiveWalkers());
+    W.putConfigurations(RemoteData[0]->begin());
+    block = nblock;
+  }
+}
+
+int HDFWalkerOutput::gather_configuration(MCWalkerConfiguration& W)
+{
+  if(myComm->size()==1)
+    return 0;
+  const int wb=OHMMS_DIM*number_of_particles;
+  std::vector<int> displ(myComm->size()), counts(myComm->size());
+  for (int i=0; i<myComm->size(); ++i)
+  {
+    counts[i]=wb*(W.WalkerOffsets[i+1]-W.WalkerOffsets[i]);
+    displ[i]=wb*W.WalkerOffsets[i];
+  }
+  if(!myComm->rank())
+    RemoteData[1]->resize(wb*W.WalkerOffsets[myComm->size()]);
+  mpi::gatherv(*myComm,*RemoteData[0],*RemoteData[1],counts,displ);
+  return 1;
+}
+
+/** write the staged configurations on the helper thread
+ * @param fname name of the config file
+ * @param buffer_id index of RemoteData with all the walkers
+ *
+ * The layout is the same as dump. No communication is done here and the
+ * data is written to a temporary file which replaces fname when it is
+ * complete, so that the previous checkpoint survives a failed write. The
+ * random states of the same block are written after the walkers.
+ */
+void HDFWalkerOutput::write_staged(const std::string& fname, int buffer_id)
+{
+  std::string tmpname=fname+".tmp";
+  //a serial archive, the other ranks do not take part
+  hdf_archive dump_file(0,false);
+  if(!dump_file.create(tmpname))
+  {
+    app_error() << "  Failed to create the checkpoint file " << tmpname << std::endl;
+    return;
+  }
+  HDFVersion cur_version;
+  dump_file.write(cur_version.version,hdf::version);
+  dump_file.push(hdf::main_state);
+  dump_file.write(StagedBlock,"block");
+  dump_file.write(StagedOffsets,"walker_partition");
+  dump_file.write(number_of_walkers,hdf::num_walkers);
+  TinyVector<int,3> gcounts(number_of_walkers,number_of_particles,OHMMS_DIM);
+  hyperslab_proxy<BufferType,3> slab(*RemoteData[buffer_id],gcounts);
+  dump_file.write(slab,hdf::walkers);
+  dump_file.close();
+  if(std::rename(tmpname.c_str(),fname.c_str()))
+  {
+    app_error() << "  Failed to rename " << tmpname << " to " << fname << std::endl;
+    return;
+  }
+  RandomNumberControl::writeStaged(RootName,myComm);
+}
+
 /*
 bool HDFWalkerOutput::dump(ForwardWalkingHistoryObject& FWO)
 {
@@ -22,6 +22,7 @@
 #include <Particle/MCWalkerConfiguration.h>
 // #include <QMCDrivers/ForwardWalking/ForwardWalkingStructure.h>
 #include <utility>
+#include <thread>
 #include <io/hdf_archive.h>
 #ifdef HAVE_ADIOS
 #include <adios.h>
@@ -83,6 +84,22 @@ public:
    * @param w walkers
    */
   bool dump(MCWalkerConfiguration& w, int block);
+
+  /** enable or disable the background write of the configurations
+   * @param async if true, dump returns after the walkers and the random states are staged
+   *
+   * Requires a thread-safe HDF5 library, otherwise the writes stay synchronous.
+   */
+  void setAsync(bool async);
+
+  ///return true if dump writes the walkers and the random states in the background
+  inline bool isAsync() const
+  {
+    return AsyncWrite;
+  }
+
+  ///wait for the background write of the last dump to finish
+  void wait();
 //     bool dump(ForwardWalkingHistoryObject& FWO);
 
 private:
@@ -92,6 +109,14 @@ private:
   std::vector<Communicate::request> myRequest;
   std::vector<BufferType*> RemoteData;
   int block;
+  ///if true, the staged configurations are written by Writer
+  bool AsyncWrite;
+  ///helper thread writing the staged configurations
+  std::thread Writer;
+  ///block of the staged configurations
+  int StagedBlock;
+  ///walker partition of the staged configurations
+  std::vector<int> StagedOffsets;
 
 //     //define some types for the FW collection
 //     typedef std::vector<ForwardWalkingData> FWBufferType;
@@ -99,6 +124,12 @@ private:
 //     std::vector<std::vector<int> > FWCountData;
 
   void write_configuration(MCWalkerConfiguration& W, hdf_archive& hout, int block);
+  ///copy the walkers of this rank to RemoteData[0]
+  void stage_configuration(MCWalkerConfiguration& W, int block);
+  ///gather the staged walkers to the master and return the index of the full buffer
+  int gather_configuration(MCWalkerConfiguration& W);
+  ///write the staged configurations to fname, executed by Writer
+  void write_staged(const std::string& fname, int buffer_id);
 };
 
 }
@@ -95,7 +95,8 @@ struct MCSample
 MCWalkerConfiguration::MCWalkerConfiguration():
   OwnWalkers(true),ReadyForPbyP(false),UpdateMode(Update_Walker),Polymer(0),
 
-  MaxSamples(10),CurSampleCount(0),GlobalNumWalkers(0),reptile(0)
+  MaxSamples(10),CurSampleCount(0),GlobalNumWalkers(0),
+  FirstNewWalkerID(0),NumWalkersCreated(0),reptile(0)
 #ifdef QMC_CUDA
   ,RList_GPU("MCWalkerConfiguration::RList_GPU"),
   GradList_GPU("MCWalkerConfiguration::GradList_GPU"),
@@ -112,6 +113,7 @@ MCWalkerConfiguration::MCWalkerConfiguration():
 
 MCWalkerConfiguration::MCWalkerConfiguration(const MCWalkerConfiguration& mcw)
   : ParticleSet(mcw), OwnWalkers(true), GlobalNumWalkers(mcw.GlobalNumWalkers),
+    FirstNewWalkerID(mcw.FirstNewWalkerID), NumWalkersCreated(mcw.NumWalkersCreated),
     UpdateMode(Update_Walker), ReadyForPbyP(false), Polymer(0),
     MaxSamples(mcw.MaxSamples), CurSampleCount(0)
 #ifdef QMC_CUDA
@@ -205,6 +205,27 @@ public:
     WalkerOffsets=o;
   }
 
+  /** restart the IDs of the new walkers
+   * @param nw number of the walkers numbered [0,nw) over all the ranks
+   */
+  inline void resetWalkerIDs(long nw)
+  {
+    FirstNewWalkerID=nw;
+    NumWalkersCreated=0;
+  }
+
+  /** return the ID of a new walker
+   * @param np number of ranks
+   * @param rank rank of this walker set
+   *
+   * The IDs start above the numbered walkers and are unique over the ranks,
+   * so that every walker has its own random stream.
+   */
+  inline long newWalkerID(int np, int rank)
+  {
+    return FirstNewWalkerID+(++NumWalkersCreated)*np+rank;
+  }
+
   ///return the number of particles per walker
   inline int getParticleNum() const
   {
@@ -385,6 +406,10 @@ protected:
   int LocalNumWalkers;
   ///number of walkers shared by a MPI group
   int GlobalNumWalkers;
+  ///first ID of the walkers created after the walkers were numbered
+  long FirstNewWalkerID;
+  ///number of walkers created by this rank since the walkers were numbered
+  long NumWalkersCreated;
   ///update-mode index
   int UpdateMode;
 
@@ -54,7 +54,7 @@ void add_p_timer(std::vector<NewTimer*>& timers)
 
 ParticleSet::ParticleSet()
   : UseBoundBox(true), UseSphereUpdate(true), IsGrouped(true)
-  , ThreadID(0), SK(0), ParentTag(-1), ParentName("0")
+  , UseSoADistanceTables(false), ThreadID(0), SK(0), ParentTag(-1), ParentName("0")
   , quantum_domain(classical)
 {
   initParticleSet();
@@ -64,7 +64,7 @@ ParticleSet::ParticleSet()
 
 ParticleSet::ParticleSet(const ParticleSet& p)
   : UseBoundBox(p.UseBoundBox), UseSphereUpdate(p.UseSphereUpdate),IsGrouped(p.IsGrouped)
-  , ThreadID(0), mySpecies(p.getSpeciesSet()),SK(0), ParentTag(p.tag()), ParentName(p.parentName())
+  , UseSoADistanceTables(p.UseSoADistanceTables), ThreadID(0), mySpecies(p.getSpeciesSet()),SK(0), ParentTag(p.tag()), ParentName(p.parentName())
 {
   set_quantum_domain(p.quantum_domain);
   initBase();
@@ -741,6 +741,72 @@ void ParticleSet::acceptMove(Index_t iat)
   }
 }
 
+void ParticleSet::mw_makeMoveAndCheck(const std::vector<ParticleSet*>& P_list, Index_t iat,
+                                      const std::vector<SingleParticlePos_t>& displs, std::vector<int>& valid)
+{
+  const int nw=P_list.size();
+  if(nw==0)
+    return;
+  P_list[0]->myTimers[0]->start();
+  std::vector<SingleParticlePos_t> newpos(nw);
+  for(int iw=0; iw<nw; ++iw)
+  {
+    ParticleSet& P(*P_list[iw]);
+    P.activePtcl=iat;
+    P.activePos=P.R[iat];
+    newpos[iw]=P.activePos+displs[iw];
+    valid[iw]=1;
+    if (P.UseBoundBox)
+    {
+      if (P.Lattice.outOfBound(P.Lattice.toUnit(displs[iw])))
+        valid[iw]=0;
+      else
+      {
+        P.newRedPos=P.Lattice.toUnit(newpos[iw]);
+        valid[iw]=P.Lattice.isValid(P.newRedPos);
+      }
+    }
+  }
+  //the distance tables see the old position of iat
+  for (int i=0; i<P_list[0]->DistTables.size(); ++i)
+    for(int iw=0; iw<nw; ++iw)
+      if(valid[iw])
+        P_list[iw]->DistTables[i]->move(*P_list[iw],newpos[iw],iat);
+  for(int iw=0; iw<nw; ++iw)
+  {
+    if(!valid[iw])
+      continue;
+    ParticleSet& P(*P_list[iw]);
+    P.R[iat]=newpos[iw];
+    if (P.UseBoundBox && P.SK && P.SK->DoUpdate)
+      P.SK->makeMove(iat,newpos[iw]);
+  }
+  P_list[0]->myTimers[0]->stop();
+}
+
+void ParticleSet::mw_acceptMove(const std::vector<ParticleSet*>& P_list, Index_t iat)
+{
+  const int nw=P_list.size();
+  if(nw==0)
+    return;
+  for(int iw=0; iw<nw; ++iw)
+    if(P_list[iw]->activePtcl != iat)
+    {
+      std::ostringstream o;
+      o << "  Illegal acceptMove " << iat << " != " << P_list[iw]->activePtcl;
+      APP_ABORT(o.str());
+    }
+  for (int i=0; i<P_list[0]->DistTables.size(); ++i)
+    for(int iw=0; iw<nw; ++iw)
+      P_list[iw]->DistTables[i]->update(iat);
+  for(int iw=0; iw<nw; ++iw)
+  {
+    ParticleSet& P(*P_list[iw]);
+    if (P.SK && P.SK->DoUpdate)
+      P.SK->acceptMove(iat,P.GroupID[iat]);
+  }
+}
+
 void ParticleSet::makeVirtualMoves(const SingleParticlePos_t& newpos)
 {
   activePtcl=0;
@@ -130,6 +130,8 @@ public:
   bool IsGrouped;
   ///true if the particles have the same mass
   bool SameMass;
+  ///true if the distance tables use the structure-of-arrays layout
+  bool UseSoADistanceTables;
   ///threa id
   Index_t ThreadID;
   ///the index of the active particle for particle-by-particle moves
@@ -364,6 +366,18 @@ public:
    */
   bool makeMoveAndCheck(Index_t iat, const SingleParticlePos_t& displ);
 
+  /** move the iat-th particle of many walkers
+   * @param P_list the ParticleSets of the walkers
+   * @param iat the index of the particle to be moved
+   * @param displs the displacements of the walkers
+   * @param valid 1 if the move of a walker is valid, 0 otherwise
+   *
+   * Same as makeMoveAndCheck of each walker. The distance tables of the same
+   * index are moved together over the walkers.
+   */
+  static void mw_makeMoveAndCheck(const std::vector<ParticleSet*>& P_list, Index_t iat,
+                                  const std::vector<SingleParticlePos_t>& displs, std::vector<int>& valid);
+
   /** move all the particles of a walker
    * @param awalker the walker to operate
    * @param deltaR proposed displacement
@@ -402,6 +416,12 @@ public:
    */
   void acceptMove(Index_t iat);
 
+  /** accept the moves of the iat-th particle of many walkers
+   * @param P_list the ParticleSets of the walkers with a valid move of iat
+   * @param iat the index of the moved particle
+   */
+  static void mw_acceptMove(const std::vector<ParticleSet*>& P_list, Index_t iat);
+
   /** reject the move
    */
   void rejectMove(Index_t iat);
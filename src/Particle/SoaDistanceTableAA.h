@@ -0,0 +1,138 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_SOA_DISTANCETABLEAA_H
+#define QMCPLUSPLUS_SOA_DISTANCETABLEAA_H
+
+namespace qmcplusplus
+{
+
+/**@ingroup nnlist
+ * @brief A derived class from SymmetricDTD with the structure-of-arrays storage
+ *
+ * The full rows of Distances and Displacements are computed by the
+ * DTD_BConds<T,D,SC>::computeDistances kernel on the SoA copy of the
+ * positions. The AoS data of SymmetricDTD are kept in sync so that
+ * the consumers of r_m, dr_m and Temp work unchanged.
+ */
+template<typename T, unsigned D, int SC>
+struct SoaDistanceTableAA: public SymmetricDTD<T,D,SC>
+{
+  typedef SymmetricDTD<T,D,SC> base_type;
+  typedef typename base_type::PosType PosType;
+  typedef typename base_type::IndexType IndexType;
+
+  ///number of particles
+  int Ntargets;
+  ///SoA copy of the positions
+  VectorSoaContainer<T,D> RSoA;
+  ///position of the proposed move
+  PosType newPos;
+
+  SoaDistanceTableAA(ParticleSet& target)
+    : base_type(target,target), Ntargets(0)
+  {
+    this->DTType=DistanceTableData::DT_SOA;
+    resizeSoA();
+  }
+
+  void create(int walkers)
+  {
+    base_type::create(walkers);
+    resizeSoA();
+  }
+
+  inline void resizeSoA()
+  {
+    Ntargets=this->N[DistanceTableData::SourceIndex];
+    const int nalign=getAlignedSize<T>(Ntargets);
+    RSoA.resize(Ntargets);
+    this->Distances.resize(Ntargets);
+    this->Displacements.resize(Ntargets);
+    for(int i=0; i<Ntargets; ++i)
+    {
+      this->Distances[i].resize(nalign);
+      this->Displacements[i].resize(Ntargets);
+    }
+    this->Temp_r.resize(nalign);
+    this->Temp_dr.resize(Ntargets);
+  }
+
+  inline void evaluate(const ParticleSet& P)
+  {
+    const T BigR=std::numeric_limits<T>::max();
+    RSoA.copyIn(P.R);
+    for(int i=0; i<Ntargets; ++i)
+    {
+      DTD_BConds<T,D,SC>::computeDistances(P.R[i],RSoA,this->Distances[i].data(),this->Displacements[i],0,Ntargets);
+      this->Distances[i][i]=BigR;
+      this->Displacements[i].set(i,PosType());
+    }
+    //AoS data, dr_m[ij]=R[j]-R[i] for j>i
+    for(int i=0,ij=0; i<Ntargets; ++i)
+      for(int j=i+1; j<Ntargets; ++j,++ij)
+      {
+        this->r_m[ij]=this->Distances[i][j];
+        this->rinv_m[ij]=1.0/this->Distances[i][j];
+        this->dr_m[ij]=this->Displacements[i][j];
+      }
+  }
+
+  ///evaluate the temporary pair relations
+  inline void move(const ParticleSet& P, const PosType& rnew, IndexType jat)
+  {
+    this->activePtcl=jat;
+    newPos=rnew;
+    DTD_BConds<T,D,SC>::computeDistances(rnew,RSoA,this->Temp_r.data(),this->Temp_dr,0,Ntargets);
+    this->Temp_r[jat]=std::numeric_limits<T>::max();
+    this->Temp_dr.set(jat,PosType());
+    //AoS data, Temp[iat].dr1=rnew-R[iat]
+    for(int iat=0; iat<Ntargets; ++iat)
+    {
+      this->Temp[iat].r1=this->Temp_r[iat];
+      this->Temp[iat].rinv1=1.0/this->Temp_r[iat];
+      this->Temp[iat].dr1=-1.0*this->Temp_dr[iat];
+      this->Temp[iat].dr1_nobox=rnew-P.R[iat];
+    }
+    //the old position of jat as SymmetricDTD::move does
+    PosType drij(rnew-P.R[jat]);
+    this->Temp[jat].r1=std::sqrt(DTD_BConds<T,D,SC>::apply_bc(drij));
+    this->Temp[jat].rinv1=1.0/this->Temp[jat].r1;
+    this->Temp[jat].dr1=drij;
+  }
+
+  inline void moveOnSphere(const ParticleSet& P, const PosType& rnew, IndexType jat)
+  {
+    move(P,rnew,jat);
+  }
+
+  ///update the row and the column of jat-th particle
+  inline void update(IndexType jat)
+  {
+    std::copy(this->Temp_r.begin(),this->Temp_r.end(),this->Distances[jat].begin());
+    std::copy(this->Temp_dr.myData.begin(),this->Temp_dr.myData.end(),this->Displacements[jat].myData.begin());
+    for(int iat=0; iat<Ntargets; ++iat)
+      if(iat!=jat)
+        this->Distances[iat][jat]=this->Temp_r[iat];
+    for(unsigned d=0; d<D; ++d)
+    {
+      const T* restrict dr=this->Temp_dr.data(d);
+      for(int iat=0; iat<Ntargets; ++iat)
+        if(iat!=jat)
+          this->Displacements[iat].data(d)[jat]=-dr[iat];
+    }
+    RSoA.set(jat,newPos);
+    base_type::update(jat);
+  }
+};
+}
+#endif
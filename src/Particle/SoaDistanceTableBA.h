@@ -0,0 +1,114 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_SOA_DISTANCETABLEBA_H
+#define QMCPLUSPLUS_SOA_DISTANCETABLEBA_H
+
+namespace qmcplusplus
+{
+
+/**@ingroup nnlist
+ * @brief A derived class from AsymmetricDTD with the structure-of-arrays storage
+ *
+ * Every target particle owns a padded row of the relations with the sources,
+ * computed by the DTD_BConds<T,D,SC>::computeDistances kernel on the SoA copy
+ * of the source positions. The AoS data of AsymmetricDTD are kept in sync
+ * so that the consumers of r_m, dr_m and Temp work unchanged.
+ */
+template<typename T, unsigned D, int SC>
+struct SoaDistanceTableBA: public AsymmetricDTD<T,D,SC>
+{
+  typedef AsymmetricDTD<T,D,SC> base_type;
+  typedef typename base_type::PosType PosType;
+  typedef typename base_type::IndexType IndexType;
+
+  ///number of sources
+  int Nsources;
+  ///number of targets
+  int Ntargets;
+  ///SoA copy of the source positions
+  VectorSoaContainer<T,D> RSoA;
+
+  SoaDistanceTableBA(const ParticleSet& source, ParticleSet& target)
+    : base_type(source,target), Nsources(0), Ntargets(0)
+  {
+    this->DTType=DistanceTableData::DT_SOA;
+    resizeSoA();
+  }
+
+  void create(int walkers)
+  {
+    base_type::create(walkers);
+    resizeSoA();
+  }
+
+  inline void resizeSoA()
+  {
+    Nsources=this->N[DistanceTableData::SourceIndex];
+    Ntargets=this->N[DistanceTableData::VisitorIndex];
+    const int nalign=getAlignedSize<T>(Nsources);
+    RSoA.resize(Nsources);
+    this->Distances.resize(Ntargets);
+    this->Displacements.resize(Ntargets);
+    for(int i=0; i<Ntargets; ++i)
+    {
+      this->Distances[i].resize(nalign);
+      this->Displacements[i].resize(Nsources);
+    }
+    this->Temp_r.resize(nalign);
+    this->Temp_dr.resize(Nsources);
+  }
+
+  inline void evaluate(const ParticleSet& P)
+  {
+    RSoA.copyIn(this->Origin->R);
+    for(int j=0; j<Ntargets; ++j)
+      DTD_BConds<T,D,SC>::computeDistances(P.R[j],RSoA,this->Distances[j].data(),this->Displacements[j],0,Nsources);
+    //AoS data, dr_m[i*Ntargets+j]=P.R[j]-R_i
+    for(int i=0,ij=0; i<Nsources; ++i)
+      for(int j=0; j<Ntargets; ++j,++ij)
+      {
+        this->r_m[ij]=this->Distances[j][i];
+        this->rinv_m[ij]=1.0/this->Distances[j][i];
+        this->dr_m[ij]=-1.0*this->Displacements[j][i];
+      }
+  }
+
+  ///evaluate the temporary pair relations
+  inline void move(const ParticleSet& P, const PosType& rnew, IndexType jat)
+  {
+    this->activePtcl=jat;
+    DTD_BConds<T,D,SC>::computeDistances(rnew,RSoA,this->Temp_r.data(),this->Temp_dr,0,Nsources);
+    //AoS data, Temp[iat].dr1=rnew-R_iat
+    for(int iat=0; iat<Nsources; ++iat)
+    {
+      this->Temp[iat].r1=this->Temp_r[iat];
+      this->Temp[iat].rinv1=1.0/this->Temp_r[iat];
+      this->Temp[iat].dr1=-1.0*this->Temp_dr[iat];
+    }
+  }
+
+  inline void moveOnSphere(const ParticleSet& P, const PosType& rnew, IndexType jat)
+  {
+    move(P,rnew,jat);
+  }
+
+  ///update the row of jat-th target particle
+  inline void update(IndexType jat)
+  {
+    std::copy(this->Temp_r.begin(),this->Temp_r.end(),this->Distances[jat].begin());
+    std::copy(this->Temp_dr.myData.begin(),this->Temp_dr.myData.end(),this->Displacements[jat].myData.begin());
+    base_type::update(jat);
+  }
+};
+}
+#endif
@@ -46,6 +46,8 @@ namespace qmcplusplus
 
     if(myPtcl->DistTables.size())
     {
+      //the tables of the quadrature points follow the layout of the quantum particles
+      UseSoADistanceTables=myPtcl->UseSoADistanceTables;
       DistTables.resize(myPtcl->DistTables.size());
       DistTables[0]=createDistanceTable(*myPtcl,*this);
       for(int i=1; i<myPtcl->DistTables.size(); ++i)
@@ -20,6 +20,7 @@
 #include "ParticleIO/XMLParticleIO.h"
 #include "ParticleIO/ParticleLayoutIO.h"
 #include "Particle/DistanceTableData.h"
+#include "Lattice/ParticleBConds.h"
 
 #include <stdio.h>
 #include <string>
@@ -472,4 +473,174 @@ const char *particles =
 
 } // TEST_CASE distance_pbc_z
 
+// compare the structure-of-arrays tables against the default tables of the same cell
+void check_soa_tables(ParticleSet& ref, ParticleSet& soa)
+{
+  for (int t=0; t<ref.DistTables.size(); t++)
+  {
+    DistanceTableData* d_ref = ref.DistTables[t];
+    DistanceTableData* d_soa = soa.DistTables[t];
+    REQUIRE( d_ref->DTType == DistanceTableData::DT_AOS );
+    REQUIRE( d_soa->DTType == DistanceTableData::DT_SOA );
+    const int nsrc = d_ref->centers();
+    const int ntar = d_ref->targets();
+    for (int i=0; i<nsrc; i++)
+      for (int j=0; j<ntar; j++)
+      {
+        if (t==0 && j<=i) continue; // AA table stores i<j
+        const int ij = (t==0) ? d_ref->IJ[i*ntar+j] : d_ref->loc(i,j);
+        REQUIRE( d_soa->r(ij) == Approx(d_ref->r(ij)) );
+        REQUIRE( d_soa->rinv(ij) == Approx(d_ref->rinv(ij)) );
+        // SoA displacements are source - target
+        for (int d=0; d<3; d++)
+        {
+          REQUIRE( d_soa->dr(ij)[d] == Approx(d_ref->dr(ij)[d]) );
+          if (t==0)
+          {
+            REQUIRE( d_soa->Displacements[i][j][d] == Approx(d_ref->dr(ij)[d]) );
+            REQUIRE( d_soa->Displacements[j][i][d] == Approx(-d_ref->dr(ij)[d]) );
+          }
+          else
+            REQUIRE( d_soa->Displacements[j][i][d] == Approx(-d_ref->dr(ij)[d]) );
+        }
+        if (t==0)
+        {
+          REQUIRE( d_soa->Distances[i][j] == Approx(d_ref->r(ij)) );
+          REQUIRE( d_soa->Distances[j][i] == Approx(d_ref->r(ij)) );
+        }
+        else
+          REQUIRE( d_soa->Distances[j][i] == Approx(d_ref->r(ij)) );
+      }
+  }
+}
+
+void test_soa_tables(const ParticleSet::ParticleLayout_t& lattice)
+{
+  ParticleSet ions, elec_ref, elec_soa;
+  ions.setName("ion0");
+  ions.Lattice.copy(lattice);
+  ions.create(3);
+  elec_ref.setName("e");
+  elec_ref.Lattice.copy(lattice);
+  elec_ref.create(7);
+  elec_soa.setName("e");
+  elec_soa.Lattice.copy(lattice);
+  elec_soa.create(7);
+  elec_soa.UseSoADistanceTables = true;
+
+  for (int i=0; i<ions.getTotalNum(); i++)
+    ions.R[i] = ParticleSet::SingleParticlePos_t(0.3+1.1*i, 0.7*i, 2.0-0.4*i);
+  for (int i=0; i<elec_ref.getTotalNum(); i++)
+    elec_ref.R[i] = ParticleSet::SingleParticlePos_t(0.1+0.9*i, 2.5-0.6*i, 0.2+0.45*i*i);
+  elec_soa.R = elec_ref.R;
+
+  elec_ref.addTable(elec_ref);
+  elec_ref.addTable(ions);
+  elec_soa.addTable(elec_soa);
+  elec_soa.addTable(ions);
+  elec_ref.update();
+  elec_soa.update();
+  check_soa_tables(elec_ref, elec_soa);
+
+  // accept the moves of the even particles, reject the others
+  for (int iel=0; iel<elec_ref.getTotalNum(); iel++)
+  {
+    ParticleSet::SingleParticlePos_t disp(0.8-0.3*iel, 0.25*iel, -1.7+0.5*iel);
+    elec_ref.makeMove(iel, disp);
+    elec_soa.makeMove(iel, disp);
+    for (int t=0; t<elec_ref.DistTables.size(); t++)
+      for (int j=0; j<elec_ref.DistTables[t]->centers(); j++)
+      {
+        REQUIRE( elec_soa.DistTables[t]->Temp[j].r1 == Approx(elec_ref.DistTables[t]->Temp[j].r1) );
+        if (t==0 && j==iel) continue;
+        REQUIRE( elec_soa.DistTables[t]->Temp_r[j] == Approx(elec_ref.DistTables[t]->Temp[j].r1) );
+      }
+    if (iel%2 == 0)
+    {
+      elec_ref.acceptMove(iel);
+      elec_soa.acceptMove(iel);
+    }
+    else
+    {
+      elec_ref.rejectMove(iel);
+      elec_soa.rejectMove(iel);
+    }
+  }
+  check_soa_tables(elec_ref, elec_soa);
+}
+
+TEST_CASE("distance_soa_tables", "[distance_table]")
+{
+  OHMMS::Controller->initialize(0, NULL);
+  OhmmsInfo("testlogfile");
+
+  // open boundary conditions
+  ParticleSet::ParticleLayout_t open_cell;
+  test_soa_tables(open_cell);
+
+  // orthorhombic cell
+  ParticleSet::ParticleLayout_t ortho_cell;
+  ortho_cell.BoxBConds = true;
+  ortho_cell.R.diagonal(4.0);
+  ortho_cell.R(2,2) = 5.0;
+  ortho_cell.reset();
+  test_soa_tables(ortho_cell);
+
+  // general cell
+  ParticleSet::ParticleLayout_t general_cell;
+  general_cell.BoxBConds = true;
+  general_cell.R.diagonal(4.0);
+  general_cell.R(1,0) = 1.0;
+  general_cell.R(2,1) = 0.5;
+  general_cell.reset();
+  test_soa_tables(general_cell);
+} // TEST_CASE distance_soa_tables
+
+// compare the SoA kernel of a boundary condition against its scalar apply_bc
+template<int SC>
+void test_soa_kernel(const ParticleSet::ParticleLayout_t& lattice)
+{
+  typedef OHMMS_PRECISION RealType;
+  typedef ParticleSet::SingleParticlePos_t PosType;
+  DTD_BConds<RealType,3,SC> bc(lattice);
+  const int n=13;
+  VectorSoaContainer<RealType,3> R0(n), temp_dr(n);
+  std::vector<RealType> temp_r(n);
+  for (int i=0; i<n; i++)
+    R0.set(i, PosType(-3.1+1.7*i, 4.2-0.9*i, 0.3*i*i-2.0));
+  PosType pos(0.4, -1.3, 2.2);
+  bc.computeDistances(pos, R0, temp_r.data(), temp_dr, 0, n);
+  for (int i=0; i<n; i++)
+  {
+    PosType displ = R0[i]-pos;
+    RealType r2 = bc.apply_bc(displ);
+    REQUIRE( temp_r[i] == Approx(std::sqrt(r2)) );
+    for (int d=0; d<3; d++)
+      REQUIRE( temp_dr[i][d] == Approx(displ[d]) );
+  }
+}
+
+TEST_CASE("distance_soa_image_cells", "[distance_table]")
+{
+  ParticleSet::ParticleLayout_t bulk;
+  bulk.BoxBConds = true;
+  bulk.R.diagonal(3.0);
+  bulk.R(1,0) = 2.4;
+  bulk.R(2,0) = -1.1;
+  bulk.R(2,1) = 1.8;
+  bulk.reset();
+  test_soa_kernel<PPPG>(bulk);
+  test_soa_kernel<PPPX>(bulk);
+
+  ParticleSet::ParticleLayout_t slab;
+  slab.BoxBConds = true;
+  slab.BoxBConds[2] = false;
+  slab.R.diagonal(3.0);
+  slab.R(1,0) = 2.4;
+  slab.R(2,2) = 10.0;
+  slab.reset();
+  test_soa_kernel<PPNG>(slab);
+  test_soa_kernel<PPNX>(slab);
+} // TEST_CASE distance_soa_image_cells
+
 } // namespace qmcplusplus
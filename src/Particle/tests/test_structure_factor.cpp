@@ -0,0 +1,110 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+
+#include "OhmmsPETE/Tensor.h"
+#include "Utilities/OhmmsInfo.h"
+#include "Particle/ParticleSet.h"
+#include "LongRange/StructFact.h"
+
+#include <stdio.h>
+#include <string>
+
+namespace qmcplusplus
+{
+
+#if defined(USE_REAL_STRUCT_FACTOR)
+void check_eikr(const StructFact& sk, int iat, const ParticleSet::SingleParticlePos_t& pos)
+{
+  const KContainer& kl=sk.KLists;
+  for(int ki=0; ki<kl.numk; ki++)
+  {
+    ParticleSet::RealType phi=dot(kl.kpts_cart[ki],pos);
+    REQUIRE( sk.eikr_r[iat][ki] == Approx(std::cos(phi)) );
+    REQUIRE( sk.eikr_i[iat][ki] == Approx(std::sin(phi)) );
+  }
+}
+
+TEST_CASE("structure_factor_pbyp", "[particle][longrange]")
+{
+  OHMMS::Controller->initialize(0, NULL);
+  OhmmsInfo("testlogfile");
+
+  // general cell
+  ParticleSet::ParticleLayout_t lattice;
+  lattice.BoxBConds = true;
+  lattice.R.diagonal(4.0);
+  lattice.R(1,0) = 1.0;
+  lattice.R(2,1) = 0.5;
+  lattice.reset();
+
+  ParticleSet elec;
+  elec.setName("e");
+  elec.Lattice.copy(lattice);
+  elec.LRBox.copy(lattice);
+  std::vector<int> agroup(2);
+  agroup[0]=3;
+  agroup[1]=2;
+  elec.create(agroup);
+  elec.getSpeciesSet().addSpecies("u");
+  elec.getSpeciesSet().addSpecies("d");
+  for (int i=0; i<elec.getTotalNum(); i++)
+    elec.R[i] = ParticleSet::SingleParticlePos_t(0.1+0.9*i, 2.5-0.6*i, 0.2+0.45*i*i);
+
+  StructFact sk(elec,6.0);
+  const KContainer& kl=sk.KLists;
+  REQUIRE( kl.numk > 0 );
+  for(int ki=0; ki<kl.numk; ki++)
+    for(int idim=0; idim<OHMMS_DIM; idim++)
+    {
+      REQUIRE( kl.kpts_cart_soa.data(idim)[ki] == Approx(kl.kpts_cart[ki][idim]) );
+      REQUIRE( kl.kpts_index.data(idim)[ki] == kl.kpts[ki][idim]+kl.mmax[OHMMS_DIM] );
+    }
+  for (int i=0; i<elec.getTotalNum(); i++)
+    check_eikr(sk,i,elec.R[i]);
+
+  // accept the moves of the even particles, reject the others
+  for (int iel=0; iel<elec.getTotalNum(); iel++)
+  {
+    ParticleSet::SingleParticlePos_t newpos=elec.R[iel]+ParticleSet::SingleParticlePos_t(0.8-0.3*iel, 0.25*iel, -1.7+0.5*iel);
+    sk.makeMove(iel,newpos);
+    for(int ki=0; ki<kl.numk; ki++)
+    {
+      ParticleSet::RealType phi=dot(kl.kpts_cart[ki],newpos);
+      REQUIRE( sk.eikr_r_temp[ki] == Approx(std::cos(phi)) );
+      REQUIRE( sk.eikr_i_temp[ki] == Approx(std::sin(phi)) );
+    }
+    if (iel%2 == 0)
+    {
+      sk.acceptMove(iel,elec.GroupID[iel]);
+      elec.R[iel]=newpos;
+    }
+    else
+      sk.rejectMove(iel,elec.GroupID[iel]);
+  }
+
+  // the incremental rho_k agrees with the one from scratch
+  StructFact sk_ref(elec,6.0);
+  for (int i=0; i<elec.getTotalNum(); i++)
+    check_eikr(sk,i,elec.R[i]);
+  for(int ig=0; ig<2; ig++)
+    for(int ki=0; ki<kl.numk; ki++)
+    {
+      REQUIRE( sk.rhok_r[ig][ki] == Approx(sk_ref.rhok_r[ig][ki]) );
+      REQUIRE( sk.rhok_i[ig][ki] == Approx(sk_ref.rhok_i[ig][ki]) );
+    }
+}
+#endif
+
+}
@@ -15,11 +15,13 @@
 #include "Particle/MCWalkerConfiguration.h"
 #include "Particle/HDFWalkerOutput.h"
 #include "Particle/HDFWalkerInput_0_4.h"
+#include "OhmmsApp/RandomNumberControl.h"
 
 
 
 #include <stdio.h>
 #include <string>
+#include <fstream>
 
 using std::string;
 
@@ -42,7 +44,8 @@ TEST_CASE("walker", "[particle]")
 }
 
 
-TEST_CASE("walker HDF read and write", "[particle]")
+// write two walkers, in the background if async, and read them back
+void test_walker_hdf(const string& name, bool async)
 {
   OHMMS::Controller->initialize(0, NULL);
   Communicate *c = OHMMS::Controller;
@@ -82,9 +85,26 @@ TEST_CASE("walker HDF read and write", "[particle]")
 
   W.setWalkerOffsets(walker_offset);
 
-  c->setName("walker_test");
-  HDFWalkerOutput hout(W, "this string apparently does nothing", c);
+#if defined(HAVE_LIBBOOST)
+  const string rng_name = name+".random.xml";
+#else
+  const string rng_name = name+".random.h5";
+#endif
+  remove(rng_name.c_str());
+
+  c->setName(name);
+  HDFWalkerOutput hout(W, name, c);
+  hout.setAsync(async);
   hout.dump(W, 0);
+  if (hout.isAsync())
+  {
+    // the walkers are staged, changing them does not affect the file
+    w1.R[0] = 3.0;
+    hout.wait();
+    // the random states of the block are written with the walkers
+    std::ifstream rng_file(rng_name.c_str());
+    REQUIRE(rng_file.good());
+  }
 
   c->barrier();
 
@@ -94,15 +114,26 @@ TEST_CASE("walker HDF read and write", "[particle]")
 
   HDFVersion version(0,4);
   HDFWalkerInput_0_4 hinp(W2, c, version);
-  bool okay = hinp.read_hdf5("walker_test");
+  bool okay = hinp.read_hdf5(name);
   REQUIRE(okay);
 
   REQUIRE(W2.getActiveWalkers() == 2);
   for (int i = 0; i < 3; i++)
   {
-    REQUIRE(W2[0]->R[0][i] == w1.R[0][i]);
+    REQUIRE(W2[0]->R[0][i] == 1.0);
     REQUIRE(W2[1]->R[0][i] == w2.R[0][i]);
   }
 }
 
+TEST_CASE("walker HDF read and write", "[particle]")
+{
+  test_walker_hdf("walker_test", false);
+}
+
+TEST_CASE("walker HDF asynchronous write", "[particle]")
+{
+  RandomNumberControl::make_seeds();
+  test_walker_hdf("walker_async_test", true);
+}
+
 }
@@ -23,6 +23,7 @@
 #include "OhmmsPETE/OhmmsMatrix.h"
 #include "ParticleBase/ParticleAttrib.h"
 #include "Utilities/RandomGenerator.h"
+#include "Utilities/PhiloxRandom.h"
 
 /*!\fn template<class T> void assignGaussRand(T* restrict a, unsigned n)
   *\param a the starting pointer
@@ -67,6 +68,13 @@ inline void assignGaussRand(T* restrict a, unsigned n, RG& rng)
   }
 }
 
+///bulk Gaussian numbers of the counter-based generator
+template<class T, class RT>
+inline void assignGaussRand(T* restrict a, unsigned n, PhiloxRandom<RT>& rng)
+{
+  rng.generate_normal(a,n);
+}
+
 /*!\fn template<class T> void assignUniformRand(T* restrict a, unsigned n)
   *\param a the starting pointer
   *\param n the number of type T to be assigned
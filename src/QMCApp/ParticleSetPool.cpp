@@ -142,6 +142,7 @@ bool ParticleSetPool::put(xmlNodePtr cur)
   std::string role("none");
   std::string randomR("no");
   std::string randomsrc;
+  std::string dtlayout("aos");
   OhmmsAttributeSet pAttrib;
   pAttrib.add(id,"id");
   pAttrib.add(id,"name");
@@ -149,6 +150,7 @@ bool ParticleSetPool::put(xmlNodePtr cur)
   pAttrib.add(randomR,"random");
   pAttrib.add(randomsrc,"randomsrc");
   pAttrib.add(randomsrc,"random_source");
+  pAttrib.add(dtlayout,"distancetable");
   pAttrib.put(cur);
   //backward compatibility
   if(id == "e" && role=="none")
@@ -167,6 +169,17 @@ bool ParticleSetPool::put(xmlNodePtr cur)
       app_log() << "  Initializing the lattice of " << id << " by the global supercell" << std::endl;
       pTemp->Lattice.copy(*SimulationCell);
     }
+    if(dtlayout=="soa")
+    {
+#if OHMMS_DIM == 3
+      app_log() << "  Using the structure-of-arrays distance tables for " << id << std::endl;
+      pTemp->UseSoADistanceTables=true;
+#else
+      app_warning() << "  distancetable=\"soa\" is available only in 3D. Using the default tables." << std::endl;
+#endif
+    }
+    else if(dtlayout!="aos")
+      APP_ABORT("ParticleSetPool::put unknown distancetable=\""+dtlayout+"\". Use aos or soa.");
     myPool[id] = pTemp;
     XMLParticleParser pread(*pTemp,TileMatrix);
     bool success = pread.put(cur);
@@ -68,7 +68,7 @@ namespace qmcplusplus
 {
 
 QMCMain::QMCMain(Communicate* c)
-  : QMCDriverFactory(c), QMCAppBase(), FirstQMC(true)
+  : QMCDriverFactory(c), QMCAppBase(), FirstQMC(true), FirstStepTimer(0)
 #if !defined(REMOVE_TRACEMANAGER)
   , traces_xml(NULL)
 #endif
@@ -187,6 +187,9 @@ bool QMCMain::execute()
   NewTimer *t2 = TimerManager.createTimer("Total", timer_level_coarse);
   t2->start();
 
+  FirstStepTimer = TimerManager.createTimer("TimeToFirstStep", timer_level_coarse);
+  FirstStepTimer->start();
+
   NewTimer *t3 = TimerManager.createTimer("Startup", timer_level_coarse);
   t3->start();
 
@@ -250,6 +253,12 @@ bool QMCMain::execute()
     }
   }
   m_qmcaction.clear();
+  if(FirstStepTimer)
+  {
+    //no QMC section was run
+    FirstStepTimer->stop();
+    FirstStepTimer=0;
+  }
   t2->stop();
   app_log() << "  Total Execution time = " << std::setprecision(4) << t1.elapsed() << " secs" << std::endl;
   if(is_manager())
@@ -621,6 +630,11 @@ bool QMCMain::runQMC(xmlNodePtr cur)
     qmcDriver->putTraces(traces_xml);
 #endif
     qmcDriver->process(cur);
+    if(FirstStepTimer)
+    {
+      FirstStepTimer->stop();
+      FirstStepTimer=0;
+    }
     OhmmsInfo::flush();
     Timer qmcTimer;
     NewTimer *t1 = TimerManager.createTimer(qmcDriver->getEngineName(), timer_level_coarse);
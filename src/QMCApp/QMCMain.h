@@ -24,6 +24,7 @@
 
 #include "QMCApp/QMCDriverFactory.h"
 #include "QMCApp/QMCAppBase.h"
+#include "Utilities/NewTimer.h"
 
 namespace qmcplusplus
 {
@@ -54,6 +55,9 @@ private:
   ///flag to indicate that a qmc is the first QMC
   bool FirstQMC;
 
+  ///timer from the start of execute to the run of the first QMC section
+  NewTimer* FirstStepTimer;
+
   ///previous configuration file for next qmc node
   std::string PrevConfigFile;
 
@@ -97,6 +97,22 @@ int main(int argc, char **argv)
           }
         }
       }
+      // -timer-timeline=first,last records the timers of the steps [first,last)
+      if (c.find("-timer-timeline") < c.size())
+      {
+        int first = 0, last = 10;
+        int pos = c.find("=");
+        if (pos != std::string::npos)
+        {
+          if (sscanf(c.substr(pos+1).c_str(), "%d,%d", &first, &last) != 2 || last <= first)
+          {
+            std::cerr << "Invalid timer timeline window: " << c.substr(pos+1) << ", expected first,last" << std::endl;
+            first = 0;
+            last = 10;
+          }
+        }
+        TimerManager.set_timeline_window(first, last);
+      }
     }
     else
     {
@@ -187,6 +203,7 @@ int main(int argc, char **argv)
     timingDoc.dump(qmc->getTitle() + ".info.xml");
   }
   TimerManager.print(qmcComm);
+  TimerManager.write_timeline(qmcComm, qmc->getTitle());
 
   if(qmc)
     delete qmc;
@@ -51,7 +51,7 @@ std::vector<std::vector<TrialWaveFunction*> > CloneManager::PsiPoolClones;
 std::vector<std::vector<QMCHamiltonian*> > CloneManager::HPoolClones;
 
 /// Constructor.
-CloneManager::CloneManager(HamiltonianPool& hpool): cloneEngine(hpool)
+CloneManager::CloneManager(HamiltonianPool& hpool): cloneEngine(hpool), ChunksPerThread(0), CrowdSize(1)
 {
   NumThreads=omp_get_max_threads();
   wPerNode.resize(NumThreads+1,0);
@@ -70,6 +70,13 @@ CloneManager::~CloneManager()
 #endif
 }
 
+void CloneManager::reportIdle()
+{
+  app_log() << "  Idle fraction of " << NumThreads << " threads per parallel region ("
+            << (wChunks.enabled()?"dynamic":"static") << " partition)  mean = "
+            << wChunks.meanIdle() << "  max = " << wChunks.maxIdle() << std::endl;
+}
+
 void CloneManager::makeClones(MCWalkerConfiguration& w,
                               TrialWaveFunction& psi, QMCHamiltonian& ham)
 {
@@ -23,6 +23,7 @@
 #define QMCPLUSPLUS_CLONEMANAGER_H
 #include "QMCDrivers/QMCUpdateBase.h"
 #include "CorrelatedSampling/CSUpdateBase.h"
+#include "QMCDrivers/WalkerChunks.h"
 // #include "QMCDrivers/EE/QMCRenyiUpdateBase.h"
 
 namespace qmcplusplus
@@ -98,6 +99,14 @@ protected:
   
   ///Walkers per node
   std::vector<int> wPerNode;
+  ///number of walker chunks per thread, 0 to divide the walkers statically
+  int ChunksPerThread;
+  ///scheduler of the walker chunks over the threads
+  WalkerChunks wChunks;
+  ///number of walkers moved together by a mover, 1 to move one walker at a time
+  int CrowdSize;
+  ///report the idle fraction of the threads
+  void reportIdle();
 };
 }
 #endif
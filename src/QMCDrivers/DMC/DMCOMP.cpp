@@ -27,6 +27,7 @@
 #include "Message/Communicate.h"
 #include "Message/OpenMP.h"
 #include "Utilities/Timer.h"
+#include "Utilities/NewTimer.h"
 #include "OhmmsApp/RandomNumberControl.h"
 #include "Utilities/ProgressReportEngine.h"
 #include <qmc_common.h>
@@ -58,6 +59,8 @@ DMCOMP::DMCOMP(MCWalkerConfiguration& w, TrialWaveFunction& psi, QMCHamiltonian&
   m_param.add(NonLocalMove,"nonlocalmoves","string");
   m_param.add(mover_MaxAge,"MaxAge","double");
   m_param.add(UseFastGrad,"fastgrad", "string");
+  m_param.add(ChunksPerThread,"chunks_per_thread","int");
+  m_param.add(CrowdSize,"crowd_size","int");
   //DMC overwrites ConstPopulation
   ConstPopulation=false;
 }
@@ -146,6 +149,10 @@ void DMCOMP::resetUpdateEngines()
     estimatorClones.resize(NumThreads,0);
     traceClones.resize(NumThreads,0);
     FairDivideLow(W.getActiveWalkers(),NumThreads,wPerNode);
+    bool use_crowds=CrowdSize>1 && QMCDriverMode[QMC_UPDATE_MODE] && UseFastGrad == "yes" && !W.Collectables.size();
+#if !defined(REMOVE_TRACEMANAGER)
+    use_crowds = use_crowds && !Traces->streaming_traces;
+#endif
     {
       //log file
       std::ostringstream o;
@@ -164,6 +171,10 @@ void DMCOMP::resetUpdateEngines()
         o << "\n  Walkers are killed when a node crossing is detected";
       else
         o << "\n  DMC moves are rejected when a node crossing is detected";
+      if(use_crowds)
+        o << "\n  Crowds of " << CrowdSize << " walkers are moved together";
+      else if(CrowdSize>1)
+        o << "\n  crowd_size is ignored, it requires the fast gradient, particle-by-particle moves, no collectables and no traces";
       app_log() << o.str() << std::endl;
     }
 #if !defined(BGP_BUG)
@@ -181,7 +192,9 @@ void DMCOMP::resetUpdateEngines()
       branchClones[ip] = new BranchEngineType(*branchEngine);
       if(QMCDriverMode[QMC_UPDATE_MODE])
       {
-        if(UseFastGrad == "yes")
+        if(use_crowds)
+          Movers[ip] = new DMCUpdatePbyPCrowd(*wClones[ip],*psiClones[ip],*hClones[ip],*Rng[ip],CrowdSize);
+        else if(UseFastGrad == "yes")
           Movers[ip] = new DMCUpdatePbyPWithRejectionFast(*wClones[ip],*psiClones[ip],*hClones[ip],*Rng[ip]);
         else
           Movers[ip] = new DMCUpdatePbyPWithRejection(*wClones[ip],*psiClones[ip],*hClones[ip],*Rng[ip]);
@@ -262,11 +275,12 @@ bool DMCOMP::run()
 #if !defined(REMOVE_TRACEMANAGER)
   Traces->startRun(nBlocks,traceClones);
 #endif
+  //collectables are reset once per step and cannot be shared by the chunks
+  wChunks.setup(Rng,W.Collectables.size()?0:ChunksPerThread);
+  wChunks.resetIdle();
   Timer myclock;
   IndexType block = 0;
   IndexType updatePeriod=(QMCDriverMode[QMC_UPDATE_MODE])?Period4CheckProperties:(nBlocks+1)*nSteps;
-  int sample = 0;
-
   prof.push("dmc_loop");
   do // block
   {
@@ -277,6 +291,7 @@ bool DMCOMP::run()
     IndexType step = 0;
     for(IndexType step=0; step< nSteps; ++step, CurrentStep+=BranchInterval)
     {
+      TimerManager.advance_timeline();
       prof.push("dmc_advance");
 
       //         if(storeConfigs && (CurrentStep%storeConfigs == 0)) {
@@ -284,24 +299,24 @@ bool DMCOMP::run()
       //           W.resetWalkerParents();
       //         }
      
+      wChunks.partition(W.getActiveWalkers());
+      wChunks.startRegion();
       #pragma omp parallel
       {
         int ip=omp_get_thread_num();
-        int now=CurrentStep;
-        Movers[ip]->set_step(sample);
-        MCWalkerConfiguration::iterator
-        wit(W.begin()+wPerNode[ip]), wit_end(W.begin()+wPerNode[ip+1]);
-        for(int interval = 0; interval<BranchInterval-1; ++interval,++now)
-          Movers[ip]->advanceWalkers(wit,wit_end,false);
-        wClones[ip]->resetCollectables();
-        Movers[ip]->advanceWalkers(wit,wit_end,false);
-        Movers[ip]->setMultiplicity(wit,wit_end);
-        if(QMCDriverMode[QMC_UPDATE_MODE] && now%updatePeriod == 0)
-          Movers[ip]->updateWalkers(wit, wit_end);
-        // recompute the accuracy critical part of Psi at the end of the last step.
-        if ( step+1 == nSteps && nBlocksBetweenRecompute && (1+block)%nBlocksBetweenRecompute == 0 && QMCDriverMode[QMC_UPDATE_MODE] )
-          Movers[ip]->recomputePsi(wit,wit_end);
+        if(wChunks.enabled())
+        {
+          for(int ic=wChunks.next(ip); ic>=0; ic=wChunks.next(ip))
+          {
+            advanceWalkers(ip,W.begin()+wChunks.first(ic),W.begin()+wChunks.last(ic),step,block,updatePeriod);
+            wChunks.release(ip,ic);
+          }
+        }
+        else
+          advanceWalkers(ip,W.begin()+wPerNode[ip],W.begin()+wPerNode[ip+1],step,block,updatePeriod);
+        wChunks.stopThread(ip);
       }
+      wChunks.stopRegion();
 
       prof.pop(); //close dmc_advance
 
@@ -320,7 +335,6 @@ bool DMCOMP::run()
       //         }
       if(variablePop)
         FairDivideLow(W.getActiveWalkers(),NumThreads,wPerNode);
-      sample++;
       prof.pop(); //close dmc_branch
     }
 //       branchEngine->debugFWconfig();
@@ -331,6 +345,7 @@ bool DMCOMP::run()
     block++;
     if(DumpConfig &&block%Period4CheckPoint == 0)
     {
+      wChunks.finalize();
       for(int ip=0; ip<NumThreads; ip++)
         *(RandomNumberControl::Children[ip])=*(Rng[ip]);
     }
@@ -340,6 +355,8 @@ bool DMCOMP::run()
   prof.pop(); //close loop
 
   //for(int ip=0; ip<NumThreads; ip++) Movers[ip]->stopRun();
+  wChunks.finalize();
+  reportIdle();
   for(int ip=0; ip<NumThreads; ip++)
     *(RandomNumberControl::Children[ip])=*(Rng[ip]);
   Estimators->stop();
@@ -351,6 +368,26 @@ bool DMCOMP::run()
   return finalize(nBlocks);
 }
 
+void DMCOMP::advanceWalkers(int ip, MCWalkerConfiguration::iterator wit, MCWalkerConfiguration::iterator wit_end,
+                            IndexType step, IndexType block, IndexType updatePeriod)
+{
+  // every sub-step between the branches draws from its own walker streams
+  int now=CurrentStep;
+  for(int interval = 0; interval<BranchInterval-1; ++interval,++now)
+  {
+    Movers[ip]->set_step(now);
+    Movers[ip]->advanceWalkers(wit,wit_end,false);
+  }
+  wClones[ip]->resetCollectables();
+  Movers[ip]->set_step(now);
+  Movers[ip]->advanceWalkers(wit,wit_end,false);
+  Movers[ip]->setMultiplicity(wit,wit_end);
+  if(QMCDriverMode[QMC_UPDATE_MODE] && now%updatePeriod == 0)
+    Movers[ip]->updateWalkers(wit, wit_end);
+  // recompute the accuracy critical part of Psi at the end of the last step.
+  if ( step+1 == nSteps && nBlocksBetweenRecompute && (1+block)%nBlocksBetweenRecompute == 0 && QMCDriverMode[QMC_UPDATE_MODE] )
+    Movers[ip]->recomputePsi(wit,wit_end);
+}
 
 void DMCOMP::benchMark()
 {
@@ -68,6 +68,9 @@ private:
 
   void resetUpdateEngines();
   void benchMark();
+  ///advance the walkers [wit,wit_end) by a branch interval on the thread ip
+  void advanceWalkers(int ip, MCWalkerConfiguration::iterator wit, MCWalkerConfiguration::iterator wit_end,
+                      IndexType step, IndexType block, IndexType updatePeriod);
   /// Copy Constructor (disabled)
   DMCOMP(const DMCOMP& a): QMCDriver(a), CloneManager(a) { }
   /// Copy operator (disabled).
@@ -51,6 +51,7 @@ void DMCUpdateAllWithRejection::advanceWalkers(WalkerIter_t it, WalkerIter_t it_
   for(; it != it_end; ++it)
   {
     Walker_t& thisWalker(**it);
+    setWalkerStream(thisWalker);
     W.loadWalker(thisWalker,false);
     //create a 3N-Dimensional Gaussian with variance=1
     RealType nodecorr=setScaledDriftPbyPandNodeCorr(Tau,MassInvP,W.G,drift);
@@ -165,6 +166,7 @@ void DMCUpdateAllWithKill::advanceWalkers(WalkerIter_t it, WalkerIter_t it_end,
   for(; it != it_end; ++it)
   {
     Walker_t& thisWalker(**it);
+    setWalkerStream(thisWalker);
     W.loadWalker(thisWalker,false);
     //RealType nodecorr = setScaledDriftPbyPandNodeCorr(m_tauovermass,W.G,drift);
     RealType nodecorr=setScaledDriftPbyPandNodeCorr(Tau,MassInvP,W.G,drift);
@@ -58,6 +58,7 @@ void DMCUpdatePbyPWithRejection::advanceWalkers(WalkerIter_t it, WalkerIter_t it
   {
     //MCWalkerConfiguration::WalkerData_t& w_buffer = *(W.DataSet[iwalker]);
     Walker_t& thisWalker(**it);
+    setWalkerStream(thisWalker);
     Walker_t::Buffer_t& w_buffer(thisWalker.DataSet);
     W.loadWalker(thisWalker,true);
     //W.R = thisWalker.R;
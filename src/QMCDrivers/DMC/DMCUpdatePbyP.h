@@ -17,6 +17,7 @@
 #ifndef QMCPLUSPLUS_DMC_UPDATE_PARTICLEBYPARTCLE_H
 #define QMCPLUSPLUS_DMC_UPDATE_PARTICLEBYPARTCLE_H
 #include "QMCDrivers/QMCUpdateBase.h"
+#include "QMCDrivers/WalkerCrowd.h"
 namespace qmcplusplus
 {
 
@@ -55,6 +56,31 @@ private:
 };
 
 
+/** DMCUpdatePbyPWithRejectionFast moving the particles of a crowd of walkers in lockstep
+ *
+ * Each particle of crowd_size walkers is moved before the next one and the
+ * ratios are evaluated by TrialWaveFunction::mw_ratioGrad for the crowd.
+ */
+class DMCUpdatePbyPCrowd: public QMCUpdateBase
+{
+
+public:
+
+  /// Constructor.
+  DMCUpdatePbyPCrowd(MCWalkerConfiguration& w, TrialWaveFunction& psi,
+                     QMCHamiltonian& h, RandomGenerator_t& rg, int crowd_size);
+  ///destructor
+  ~DMCUpdatePbyPCrowd();
+
+  void advanceWalkers(WalkerIter_t it, WalkerIter_t it_end, bool measure);
+
+private:
+  ///copies of W, Psi and H for the walkers of a crowd
+  WalkerCrowd Crowd;
+  std::vector<NewTimer*> myTimers;
+};
+
+
 class DMCUpdatePbyPWithKill: public QMCUpdateBase
 {
 
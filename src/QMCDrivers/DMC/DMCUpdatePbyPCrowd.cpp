@@ -0,0 +1,209 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "QMCDrivers/DMC/DMCUpdatePbyP.h"
+#include "QMCDrivers/DriftOperators.h"
+
+namespace qmcplusplus
+{
+
+/// Constructor.
+DMCUpdatePbyPCrowd::DMCUpdatePbyPCrowd(MCWalkerConfiguration& w,
+                                       TrialWaveFunction& psi, QMCHamiltonian& h, RandomGenerator_t& rg, int crowd_size):
+  QMCUpdateBase(w,psi,h,rg), Crowd(w,psi,h,crowd_size)
+{
+  myTimers.push_back(new NewTimer("DMCUpdatePbyPCrowd::advance")); //timer for the walker loop
+  myTimers.push_back(new NewTimer("DMCUpdatePbyPCrowd::movePbyP")); //timer for MC, ratio etc
+  myTimers.push_back(new NewTimer("DMCUpdatePbyPCrowd::updateMBO")); //timer for measurements
+  myTimers.push_back(new NewTimer("DMCUpdatePbyPCrowd::energy")); //timer for measurements
+  for (int i=0; i<myTimers.size(); ++i)
+    TimerManager.addTimer(myTimers[i]);
+}
+
+/// destructor
+DMCUpdatePbyPCrowd::~DMCUpdatePbyPCrowd() { }
+
+/** advance the walkers crowd by crowd with killnode==no
+ *
+ * The moves, the branching weights and the T-moves are the same as
+ * DMCUpdatePbyPWithRejectionFast. The random numbers of a walker are drawn
+ * from its stream before the particles of the crowd are moved. The hamiltonian
+ * of a walker draws from its stream where the moves left it.
+ */
+void DMCUpdatePbyPCrowd::advanceWalkers(WalkerIter_t it, WalkerIter_t it_end, bool measure)
+{
+  myTimers[0]->start();
+  const int nat=W.getTotalNum();
+  const int ncrowd=Crowd.size();
+  std::vector<int> nAcceptTemp(ncrowd), nRejectTemp(ncrowd);
+  std::vector<RealType> rr_proposed(ncrowd), rr_accepted(ncrowd);
+  while(it != it_end)
+  {
+    const int nw=std::min(static_cast<int>(it_end-it),ncrowd);
+    for (int k=0; k<nw; ++k)
+    {
+      Walker_t& thisWalker(**(it+k));
+      setWalkerStream(thisWalker);
+      //nat for the moves and one for the T-move
+      Crowd.drawRandom(k,RandomGen,nat,nat+1);
+      Crowd.loadWalker(k,thisWalker,W.current_step);
+      nAcceptTemp[k]=0;
+      nRejectTemp[k]=0;
+      rr_proposed[k]=0.0;
+      rr_accepted[k]=0.0;
+    }
+    myTimers[1]->start();
+    for(int ig=0; ig<W.groups(); ++ig) //loop over species
+    {
+      RealType tauovermass = Tau*MassInvS[ig];
+      RealType oneover2tau = 0.5/(tauovermass);
+      RealType sqrttau = std::sqrt(tauovermass);
+      for (int iat=W.first(ig); iat<W.last(ig); ++iat)
+      {
+        //propose the moves of iat of the crowd
+        Crowd.clearMoves();
+        for (int k=0; k<nw; ++k)
+        {
+          const PosType& delta(Crowd.deltaR_list[k][iat]);
+          GradType grad_iat=Crowd.Psi_list[k]->evalGrad(*Crowd.W_list[k],iat);
+          mPosType dr;
+          getScaledDrift(tauovermass, grad_iat, dr);
+          dr += sqrttau * delta;
+          RealType rr=tauovermass*dot(delta,delta);
+          rr_proposed[k]+=rr;
+          if(rr>m_r2max)
+          {
+            ++nRejectTemp[k];
+            continue;
+          }
+          Crowd.propose(k,dr);
+        }
+        Crowd.makeMoves(iat);
+        Crowd.ratioGrad(iat);
+        for (int i=0; i<Crowd.Active.size(); ++i)
+        {
+          const int k=Crowd.Active[i];
+          Walker_t& thisWalker(**(it+k));
+          MCWalkerConfiguration& w_k(*Crowd.W_list[k]);
+          TrialWaveFunction& psi_k(*Crowd.Psi_list[k]);
+          //node is crossed reject the move
+          if (branchEngine->phaseChanged(psi_k.getPhaseDiff()))
+          {
+            ++nRejectTemp[k];
+            ++nNodeCrossing;
+            w_k.rejectMove(iat);
+            psi_k.rejectMove(iat);
+          }
+          else
+          {
+            const PosType& delta(Crowd.deltaR_list[k][iat]);
+            EstimatorRealType logGf = -0.5*dot(delta,delta);
+            mPosType dr;
+            getScaledDrift(tauovermass, Crowd.Grads[i], dr);
+            dr = thisWalker.R[iat] - w_k.R[iat] - dr;
+            EstimatorRealType logGb = -oneover2tau*dot(dr,dr);
+            RealType prob = Crowd.Ratios[i]*Crowd.Ratios[i]*std::exp(logGb-logGf);
+            if(Crowd.Uniform_list[k][iat] < prob)
+            {
+              ++nAcceptTemp[k];
+              Crowd.accept(k);
+              rr_accepted[k]+=tauovermass*dot(delta,delta);
+            }
+            else
+            {
+              ++nRejectTemp[k];
+              w_k.rejectMove(iat);
+              psi_k.rejectMove(iat);
+            }
+          }
+        }
+        Crowd.acceptMoves(iat);
+      }
+    }
+    myTimers[1]->stop();
+    for (int k=0; k<nw; ++k)
+    {
+      Walker_t& thisWalker(**(it+k));
+      Walker_t::Buffer_t& w_buffer(thisWalker.DataSet);
+      MCWalkerConfiguration& w_k(*Crowd.W_list[k]);
+      TrialWaveFunction& psi_k(*Crowd.Psi_list[k]);
+      QMCHamiltonian& h_k(*Crowd.H_list[k]);
+      EstimatorRealType eold(thisWalker.Properties(LOCALENERGY));
+      EstimatorRealType enew(eold);
+      if(UseTMove)
+        nonLocalOps.reset();
+      if(nAcceptTemp[k]>0)
+      {
+        //need to overwrite the walker properties
+        myTimers[2]->start();
+        thisWalker.Age=0;
+        thisWalker.R = w_k.R;
+        RealType logpsi = psi_k.updateBuffer(w_k,w_buffer,false);
+        w_k.saveWalker(thisWalker);
+        myTimers[2]->stop();
+        myTimers[3]->start();
+        Crowd.resumeStream(k,RandomGen);
+        if(UseTMove)
+          enew= h_k.evaluate(w_k,nonLocalOps.Txy);
+        else
+          enew= h_k.evaluate(w_k);
+        myTimers[3]->stop();
+        thisWalker.resetProperty(logpsi,psi_k.getPhase(),enew,rr_accepted[k],rr_proposed[k],1.0 );
+        thisWalker.Weight *= branchEngine->branchWeight(enew,eold);
+        h_k.auxHevaluate(w_k,thisWalker);
+        h_k.saveProperty(thisWalker.getPropertyBase());
+      }
+      else
+      {
+        //all moves are rejected: does not happen normally with reasonable wavefunctions
+        thisWalker.Age++;
+        thisWalker.Properties(R2ACCEPTED)=0.0;
+        //weight is set to 0 consistent w/ no evaluate/auxHevaluate
+        RealType wtmp = thisWalker.Weight;
+        thisWalker.Weight = 0.0;
+        h_k.rejectedMove(w_k,thisWalker);
+        thisWalker.Weight = wtmp;
+        ++nAllRejected;
+        enew=eold;//copy back old energy
+        thisWalker.Weight *= branchEngine->branchWeight(enew,eold);
+      }
+      if(UseTMove)
+      {
+        int ibar = nonLocalOps.selectMove(Crowd.Uniform_list[k][nat]);
+        //make a non-local move
+        if(ibar)
+        {
+          int iat=nonLocalOps.id(ibar);
+          if(w_k.makeMoveAndCheck(iat,nonLocalOps.delta(ibar)))
+          {
+            myTimers[2]->start();
+            psi_k.ratio(w_k,iat,dG,dL);
+            w_k.acceptMove(iat);
+            psi_k.acceptMove(w_k,iat);
+            w_k.G += dG;
+            w_k.L += dL;
+            psi_k.evaluateLog(w_k,w_buffer);
+            w_k.saveWalker(thisWalker);
+            ++NonLocalMoveAccepted;
+            myTimers[2]->stop();
+          }
+        }
+      }
+      nAccept += nAcceptTemp[k];
+      nReject += nRejectTemp[k];
+    }
+    it += nw;
+  }
+  myTimers[0]->stop();
+}
+
+}
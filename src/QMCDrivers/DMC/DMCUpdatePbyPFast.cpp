@@ -65,6 +65,7 @@ void DMCUpdatePbyPWithRejectionFast::advanceWalkers(WalkerIter_t it, WalkerIter_
   {
     //MCWalkerConfiguration::WalkerData_t& w_buffer = *(W.DataSet[iwalker]);
     Walker_t& thisWalker(**it);
+    setWalkerStream(thisWalker);
     Walker_t::Buffer_t& w_buffer(thisWalker.DataSet);
     W.loadWalker(thisWalker,true);
     //W.R = thisWalker.R;
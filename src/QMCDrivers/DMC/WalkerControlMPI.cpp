@@ -64,6 +64,11 @@ WalkerControlMPI::WalkerControlMPI(Communicate* c): WalkerControlBase(c)
   TimerManager.addTimer(myTimers[2]);
 }
 
+WalkerControlMPI::~WalkerControlMPI()
+{
+  completeSends();
+}
+
 int
 WalkerControlMPI::branch(int iter, MCWalkerConfiguration& W, RealType trigger)
 {
@@ -102,7 +107,7 @@ WalkerControlMPI::branch(int iter, MCWalkerConfiguration& W, RealType trigger)
   myTimers[1]->stop();
   myTimers[2]->start();
   if(qmc_common.async_swap)
-    swapWalkersAsync(W);
+    swapWalkersNonblocking(W);
   else
     swapWalkersSimple(W);
   myTimers[2]->stop();
@@ -220,6 +225,102 @@ void WalkerControlMPI::swapWalkersSimple(MCWalkerConfiguration& W)
     W.insert(W.end(),newW.begin(),newW.end());
 }
 
+void WalkerControlMPI::completeSends()
+{
+  if(SendRequests.size())
+  {
+    std::vector<MPI_Status> status(SendRequests.size());
+    MPI_Waitall(SendRequests.size(),&SendRequests[0],&status[0]);
+    SendRequests.clear();
+  }
+}
+
+void WalkerControlMPI::swapWalkersNonblocking(MCWalkerConfiguration& W)
+{
+  //the send buffers of the previous exchange are reused
+  completeSends();
+  FairDivideLow(Cur_pop,NumContexts,FairOffSet);
+  std::vector<int> minus, plus;
+  for(int ip=0; ip<NumContexts; ip++)
+  {
+    int dn=NumPerNode[ip]-(FairOffSet[ip+1]-FairOffSet[ip]);
+    if(dn>0)
+      plus.insert(plus.end(),dn,ip);
+    else
+      if(dn<0)
+        minus.insert(minus.end(),-dn,ip);
+  }
+  //number of walkers to send to and to receive from each rank
+  std::vector<int> nsendTo(NumContexts,0), nrecvFrom(NumContexts,0);
+  int nswap=std::min(plus.size(), minus.size());
+  for(int ic=0; ic<nswap; ic++)
+  {
+    if(plus[ic]==MyContext)
+      nsendTo[minus[ic]]++;
+    if(minus[ic]==MyContext)
+      nrecvFrom[plus[ic]]++;
+  }
+  if(SendSlabs.size()!=NumContexts)
+  {
+    SendSlabs.resize(NumContexts);
+    RecvSlabs.resize(NumContexts);
+  }
+  Walker_t& wRef(*W[0]);
+  const int wsize=wRef.byteSize();
+  std::vector<Communicate::request> recvRequests;
+  std::vector<int> recvFrom;
+  for(int ip=0; ip<NumContexts; ++ip)
+  {
+    if(nrecvFrom[ip]==0)
+      continue;
+    const int nbytes=nrecvFrom[ip]*wsize;
+    if(RecvSlabs[ip].size()<nbytes)
+      RecvSlabs[ip].resize(nbytes);
+    recvRequests.push_back(Communicate::request());
+    recvFrom.push_back(ip);
+    MPI_Irecv(&RecvSlabs[ip][0],nbytes,MPI_CHAR,ip,ip,myComm->getMPI(),&recvRequests.back());
+  }
+  int last=W.getActiveWalkers()-1;
+  int nsend=0;
+  for(int ip=0; ip<NumContexts; ++ip)
+  {
+    if(nsendTo[ip]==0)
+      continue;
+    const int nbytes=nsendTo[ip]*wsize;
+    if(SendSlabs[ip].size()<nbytes)
+      SendSlabs[ip].resize(nbytes);
+    //each walker, including its DataSet, is copied into the slab
+    WalkerByteStream sendStream(&SendSlabs[ip][0]);
+    for(int iw=0; iw<nsendTo[ip]; ++iw, --last)
+      W[last]->putMessage(sendStream);
+    SendRequests.push_back(Communicate::request());
+    MPI_Isend(&SendSlabs[ip][0],nbytes,MPI_CHAR,ip,MyContext,myComm->getMPI(),&SendRequests.back());
+    nsend+=nsendTo[ip];
+  }
+  //the walkers are in the send buffers, remove them before the new ones arrive
+  NumWalkersSent=nsend;
+  if(nsend)
+    W.destroyWalkers(W.begin()+NumPerNode[MyContext]-nsend, W.end());
+  //unpack the walkers in the order of arrival
+  std::vector<Walker_t*> newW;
+  for(int ir=0; ir<recvRequests.size(); ++ir)
+  {
+    int idx;
+    MPI_Status status;
+    MPI_Waitany(recvRequests.size(),&recvRequests[0],&idx,&status);
+    const int ip=recvFrom[idx];
+    WalkerByteStream recvStream(&RecvSlabs[ip][0]);
+    for(int iw=0; iw<nrecvFrom[ip]; ++iw)
+    {
+      Walker_t *awalker= new Walker_t(wRef);
+      awalker->getMessage(recvStream);
+      newW.push_back(awalker);
+    }
+  }
+  if(newW.size())
+    W.insert(W.end(),newW.begin(),newW.end());
+}
+
 /** swap Walkers with Irecv/Send
  *
  * The algorithm ensures that the load per node can differ only by one walker.
@@ -18,6 +18,7 @@
 #define QMCPLUSPLUS_WALKER_CONTROL_MPI_H
 
 #include "QMCDrivers/WalkerControlBase.h"
+#include <cstring>
 
 
 namespace qmcplusplus
@@ -25,6 +26,59 @@ namespace qmcplusplus
 
 class NewTimer;
 
+/** serialize walkers into a raw byte buffer
+ *
+ * Provides the operators Walker::putMessage and Walker::getMessage use on
+ * OOMPI_Packed. The data are copied with memcpy at the cursor, so that a
+ * walker is written to or read from a persistent buffer without MPI_Pack.
+ */
+struct WalkerByteStream
+{
+  char* cursor;
+
+  explicit WalkerByteStream(char* first): cursor(first) {}
+
+  template<typename T>
+  inline void Pack(const T* x, int n)
+  {
+    std::memcpy(cursor,x,n*sizeof(T));
+    cursor+=n*sizeof(T);
+  }
+
+  template<typename T>
+  inline void Unpack(T* x, int n)
+  {
+    std::memcpy(x,cursor,n*sizeof(T));
+    cursor+=n*sizeof(T);
+  }
+
+  template<typename T>
+  inline void Pack(const T& x)
+  {
+    Pack(&x,1);
+  }
+
+  template<typename T>
+  inline void Unpack(T& x)
+  {
+    Unpack(&x,1);
+  }
+
+  template<typename T>
+  inline WalkerByteStream& operator<<(const T& x)
+  {
+    Pack(&x,1);
+    return *this;
+  }
+
+  template<typename T>
+  inline WalkerByteStream& operator>>(T& x)
+  {
+    Unpack(&x,1);
+    return *this;
+  }
+};
+
 /** Class to handle walker controls with simple global sum
  *
  * Base class to handle serial mode with branching only
@@ -35,17 +89,36 @@ struct WalkerControlMPI: public WalkerControlBase
   int Cur_max;
   int Cur_min;
   std::vector<NewTimer*> myTimers;
+  ///persistent send buffer for each rank, grown but never shrunk
+  std::vector<std::vector<char> > SendSlabs;
+  ///persistent receive buffer for each rank, grown but never shrunk
+  std::vector<std::vector<char> > RecvSlabs;
+  ///sends of the last swapWalkersNonblocking, completed by the next exchange
+  std::vector<Communicate::request> SendRequests;
   /** default constructor
    *
    * Set the SwapMode to zero so that instantiation can be done
    */
   WalkerControlMPI(Communicate* c=0);
 
+  ~WalkerControlMPI();
+
   /** perform branch and swap walkers as required */
   int branch(int iter, MCWalkerConfiguration& W, RealType trigger);
 
   void swapWalkersSimple(MCWalkerConfiguration& W);
 
+  /** swap walkers with Irecv/Isend on the persistent buffers
+   *
+   * Same pairing as swapWalkersSimple. The walkers to the same rank are
+   * written back to back in SendSlabs and go in one message. The sends are
+   * left in flight and overlap with the next advance of the local walkers.
+   */
+  void swapWalkersNonblocking(MCWalkerConfiguration& W);
+
+  ///wait for the sends posted by the last swapWalkersNonblocking
+  void completeSends();
+
   //old implementations
   void swapWalkersAsync(MCWalkerConfiguration& W);
   void swapWalkersBlocked(MCWalkerConfiguration& W);
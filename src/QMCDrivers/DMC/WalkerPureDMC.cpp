@@ -114,7 +114,7 @@ int WalkerPureDMC::getIndexPermutation(MCWalkerConfiguration& W)
     int im=minus[i],ip=plus[i];
     W[im]->makeCopy(*(W[ip]));
     W[im]->ParentID=W[ip]->ID;
-    W[im]->ID=(++NumWalkersCreated)*NumContexts+MyContext;
+    W[im]->ID=W.newWalkerID(NumContexts,MyContext);
   }
   //int killed = shuffleIndex(nw);
   //fout << "# Total weight " << wtot << " " << killed <<  std::endl;
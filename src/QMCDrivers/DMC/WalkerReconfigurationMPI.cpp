@@ -175,7 +175,7 @@ int WalkerReconfigurationMPI::swapWalkers(MCWalkerConfiguration& W)
     int ip=plus[lower]; //walker index to be duplicated
     W[im]->makeCopy(*(W[ip])); //copy the walker
     W[im]->ParentID=W[ip]->ID;
-    W[im]->ID=(++NumWalkersCreated)*NumContexts+MyContext;
+    W[im]->ID=W.newWalkerID(NumContexts,MyContext);
     minus.pop_back();//remove it
     plus.pop_back();//remove it
   }
@@ -280,7 +280,7 @@ void WalkerReconfigurationMPI::recvWalkers(MCWalkerConfiguration& W,
       int im=minus[last];
       W[im]->getMessage(recvBuffer);
       W[im]->ParentID=W[im]->ID;
-      W[im]->ID=(++NumWalkersCreated)*NumContexts+MyContext;
+      W[im]->ID=W.newWalkerID(NumContexts,MyContext);
       --last;
     }
     ++ic;
@@ -0,0 +1,201 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "QMCDrivers/LinearMethodDavidson.h"
+#include "Numerics/OhmmsBlas.h"
+#include <cmath>
+#include <limits>
+
+namespace qmcplusplus
+{
+
+LinearMethodDavidson::LinearMethodDavidson()
+  : MaxIterations(100), MaxSubspace(32), Tolerance(1.0e-6), NumIterations(0), ResidualNorm(0)
+{ }
+
+bool LinearMethodDavidson::addVector(int k, std::vector<RealType>& t)
+{
+  const int n=t.size();
+  RealType norm0=std::sqrt(BLAS::dot(n,&t[0],&t[0]));
+  if(norm0==0.0)
+    return false;
+  //twice is enough
+  for(int pass=0; pass<2; ++pass)
+    for(int i=0; i<k; ++i)
+    {
+      RealType p=BLAS::dot(n,V[i],&t[0]);
+      for(int j=0; j<n; ++j)
+        t[j]-=p*V[i][j];
+    }
+  RealType norm=std::sqrt(BLAS::dot(n,&t[0],&t[0]));
+  if(norm<1.0e-8*norm0)
+    return false;
+  for(int j=0; j<n; ++j)
+    V(k,j)=t[j]/norm;
+  return true;
+}
+
+LinearMethodDavidson::RealType LinearMethodDavidson::solveProjected(int k, std::vector<RealType>& y)
+{
+  //column major copies, destroyed by ggev
+  std::vector<RealType> A(k*k), B(k*k), VR(k*k);
+  for(int i=0; i<k; ++i)
+    for(int j=0; j<k; ++j)
+    {
+      A[i+j*k]=Hs(i,j);
+      B[i+j*k]=Ss(i,j);
+    }
+  char jl('N');
+  char jr('V');
+  std::vector<RealType> alphar(k),alphai(k),beta(k);
+  int info;
+  int lwork(-1);
+  std::vector<RealType> work(1);
+  RealType tt(0);
+  int t(1);
+  LAPACK::ggev(&jl, &jr, &k, &A[0], &k, &B[0], &k, &alphar[0], &alphai[0], &beta[0], &tt, &t, &VR[0], &k, &work[0], &lwork, &info);
+  lwork=int(work[0]);
+  work.resize(lwork);
+  LAPACK::ggev(&jl, &jr, &k, &A[0], &k, &B[0], &k, &alphar[0], &alphai[0], &beta[0], &tt, &t, &VR[0], &k, &work[0], &lwork, &info);
+  if (info!=0)
+  {
+    APP_ABORT("LinearMethodDavidson::solveProjected Invalid Matrix Diagonalization Function!");
+  }
+  //lowest real eigenvalue, the real part of a complex pair only if there is none
+  int best=-1;
+  bool best_real=false;
+  RealType lowest=std::numeric_limits<RealType>::max();
+  for(int i=0; i<k; ++i)
+  {
+    if(beta[i]==0.0)
+      continue;
+    RealType evi(alphar[i]/beta[i]);
+    bool is_real=(alphai[i]==0.0);
+    if(std::abs(evi)>=1e10 || (best_real && !is_real))
+      continue;
+    if(evi<lowest || (is_real && !best_real))
+    {
+      lowest=evi;
+      best=i;
+      best_real=is_real;
+    }
+  }
+  if(best<0)
+  {
+    APP_ABORT("LinearMethodDavidson::solveProjected no finite eigenvalue");
+  }
+  //the real part of a complex pair is the first of the two columns
+  if(!best_real && alphai[best]<0.0)
+    best--;
+  y.resize(k);
+  RealType norm=0.0;
+  for(int i=0; i<k; ++i)
+  {
+    y[i]=VR[i+best*k];
+    norm+=y[i]*y[i];
+  }
+  norm=1.0/std::sqrt(norm);
+  for(int i=0; i<k; ++i)
+    y[i]*=norm;
+  return lowest;
+}
+
+LinearMethodDavidson::RealType
+LinearMethodDavidson::solve(MatrixProducts& op, const std::vector<RealType>& Ldiag, const std::vector<RealType>& Rdiag,
+                            std::vector<RealType>& ev)
+{
+  const int n=Ldiag.size();
+  const int maxk=std::max(2,std::min(MaxSubspace,n));
+  V.resize(maxk,n);
+  LV.resize(maxk,n);
+  RV.resize(maxk,n);
+  Hs.resize(maxk,maxk);
+  Ss.resize(maxk,maxk);
+  Matrix<RealType> X(1,n), LX(1,n), RX(1,n);
+  std::vector<RealType> t(n,0.0), c(n), Lc(n), Rc(n), y;
+  //start from the current wavefunction
+  t[0]=1.0;
+  addVector(0,t);
+  int k=0;
+  RealType lambda=0.0;
+  NumIterations=0;
+  ResidualNorm=std::numeric_limits<RealType>::max();
+  while(true)
+  {
+    //products with the new vector and the new row and column of the projected matrices
+    std::copy(V[k],V[k]+n,X[0]);
+    op.apply(X,LX,RX);
+    std::copy(LX[0],LX[0]+n,LV[k]);
+    std::copy(RX[0],RX[0]+n,RV[k]);
+    k++;
+    for(int i=0; i<k; ++i)
+    {
+      Hs(i,k-1)=BLAS::dot(n,V[i],LV[k-1]);
+      Ss(i,k-1)=BLAS::dot(n,V[i],RV[k-1]);
+      Hs(k-1,i)=BLAS::dot(n,V[k-1],LV[i]);
+      Ss(k-1,i)=BLAS::dot(n,V[k-1],RV[i]);
+    }
+    lambda=solveProjected(k,y);
+    //Ritz vector and the residual
+    std::fill(c.begin(),c.end(),0.0);
+    std::fill(Lc.begin(),Lc.end(),0.0);
+    std::fill(Rc.begin(),Rc.end(),0.0);
+    for(int i=0; i<k; ++i)
+      for(int j=0; j<n; ++j)
+      {
+        c[j]+=y[i]*V(i,j);
+        Lc[j]+=y[i]*LV(i,j);
+        Rc[j]+=y[i]*RV(i,j);
+      }
+    RealType rnorm=0.0;
+    for(int j=0; j<n; ++j)
+    {
+      t[j]=Lc[j]-lambda*Rc[j];
+      rnorm+=t[j]*t[j];
+    }
+    ResidualNorm=std::sqrt(rnorm);
+    if(ResidualNorm<=Tolerance || NumIterations>=MaxIterations || k==n)
+      break;
+    NumIterations++;
+    //collapse the search space to the Ritz vector
+    if(k==maxk)
+    {
+      std::copy(c.begin(),c.end(),V[0]);
+      std::copy(Lc.begin(),Lc.end(),LV[0]);
+      std::copy(Rc.begin(),Rc.end(),RV[0]);
+      Hs(0,0)=BLAS::dot(n,V[0],LV[0]);
+      Ss(0,0)=BLAS::dot(n,V[0],RV[0]);
+      k=1;
+    }
+    //diagonal preconditioner
+    std::vector<RealType> r(t);
+    for(int j=0; j<n; ++j)
+    {
+      RealType denom=Ldiag[j]-lambda*Rdiag[j];
+      if(std::abs(denom)<1.0e-8)
+        denom=(denom<0.0)?-1.0e-8:1.0e-8;
+      t[j]=-r[j]/denom;
+    }
+    if(!addVector(k,t))
+    {
+      t=r;
+      if(!addVector(k,t))
+        break;
+    }
+  }
+  ev.resize(n);
+  for(int j=0; j<n; ++j)
+    ev[j]=c[j]/c[0];
+  return lambda;
+}
+
+}
@@ -0,0 +1,104 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file LinearMethodDavidson.h
+ * @brief matrix-free Davidson solver for the generalized eigenvalue problem of the linear method
+ */
+#ifndef QMCPLUSPLUS_LINEAR_METHOD_DAVIDSON_H
+#define QMCPLUSPLUS_LINEAR_METHOD_DAVIDSON_H
+
+#include "Configuration.h"
+#include "OhmmsPETE/OhmmsMatrix.h"
+#include <vector>
+
+namespace qmcplusplus
+{
+
+/** Lowest eigenpair of Left c = E Right c without the dense matrices
+ *
+ * Left and Right are only accessed through their products with a block of
+ * vectors, see MatrixProducts. The search space starts from the current
+ * wavefunction (1,0,...,0) and is extended by the residual preconditioned with
+ * the diagonals. The projected problem is solved with LAPACK::ggev and the
+ * lowest real eigenvalue is selected as in QMCLinearOptimize::getLowestEigenvector.
+ * The search space is collapsed to the Ritz vector when it reaches MaxSubspace.
+ */
+class LinearMethodDavidson: public QMCTraits
+{
+public:
+  ///products with the matrices of the linear method
+  struct MatrixProducts
+  {
+    virtual ~MatrixProducts() {}
+    /** compute the products with a block of vectors
+     * @param X the vectors in the rows
+     * @param LX Left times the rows of X
+     * @param RX Right times the rows of X
+     */
+    virtual void apply(const Matrix<RealType>& X, Matrix<RealType>& LX, Matrix<RealType>& RX)=0;
+  };
+
+  ///maximum number of the iterations
+  int MaxIterations;
+  ///maximum dimension of the search space
+  int MaxSubspace;
+  ///tolerance on the norm of the residual
+  RealType Tolerance;
+
+  LinearMethodDavidson();
+
+  /** find the lowest eigenpair
+   * @param op matrix products
+   * @param Ldiag diagonal of Left
+   * @param Rdiag diagonal of Right
+   * @param ev eigenvector normalized to ev[0]=1 on exit
+   * @return the eigenvalue
+   */
+  RealType solve(MatrixProducts& op, const std::vector<RealType>& Ldiag, const std::vector<RealType>& Rdiag,
+                 std::vector<RealType>& ev);
+
+  ///return the number of the iterations of the last solve
+  inline int iterations() const
+  {
+    return NumIterations;
+  }
+  ///return the norm of the final residual of the last solve
+  inline RealType residual() const
+  {
+    return ResidualNorm;
+  }
+  ///return true if the last solve converged
+  inline bool converged() const
+  {
+    return ResidualNorm<=Tolerance;
+  }
+
+private:
+  int NumIterations;
+  RealType ResidualNorm;
+  ///search space, products with Left and Right
+  Matrix<RealType> V, LV, RV;
+  ///projected matrices
+  Matrix<RealType> Hs, Ss;
+
+  /** add a vector to the search space
+   * @param k current dimension
+   * @param t vector, orthogonalized against the search space
+   * @return false if t is in the search space
+   */
+  bool addVector(int k, std::vector<RealType>& t);
+  ///solve the projected problem of dimension k, return the lowest eigenvalue and its eigenvector y
+  RealType solveProjected(int k, std::vector<RealType>& y);
+};
+
+}
+#endif
@@ -0,0 +1,226 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "QMCDrivers/LinearMethodMoments.h"
+#include "Numerics/OhmmsBlas.h"
+#include "Utilities/UtilityFunctions.h"
+#include "Message/CommOperators.h"
+#include <cmath>
+
+namespace qmcplusplus
+{
+
+enum {SUM_D=0, SUM_H, SUM_HE, SUM_DE, SUM_DE2, NUM_SUMS};
+
+LinearMethodMoments::LinearMethodMoments()
+  : NumParams(0), UseVariance(false), Ovl(0), Ham(0), SumW(0), SumE(0), SumE2(0)
+{ }
+
+void LinearMethodMoments::resize(int nparams, int nrows, bool variance)
+{
+  if(nparams!=NumParams)
+    Shift.assign(nparams,0.0);
+  NumParams=nparams;
+  UseVariance=variance;
+  Mvv.resize(variance?nparams:0,variance?nparams:0);
+  Sums.resize(NUM_SUMS,nparams);
+  BatchD.resize(nrows,nparams);
+  BatchWD.resize(nrows,nparams);
+  BatchH.resize(nrows,nparams);
+  BatchV.resize(variance?nrows:0,nparams);
+  BatchW.resize(nrows);
+  BatchE.resize(nrows);
+}
+
+void LinearMethodMoments::reset(Matrix<Return_t>* ovl, Matrix<Return_t>* ham)
+{
+  if(ovl==0 || ham==0)
+  {
+    Mdd.resize(NumParams+1,NumParams+1);
+    MdH.resize(NumParams+1,NumParams+1);
+    ovl=&Mdd;
+    ham=&MdH;
+  }
+  else
+  {
+    //accumulate into the matrices of the caller, free the owned ones
+    Mdd.resize(0,0);
+    MdH.resize(0,0);
+  }
+  Ovl=ovl;
+  Ham=ham;
+  *Ovl=0.0;
+  *Ham=0.0;
+  Mvv=0.0;
+  Sums=0.0;
+  SumW=SumE=SumE2=0.0;
+}
+
+void LinearMethodMoments::setShift(const std::vector<Return_t>& shift)
+{
+  std::copy(shift.begin(),shift.begin()+NumParams,Shift.begin());
+}
+
+void LinearMethodMoments::addSample(int row, const Return_t* dlogpsi, const Return_t* dhpsioverpsi,
+                                    Return_t eloc, Return_t weight)
+{
+  Return_t* restrict d=BatchD[row];
+  Return_t* restrict wd=BatchWD[row];
+  Return_t* restrict h=BatchH[row];
+  for(int i=0; i<NumParams; ++i)
+  {
+    d[i]=dlogpsi[i]-Shift[i];
+    wd[i]=weight*d[i];
+    h[i]=dhpsioverpsi[i]+d[i]*eloc;
+  }
+  if(UseVariance)
+  {
+    Return_t* restrict v=BatchV[row];
+    Return_t sqw=std::sqrt(weight);
+    for(int i=0; i<NumParams; ++i)
+      v[i]=sqw*(dhpsioverpsi[i]-2.0*d[i]*eloc);
+  }
+  BatchW[row]=weight;
+  BatchE[row]=eloc;
+}
+
+void LinearMethodMoments::clearRow(int row)
+{
+  std::fill(BatchD[row],BatchD[row]+NumParams,0.0);
+  std::fill(BatchWD[row],BatchWD[row]+NumParams,0.0);
+  std::fill(BatchH[row],BatchH[row]+NumParams,0.0);
+  if(UseVariance)
+    std::fill(BatchV[row],BatchV[row]+NumParams,0.0);
+  BatchW[row]=0.0;
+  BatchE[row]=0.0;
+}
+
+void LinearMethodMoments::accumulate(int ip, int nthreads)
+{
+  const int nrows=BatchD.rows();
+  std::vector<int> slab;
+  FairDivideLow(NumParams,nthreads,slab);
+  const int p0=slab[ip];
+  const int np=slab[ip+1]-slab[ip];
+  if(np>0)
+  {
+    //the matrices are row major: the rows [p0,p0+np) of M=A^T B are the columns of B^T A in column major
+    const int ld=NumParams+1;
+    BLAS::gemm('N','T',NumParams,np,nrows,1.0,BatchD.data(),NumParams,BatchWD.data()+p0,NumParams,1.0,(*Ovl)[p0+1]+1,ld);
+    BLAS::gemm('N','T',NumParams,np,nrows,1.0,BatchH.data(),NumParams,BatchWD.data()+p0,NumParams,1.0,(*Ham)[p0+1]+1,ld);
+    if(UseVariance)
+      BLAS::gemm('N','T',NumParams,np,nrows,1.0,BatchV.data(),NumParams,BatchV.data()+p0,NumParams,1.0,Mvv[p0],NumParams);
+    for(int s=0; s<nrows; ++s)
+    {
+      const Return_t w=BatchW[s];
+      const Return_t we=w*BatchE[s];
+      const Return_t we2=we*BatchE[s];
+      const Return_t* restrict d=BatchD[s];
+      const Return_t* restrict h=BatchH[s];
+      for(int i=p0; i<p0+np; ++i)
+      {
+        Sums(SUM_D,i)+=w*d[i];
+        Sums(SUM_H,i)+=w*h[i];
+        Sums(SUM_HE,i)+=we*h[i];
+        Sums(SUM_DE,i)+=we*d[i];
+        Sums(SUM_DE2,i)+=we2*d[i];
+      }
+    }
+  }
+  if(ip==0)
+  {
+    for(int s=0; s<nrows; ++s)
+    {
+      SumW+=BatchW[s];
+      SumE+=BatchW[s]*BatchE[s];
+      SumE2+=BatchW[s]*BatchE[s]*BatchE[s];
+    }
+  }
+}
+
+void LinearMethodMoments::reduce(Communicate* comm)
+{
+  comm->allreduce(*Ovl);
+  comm->allreduce(*Ham);
+  if(UseVariance)
+    comm->allreduce(Mvv);
+  comm->allreduce(Sums);
+  std::vector<Return_t> s(3);
+  s[0]=SumW;
+  s[1]=SumE;
+  s[2]=SumE2;
+  comm->allreduce(s);
+  SumW=s[0];
+  SumE=s[1];
+  SumE2=s[2];
+}
+
+void LinearMethodMoments::fillMatrices(Matrix<Return_t>& Left, Matrix<Return_t>& Right,
+                                       Return_t b1, Return_t b2, Return_t H2_avg, Return_t V_avg, Return_t E_avg)
+{
+  const int n=NumParams;
+  const Return_t wgtinv=(SumW==0)?0:1.0/SumW;
+  const Return_t e1=SumE*wgtinv;
+  const Return_t e2=SumE2*wgtinv;
+  //offset of the mean from the shift and the first moments w.r.t. the shift
+  std::vector<Return_t> delta(n), sh(n), sde(n), de(n), vte(n);
+  for(int i=0; i<n; ++i)
+  {
+    delta[i]=Sums(SUM_D,i)*wgtinv;
+    sh[i]=Sums(SUM_H,i)*wgtinv;
+    sde[i]=Sums(SUM_DE,i)*wgtinv;
+    Return_t sde2=Sums(SUM_DE2,i)*wgtinv;
+    Return_t she=Sums(SUM_HE,i)*wgtinv;
+    //centered: <d E>, <d E^2>, <h>, <h E>
+    de[i]=sde[i]-delta[i]*e1;
+    Return_t de2=sde2-delta[i]*e2;
+    Return_t h=sh[i]-sde[i];
+    Return_t he=she-sde2;
+    //<(h - 2 d' E) E> for the correction of M_vv
+    vte[i]=he-2.0*sde2;
+    Return_t vterm=he-E_avg*h+de2-2.0*E_avg*de[i];
+    Right(0,i+1) = b1*H2_avg*vterm;
+    Right(i+1,0) = b1*H2_avg*vterm;
+    Left(0,i+1) = b2*vterm+(1-b2)*(h+de[i]);
+    Left(i+1,0) = b2*vterm+(1-b2)*de[i];
+  }
+  //in place if the moments are accumulated in Left and Right
+  for(int i=0; i<n; ++i)
+  {
+    const Return_t* dd=(*Ovl)[i+1]+1;
+    const Return_t* dh=(*Ham)[i+1]+1;
+    const Return_t* vv=UseVariance?Mvv[i]:0;
+    Return_t* left=Left[i+1]+1;
+    Return_t* right=Right[i+1]+1;
+    for(int j=0; j<n; ++j)
+    {
+      Return_t ovlij=dd[j]*wgtinv-delta[i]*delta[j];
+      Return_t hamij=dh[j]*wgtinv-delta[i]*sh[j]-delta[j]*sde[i]+delta[i]*delta[j]*e1;
+      Return_t varij=0;
+      if(UseVariance)
+        varij=vv[j]*wgtinv+2.0*(delta[j]*vte[i]+delta[i]*vte[j])+4.0*delta[i]*delta[j]*e2;
+      left[j] = (1-b2)*hamij+b2*(varij+V_avg*ovlij);
+      right[j] = ovlij+b1*H2_avg*varij;
+    }
+  }
+  //center the next accumulation at the current mean
+  for(int i=0; i<n; ++i)
+    Shift[i]+=delta[i];
+}
+
+size_t LinearMethodMoments::bytes() const
+{
+  return sizeof(Return_t)*(Mdd.size()+MdH.size()+Mvv.size()+Sums.size()
+                           +BatchD.size()+BatchWD.size()+BatchH.size()+BatchV.size());
+}
+
+}
@@ -0,0 +1,135 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file LinearMethodMoments.h
+ * @brief accumulate the overlap and Hamiltonian matrices of the linear method by sample batches
+ */
+#ifndef QMCPLUSPLUS_LINEAR_METHOD_MOMENTS_H
+#define QMCPLUSPLUS_LINEAR_METHOD_MOMENTS_H
+
+#include "Configuration.h"
+#include "OhmmsPETE/OhmmsMatrix.h"
+#include "Message/Communicate.h"
+#include <vector>
+
+namespace qmcplusplus
+{
+
+/** Weighted moments of the parameter derivatives over the samples
+ *
+ * The samples are added to the rows of a batch, one block of rows per
+ * thread. A full batch is accumulated with GEMM into the moments
+ *
+ *   M_dd(i,j) = sum_s w_s d_i d_j
+ *   M_dH(i,j) = sum_s w_s d_i (h_j + d_j E)
+ *   M_vv(i,j) = sum_s w_s (h_i - 2 d_i E)(h_j - 2 d_j E)
+ *
+ * with d = dlogpsi - Shift, h = dhpsioverpsi and the local energy E.
+ * The rows of the moments are divided among the threads calling accumulate.
+ * The overlap and Hamiltonian matrices centered at the mean derivatives are
+ * recovered from the moments, hence the samples do not need to be stored.
+ * The shift only controls the round-off, it is the mean of the previous
+ * accumulation by default.
+ *
+ * M_dd and M_dH are the parameter blocks of (n+1)x(n+1) matrices. They are
+ * either owned or the matrices of the linear method, which are then filled
+ * in place without any extra copy.
+ */
+class LinearMethodMoments: public QMCTraits
+{
+public:
+  typedef QMCTraits::RealType Return_t;
+
+  LinearMethodMoments();
+
+  /** allocate the moments and the batch
+   * @param nparams number of the parameters
+   * @param nrows number of the rows of a batch
+   * @param variance true if M_vv is needed
+   */
+  void resize(int nparams, int nrows, bool variance);
+
+  /** clear the sums
+   * @param ovl matrix to accumulate M_dd, owned matrix if null
+   * @param ham matrix to accumulate M_dH, owned matrix if null
+   */
+  void reset(Matrix<Return_t>* ovl=0, Matrix<Return_t>* ham=0);
+
+  ///set the shift of the derivatives
+  void setShift(const std::vector<Return_t>& shift);
+
+  ///return the number of the rows of a batch
+  inline int batchSize() const
+  {
+    return BatchD.rows();
+  }
+
+  /** add a sample to a row of the batch
+   * @param row row index of the batch
+   * @param dlogpsi derivatives of log(psi)
+   * @param dhpsioverpsi derivatives of the local energy
+   * @param eloc local energy
+   * @param weight weight of the sample
+   */
+  void addSample(int row, const Return_t* dlogpsi, const Return_t* dhpsioverpsi, Return_t eloc, Return_t weight);
+
+  ///zero a row of the batch which has no sample
+  void clearRow(int row);
+
+  /** accumulate the batch, called by all the threads
+   * @param ip thread index
+   * @param nthreads number of the threads sharing the work
+   */
+  void accumulate(int ip, int nthreads);
+
+  ///sum the moments over the tasks
+  void reduce(Communicate* comm);
+
+  /** fill the matrices of the linear method, see QMCCostFunctionOMP::fillOverlapHamiltonianMatrices
+   *
+   * The first row and column of the parameter blocks are filled. Left(0,0) and
+   * Right(0,0) are set by the caller.
+   */
+  void fillMatrices(Matrix<Return_t>& Left, Matrix<Return_t>& Right,
+                    Return_t b1, Return_t b2, Return_t H2_avg, Return_t V_avg, Return_t E_avg);
+
+  ///return the memory of the moments and the batch in bytes
+  size_t bytes() const;
+
+private:
+  ///number of the parameters
+  int NumParams;
+  ///true if M_vv is accumulated
+  bool UseVariance;
+  ///shift of the derivatives
+  std::vector<Return_t> Shift;
+  ///owned M_dd and M_dH
+  Matrix<Return_t> Mdd, MdH;
+  ///M_vv
+  Matrix<Return_t> Mvv;
+  ///matrices accumulating M_dd and M_dH
+  Matrix<Return_t> *Ovl, *Ham;
+  /** first moments
+   *
+   * rows: w d, w (h+dE), w E (h+dE), w E d, w E^2 d
+   */
+  Matrix<Return_t> Sums;
+  ///sum of the weights, w E, w E^2
+  Return_t SumW, SumE, SumE2;
+  ///batch d, w d, h + d E and sqrt(w) (h - 2 d E)
+  Matrix<Return_t> BatchD, BatchWD, BatchH, BatchV;
+  ///weights and local energies of the batch
+  std::vector<Return_t> BatchW, BatchE;
+};
+
+}
+#endif
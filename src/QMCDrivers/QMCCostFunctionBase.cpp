@@ -37,7 +37,8 @@ QMCCostFunctionBase::QMCCostFunctionBase(MCWalkerConfiguration& w, TrialWaveFunc
   w_en(0.0), w_var(1.0), w_abs(0.0),w_w(0.0),w_beta(0.0), GEVType("mixed"),
   CorrelationFactor(0.0), m_wfPtr(NULL), m_doc_out(NULL), msg_stream(0), debug_stream(0),
   SmallWeight(0),usebuffer("no"), includeNonlocalH("no"),needGrads(true), vmc_or_dmc(2.0),
-  StoreDerivInfo(true),DerivStorageLevel(-1), targetExcitedStr("no"), targetExcited(false), omega_shift(0.0)
+  StoreDerivInfo(true),DerivStorageLevel(-1), targetExcitedStr("no"), targetExcited(false), omega_shift(0.0),
+  StoreDerivRecords(true), SampleBatchSize(64)
 {
   GEVType="mixed";
   //paramList.resize(10);
@@ -480,6 +481,7 @@ QMCCostFunctionBase::put(xmlNodePtr q)
 {
   std::string writeXmlPerStep("no");
   std::string computeNLPPderiv("no");
+  std::string storeDerivs("yes");
   ParameterSet m_param;
   m_param.add(writeXmlPerStep,"dumpXML","string");
   m_param.add(MinNumWalkers,"minwalkers","scalar");
@@ -492,8 +494,14 @@ QMCCostFunctionBase::put(xmlNodePtr q)
   m_param.add(GEVType,"GEVMethod","string");
   m_param.add(targetExcitedStr,"targetExcited","string");
   m_param.add(omega_shift,"omega","double");
+  m_param.add(storeDerivs,"store_derivs","string");
+  m_param.add(SampleBatchSize,"sample_batch","int");
   m_param.put(q);
 
+  tolower(storeDerivs);
+  StoreDerivRecords = (storeDerivs != "no");
+  SampleBatchSize = std::max(SampleBatchSize,1);
+
   tolower(targetExcitedStr);
   targetExcited = ( targetExcitedStr == "yes" );
 
@@ -969,6 +977,16 @@ QMCCostFunctionBase::lineoptimization(const std::vector<Return_t>& x0, const std
   return true;
 }
 
+void QMCCostFunctionBase::setupOverlapHamiltonianProducts(std::vector<Return_t>& Ldiag, std::vector<Return_t>& Rdiag)
+{
+  APP_ABORT("QMCCostFunctionBase::setupOverlapHamiltonianProducts is not implemented by this cost function.");
+}
+
+void QMCCostFunctionBase::applyOverlapHamiltonianProducts(const Matrix<Return_t>& X, Matrix<Return_t>& LX, Matrix<Return_t>& RX)
+{
+  APP_ABORT("QMCCostFunctionBase::applyOverlapHamiltonianProducts is not implemented by this cost function.");
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /// \brief  If the LMYEngine is available, returns the cost function calculated by the engine.
 ///         Otherwise, returns the usual cost function.
@@ -165,6 +165,19 @@ public:
 
   virtual Return_t fillOverlapHamiltonianMatrices(Matrix<Return_t>& Left, Matrix<Return_t>& Right)=0;
 
+  /** prepare the products with the matrices of fillOverlapHamiltonianMatrices without building them
+   * @param Ldiag diagonal of Left
+   * @param Rdiag diagonal of Right
+   */
+  virtual void setupOverlapHamiltonianProducts(std::vector<Return_t>& Ldiag, std::vector<Return_t>& Rdiag);
+
+  /** products of Left and Right with a block of vectors, summed over the samples of all the tasks
+   * @param X the vectors in the rows
+   * @param LX Left times the rows of X
+   * @param RX Right times the rows of X
+   */
+  virtual void applyOverlapHamiltonianProducts(const Matrix<Return_t>& X, Matrix<Return_t>& LX, Matrix<Return_t>& RX);
+
 #ifdef HAVE_LMY_ENGINE
   Return_t LMYEngineCost(const bool needDeriv, cqmc::engine::LMYEngine * EngineObj);
 #endif
@@ -335,6 +348,10 @@ protected:
   bool StoreDerivInfo;
   // storage level
   int DerivStorageLevel;
+  ///true if the derivatives of every sample are stored for the linear method
+  bool StoreDerivRecords;
+  ///number of the samples per thread accumulated together into the linear method matrices
+  int SampleBatchSize;
 
 
   typedef ParticleSet::ParticleGradient_t ParticleGradient_t;
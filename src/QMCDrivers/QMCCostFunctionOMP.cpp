@@ -23,6 +23,7 @@
 #include "QMCWaveFunctions/TrialWaveFunction.h"
 #include "Particle/HDFWalkerInputCollect.h"
 #include "Message/CommOperators.h"
+#include "Numerics/OhmmsBlas.h"
 //#define QMCCOSTFUNCTION_DEBUG
 
 
@@ -80,6 +81,8 @@ void QMCCostFunctionOMP::GradCost(std::vector<Return_t>& PGradient, const std::v
   }
   else
   {
+    if (!StoreDerivRecords)
+      APP_ABORT("QMCCostFunctionOMP::GradCost requires the derivatives of the samples, set store_derivs to yes");
     for (int j=0; j<NumOptimizables; j++)
       OptVariables[j]=PM[j];
     resetPsi();
@@ -319,7 +322,14 @@ void QMCCostFunctionOMP::checkConfigurations()
     numW += wClones[i]->getActiveWalkers();
   app_log() <<"Memory usage: " << std::endl;
   app_log() <<"Linear method (approx matrix usage: 4*N^2): " <<NumParams()*NumParams()*sizeof(QMCTraits::RealType)*4.0/1.0e6  <<" MB" << std::endl; // assuming 4 matrices
-  app_log() <<"Deriv,HDerivRecord:      " <<numW*NumOptimizables*sizeof(QMCTraits::RealType)*3.0/1.0e6 <<" MB" << std::endl;
+  if(StoreDerivRecords)
+    app_log() <<"Deriv,HDerivRecord:      " <<numW*NumOptimizables*sizeof(QMCTraits::RealType)*3.0/1.0e6 <<" MB" << std::endl;
+  else
+  {
+    Moments.resize(NumParams(),NumThreads*SampleBatchSize,w_beta!=0.0);
+    Moments.reset();
+    app_log() <<"Moments of the derivatives, samples are not stored: " <<Moments.bytes()/1.0e6 <<" MB" << std::endl;
+  }
   if(StoreDerivInfo)
   {
     MCWalkerConfiguration& dummy(*wClones[0]);
@@ -345,21 +355,17 @@ void QMCCostFunctionOMP::checkConfigurations()
     int ip = omp_get_thread_num();
     MCWalkerConfiguration& wRef(*wClones[ip]);
     if (RecordsOnNode[ip] ==0)
-    {
       RecordsOnNode[ip]=new Matrix<Return_t>;
+    if (RecordsOnNode[ip]->size1()!=wRef.getActiveWalkers())
       RecordsOnNode[ip]->resize(wRef.getActiveWalkers(),SUM_INDEX_SIZE);
-      if (needGrads)
+    if (needGrads && StoreDerivRecords)
+    {
+      if (DerivRecords[ip]==0)
       {
         DerivRecords[ip]=new Matrix<Return_t>;
-        DerivRecords[ip]->resize(wRef.getActiveWalkers(),NumOptimizables);
         HDerivRecords[ip]=new Matrix<Return_t>;
-        HDerivRecords[ip]->resize(wRef.getActiveWalkers(),NumOptimizables);
       }
-    }
-    else if (RecordsOnNode[ip]->size1()!=wRef.getActiveWalkers())
-    {
-      RecordsOnNode[ip]->resize(wRef.getActiveWalkers(),SUM_INDEX_SIZE);
-      if (needGrads)
+      if (DerivRecords[ip]->size1()!=wRef.getActiveWalkers() || DerivRecords[ip]->size2()!=NumOptimizables)
       {
         DerivRecords[ip]->resize(wRef.getActiveWalkers(),NumOptimizables);
         HDerivRecords[ip]->resize(wRef.getActiveWalkers(),NumOptimizables);
@@ -408,7 +414,7 @@ void QMCCostFunctionOMP::checkConfigurations()
       saved[REWEIGHT]=thisWalker.Weight=1.0;
       //          thisWalker.resetProperty(logpsi,psiClones[ip]->getPhase(),x);
       Return_t etmp;
-      if (needGrads)
+      if (needGrads && StoreDerivRecords)
       {
         //allocate vector
         std::vector<Return_t> Dsaved(NumOptimizables,0.0);
@@ -434,7 +440,11 @@ void QMCCostFunctionOMP::checkConfigurations()
     // #pragma omp atomic
     //       eft_tot+=ef;
   }
-  OptVariablesForPsi.setComputed();
+  //without the records, all the derivatives are computed by correlatedSampling
+  if (StoreDerivRecords)
+    OptVariablesForPsi.setComputed();
+  else
+    OptVariablesForPsi.setRecompute();
   //     app_log() << "  VMC Efavg = " << eft_tot/static_cast<Return_t>(wPerNode[NumThreads]) << std::endl;
   //Need to sum over the processors
   std::vector<Return_t> etemp(3);
@@ -713,6 +723,16 @@ QMCCostFunctionOMP::Return_t QMCCostFunctionOMP::correlatedSampling(bool needGra
   Return_t NSm1 = 1.0/NumSamples;
   Return_t inv_n_samples=1.0/NumSamples;
   typedef MCWalkerConfiguration::Walker_t Walker_t;
+  //accumulate the linear method moments in batches instead of storing the derivatives
+  const bool accumulate=needGrad && !StoreDerivRecords;
+  int nbatches=1;
+  if (accumulate)
+  {
+    Moments.reset();
+    nbatches=0;
+    for (int ip=0; ip<NumThreads; ++ip)
+      nbatches=std::max(nbatches,(wClones[ip]->getActiveWalkers()+SampleBatchSize-1)/SampleBatchSize);
+  }
 #pragma omp parallel reduction(+:wgt_tot,wgt_tot2)
   {
     int ip = omp_get_thread_num();
@@ -722,62 +742,84 @@ QMCCostFunctionOMP::Return_t QMCCostFunctionOMP::correlatedSampling(bool needGra
     MCWalkerConfiguration& wRef(*wClones[ip]);
     Return_t wgt_node=0.0, wgt_node2=0.0;
     //int totalElements=W.getTotalNum()*OHMMS_DIM;
-    MCWalkerConfiguration::iterator it(wRef.begin());
-    MCWalkerConfiguration::iterator it_end(wRef.end());
-    int iw=0,iwg=wPerNode[ip];
-    for (; it!= it_end; ++it,++iw,++iwg)
+    const int nw=wRef.getActiveWalkers();
+    const int nb=accumulate?SampleBatchSize:nw;
+    for (int ib=0; ib<nbatches; ++ib)
     {
-      ParticleSet::Walker_t& thisWalker(**it);
-      wRef.R=thisWalker.R;
-      wRef.update();
-      Return_t* restrict saved = (*RecordsOnNode[ip])[iw];
-      // buffer for MultiSlaterDet data
-      Return_t logpsi;
-      //           Return_t logpsi_old = thisWalker.getPropertyBase()[LOGPSI];
-      //          if((usebuffer=="yes")||(includeNonlocalH=="yes"))
-      if(StoreDerivInfo)
+      for (int k=0; k<nb; ++k)
       {
-        Walker_t::Buffer_t& tbuffer=thisWalker.DataSetForDerivatives;
-        logpsi=psiClones[ip]->evaluateDeltaLog(wRef,tbuffer);
-        wRef.G += *dLogPsi[iwg];
-        wRef.L += *d2LogPsi[iwg];
-      }
-      else
-      {
-        logpsi=psiClones[ip]->evaluateDeltaLog(wRef,compute_all_from_scratch);
-        wRef.G += *dLogPsi[iwg];
-        wRef.L += *d2LogPsi[iwg];
-        //             logpsi=psiClones[ip]->evaluateLog(wRef);
-      }
-      //          Return_t weight = std::exp(2.0*(logpsi-saved[LOGPSI_FREE]));
-      Return_t weight = saved[REWEIGHT] = vmc_or_dmc*(logpsi-saved[LOGPSI_FREE])+std::log(thisWalker.Weight);
-      //          if(std::isnan(weight)||std::isinf(weight)) weight=0;
-      if (needGrad)
-      {
-        std::vector<Return_t> Dsaved(NumOptimizables,0);
-        std::vector<Return_t> HDsaved(NumOptimizables,0);
-        psiClones[ip]->evaluateDerivatives(wRef, OptVariablesForPsi, Dsaved, HDsaved);
-        saved[ENERGY_NEW] =
-          H_KE_Node[ip]->evaluateValueAndDerivatives(wRef,OptVariablesForPsi,Dsaved,HDsaved,compute_nlpp)
-          +saved[ENERGY_FIXED];;
-        for( int i=0; i<NumOptimizables; i++)
-          if(OptVariablesForPsi.recompute(i))
+        int iw=ib*nb+k, iwg=wPerNode[ip]+iw;
+        if (iw>=nw)
+        {
+          if (accumulate)
+            Moments.clearRow(ip*nb+k);
+          continue;
+        }
+        ParticleSet::Walker_t& thisWalker(*wRef[iw]);
+        wRef.R=thisWalker.R;
+        wRef.update();
+        Return_t* restrict saved = (*RecordsOnNode[ip])[iw];
+        // buffer for MultiSlaterDet data
+        Return_t logpsi;
+        //           Return_t logpsi_old = thisWalker.getPropertyBase()[LOGPSI];
+        //          if((usebuffer=="yes")||(includeNonlocalH=="yes"))
+        if(StoreDerivInfo)
+        {
+          Walker_t::Buffer_t& tbuffer=thisWalker.DataSetForDerivatives;
+          logpsi=psiClones[ip]->evaluateDeltaLog(wRef,tbuffer);
+          wRef.G += *dLogPsi[iwg];
+          wRef.L += *d2LogPsi[iwg];
+        }
+        else
+        {
+          logpsi=psiClones[ip]->evaluateDeltaLog(wRef,compute_all_from_scratch);
+          wRef.G += *dLogPsi[iwg];
+          wRef.L += *d2LogPsi[iwg];
+          //             logpsi=psiClones[ip]->evaluateLog(wRef);
+        }
+        //          Return_t weight = std::exp(2.0*(logpsi-saved[LOGPSI_FREE]));
+        Return_t weight = saved[REWEIGHT] = vmc_or_dmc*(logpsi-saved[LOGPSI_FREE])+std::log(thisWalker.Weight);
+        //          if(std::isnan(weight)||std::isinf(weight)) weight=0;
+        if (needGrad)
+        {
+          std::vector<Return_t> Dsaved(NumOptimizables,0);
+          std::vector<Return_t> HDsaved(NumOptimizables,0);
+          psiClones[ip]->evaluateDerivatives(wRef, OptVariablesForPsi, Dsaved, HDsaved);
+          saved[ENERGY_NEW] =
+            H_KE_Node[ip]->evaluateValueAndDerivatives(wRef,OptVariablesForPsi,Dsaved,HDsaved,compute_nlpp)
+            +saved[ENERGY_FIXED];;
+          if (accumulate)
+            Moments.addSample(ip*nb+k,&Dsaved[0],&HDsaved[0],saved[ENERGY_NEW],std::exp(weight));
+          else
           {
-            (*DerivRecords[ip])(iw,i) = Dsaved[i];
-            (*HDerivRecords[ip])(iw,i) = HDsaved[i];
+            for( int i=0; i<NumOptimizables; i++)
+              if(OptVariablesForPsi.recompute(i))
+              {
+                (*DerivRecords[ip])(iw,i) = Dsaved[i];
+                (*HDerivRecords[ip])(iw,i) = HDsaved[i];
+              }
           }
-        //saved[ENERGY_NEW] = H_KE_Node[ip]->evaluate(wRef) + saved[ENERGY_FIXED];
+          //saved[ENERGY_NEW] = H_KE_Node[ip]->evaluate(wRef) + saved[ENERGY_FIXED];
+        }
+        else
+          saved[ENERGY_NEW] = H_KE_Node[ip]->evaluate(wRef) + saved[ENERGY_FIXED];
+        wgt_node+=inv_n_samples*weight;
+        wgt_node2+=inv_n_samples*weight*weight;
+      }
+      if (accumulate)
+      {
+        #pragma omp barrier
+        Moments.accumulate(ip,NumThreads);
+        #pragma omp barrier
       }
-      else
-        saved[ENERGY_NEW] = H_KE_Node[ip]->evaluate(wRef) + saved[ENERGY_FIXED];
-      wgt_node+=inv_n_samples*weight;
-      wgt_node2+=inv_n_samples*weight*weight;
     }
     wgt_tot += wgt_node;
     wgt_tot2 += wgt_node2;
   }
   //this is MPI barrier
   OHMMS::Controller->barrier();
+  if (accumulate)
+    Moments.reduce(myComm);
   //collect the total weight for normalization and apply maximum weight
   myComm->allreduce(wgt_tot);
   myComm->allreduce(wgt_tot2);
@@ -847,7 +889,57 @@ QMCCostFunctionOMP::Return_t QMCCostFunctionOMP::correlatedSampling(bool needGra
 QMCCostFunctionOMP::Return_t
 QMCCostFunctionOMP::fillOverlapHamiltonianMatrices(Matrix<Return_t>& Left, Matrix<Return_t>& Right)
 {
-  RealType b1,b2;
+  RealType b1,b2,H2_avg,V_avg;
+  getLinearMethodCoefficients(b1,b2,H2_avg,V_avg);
+
+  Right=0.0;
+  Left=0.0;
+
+  if (StoreDerivRecords)
+  {
+    std::vector<Return_t> D_avg;
+    getDerivativeAverages(D_avg);
+
+    //accumulate the batches of the stored samples directly in Left and Right
+    Moments.resize(NumParams(),NumThreads*SampleBatchSize,b1!=0.0 || b2!=0.0);
+    Moments.setShift(D_avg);
+    Moments.reset(&Right,&Left);
+    int nbatches=0;
+    for (int ip=0; ip<NumThreads; ++ip)
+      nbatches=std::max(nbatches,(wClones[ip]->getActiveWalkers()+SampleBatchSize-1)/SampleBatchSize);
+    #pragma omp parallel
+    {
+      int ip=omp_get_thread_num();
+      const int nw=wClones[ip]->getActiveWalkers();
+      for (int ib=0; ib<nbatches; ++ib)
+      {
+        for (int k=0; k<SampleBatchSize; ++k)
+        {
+          int iw=ib*SampleBatchSize+k;
+          if (iw<nw)
+            Moments.addSample(ip*SampleBatchSize+k,(*DerivRecords[ip])[iw],(*HDerivRecords[ip])[iw],
+                              (*RecordsOnNode[ip])(iw,ENERGY_NEW),(*RecordsOnNode[ip])(iw,REWEIGHT));
+          else
+            Moments.clearRow(ip*SampleBatchSize+k);
+        }
+        #pragma omp barrier
+        Moments.accumulate(ip,NumThreads);
+        #pragma omp barrier
+      }
+    }
+    Moments.reduce(myComm);
+  }
+  Moments.fillMatrices(Left,Right,b1,b2,H2_avg,V_avg,curAvg_w);
+  Left(0,0) = (1-b2)*curAvg_w + b2*V_avg;
+  Right(0,0) = 1.0+b1*H2_avg*V_avg;
+  if (GEVType=="H2")
+    return H2_avg;
+
+  return 1.0;
+}
+
+void QMCCostFunctionOMP::getLinearMethodCoefficients(Return_t& b1, Return_t& b2, Return_t& H2_avg, Return_t& V_avg)
+{
   if (GEVType=="H2")
   {
     b1=w_beta;
@@ -858,19 +950,19 @@ QMCCostFunctionOMP::fillOverlapHamiltonianMatrices(Matrix<Return_t>& Left, Matri
     b2=w_beta;
     b1=0;
   }
-
-  Right=0.0;
-  Left=0.0;
-
   //     resetPsi();
   //     Return_t NWE = NumWalkersEff=correlatedSampling(true);
   curAvg_w = SumValue[SUM_E_WGT]/SumValue[SUM_WGT];
   Return_t curAvg2_w = SumValue[SUM_ESQ_WGT]/SumValue[SUM_WGT];
   //    RealType H2_avg = 1.0/curAvg2_w;
-  RealType H2_avg = 1.0/(curAvg_w*curAvg_w);
+  H2_avg = 1.0/(curAvg_w*curAvg_w);
   //    RealType H2_avg = 1.0/std::sqrt(curAvg_w*curAvg_w*curAvg2_w);
-  RealType V_avg = curAvg2_w - curAvg_w*curAvg_w;
-  std::vector<Return_t> D_avg(NumParams(),0.0);
+  V_avg = curAvg2_w - curAvg_w*curAvg_w;
+}
+
+void QMCCostFunctionOMP::getDerivativeAverages(std::vector<Return_t>& D_avg)
+{
+  D_avg.assign(NumParams(),0.0);
   Return_t wgtinv = 1.0/SumValue[SUM_WGT];
   for (int ip=0; ip<NumThreads; ip++)
   {
@@ -886,60 +978,150 @@ QMCCostFunctionOMP::fillOverlapHamiltonianMatrices(Matrix<Return_t>& Left, Matri
       }
     }
   }
-
   myComm->allreduce(D_avg);
+}
 
-  for (int ip=0; ip<NumThreads; ip++)
+/** the matrices of fillOverlapHamiltonianMatrices are sums over the samples of
+ * outer products of the centered derivatives d, the derivatives of the local
+ * energy h and the local energy. The products with a block of vectors only take
+ * the projections of d and h on the vectors, two GEMMs on the stored records,
+ * and two GEMMs back to the parameters.
+ */
+void QMCCostFunctionOMP::setupOverlapHamiltonianProducts(std::vector<Return_t>& Ldiag, std::vector<Return_t>& Rdiag)
+{
+  if (!StoreDerivRecords)
   {
+    APP_ABORT("QMCCostFunctionOMP::setupOverlapHamiltonianProducts requires store_derivs=\"yes\".");
+  }
+  getLinearMethodCoefficients(ProductB1,ProductB2,ProductH2,ProductV);
+  getDerivativeAverages(ProductDavg);
+  const int np=NumParams();
+  const Return_t b1H2=ProductB1*ProductH2;
+  const Return_t b2=ProductB2;
+  const Return_t wgtinv=1.0/SumValue[SUM_WGT];
+  Matrix<Return_t> diags(NumThreads,2*np);
+  diags=0.0;
+  #pragma omp parallel
+  {
+    int ip=omp_get_thread_num();
     int nw=wClones[ip]->getActiveWalkers();
+    Return_t* restrict ldiag=diags[ip];
+    Return_t* restrict rdiag=diags[ip]+np;
     for (int iw=0; iw<nw; iw++)
     {
       const Return_t* restrict saved = (*RecordsOnNode[ip])[iw];
       Return_t weight=saved[REWEIGHT]*wgtinv;
-      Return_t eloc_new=saved[ENERGY_NEW];
+      Return_t eloc=saved[ENERGY_NEW];
       const Return_t* Dsaved= (*DerivRecords[ip])[iw];
       const Return_t* HDsaved= (*HDerivRecords[ip])[iw];
-      #pragma omp parallel for
-      for (int pm=0; pm<NumParams(); pm++)
+      for (int pm=0; pm<np; pm++)
       {
-        Return_t wfe = (HDsaved[pm] +(Dsaved[pm]-D_avg[pm])*eloc_new)*weight;
-        Return_t wfd = (Dsaved[pm]-D_avg[pm])*weight;
-        Return_t vterm =  HDsaved[pm]*(eloc_new-curAvg_w)+(Dsaved[pm]-D_avg[pm])*eloc_new*(eloc_new-2.0*curAvg_w);
-        //                Return_t vterm = (HDsaved[pm]+(Dsaved[pm]-D_avg[pm])*eloc_new -curAvg_w)*(eloc_new-curAvg_w);
-        //                 H2
-        Right(0,pm+1) += b1*H2_avg*vterm*weight;
-        Right(pm+1,0) += b1*H2_avg*vterm*weight;
-        //                 Variance
-        Left(0,pm+1) += b2*vterm*weight;
-        Left(pm+1,0) += b2*vterm*weight;
-        //                 Hamiltonian
-        Left(0,pm+1) += (1-b2)*wfe;
-        Left(pm+1,0) += (1-b2)*wfd*eloc_new;
-        for (int pm2=0; pm2<NumParams(); pm2++)
+        Return_t d=Dsaved[pm]-ProductDavg[pm];
+        Return_t v=HDsaved[pm]-2.0*d*eloc;
+        ldiag[pm]+=weight*((1-b2)*d*(HDsaved[pm]+d*eloc)+b2*(v*v+ProductV*d*d));
+        rdiag[pm]+=weight*(d*d+b1H2*v*v);
+      }
+    }
+  }
+  std::vector<Return_t> sums(2*np,0.0);
+  for (int ip=0; ip<NumThreads; ip++)
+    for (int pm=0; pm<2*np; pm++)
+      sums[pm]+=diags(ip,pm);
+  myComm->allreduce(sums);
+  Ldiag.resize(np+1);
+  Rdiag.resize(np+1);
+  Ldiag[0]=(1-b2)*curAvg_w+b2*ProductV;
+  Rdiag[0]=1.0+b1H2*ProductV;
+  std::copy(sums.begin(),sums.begin()+np,Ldiag.begin()+1);
+  std::copy(sums.begin()+np,sums.end(),Rdiag.begin()+1);
+}
+
+void QMCCostFunctionOMP::applyOverlapHamiltonianProducts(const Matrix<Return_t>& X, Matrix<Return_t>& LX, Matrix<Return_t>& RX)
+{
+  const int np=NumParams();
+  const int n=np+1;
+  const int m=X.rows();
+  const Return_t b1H2=ProductB1*ProductH2;
+  const Return_t b2=ProductB2;
+  const Return_t V_avg=ProductV;
+  const Return_t E_avg=curAvg_w;
+  const Return_t wgtinv=1.0/SumValue[SUM_WGT];
+  //projections of the mean derivatives
+  std::vector<Return_t> dx(m);
+  for (int k=0; k<m; k++)
+    dx[k]=BLAS::dot(np,&ProductDavg[0],X[k]+1);
+  std::vector<Matrix<Return_t> > threadLX(NumThreads), threadRX(NumThreads);
+  #pragma omp parallel
+  {
+    int ip=omp_get_thread_num();
+    int nw=wClones[ip]->getActiveWalkers();
+    Matrix<Return_t>& myLX=threadLX[ip];
+    Matrix<Return_t>& myRX=threadRX[ip];
+    myLX.resize(m,n);
+    myRX.resize(m,n);
+    myLX=0.0;
+    myRX=0.0;
+    if (nw>0)
+    {
+      const Return_t* D=DerivRecords[ip]->data();
+      const Return_t* HD=HDerivRecords[ip]->data();
+      //coefficients of d and h of each sample for each vector
+      Matrix<Return_t> PD(nw,m), PH(nw,m), CdL(nw,m), ChL(nw,m), CdR(nw,m), ChR(nw,m);
+      BLAS::gemm('T','N',m,nw,np,1.0,X.data()+1,n,D,np,0.0,PD.data(),m);
+      BLAS::gemm('T','N',m,nw,np,1.0,X.data()+1,n,HD,np,0.0,PH.data(),m);
+      std::vector<Return_t> sumL(m,0.0), sumR(m,0.0);
+      for (int iw=0; iw<nw; iw++)
+      {
+        const Return_t* restrict saved = (*RecordsOnNode[ip])[iw];
+        Return_t weight=saved[REWEIGHT]*wgtinv;
+        Return_t eloc=saved[ENERGY_NEW];
+        for (int k=0; k<m; k++)
         {
-          //                Hamiltonian
-          Left(pm+1,pm2+1) += (1-b2)*wfd*(HDsaved[pm2] + (Dsaved[pm2]-D_avg[pm2])*eloc_new);
-          //                Overlap
-          RealType ovlij=wfd*(Dsaved[pm2]-D_avg[pm2]);
-          Right(pm+1,pm2+1) += ovlij;
-          //                Variance
-          RealType varij=weight*(HDsaved[pm] - 2.0*(Dsaved[pm]-D_avg[pm])*eloc_new)*(HDsaved[pm2] - 2.0*(Dsaved[pm2]-D_avg[pm2])*eloc_new);
-          //                  RealType varij=weight*(HDsaved[pm] +(Dsaved[pm]-D_avg[pm])*eloc_new-curAvg_w)*
-          //                                      (HDsaved[pm2] + (Dsaved[pm2]-D_avg[pm2])*eloc_new-curAvg_w);
-          Left(pm+1,pm2+1) +=  b2*(varij+V_avg*ovlij);
-//                H2
-          Right(pm+1,pm2+1) += b1*H2_avg*varij;
+          Return_t x0=X(k,0);
+          Return_t a=PD(iw,k)-dx[k];
+          Return_t hd=PH(iw,k);
+          Return_t c=hd-2.0*a*eloc;
+          Return_t vterm=hd*(eloc-E_avg)+a*eloc*(eloc-2.0*E_avg);
+          myLX(k,0)+=weight*(b2*vterm+(1-b2)*(hd+a*eloc));
+          myRX(k,0)+=weight*b1H2*vterm;
+          CdL(iw,k)=weight*(x0*(b2*eloc*(eloc-2.0*E_avg)+(1-b2)*eloc)+(1-b2)*(hd+a*eloc)+b2*(V_avg*a-2.0*eloc*c));
+          ChL(iw,k)=weight*b2*(x0*(eloc-E_avg)+c);
+          CdR(iw,k)=weight*(x0*b1H2*eloc*(eloc-2.0*E_avg)+a-2.0*b1H2*eloc*c);
+          ChR(iw,k)=weight*b1H2*(x0*(eloc-E_avg)+c);
+          sumL[k]+=CdL(iw,k);
+          sumR[k]+=CdR(iw,k);
         }
       }
+      BLAS::gemm('N','T',np,m,nw,1.0,D,np,CdL.data(),m,1.0,myLX.data()+1,n);
+      BLAS::gemm('N','T',np,m,nw,1.0,HD,np,ChL.data(),m,1.0,myLX.data()+1,n);
+      BLAS::gemm('N','T',np,m,nw,1.0,D,np,CdR.data(),m,1.0,myRX.data()+1,n);
+      BLAS::gemm('N','T',np,m,nw,1.0,HD,np,ChR.data(),m,1.0,myRX.data()+1,n);
+      //center the derivatives
+      for (int k=0; k<m; k++)
+        for (int pm=0; pm<np; pm++)
+        {
+          myLX(k,pm+1)-=ProductDavg[pm]*sumL[k];
+          myRX(k,pm+1)-=ProductDavg[pm]*sumR[k];
+        }
     }
   }
-  myComm->allreduce(Right);
-  myComm->allreduce(Left);
-  Left(0,0) = (1-b2)*curAvg_w + b2*V_avg;
-  Right(0,0) = 1.0+b1*H2_avg*V_avg;
-  if (GEVType=="H2")
-    return H2_avg;
-
-  return 1.0;
+  LX.resize(m,n);
+  RX.resize(m,n);
+  LX=0.0;
+  RX=0.0;
+  for (int ip=0; ip<NumThreads; ip++)
+  {
+    LX+=threadLX[ip];
+    RX+=threadRX[ip];
+  }
+  myComm->allreduce(LX);
+  myComm->allreduce(RX);
+  const Return_t left00=(1-b2)*E_avg+b2*V_avg;
+  const Return_t right00=1.0+b1H2*V_avg;
+  for (int k=0; k<m; k++)
+  {
+    LX(k,0)+=left00*X(k,0);
+    RX(k,0)+=right00*X(k,0);
+  }
 }
 }
@@ -19,6 +19,7 @@
 
 #include "QMCDrivers/QMCCostFunctionBase.h"
 #include "QMCDrivers/CloneManager.h"
+#include "QMCDrivers/LinearMethodMoments.h"
 #include "QMCWaveFunctions/OrbitalSetTraits.h"
 
 namespace qmcplusplus
@@ -50,6 +51,8 @@ public:
   void resetWalkers();   
   void GradCost(std::vector<Return_t>& PGradient, const std::vector<Return_t>& PM, Return_t FiniteDiff=0);
   Return_t fillOverlapHamiltonianMatrices(Matrix<Return_t>& Left, Matrix<Return_t>& Right);
+  void setupOverlapHamiltonianProducts(std::vector<Return_t>& Ldiag, std::vector<Return_t>& Rdiag);
+  void applyOverlapHamiltonianProducts(const Matrix<Return_t>& X, Matrix<Return_t>& LX, Matrix<Return_t>& RX);
 
 protected:
   std::vector<QMCHamiltonian*> H_KE_Node;
@@ -59,11 +62,21 @@ protected:
   */
   std::vector<Matrix<Return_t>* > DerivRecords;
   std::vector<Matrix<Return_t>* > HDerivRecords;
+  ///moments of the derivatives for the linear method
+  LinearMethodMoments Moments;
+  ///mean derivatives for the matrix-free products
+  std::vector<Return_t> ProductDavg;
+  ///b1, b2, H2_avg and V_avg of fillOverlapHamiltonianMatrices for the matrix-free products
+  Return_t ProductB1, ProductB2, ProductH2, ProductV;
   Return_t CSWeight;
 
   ///vmc walkers to clean up
   std::vector<int> nVMCWalkers;
   Return_t correlatedSampling(bool needGrad=true);
+  ///set the coefficients of the matrices of the linear method
+  void getLinearMethodCoefficients(Return_t& b1, Return_t& b2, Return_t& H2_avg, Return_t& V_avg);
+  ///weighted mean of the stored derivatives over all the tasks
+  void getDerivativeAverages(std::vector<Return_t>& D_avg);
 
     #ifdef HAVE_LMY_ENGINE
   int total_samples();
@@ -67,6 +67,10 @@ QMCDriver::QMCDriver(MCWalkerConfiguration& w, TrialWaveFunction& psi, QMCHamilt
   RollBackBlocks=0;
   m_param.add(RollBackBlocks,"rewind","int");
   Period4CheckPoint=-1;
+  AsyncCheckpoint="no";
+  m_param.add(AsyncCheckpoint,"async_checkpoint","string");
+  AsyncReduction="no";
+  m_param.add(AsyncReduction,"async_reduction","string");
   storeConfigs=0;
   //m_param.add(storeConfigs,"storeConfigs","int");
   m_param.add( storeConfigs,"storeconfigs","int");
@@ -136,8 +140,8 @@ QMCDriver::QMCDriver(MCWalkerConfiguration& w, TrialWaveFunction& psi, QMCHamilt
   // cpu mixed precision
   nBlocksBetweenRecompute = 1;
 #else
-  // cpu double precision
-  nBlocksBetweenRecompute = 0;
+  // cpu double precision, recompute if the orbitals are in single precision
+  nBlocksBetweenRecompute = qmc_common.use_single_spo? 1:0;
 #endif
 #endif
   m_param.add(nBlocksBetweenRecompute,"blocks_between_recompute","int");
@@ -211,8 +215,10 @@ void QMCDriver::process(xmlNodePtr cur)
 #endif
   branchEngine->put(cur);
   Estimators->put(W,H,cur);
+  Estimators->setAsyncReduction(AsyncReduction=="yes");
   if(wOut==0)
     wOut = new HDFWalkerOutput(W,RootName,myComm);
+  wOut->setAsync(AsyncCheckpoint=="yes");
   branchEngine->start(RootName);
   branchEngine->write(RootName);
   //use new random seeds
@@ -443,7 +449,9 @@ void QMCDriver::recordBlock(int block)
       wOut->dump(W, block);
     }
     branchEngine->write(RootName,true); //save energy_history
-    RandomNumberControl::write(RootName,myComm);
+    //the background dump writes the random states after the walkers of the same block
+    if(!(ADIOS::useHDF5() && wOut->isAsync()))
+      RandomNumberControl::write(RootName,myComm);
   }
 }
 
@@ -521,6 +529,8 @@ void QMCDriver::setWalkerOffsets()
     W[iw]->ID       = id;
     W[iw]->ParentID = id;
   }
+  //the walkers created by the branching take the IDs above the numbered ones
+  W.resetWalkerIDs(nwoff[myComm->size()]);
   app_log() << "  Total number of walkers: " << W.EnsembleProperty.NumSamples  <<  std::endl;
   app_log() << "  Total weight: " << W.EnsembleProperty.Weight  <<  std::endl;
 }
@@ -601,6 +611,8 @@ bool QMCDriver::putQMCInfo(xmlNodePtr cur)
     Period4CheckPoint=nBlocks;
   //reset CurrentStep to zero if qmc/@continue='no'
   if(!AppendRun) CurrentStep=0;
+  if(nBlocksBetweenRecompute)
+    app_log() << "  Recompute the wavefunction from scratch every " << nBlocksBetweenRecompute << " blocks" << std::endl;
 
   //if walkers are initialized via <mcwalkerset/>, use the existing one
   if(qmc_common.qmc_counter || qmc_common.is_restart)
@@ -247,6 +247,10 @@ protected:
    * The unit is a block.
    */
   int Period4CheckPoint;
+  ///if yes, the configurations are written by a helper thread of HDFWalkerOutput
+  std::string AsyncCheckpoint;
+  ///if yes, the reduction of the block averages overlaps with the next block
+  std::string AsyncReduction;
   /** period of dumping walker positions and IDs for Forward Walking
   *
   * The unit is in steps.
@@ -66,7 +66,7 @@ vdeps(1,std::vector<double>()),
   stabilizerScale(2.0), bigChange(50), w_beta(0.0),  MinMethod("quartic"), GEVtype("mixed"),
   StabilizerMethod("best"), GEVSplit("no"), stepsize(0.25), doAdaptiveThreeShift(false),
   targetExcitedStr("no"), targetExcited(false), block_lmStr("no"), block_lm(false),
-  bestShift_i(-1.0), bestShift_s(-1.0), shift_i_input(0.01), shift_s_input(1.00), doOneShiftOnly(false),
+  bestShift_i(-1.0), bestShift_s(-1.0), shift_i_input(0.01), shift_s_input(1.00), doOneShiftOnly(false), doDavidson(false),
   num_shifts(3), nblocks(1), nolds(1), nkept(1), nsamp_comp(0), omega_shift(0.0), max_param_change(0.3),
   max_relative_cost_change(10.0), block_first(true), block_second(false), block_third(false)
 {
@@ -95,6 +95,9 @@ vdeps(1,std::vector<double>()),
   m_param.add(shift_i_input, "shift_i", "double");
   m_param.add(shift_s_input, "shift_s", "double");
   m_param.add(num_shifts, "num_shifts", "int");
+  m_param.add(Davidson.MaxIterations, "davidson_max_its", "int");
+  m_param.add(Davidson.MaxSubspace, "davidson_subspace", "int");
+  m_param.add(Davidson.Tolerance, "davidson_tol", "double");
 
   #ifdef HAVE_LMY_ENGINE
   //app_log() << "construct QMCFixedSampleLinearOptimize" << endl;
@@ -421,7 +424,8 @@ QMCFixedSampleLinearOptimize::put(xmlNodePtr q)
 
   // get whether to use the adaptive three-shift version of the update
   doAdaptiveThreeShift = ( MinMethod == "adaptive" );
-  doOneShiftOnly = ( MinMethod == "OneShiftOnly" );
+  doDavidson = ( MinMethod == "davidson" );
+  doOneShiftOnly = ( MinMethod == "OneShiftOnly" || doDavidson );
 
   // sanity check
   if ( targetExcited && !doAdaptiveThreeShift )
@@ -1076,53 +1080,62 @@ bool QMCFixedSampleLinearOptimize::one_shift_run() {
   // have the cost function prepare derivative vectors for the matrix build and compute the initial cost
   const RealType initCost = optTarget->Cost(true);
 
-  // say what we are doing
-  app_log() << std::endl
-            << "*****************************************" << std::endl
-            << "Building overlap and Hamiltonian matrices" << std::endl
-            << "*****************************************" << std::endl;
+  RealType lowestEV(0.0);
+  if ( doDavidson )
+  {
+    // solve without building the matrices, also sets Lambda
+    lowestEV = davidson_solve(parameterDirections);
+  }
+  else
+  {
+    // say what we are doing
+    app_log() << std::endl
+              << "*****************************************" << std::endl
+              << "Building overlap and Hamiltonian matrices" << std::endl
+              << "*****************************************" << std::endl;
 
-  // allocate the matrices we will need
-  Matrix<RealType> ovlMat(N,N); ovlMat = 0.0;
-  Matrix<RealType> hamMat(N,N); hamMat = 0.0;
-  Matrix<RealType> invMat(N,N); invMat = 0.0;
-  Matrix<RealType> prdMat(N,N); prdMat = 0.0;
+    // allocate the matrices we will need
+    Matrix<RealType> ovlMat(N,N); ovlMat = 0.0;
+    Matrix<RealType> hamMat(N,N); hamMat = 0.0;
+    Matrix<RealType> invMat(N,N); invMat = 0.0;
+    Matrix<RealType> prdMat(N,N); prdMat = 0.0;
 
-  // build the overlap and hamiltonian matrices
-  optTarget->fillOverlapHamiltonianMatrices(hamMat, ovlMat);
-  invMat.copy(ovlMat);
+    // build the overlap and hamiltonian matrices
+    optTarget->fillOverlapHamiltonianMatrices(hamMat, ovlMat);
+    invMat.copy(ovlMat);
 
-  // prepare vector to hold largest parameter change for each shift
-  RealType max_change(0.0);
+    // prepare vector to hold largest parameter change for each shift
+    RealType max_change(0.0);
 
-  // apply the identity shift
-  for (int i=1; i<N; i++)
-  {
-    hamMat(i,i) += bestShift_i;
-    if(invMat(i,i)==0) invMat(i,i) = bestShift_i*bestShift_s;
-  }
+    // apply the identity shift
+    for (int i=1; i<N; i++)
+    {
+      hamMat(i,i) += bestShift_i;
+      if(invMat(i,i)==0) invMat(i,i) = bestShift_i*bestShift_s;
+    }
 
-  // compute the inverse of the overlap matrix
-  invert_matrix(invMat, false);
+    // compute the inverse of the overlap matrix
+    invert_matrix(invMat, false);
 
-  // apply the overlap shift
-  for (int i=1; i<N; i++)
-    for (int j=1; j<N; j++)
-      hamMat(i,j) += bestShift_s * ovlMat(i,j);
+    // apply the overlap shift
+    for (int i=1; i<N; i++)
+      for (int j=1; j<N; j++)
+        hamMat(i,j) += bestShift_s * ovlMat(i,j);
 
-  // multiply the shifted hamiltonian matrix by the inverse of the overlap matrix
-  qmcplusplus::MatrixOperators::product(invMat, hamMat, prdMat);
+    // multiply the shifted hamiltonian matrix by the inverse of the overlap matrix
+    qmcplusplus::MatrixOperators::product(invMat, hamMat, prdMat);
 
-  // transpose the result (why?)
-  for (int i=0; i<N; i++)
-    for (int j=i+1; j<N; j++)
-      std::swap(prdMat(i,j), prdMat(j,i));
+    // transpose the result (why?)
+    for (int i=0; i<N; i++)
+      for (int j=i+1; j<N; j++)
+        std::swap(prdMat(i,j), prdMat(j,i));
 
-  // compute the lowest eigenvalue of the product matrix and the corresponding eigenvector
-  const RealType lowestEV = getLowestEigenvector(prdMat, parameterDirections);
+    // compute the lowest eigenvalue of the product matrix and the corresponding eigenvector
+    lowestEV = getLowestEigenvector(prdMat, parameterDirections);
 
-  // compute the scaling constant to apply to the update
-  Lambda = getNonLinearRescale(parameterDirections, ovlMat);
+    // compute the scaling constant to apply to the update
+    Lambda = getNonLinearRescale(parameterDirections, ovlMat);
+  }
 
   // scale the update by the scaling constant
   for (int i=0; i<numParams; i++)
@@ -1185,4 +1198,86 @@ bool QMCFixedSampleLinearOptimize::one_shift_run() {
 
 }
 
+/// products with the matrices of one_shift_run including the identity and overlap shifts
+struct ShiftedOverlapHamiltonianProducts: public LinearMethodDavidson::MatrixProducts
+{
+  typedef QMCTraits::RealType RealType;
+  QMCCostFunctionBase& optTarget;
+  RealType shift_i, shift_s;
+  /// first column of the overlap matrix, not included in the overlap shift
+  std::vector<RealType> ovlCol0;
+  /// true if the diagonal of the overlap matrix is zero
+  std::vector<bool> zeroDiag;
+
+  ShiftedOverlapHamiltonianProducts(QMCCostFunctionBase& target, RealType si, RealType ss, const std::vector<RealType>& ovlDiag)
+    : optTarget(target), shift_i(si), shift_s(ss), zeroDiag(ovlDiag.size())
+  {
+    const int N=ovlDiag.size();
+    for (int i=0; i<N; i++)
+      zeroDiag[i]=(ovlDiag[i]==0);
+    Matrix<RealType> X(1,N), LX(1,N), RX(1,N);
+    X=0.0;
+    X(0,0)=1.0;
+    optTarget.applyOverlapHamiltonianProducts(X,LX,RX);
+    ovlCol0.assign(RX[0],RX[0]+N);
+  }
+
+  void apply(const Matrix<RealType>& X, Matrix<RealType>& LX, Matrix<RealType>& RX)
+  {
+    optTarget.applyOverlapHamiltonianProducts(X,LX,RX);
+    for (int k=0; k<X.rows(); k++)
+      for (int i=1; i<X.cols(); i++)
+      {
+        LX(k,i) += shift_i*X(k,i) + shift_s*(RX(k,i)-ovlCol0[i]*X(k,0));
+        if (zeroDiag[i])
+          RX(k,i) += shift_i*shift_s*X(k,i);
+      }
+  }
+};
+
+QMCFixedSampleLinearOptimize::RealType QMCFixedSampleLinearOptimize::davidson_solve(std::vector<RealType> & parameterDirections)
+{
+  // say what we are doing
+  app_log() << std::endl
+            << "*********************************************************" << std::endl
+            << "Solving the linear method eigenproblem by Davidson method" << std::endl
+            << "*********************************************************" << std::endl;
+
+  // diagonals of the matrices for the preconditioner
+  std::vector<RealType> hamDiag, ovlDiag;
+  optTarget->setupOverlapHamiltonianProducts(hamDiag, ovlDiag);
+  ShiftedOverlapHamiltonianProducts products(*optTarget, bestShift_i, bestShift_s, ovlDiag);
+
+  // apply the shifts to the diagonals as one_shift_run does to the matrices
+  std::vector<RealType> shiftedHamDiag(hamDiag), shiftedOvlDiag(ovlDiag);
+  for (int i=1; i<N; i++)
+  {
+    shiftedHamDiag[i] += bestShift_i + bestShift_s*ovlDiag[i];
+    if (ovlDiag[i]==0) shiftedOvlDiag[i] = bestShift_i*bestShift_s;
+  }
+
+  const RealType lowestEV = Davidson.solve(products, shiftedHamDiag, shiftedOvlDiag, parameterDirections);
+  app_log() << "  Davidson " << (Davidson.converged()?"converged":"did not converge") << " in "
+            << Davidson.iterations() << " iterations, residual = " << Davidson.residual()
+            << ", eigenvalue = " << lowestEV << std::endl;
+
+  // norm of the non-linear part of the update in the overlap metric for the rescaling
+  int first(0),last(0);
+  getNonLinearRange(first,last);
+  Lambda = 1.0;
+  if (first!=last)
+  {
+    Matrix<RealType> X(1,N), LX(1,N), RX(1,N);
+    X=0.0;
+    for (int i=first; i<last; i++)
+      X(0,i+1) = parameterDirections[i+1];
+    optTarget->applyOverlapHamiltonianProducts(X,LX,RX);
+    RealType D(0.0);
+    for (int i=first; i<last; i++)
+      D += X(0,i+1)*RX(0,i+1);
+    Lambda = getNonLinearRescale(D);
+  }
+  return lowestEV;
+}
+
 }
@@ -20,6 +20,7 @@
 #define QMCPLUSPLUS_QMCFSLINEAROPTIMIZATION_VMCSINGLE_H
 
 #include "QMCDrivers/QMCLinearOptimize.h"
+#include "QMCDrivers/LinearMethodDavidson.h"
 #include "Optimize/NRCOptimization.h"
 #ifdef HAVE_LMY_ENGINE
 #include "formic/utils/matrix.h"
@@ -69,6 +70,9 @@ private:
   // perform the single-shift update, no sample regeneration
   bool one_shift_run();
 
+  // solve the single-shift eigenproblem with the matrix-free Davidson solver and rescale the update
+  RealType davidson_solve(std::vector<RealType> & parameterDirections);
+
   void solveShiftsWithoutLMYEngine(const std::vector<double> & shifts_i,
                                    const std::vector<double> & shiffts_s,
                                    std::vector<std::vector<RealType> > & parameterDirections);
@@ -104,6 +108,10 @@ private:
   bool doAdaptiveThreeShift;
   /// whether to use the single-shift scheme
   bool doOneShiftOnly;
+  /// whether to solve the single-shift scheme with the Davidson solver
+  bool doDavidson;
+  /// matrix-free eigensolver
+  LinearMethodDavidson Davidson;
   /// the previous best identity shift
   RealType bestShift_i;
   /// the previous best overlap shift
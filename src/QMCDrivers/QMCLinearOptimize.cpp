@@ -577,12 +577,17 @@ QMCLinearOptimize::RealType QMCLinearOptimize::getNonLinearRescale(std::vector<R
   getNonLinearRange(first,last);
   if (first==last)
     return 1.0;
-  RealType rescale(1.0);
-  RealType xi(0.5);
   RealType D(0.0);
   for (int i=first; i<last; i++)
     for (int j=first; j<last; j++)
       D += S(i+1,j+1)*dP[i+1]*dP[j+1];
+  return getNonLinearRescale(D);
+}
+
+QMCLinearOptimize::RealType QMCLinearOptimize::getNonLinearRescale(RealType D)
+{
+  RealType rescale(1.0);
+  RealType xi(0.5);
   rescale = (1-xi)*D/((1-xi) + xi*std::sqrt(1+D));
   rescale = 1.0/(1.0-rescale);
 //     app_log()<<"rescale: "<<rescale<< std::endl;
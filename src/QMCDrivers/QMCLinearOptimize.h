@@ -183,6 +183,8 @@ public:
   void orthoScale(std::vector<RealType>& dP, Matrix<RealType>& S);
   bool nonLinearRescale( std::vector<RealType>& dP, Matrix<RealType>& S);
   RealType getNonLinearRescale( std::vector<RealType>& dP, Matrix<RealType>& S);
+  ///rescale from the norm D of the non-linear update in the overlap metric
+  RealType getNonLinearRescale(RealType D);
   void generateSamples();
   void add_timers(std::vector<NewTimer*>& timers);
   std::vector<NewTimer*> myTimers;
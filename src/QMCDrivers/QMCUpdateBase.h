@@ -131,6 +131,30 @@ public:
     W.current_step = step;
   }
 
+  /** set the step of a warmup step
+   *
+   * The warmup steps count down from -1 so that their walker streams
+   * differ from those of the steps of the run.
+   */
+  inline void set_warmup_step(int prestep)
+  {
+    W.current_step = -1-prestep;
+  }
+
+  /** select the random stream of a walker at the current step
+   *
+   * With the counter-based generator, the random numbers of a walker depend
+   * on the seed, the walker ID, the step and the QMC section only.
+   * The drivers set a distinct step for every move of the walkers, including
+   * the sub-steps between the branches and the warmup steps.
+   */
+  inline void setWalkerStream(const Walker_t& awalker)
+  {
+#if defined(QMC_RNG_PHILOX)
+    RandomGen.set_stream(awalker.ID,W.current_step,branchEngine->iParam[SimpleFixedNodeBranch::B_COUNTER]);
+#endif
+  }
+
 
 
   ///** start a run */
@@ -582,7 +582,10 @@ void VMCLinearOptOMP::resetRun()
 //       if (UseDrift != "rn")
 //       {
     for (int prestep=0; prestep<nWarmupSteps; ++prestep)
+    {
+      Movers[ip]->set_warmup_step(prestep);
       Movers[ip]->advanceWalkers(W.begin()+wPerNode[ip],W.begin()+wPerNode[ip+1],true);
+    }
     if (nWarmupSteps && QMCDriverMode[QMC_UPDATE_MODE])
       Movers[ip]->updateWalkers(W.begin()+wPerNode[ip],W.begin()+wPerNode[ip+1]);
     #pragma omp critical
@@ -24,6 +24,7 @@
 #include "OhmmsApp/RandomNumberControl.h"
 #include "Message/OpenMP.h"
 #include "Message/CommOperators.h"
+#include "Utilities/NewTimer.h"
 #include "tau/profiler.h"
 #include <qmc_common.h>
 //#define ENABLE_VMC_OMP_MASTER
@@ -50,6 +51,8 @@ VMCSingleOMP::VMCSingleOMP(MCWalkerConfiguration& w, TrialWaveFunction& psi, QMC
   m_param.add(UseDrift,"useDrift","string");
   m_param.add(UseDrift,"usedrift","string");
   m_param.add(UseDrift,"use_drift","string");
+  m_param.add(ChunksPerThread,"chunks_per_thread","int");
+  m_param.add(CrowdSize,"crowd_size","int");
 
   prevSteps=nSteps;
   prevStepsBetweenSamples=nStepsBetweenSamples;
@@ -66,38 +69,32 @@ bool VMCSingleOMP::run()
   Traces->startRun(nBlocks,traceClones);
 #endif
   const bool has_collectables=W.Collectables.size();
+  //the collectables are normalized and the samples are stored per thread
+  wChunks.setup(Rng,(has_collectables||nSamplesPerThread)?0:ChunksPerThread);
+  wChunks.resetIdle();
   for (int block=0; block<nBlocks; ++block)
   {
+    TimerManager.advance_timeline(nSteps);
+    wChunks.partition(W.getActiveWalkers());
+    wChunks.startRegion();
     #pragma omp parallel
     {
       int ip=omp_get_thread_num();
-      //IndexType updatePeriod=(QMCDriverMode[QMC_UPDATE_MODE])?Period4CheckProperties:(nBlocks+1)*nSteps;
-      IndexType updatePeriod=(QMCDriverMode[QMC_UPDATE_MODE])?Period4CheckProperties:0;
-      //assign the iterators and resuse them
-      MCWalkerConfiguration::iterator wit(W.begin()+wPerNode[ip]), wit_end(W.begin()+wPerNode[ip+1]);
       Movers[ip]->startBlock(nSteps);
-      int now_loc=CurrentStep;
-      RealType cnorm=1.0/static_cast<RealType>(wPerNode[ip+1]-wPerNode[ip]);
-      for (int step=0; step<nSteps; ++step)
+      if(wChunks.enabled())
       {
-        Movers[ip]->set_step(now_loc);
-        //collectables are reset, it is accumulated while advancing walkers
-        wClones[ip]->resetCollectables();
-        Movers[ip]->advanceWalkers(wit,wit_end,false);
-        if(has_collectables)
-          wClones[ip]->Collectables *= cnorm;
-        Movers[ip]->accumulate(wit,wit_end);
-        ++now_loc;
-        //if (updatePeriod&& now_loc%updatePeriod==0) Movers[ip]->updateWalkers(wit,wit_end);
-        if (Period4WalkerDump&& now_loc%Period4WalkerDump==0)
-          wClones[ip]->saveEnsemble(wit,wit_end);
-//           if(storeConfigs && (now_loc%storeConfigs == 0))
-//             ForwardWalkingHistory.storeConfigsForForwardWalking(*wClones[ip]);
+        for(int ic=wChunks.next(ip); ic>=0; ic=wChunks.next(ip))
+        {
+          advanceBlock(ip,W.begin()+wChunks.first(ic),W.begin()+wChunks.last(ic),block,has_collectables);
+          wChunks.release(ip,ic);
+        }
       }
-      if ( nBlocksBetweenRecompute && (1+block)%nBlocksBetweenRecompute == 0 && QMCDriverMode[QMC_UPDATE_MODE] )
-        Movers[ip]->recomputePsi(wit,wit_end);
+      else
+        advanceBlock(ip,W.begin()+wPerNode[ip],W.begin()+wPerNode[ip+1],block,has_collectables);
       Movers[ip]->stopBlock(false);
+      wChunks.stopThread(ip);
     }//end-of-parallel for
+    wChunks.stopRegion();
     //Estimators->accumulateCollectables(wClones,nSteps);
     CurrentStep+=nSteps;
     Estimators->stopBlock(estimatorClones);
@@ -114,6 +111,8 @@ bool VMCSingleOMP::run()
   Traces->stopRun();
 #endif
   //copy back the random states
+  wChunks.finalize();
+  reportIdle();
   for (int ip=0; ip<NumThreads; ++ip)
     *(RandomNumberControl::Children[ip])=*(Rng[ip]);
   ///write samples to a file
@@ -128,6 +127,31 @@ bool VMCSingleOMP::run()
   return finalize(nBlocks,!wrotesamples);
 }
 
+void VMCSingleOMP::advanceBlock(int ip, MCWalkerConfiguration::iterator wit, MCWalkerConfiguration::iterator wit_end,
+                                int block, bool has_collectables)
+{
+  int now_loc=CurrentStep;
+  RealType cnorm=1.0/static_cast<RealType>(wit_end-wit);
+  for (int step=0; step<nSteps; ++step)
+  {
+    Movers[ip]->set_step(now_loc);
+    //collectables are reset, it is accumulated while advancing walkers
+    wClones[ip]->resetCollectables();
+    Movers[ip]->advanceWalkers(wit,wit_end,false);
+    if(has_collectables)
+      wClones[ip]->Collectables *= cnorm;
+    Movers[ip]->accumulate(wit,wit_end);
+    ++now_loc;
+    //if (updatePeriod&& now_loc%updatePeriod==0) Movers[ip]->updateWalkers(wit,wit_end);
+    if (Period4WalkerDump&& now_loc%Period4WalkerDump==0)
+      wClones[ip]->saveEnsemble(wit,wit_end);
+//           if(storeConfigs && (now_loc%storeConfigs == 0))
+//             ForwardWalkingHistory.storeConfigsForForwardWalking(*wClones[ip]);
+  }
+  if ( nBlocksBetweenRecompute && (1+block)%nBlocksBetweenRecompute == 0 && QMCDriverMode[QMC_UPDATE_MODE] )
+    Movers[ip]->recomputePsi(wit,wit_end);
+}
+
 void VMCSingleOMP::resetRun()
 {
   ////only VMC can overwrite this
@@ -148,6 +172,12 @@ void VMCSingleOMP::resetRun()
     estimatorClones.resize(NumThreads,0);
     traceClones.resize(NumThreads,0);
     Rng.resize(NumThreads,0);
+    bool use_crowds=CrowdSize>1 && QMCDriverMode[QMC_UPDATE_MODE] && !W.Collectables.size();
+#if !defined(REMOVE_TRACEMANAGER)
+    use_crowds = use_crowds && !Traces->streaming_traces;
+#endif
+    if(CrowdSize>1 && !use_crowds)
+      app_log() << "  crowd_size is ignored, it requires particle-by-particle moves, no collectables and no traces" << std::endl;
 #if !defined(BGP_BUG)
     #pragma omp parallel for
 #endif
@@ -186,7 +216,12 @@ void VMCSingleOMP::resetRun()
         //               // Movers[ip]=new VMCUpdatePbyPWithDrift(*wClones[ip],*psiClones[ip],*hClones[ip],*Rng[ip]);
         //             }
         //             else
-        if (UseDrift == "yes")
+        if (use_crowds)
+        {
+          os <<"  PbyP moves of crowds of " << CrowdSize << " walkers, using VMCUpdatePbyPCrowd"<< std::endl;
+          Movers[ip]=new VMCUpdatePbyPCrowd(*wClones[ip],*psiClones[ip],*hClones[ip],*Rng[ip],CrowdSize,UseDrift == "yes");
+        }
+        else if (UseDrift == "yes")
         {
           os <<"  PbyP moves with drift, using VMCUpdatePbyPWithDriftFast"<< std::endl;
           Movers[ip]=new VMCUpdatePbyPWithDriftFast(*wClones[ip],*psiClones[ip],*hClones[ip],*Rng[ip]);
@@ -260,7 +295,10 @@ void VMCSingleOMP::resetRun()
 //       if (UseDrift != "rn")
 //       {
     for (int prestep=0; prestep<nWarmupSteps; ++prestep)
+    {
+      Movers[ip]->set_warmup_step(prestep);
       Movers[ip]->advanceWalkers(W.begin()+wPerNode[ip],W.begin()+wPerNode[ip+1],true);
+    }
     if (nWarmupSteps && QMCDriverMode[QMC_UPDATE_MODE])
       Movers[ip]->updateWalkers(W.begin()+wPerNode[ip],W.begin()+wPerNode[ip+1]);
 //       }
@@ -43,6 +43,9 @@ private:
   std::string UseDrift;
   ///check the run-time environments
   void resetRun();
+  ///advance the walkers [wit,wit_end) by a block on the thread ip
+  void advanceBlock(int ip, MCWalkerConfiguration::iterator wit, MCWalkerConfiguration::iterator wit_end,
+                    int block, bool has_collectables);
   ///copy constructor
   VMCSingleOMP(const VMCSingleOMP& a): QMCDriver(a),CloneManager(a) { }
   /// Copy operator (disabled).
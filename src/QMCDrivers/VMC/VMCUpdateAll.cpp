@@ -38,6 +38,7 @@ void VMCUpdateAll::advanceWalkers(WalkerIter_t it, WalkerIter_t it_end, bool mea
   for (; it!= it_end; ++it)
   {
     MCWalkerConfiguration::Walker_t& thisWalker(**it);
+    setWalkerStream(thisWalker);
     makeGaussRandomWithEngine(deltaR,RandomGen);
     //if (!W.makeMove(thisWalker,deltaR, m_sqrttau))
     if (!W.makeMove(thisWalker,deltaR,SqrtTauOverMass))
@@ -190,6 +191,7 @@ void VMCUpdateAllWithDrift::advanceWalkers(WalkerIter_t it, WalkerIter_t it_end,
   for (; it != it_end; ++it)
   {
     MCWalkerConfiguration::Walker_t& thisWalker(**it);
+    setWalkerStream(thisWalker);
     W.loadWalker(thisWalker,false);
   //  RealType nodecorr=setScaledDriftPbyPandNodeCorr(Tau,MassInvP,W.G,drift);
     assignDrift(Tau,MassInvP,W.G,drift);
@@ -58,6 +58,7 @@ void VMCUpdatePbyP::advanceWalkers(WalkerIter_t it, WalkerIter_t it_end, bool me
   for (; it != it_end; ++it)
   {
     Walker_t& thisWalker(**it);
+    setWalkerStream(thisWalker);
     W.loadWalker(thisWalker,true);
     Walker_t::Buffer_t& w_buffer(thisWalker.DataSet);
     Psi.copyFromBuffer(W,w_buffer);
@@ -402,6 +403,7 @@ void VMCUpdatePbyPWithDrift::advanceWalkers(WalkerIter_t it, WalkerIter_t it_end
   for (; it != it_end; ++it)
   {
     Walker_t& thisWalker(**it);
+    setWalkerStream(thisWalker);
     W.loadWalker(thisWalker,true);
     Walker_t::Buffer_t& w_buffer(thisWalker.DataSet);
     Psi.copyFromBuffer(W,thisWalker.DataSet);
@@ -643,6 +645,7 @@ void VMCUpdatePbyPWithDriftFast::advanceWalkers(WalkerIter_t it, WalkerIter_t it
   for (; it != it_end; ++it)
   {
     Walker_t& thisWalker(**it);
+    setWalkerStream(thisWalker);
     Walker_t::Buffer_t& w_buffer(thisWalker.DataSet);
     W.loadWalker(thisWalker,true);
     //W.R = thisWalker.R;
@@ -750,6 +753,7 @@ void VMCUpdateRenyiWithDriftFast::advanceWalkers(WalkerIter_t it, WalkerIter_t i
   for (; it != it_end; ++it)
   {
     Walker_t& thisWalker(**it);
+    setWalkerStream(thisWalker);
     Walker_t::Buffer_t& w_buffer(thisWalker.DataSet);
     W.loadWalker(thisWalker,true);
     Psi.copyFromBuffer(W,w_buffer);
@@ -18,6 +18,7 @@
 #ifndef QMCPLUSPLUS_VMC_PARTICLEBYPARTICLE_UPDATE_H
 #define QMCPLUSPLUS_VMC_PARTICLEBYPARTICLE_UPDATE_H
 #include "QMCDrivers/QMCUpdateBase.h"
+#include "QMCDrivers/WalkerCrowd.h"
 
 namespace qmcplusplus
 {
@@ -108,6 +109,31 @@ private:
   std::vector<NewTimer*> myTimers;
 };
 
+/** @ingroup QMCDrivers  ParticleByParticle
+ *@brief Implements the VMC algorithm moving the particles of a crowd of walkers in lockstep.
+ *
+ * Each particle of crowd_size walkers is moved before the next one and the
+ * ratios are evaluated by TrialWaveFunction::mw_ratioGrad for the crowd.
+ */
+class VMCUpdatePbyPCrowd: public QMCUpdateBase
+{
+public:
+  /// Constructor.
+  VMCUpdatePbyPCrowd(MCWalkerConfiguration& w, TrialWaveFunction& psi,
+                     QMCHamiltonian& h, RandomGenerator_t& rg, int crowd_size, bool use_drift);
+
+  ~VMCUpdatePbyPCrowd();
+
+  void advanceWalkers(WalkerIter_t it, WalkerIter_t it_end, bool measure);
+
+private:
+  ///use the drift in the proposed moves
+  bool UseDrift;
+  ///copies of W, Psi and H for the walkers of a crowd
+  WalkerCrowd Crowd;
+  std::vector<NewTimer*> myTimers;
+};
+
 
 /** @ingroup QMCDrivers  ParticleByParticle
 *@brief Implements the VMC algorithm using particle-by-particle move. Samples |Psi| to increase number of walkers near nodes.
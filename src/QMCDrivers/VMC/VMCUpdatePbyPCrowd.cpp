@@ -0,0 +1,164 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "QMCDrivers/VMC/VMCUpdatePbyP.h"
+#include "QMCDrivers/DriftOperators.h"
+
+namespace qmcplusplus
+{
+
+/// Constructor
+VMCUpdatePbyPCrowd::VMCUpdatePbyPCrowd(MCWalkerConfiguration& w, TrialWaveFunction& psi,
+                                       QMCHamiltonian& h, RandomGenerator_t& rg, int crowd_size, bool use_drift):
+  QMCUpdateBase(w,psi,h,rg), UseDrift(use_drift), Crowd(w,psi,h,crowd_size)
+{
+  myTimers.push_back(new NewTimer("VMCUpdatePbyPCrowd::advance",timer_level_medium)); //timer for the walker loop
+  myTimers.push_back(new NewTimer("VMCUpdatePbyPCrowd::movePbyP",timer_level_medium)); //timer for MC, ratio etc
+  myTimers.push_back(new NewTimer("VMCUpdatePbyPCrowd::updateMBO",timer_level_medium)); //timer for measurements
+  myTimers.push_back(new NewTimer("VMCUpdatePbyPCrowd::energy",timer_level_medium)); //timer for measurements
+  for (int i=0; i<myTimers.size(); ++i)
+    TimerManager.addTimer(myTimers[i]);
+}
+
+VMCUpdatePbyPCrowd::~VMCUpdatePbyPCrowd()
+{
+}
+
+/** advance the walkers crowd by crowd
+ *
+ * The acceptance is the same as VMCUpdatePbyPWithDriftFast with the drift and
+ * VMCUpdatePbyP without it. The random numbers of a walker are drawn from its
+ * stream before the particles of the crowd are moved. The hamiltonian of a
+ * walker draws from its stream where the moves left it.
+ */
+void VMCUpdatePbyPCrowd::advanceWalkers(WalkerIter_t it, WalkerIter_t it_end, bool measure)
+{
+  myTimers[0]->start();
+  const int nat=W.getTotalNum();
+  std::vector<int> moved(Crowd.size());
+  while(it != it_end)
+  {
+    const int nw=std::min(static_cast<int>(it_end-it),Crowd.size());
+    for (int k=0; k<nw; ++k)
+    {
+      Walker_t& thisWalker(**(it+k));
+      setWalkerStream(thisWalker);
+      Crowd.drawRandom(k,RandomGen,nSubSteps*nat,nSubSteps*nat);
+      Crowd.loadWalker(k,thisWalker,W.current_step);
+    }
+    myTimers[1]->start();
+    for (int iter=0; iter<nSubSteps; ++iter)
+    {
+      const int offset=iter*nat;
+      std::fill(moved.begin(),moved.end(),0);
+      for(int ig=0; ig<W.groups(); ++ig) //loop over species
+      {
+        RealType tauovermass = Tau*MassInvS[ig];
+        RealType oneover2tau = 0.5/(tauovermass);
+        RealType sqrttau = std::sqrt(tauovermass);
+        for (int iat=W.first(ig); iat<W.last(ig); ++iat)
+        {
+          //propose the moves of iat of the crowd
+          Crowd.clearMoves();
+          for (int k=0; k<nw; ++k)
+          {
+            mPosType dr;
+            if(UseDrift)
+            {
+              GradType grad_now=Crowd.Psi_list[k]->evalGrad(*Crowd.W_list[k],iat);
+              getScaledDrift(tauovermass,grad_now,dr);
+              dr += sqrttau*Crowd.deltaR_list[k][offset+iat];
+            }
+            else
+              dr = sqrttau*Crowd.deltaR_list[k][offset+iat];
+            Crowd.propose(k,dr);
+          }
+          nReject += Crowd.makeMoves(iat);
+          Crowd.ratioGrad(iat);
+          for (int i=0; i<Crowd.Active.size(); ++i)
+          {
+            const int k=Crowd.Active[i];
+            Walker_t& thisWalker(**(it+k));
+            MCWalkerConfiguration& w_k(*Crowd.W_list[k]);
+            TrialWaveFunction& psi_k(*Crowd.Psi_list[k]);
+            RealType prob = Crowd.Ratios[i]*Crowd.Ratios[i];
+            //zero is always rejected
+            if (prob<std::numeric_limits<RealType>::epsilon())
+            {
+              ++nReject;
+              w_k.rejectMove(iat);
+              psi_k.rejectMove(iat);
+              continue;
+            }
+            if(UseDrift)
+            {
+              const PosType& delta(Crowd.deltaR_list[k][offset+iat]);
+              RealType logGf = -0.5e0*dot(delta,delta);
+              mPosType dr;
+              getScaledDrift(tauovermass,Crowd.Grads[i],dr);
+              dr = thisWalker.R[iat]-w_k.R[iat]-dr;
+              RealType logGb = -oneover2tau*dot(dr,dr);
+              prob *= std::exp(logGb-logGf);
+            }
+            if (Crowd.Uniform_list[k][offset+iat] < prob)
+            {
+              moved[k] = 1;
+              ++nAccept;
+              Crowd.accept(k);
+            }
+            else
+            {
+              ++nReject;
+              w_k.rejectMove(iat);
+              psi_k.rejectMove(iat);
+            }
+          }
+          Crowd.acceptMoves(iat);
+        }
+      }
+      //for subSteps must update the walkers
+      for (int k=0; k<nw; ++k)
+      {
+        Walker_t& thisWalker(**(it+k));
+        MCWalkerConfiguration& w_k(*Crowd.W_list[k]);
+        thisWalker.R=w_k.R;
+        thisWalker.G=w_k.G;
+        thisWalker.L=w_k.L;
+      }
+    }
+    myTimers[1]->stop();
+    for (int k=0; k<nw; ++k)
+    {
+      Walker_t& thisWalker(**(it+k));
+      MCWalkerConfiguration& w_k(*Crowd.W_list[k]);
+      TrialWaveFunction& psi_k(*Crowd.Psi_list[k]);
+      QMCHamiltonian& h_k(*Crowd.H_list[k]);
+      myTimers[2]->start();
+      RealType logpsi = psi_k.updateBuffer(w_k,thisWalker.DataSet,false);
+      w_k.saveWalker(thisWalker);
+      myTimers[2]->stop();
+      myTimers[3]->start();
+      Crowd.resumeStream(k,RandomGen);
+      EstimatorRealType eloc=h_k.evaluate(w_k);
+      myTimers[3]->stop();
+      thisWalker.resetProperty(logpsi,psi_k.getPhase(), eloc);
+      h_k.auxHevaluate(w_k,thisWalker);
+      h_k.saveProperty(thisWalker.getPropertyBase());
+      if(!moved[k])
+        ++nAllRejected;
+    }
+    it += nw;
+  }
+  myTimers[0]->stop();
+}
+
+}
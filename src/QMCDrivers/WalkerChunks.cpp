@@ -0,0 +1,130 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "QMCDrivers/WalkerChunks.h"
+#include "Utilities/UtilityFunctions.h"
+#include "Utilities/IteratorUtility.h"
+#include <algorithm>
+
+namespace qmcplusplus
+{
+
+WalkerChunks::WalkerChunks()
+  : NumThreads(1), ChunksPerThread(0), SumIdle(0.0), MaxIdle(0.0), NumRegions(0)
+{ }
+
+WalkerChunks::~WalkerChunks()
+{
+  delete_iter(ChunkRng.begin(),ChunkRng.end());
+}
+
+void WalkerChunks::setup(std::vector<RandomGenerator_t*>& rng, int nchunks)
+{
+  NumThreads=rng.size();
+  ThreadRng=rng;
+  DoneTime.resize(NumThreads);
+  delete_iter(ChunkRng.begin(),ChunkRng.end());
+  ChunkRng.clear();
+  ChunksPerThread=std::max(nchunks,0);
+  if(ChunksPerThread==0)
+    return;
+  typedef RandomGenerator_t::uint_type uint_type;
+  ChunkRng.resize(NumThreads*ChunksPerThread);
+  for(int ip=0; ip<NumThreads; ++ip)
+  {
+    ChunkRng[ip*ChunksPerThread]=new RandomGenerator_t(*rng[ip]);
+    for(int ic=ip*ChunksPerThread+1; ic<(ip+1)*ChunksPerThread; ++ic)
+    {
+      ChunkRng[ic]=new RandomGenerator_t(*rng[ip]);
+      ChunkRng[ic]->seed(static_cast<uint_type>((*rng[ip])()*4294967295.0));
+    }
+  }
+  Next.resize(NumThreads);
+}
+
+void WalkerChunks::partition(int nw)
+{
+  if(ChunksPerThread==0)
+    return;
+  FairDivideLow(nw,NumThreads*ChunksPerThread,Offsets);
+  for(int ip=0; ip<NumThreads; ++ip)
+    Next[ip]=ip*ChunksPerThread;
+}
+
+int WalkerChunks::next(int ip)
+{
+  for(int i=0; i<NumThreads; ++i)
+  {
+    //own queue first, then steal from the following threads
+    int victim=(ip+i)%NumThreads;
+    int ic;
+    #pragma omp atomic capture
+    ic=Next[victim]++;
+    if(ic<(victim+1)*ChunksPerThread)
+    {
+      *ThreadRng[ip]=*ChunkRng[ic];
+      return ic;
+    }
+  }
+  return -1;
+}
+
+void WalkerChunks::release(int ip, int ic)
+{
+  *ChunkRng[ic]=*ThreadRng[ip];
+}
+
+void WalkerChunks::finalize()
+{
+  if(ChunksPerThread==0)
+    return;
+  for(int ip=0; ip<NumThreads; ++ip)
+    *ThreadRng[ip]=*ChunkRng[ip*ChunksPerThread];
+}
+
+void WalkerChunks::startRegion()
+{
+  RegionClock.restart();
+}
+
+void WalkerChunks::stopThread(int ip)
+{
+  DoneTime[ip]=RegionClock.elapsed();
+}
+
+void WalkerChunks::stopRegion()
+{
+  double wall=RegionClock.elapsed();
+  if(wall<=0.0)
+    return;
+  double idle=0.0;
+  for(int ip=0; ip<NumThreads; ++ip)
+    idle+=wall-DoneTime[ip];
+  idle/=wall*NumThreads;
+  SumIdle+=idle;
+  MaxIdle=std::max(MaxIdle,idle);
+  NumRegions++;
+}
+
+void WalkerChunks::resetIdle()
+{
+  SumIdle=0.0;
+  MaxIdle=0.0;
+  NumRegions=0;
+}
+
+double WalkerChunks::meanIdle() const
+{
+  return (NumRegions>0)?SumIdle/NumRegions:0.0;
+}
+
+}
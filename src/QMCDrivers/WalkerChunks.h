@@ -0,0 +1,145 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file WalkerChunks.h
+ * @brief work-stealing scheduler of the walkers over the threads
+ */
+#ifndef QMCPLUSPLUS_WALKER_CHUNKS_H
+#define QMCPLUSPLUS_WALKER_CHUNKS_H
+
+#include "Configuration.h"
+#include "Utilities/RandomGenerator.h"
+#include "Utilities/Timer.h"
+#include <vector>
+
+namespace qmcplusplus
+{
+
+/** Divide the walkers of a node into chunks which are advanced by any thread
+ *
+ * Each thread owns ChunksPerThread consecutive chunks. A thread advances its
+ * own chunks first and then takes the chunks left by the others, so that the
+ * threads with cheap walkers do not wait for the ones with expensive walkers.
+ *
+ * Each chunk has its own random number generator which is loaded into the
+ * generator of the thread advancing it. The Markov chain of a chunk does not
+ * depend on the thread and the run is reproducible for a given seed and
+ * number of chunks. The first chunk of a thread continues the stream of the
+ * thread, the others are seeded by it.
+ *
+ * Only the streams of the first chunks are saved in the checkpoints, with the
+ * streams of the threads. A restart seeds the other chunks again, so that it
+ * is a valid continuation but not the one of the uninterrupted run. With the
+ * counter-based generator, the streams are selected by the walker and the
+ * step and do not depend on the chunks.
+ *
+ * The fraction of the time the threads wait at the end of a parallel region
+ * is measured for both the static and the dynamic partitions.
+ */
+class WalkerChunks
+{
+public:
+
+  WalkerChunks();
+
+  ~WalkerChunks();
+
+  /** create the chunks
+   * @param rng generators of the threads, referenced by the movers
+   * @param nchunks number of chunks per thread, no chunks if less than one
+   */
+  void setup(std::vector<RandomGenerator_t*>& rng, int nchunks);
+
+  ///return true if the walkers are advanced by chunks
+  inline bool enabled() const
+  {
+    return ChunksPerThread>0;
+  }
+
+  /** divide the walkers into the chunks and reset the queues
+   * @param nw number of walkers on this node
+   */
+  void partition(int nw);
+
+  /** return the next chunk to be advanced by the thread ip, -1 when all are done
+   *
+   * The generator of the chunk is loaded into the generator of the thread.
+   */
+  int next(int ip);
+
+  /** save the generator of a chunk after it is advanced by the thread ip
+   */
+  void release(int ip, int ic);
+
+  ///return the index of the first walker of a chunk
+  inline int first(int ic) const
+  {
+    return Offsets[ic];
+  }
+
+  ///return the index of the walker past the last of a chunk
+  inline int last(int ic) const
+  {
+    return Offsets[ic+1];
+  }
+
+  /** copy the generators of the first chunks back to the threads
+   *
+   * Called before the states of the threads are saved. The generators of the
+   * other chunks are not saved.
+   */
+  void finalize();
+
+  ///mark the start of a parallel region
+  void startRegion();
+  ///mark the end of the work of the thread ip in a parallel region
+  void stopThread(int ip);
+  ///mark the end of a parallel region and accumulate the idle fraction
+  void stopRegion();
+
+  ///reset the statistics of the idle fraction
+  void resetIdle();
+  ///return the mean idle fraction of the threads per parallel region
+  double meanIdle() const;
+  ///return the largest idle fraction of the threads in a parallel region
+  inline double maxIdle() const
+  {
+    return MaxIdle;
+  }
+
+private:
+  ///number of threads
+  int NumThreads;
+  ///number of chunks per thread
+  int ChunksPerThread;
+  ///generators of the threads
+  std::vector<RandomGenerator_t*> ThreadRng;
+  ///generators of the chunks
+  std::vector<RandomGenerator_t*> ChunkRng;
+  ///walker offsets of the chunks
+  std::vector<int> Offsets;
+  ///next chunk in the queue of a thread
+  std::vector<int> Next;
+  ///wall clock of a parallel region
+  Timer RegionClock;
+  ///time at which each thread finished its work
+  std::vector<double> DoneTime;
+  ///sum of the idle fractions
+  double SumIdle;
+  ///largest idle fraction
+  double MaxIdle;
+  ///number of the parallel regions measured
+  int NumRegions;
+};
+
+}
+#endif
@@ -25,7 +25,7 @@ namespace qmcplusplus
 
 WalkerControlBase::WalkerControlBase(Communicate* c, bool rn)
   : MPIObjectBase(c), SwapMode(0), Nmin(1), Nmax(10)
-  , MaxCopy(2), NumWalkersCreated(0), NumWalkersSent(0)
+  , MaxCopy(2), NumWalkersSent(0)
   , targetEnergyBound(10), targetVar(2), targetSigma(10)
   , dmcStream(0), WriteRN(rn)
 {
@@ -106,7 +106,7 @@ void WalkerControlBase::setWalkerID(MCWalkerConfiguration& walkers)
   {
     if((*wit)->ID==0)
     {
-      (*wit)->ID=(++NumWalkersCreated)*NumContexts+MyContext;
+      (*wit)->ID=walkers.newWalkerID(NumContexts,MyContext);
       (*wit)->ParentID=(*wit)->ID;
     }
   }
@@ -453,7 +453,7 @@ int WalkerControlBase::copyWalkers(MCWalkerConfiguration& W)
     for(int j=0; j<ncopy_w[i]; j++, cur_walker++)
     {
       Walker_t* awalker=new Walker_t(*(good_w[i]));
-      awalker->ID=(++NumWalkersCreated)*NumContexts+MyContext;
+      awalker->ID=W.newWalkerID(NumContexts,MyContext);
       awalker->ParentID=good_w[i]->ParentID;
       W.push_back(awalker);
     }
@@ -88,8 +88,6 @@ public:
   IndexType MaxCopy;
   ///current number of walkers per processor
   IndexType NumWalkers;
-  ///Number of walkers created by this node
-  IndexType NumWalkersCreated;
   ///Number of walkers sent during the exchange
   IndexType NumWalkersSent;
   ///trial energy energy
@@ -0,0 +1,145 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "QMCDrivers/WalkerCrowd.h"
+#include "ParticleBase/RandomSeqGenerator.h"
+
+namespace qmcplusplus
+{
+
+WalkerCrowd::WalkerCrowd(MCWalkerConfiguration& w, TrialWaveFunction& psi, QMCHamiltonian& h,
+                         int crowd_size)
+{
+  W_list.resize(crowd_size);
+  Psi_list.resize(crowd_size);
+  H_list.resize(crowd_size);
+  deltaR_list.resize(crowd_size);
+  Uniform_list.resize(crowd_size);
+  Registered.resize(crowd_size,0);
+  Displs.resize(crowd_size);
+#if defined(QMC_RNG_PHILOX)
+  Streams.resize(crowd_size);
+#endif
+  for(int k=0; k<crowd_size; ++k)
+  {
+    W_list[k]=new MCWalkerConfiguration(w);
+    Psi_list[k]=psi.makeClone(*W_list[k]);
+    //the clones use the random number generator of h
+    H_list[k]=h.makeClone(*W_list[k],*Psi_list[k]);
+  }
+  Active.reserve(crowd_size);
+  Proposed.reserve(crowd_size);
+  Accepted.reserve(crowd_size);
+  Ratios.resize(crowd_size);
+  Grads.resize(crowd_size);
+  activeP.reserve(crowd_size);
+  activePsi.reserve(crowd_size);
+  activeDispls.reserve(crowd_size);
+  activeValid.reserve(crowd_size);
+}
+
+WalkerCrowd::~WalkerCrowd()
+{
+  for(int k=0; k<W_list.size(); ++k)
+  {
+    delete H_list[k];
+    delete Psi_list[k];
+    delete W_list[k];
+  }
+}
+
+void WalkerCrowd::loadWalker(int k, Walker_t& awalker, int step)
+{
+  MCWalkerConfiguration& w_k(*W_list[k]);
+  w_k.current_step=step;
+  w_k.loadWalker(awalker,true);
+  if(!Registered[k])
+  {
+    //allocate the internal data of the wavefunction
+    Walker_t::Buffer_t scratch;
+    Psi_list[k]->registerData(w_k,scratch);
+    w_k.G=awalker.G;
+    w_k.L=awalker.L;
+    Registered[k]=1;
+  }
+  Psi_list[k]->copyFromBuffer(w_k,awalker.DataSet);
+}
+
+void WalkerCrowd::drawRandom(int k, RandomGenerator_t& rng, int ngauss, int nuniform)
+{
+  deltaR_list[k].resize(ngauss);
+  makeGaussRandomWithEngine(deltaR_list[k],rng);
+  std::vector<RealType>& u(Uniform_list[k]);
+  u.resize(nuniform);
+  for(int i=0; i<nuniform; ++i)
+    u[i]=rng();
+#if defined(QMC_RNG_PHILOX)
+  Streams[k]=rng;
+#endif
+}
+
+void WalkerCrowd::resumeStream(int k, RandomGenerator_t& rng)
+{
+#if defined(QMC_RNG_PHILOX)
+  rng=Streams[k];
+#endif
+}
+
+int WalkerCrowd::makeMoves(int iat)
+{
+  const int np=Proposed.size();
+  activeP.resize(np);
+  activeDispls.resize(np);
+  activeValid.resize(np);
+  for(int i=0; i<np; ++i)
+  {
+    activeP[i]=W_list[Proposed[i]];
+    activeDispls[i]=Displs[Proposed[i]];
+  }
+  ParticleSet::mw_makeMoveAndCheck(activeP,iat,activeDispls,activeValid);
+  Active.clear();
+  for(int i=0; i<np; ++i)
+    if(activeValid[i])
+      Active.push_back(Proposed[i]);
+  return np-Active.size();
+}
+
+void WalkerCrowd::acceptMoves(int iat)
+{
+  const int na=Accepted.size();
+  activeP.resize(na);
+  activePsi.resize(na);
+  for(int i=0; i<na; ++i)
+  {
+    activeP[i]=W_list[Accepted[i]];
+    activePsi[i]=Psi_list[Accepted[i]];
+  }
+  ParticleSet::mw_acceptMove(activeP,iat);
+  if(na)
+    activePsi[0]->mw_acceptMove(activePsi,activeP,iat);
+}
+
+void WalkerCrowd::ratioGrad(int iat)
+{
+  const int na=Active.size();
+  activeP.resize(na);
+  activePsi.resize(na);
+  for(int i=0; i<na; ++i)
+  {
+    activeP[i]=W_list[Active[i]];
+    activePsi[i]=Psi_list[Active[i]];
+  }
+  if(na)
+    activePsi[0]->mw_ratioGrad(activePsi,activeP,iat,Ratios,Grads);
+}
+
+}
@@ -0,0 +1,169 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file WalkerCrowd.h
+ * @brief a crowd of walkers advanced in lockstep by a mover
+ */
+#ifndef QMCPLUSPLUS_WALKER_CROWD_H
+#define QMCPLUSPLUS_WALKER_CROWD_H
+
+#include "Particle/MCWalkerConfiguration.h"
+#include "QMCWaveFunctions/TrialWaveFunction.h"
+#include "QMCHamiltonians/QMCHamiltonian.h"
+#include "Utilities/RandomGenerator.h"
+#include <vector>
+
+namespace qmcplusplus
+{
+
+/** Copies of W, Psi and H to move the same particle of several walkers together
+ *
+ * A member k of the crowd holds a walker loaded in W_list[k] with the state of
+ * its wavefunction in Psi_list[k]. The moves of a particle are proposed for
+ * all the members first. makeMoves, ratioGrad and acceptMoves then call the
+ * multi-walker functions of ParticleSet and TrialWaveFunction over the members,
+ * so that the distance tables and the components can batch their kernels.
+ *
+ * The random numbers of a walker are drawn before the lockstep moves to
+ * keep the walker streams independent of the crowd. With the counter-based
+ * generator, the stream of a walker is saved after the draws and resumed by
+ * resumeStream before its hamiltonian is evaluated.
+ */
+class WalkerCrowd
+{
+public:
+  typedef MCWalkerConfiguration::Walker_t Walker_t;
+  typedef QMCTraits::RealType RealType;
+  typedef QMCTraits::PosType PosType;
+  typedef QMCTraits::GradType GradType;
+
+  ///particle sets of the members
+  std::vector<MCWalkerConfiguration*> W_list;
+  ///wavefunctions of the members
+  std::vector<TrialWaveFunction*> Psi_list;
+  ///hamiltonians of the members
+  std::vector<QMCHamiltonian*> H_list;
+  ///gaussian displacements of the members
+  std::vector<std::vector<PosType> > deltaR_list;
+  ///uniform random numbers of the members
+  std::vector<std::vector<RealType> > Uniform_list;
+  ///proposed displacements of the members
+  std::vector<PosType> Displs;
+  ///indices of the members with a valid move of the active particle
+  std::vector<int> Active;
+  ///ratios of the active members
+  std::vector<RealType> Ratios;
+  ///new gradients of the active members
+  std::vector<GradType> Grads;
+
+  /** constructor
+   * @param w particle set of the mover
+   * @param psi wavefunction of the mover
+   * @param h hamiltonian of the mover, its random number generator is shared by the clones
+   * @param crowd_size number of walkers moved together
+   */
+  WalkerCrowd(MCWalkerConfiguration& w, TrialWaveFunction& psi, QMCHamiltonian& h,
+              int crowd_size);
+
+  ~WalkerCrowd();
+
+  ///return the maximum number of the members
+  inline int size() const
+  {
+    return W_list.size();
+  }
+
+  /** load a walker into the k-th member
+   * @param k member index
+   * @param awalker walker
+   * @param step current MC step
+   */
+  void loadWalker(int k, Walker_t& awalker, int step);
+
+  /** draw the random numbers of the k-th member
+   * @param k member index
+   * @param rng random number generator with the stream of the walker
+   * @param ngauss number of gaussian displacements
+   * @param nuniform number of uniform random numbers
+   */
+  void drawRandom(int k, RandomGenerator_t& rng, int ngauss, int nuniform);
+
+  /** set rng to the stream of the k-th member where drawRandom left it
+   *
+   * The hamiltonians of the members share rng, e.g. for the quadrature of the
+   * non-local pseudopotentials. Does nothing unless QMC_RNG_PHILOX is set.
+   */
+  void resumeStream(int k, RandomGenerator_t& rng);
+
+  ///clear the lists of the proposed and the accepted moves
+  inline void clearMoves()
+  {
+    Proposed.clear();
+    Accepted.clear();
+  }
+
+  ///propose the displacement dr of the active particle of the k-th member
+  inline void propose(int k, const PosType& dr)
+  {
+    Displs[k]=dr;
+    Proposed.push_back(k);
+  }
+
+  /** make the proposed moves of iat
+   * @param iat the moved particle
+   * @return the number of the invalid moves
+   *
+   * Active lists the members with a valid move.
+   */
+  int makeMoves(int iat);
+
+  ///accept the move of the k-th member
+  inline void accept(int k)
+  {
+    Accepted.push_back(k);
+  }
+
+  /** update the members whose move of iat is accepted
+   * @param iat the moved particle
+   */
+  void acceptMoves(int iat);
+
+  /** evaluate the ratios and the new gradients of the active members
+   * @param iat the moved particle
+   *
+   * Ratios[i] and Grads[i] belong to the member Active[i].
+   */
+  void ratioGrad(int iat);
+
+private:
+  ///1 if the wavefunction of a member has allocated its data
+  std::vector<int> Registered;
+  ///indices of the members with a proposed move
+  std::vector<int> Proposed;
+  ///indices of the members with an accepted move
+  std::vector<int> Accepted;
+  ///particle sets of the active members
+  std::vector<ParticleSet*> activeP;
+  ///wavefunctions of the active members
+  std::vector<TrialWaveFunction*> activePsi;
+  ///displacements of the proposed moves
+  std::vector<PosType> activeDispls;
+  ///1 if a proposed move is valid
+  std::vector<int> activeValid;
+#if defined(QMC_RNG_PHILOX)
+  ///streams of the members after drawRandom
+  std::vector<RandomGenerator_t> Streams;
+#endif
+};
+
+}
+#endif
@@ -229,5 +229,91 @@ TEST_CASE("DMC Particle-by-Particle advanceWalkers LinearOrbital", "[drivers][dm
   REQUIRE(elec.R[1][2] == Approx(1.20343404334896));
 
 }
-}
+TEST_CASE("DMC Particle-by-Particle crowd advanceWalkers LinearOrbital", "[drivers][dmc]")
+{
+  Communicate *c;
+  OHMMS::Controller->initialize(0, NULL);
+  c = OHMMS::Controller;
+  OhmmsInfo("testlogfile");
+
+  ParticleSet ions;
+  MCWalkerConfiguration elec;
+
+  ions.setName("ion");
+  ions.create(1);
+  ions.R[0][0] = 0.0;
+  ions.R[0][1] = 0.0;
+  ions.R[0][2] = 0.0;
+
+  elec.setName("elec");
+  elec.setBoundBox(false);
+  std::vector<int> agroup(1);
+  agroup[0] = 2;
+  elec.create(agroup);
+  elec.R[0][0] = 1.0;
+  elec.R[0][1] = 0.0;
+  elec.R[0][2] = 0.0;
+  elec.R[1][0] = 0.0;
+  elec.R[1][1] = 0.0;
+  elec.R[1][2] = 1.0;
+  // a full crowd and a partial one
+  const int nw = 3;
+  elec.createWalkers(nw);
+  // the phase, log value, gradients and laplacians written by updateBuffer
+  for (int iw = 0; iw < nw; iw++)
+    elec.WalkerList[iw]->DataSet.resize(2 + 4*elec.getTotalNum());
+
+  SpeciesSet &tspecies =  elec.getSpeciesSet();
+  int upIdx = tspecies.addSpecies("u");
+  int downIdx = tspecies.addSpecies("d");
+  int chargeIdx = tspecies.addAttribute("charge");
+  int massIdx = tspecies.addAttribute("mass");
+  tspecies(chargeIdx, upIdx) = -1;
+  tspecies(chargeIdx, downIdx) = -1;
+  tspecies(massIdx, upIdx) = 1.0;
+  tspecies(massIdx, downIdx) = 1.0;
+
+  elec.addTable(ions);
+  elec.update();
+
+  TrialWaveFunction *psi = new TrialWaveFunction(c);
+  LinearOrbital *orb = new LinearOrbital;
+  psi->addOrbital(orb, "Linear");
+
+  FakeRandom rg;
+
+  QMCHamiltonian h;
+  h.addOperator(new BareKineticEnergy<double>(elec),"Kinetic");
+  h.addObservables(elec); // get double free error on 'h.Observables' w/o this
+
+  elec.resetWalkerProperty(); // get memory corruption w/o this
+
+  DMCUpdatePbyPCrowd dmc(elec, *psi, h, rg, 2);
+  EstimatorManager EM;
+  double tau = 0.1;
+  SimpleFixedNodeBranch branch(tau, 1);
+  TraceManager TM;
+  dmc.resetRun(&branch, &EM, &TM);
+  dmc.startBlock(1);
+
+  DMCUpdatePbyPCrowd::WalkerIter_t begin = elec.begin();
+  DMCUpdatePbyPCrowd::WalkerIter_t end = elec.end();
+  dmc.advanceWalkers(begin, end, true);
 
+  REQUIRE(dmc.nReject == 0);
+  REQUIRE(dmc.nAccept == 2*nw);
+
+  // Every walker takes the same moves as the single walker of the test above
+  for (int iw = 0; iw < nw; iw++)
+  {
+    MCWalkerConfiguration::Walker_t::ParticlePos_t& R = elec.WalkerList[iw]->R;
+    REQUIRE(R[0][0] == Approx(0.695481606677082));
+    REQUIRE(R[0][1] == Approx(0.135622695565971));
+    REQUIRE(R[0][2] == Approx(-0.168895697756948));
+
+    REQUIRE(R[1][0] == Approx(0.0678113477829853));
+    REQUIRE(R[1][1] == Approx(-0.236707045539933));
+    REQUIRE(R[1][2] == Approx(1.20343404334896));
+  }
+}
+}
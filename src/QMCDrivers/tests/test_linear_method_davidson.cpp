@@ -0,0 +1,157 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "QMCDrivers/LinearMethodDavidson.h"
+#include "Numerics/OhmmsBlas.h"
+
+#include <cmath>
+#include <vector>
+
+namespace qmcplusplus
+{
+
+typedef LinearMethodDavidson::RealType RealType;
+
+struct DenseProducts: public LinearMethodDavidson::MatrixProducts
+{
+  Matrix<RealType> L, R;
+  int NumCalls;
+  DenseProducts(int n): L(n,n), R(n,n), NumCalls(0) {}
+  void apply(const Matrix<RealType>& X, Matrix<RealType>& LX, Matrix<RealType>& RX)
+  {
+    NumCalls++;
+    int n=L.rows();
+    LX=0.0;
+    RX=0.0;
+    for (int k=0; k<X.rows(); k++)
+      for (int i=0; i<n; i++)
+        for (int j=0; j<n; j++)
+        {
+          LX(k,i)+=L(i,j)*X(k,j);
+          RX(k,i)+=R(i,j)*X(k,j);
+        }
+  }
+};
+
+// lowest real eigenpair of L c = E R c with all the eigenvectors
+static RealType dense_lowest(const DenseProducts& op, std::vector<RealType>& ev)
+{
+  int n=op.L.rows();
+  std::vector<RealType> A(n*n), B(n*n), VR(n*n);
+  for (int i=0; i<n; i++)
+    for (int j=0; j<n; j++)
+    {
+      A[i+j*n]=op.L(i,j);
+      B[i+j*n]=op.R(i,j);
+    }
+  char jl('N');
+  char jr('V');
+  std::vector<RealType> alphar(n),alphai(n),beta(n);
+  int info;
+  int lwork(-1);
+  std::vector<RealType> work(1);
+  RealType tt(0);
+  int t(1);
+  LAPACK::ggev(&jl, &jr, &n, &A[0], &n, &B[0], &n, &alphar[0], &alphai[0], &beta[0], &tt, &t, &VR[0], &n, &work[0], &lwork, &info);
+  lwork=int(work[0]);
+  work.resize(lwork);
+  LAPACK::ggev(&jl, &jr, &n, &A[0], &n, &B[0], &n, &alphar[0], &alphai[0], &beta[0], &tt, &t, &VR[0], &n, &work[0], &lwork, &info);
+  REQUIRE(info == 0);
+  int best=-1;
+  for (int i=0; i<n; i++)
+    if (alphai[i]==0.0 && (best<0 || alphar[i]/beta[i]<alphar[best]/beta[best]))
+      best=i;
+  REQUIRE(best >= 0);
+  ev.resize(n);
+  for (int i=0; i<n; i++)
+    ev[i]=VR[i+best*n]/VR[best*n];
+  return alphar[best]/beta[best];
+}
+
+static void fill_problem(DenseProducts& op)
+{
+  int n=op.L.rows();
+  for (int i=0; i<n; i++)
+    for (int j=0; j<n; j++)
+    {
+      op.L(i,j)=0.05*std::sin(1.0+i+2.0*j);
+      op.R(i,j)=0.02*std::cos(0.5*(i+j))/(1.0+std::abs(i-j));
+    }
+  for (int i=0; i<n; i++)
+  {
+    op.L(i,i)+=-1.0+0.1*i;
+    op.R(i,i)+=1.0;
+  }
+  // couple the current wavefunction to the parameters as the linear method does
+  for (int i=1; i<n; i++)
+  {
+    op.L(0,i)+=0.1/i;
+    op.L(i,0)+=0.08/i;
+  }
+}
+
+TEST_CASE("LinearMethodDavidson dense", "[drivers][optimize]")
+{
+  const int n=40;
+  DenseProducts op(n);
+  fill_problem(op);
+
+  std::vector<RealType> ev_ref;
+  RealType e_ref=dense_lowest(op,ev_ref);
+
+  std::vector<RealType> Ldiag(n), Rdiag(n);
+  for (int i=0; i<n; i++)
+  {
+    Ldiag[i]=op.L(i,i);
+    Rdiag[i]=op.R(i,i);
+  }
+
+  LinearMethodDavidson solver;
+  solver.Tolerance=1e-10;
+  // force a few restarts
+  solver.MaxSubspace=6;
+  std::vector<RealType> ev;
+  RealType e=solver.solve(op,Ldiag,Rdiag,ev);
+
+  REQUIRE(solver.converged());
+  REQUIRE(op.NumCalls < n);
+  REQUIRE(e == Approx(e_ref));
+  REQUIRE(ev[0] == Approx(1.0));
+  for (int i=1; i<n; i++)
+    REQUIRE(ev[i] == Approx(ev_ref[i]).epsilon(1e-6));
+}
+
+TEST_CASE("LinearMethodDavidson max iterations", "[drivers][optimize]")
+{
+  const int n=20;
+  DenseProducts op(n);
+  fill_problem(op);
+  std::vector<RealType> Ldiag(n), Rdiag(n);
+  for (int i=0; i<n; i++)
+  {
+    Ldiag[i]=op.L(i,i);
+    Rdiag[i]=op.R(i,i);
+  }
+  LinearMethodDavidson solver;
+  solver.Tolerance=1e-14;
+  solver.MaxIterations=2;
+  std::vector<RealType> ev;
+  solver.solve(op,Ldiag,Rdiag,ev);
+  REQUIRE(solver.iterations() == 2);
+  REQUIRE(op.NumCalls == 3);
+  REQUIRE(!solver.converged());
+  REQUIRE(ev[0] == 1.0);
+}
+
+}
@@ -0,0 +1,136 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "QMCDrivers/LinearMethodMoments.h"
+
+#include <vector>
+
+namespace qmcplusplus
+{
+
+typedef LinearMethodMoments::Return_t Return_t;
+
+// per-sample sums of QMCCostFunctionOMP::fillOverlapHamiltonianMatrices
+static void fill_reference(const Matrix<Return_t>& D, const Matrix<Return_t>& HD,
+                           const std::vector<Return_t>& E, const std::vector<Return_t>& W,
+                           Return_t b1, Return_t b2, Return_t H2_avg, Return_t V_avg, Return_t E_avg,
+                           Matrix<Return_t>& Left, Matrix<Return_t>& Right)
+{
+  int ns=D.rows();
+  int np=D.cols();
+  Return_t wsum=0;
+  for (int s=0; s<ns; s++)
+    wsum+=W[s];
+  std::vector<Return_t> D_avg(np,0.0);
+  for (int s=0; s<ns; s++)
+    for (int i=0; i<np; i++)
+      D_avg[i]+=D(s,i)*W[s]/wsum;
+  Left=0.0;
+  Right=0.0;
+  for (int s=0; s<ns; s++)
+  {
+    Return_t weight=W[s]/wsum;
+    Return_t eloc=E[s];
+    for (int i=0; i<np; i++)
+    {
+      Return_t di=D(s,i)-D_avg[i];
+      Return_t vterm=HD(s,i)*(eloc-E_avg)+di*eloc*(eloc-2.0*E_avg);
+      Right(0,i+1) += b1*H2_avg*vterm*weight;
+      Right(i+1,0) += b1*H2_avg*vterm*weight;
+      Left(0,i+1) += b2*vterm*weight+(1-b2)*(HD(s,i)+di*eloc)*weight;
+      Left(i+1,0) += b2*vterm*weight+(1-b2)*di*weight*eloc;
+      for (int j=0; j<np; j++)
+      {
+        Return_t dj=D(s,j)-D_avg[j];
+        Return_t ovlij=weight*di*dj;
+        Return_t varij=weight*(HD(s,i)-2.0*di*eloc)*(HD(s,j)-2.0*dj*eloc);
+        Left(i+1,j+1) += (1-b2)*weight*di*(HD(s,j)+dj*eloc)+b2*(varij+V_avg*ovlij);
+        Right(i+1,j+1) += ovlij+b1*H2_avg*varij;
+      }
+    }
+  }
+}
+
+static void check_moments(bool in_place, Return_t b1, Return_t b2)
+{
+  const int ns=13;
+  const int np=5;
+  const int nthreads=2;
+  const int nb=3;
+  Matrix<Return_t> D(ns,np), HD(ns,np);
+  std::vector<Return_t> E(ns), W(ns);
+  for (int s=0; s<ns; s++)
+  {
+    for (int i=0; i<np; i++)
+    {
+      D(s,i)=0.5+0.1*i+0.03*s*(i%3)-0.01*s*s/(i+1);
+      HD(s,i)=-0.2+0.07*i*s-0.02*(s%4);
+    }
+    E[s]=-1.0-0.05*s+0.01*(s%3);
+    W[s]=1.0+0.1*(s%5);
+  }
+  Return_t H2_avg=0.9, V_avg=0.3, E_avg=-1.2;
+
+  Matrix<Return_t> Lref(np+1,np+1), Rref(np+1,np+1);
+  fill_reference(D,HD,E,W,b1,b2,H2_avg,V_avg,E_avg,Lref,Rref);
+
+  LinearMethodMoments moments;
+  moments.resize(np,nthreads*nb,b1!=0.0 || b2!=0.0);
+  Matrix<Return_t> Left(np+1,np+1), Right(np+1,np+1);
+  if (in_place)
+    moments.reset(&Right,&Left);
+  else
+    moments.reset();
+  // distribute the samples over the batch rows of two threads
+  int nbatches=(ns+nthreads*nb-1)/(nthreads*nb);
+  for (int ib=0; ib<nbatches; ib++)
+  {
+    for (int row=0; row<nthreads*nb; row++)
+    {
+      int s=ib*nthreads*nb+row;
+      if (s<ns)
+        moments.addSample(row,D[s],HD[s],E[s],W[s]);
+      else
+        moments.clearRow(row);
+    }
+    for (int ip=0; ip<nthreads; ip++)
+      moments.accumulate(ip,nthreads);
+  }
+  moments.fillMatrices(Left,Right,b1,b2,H2_avg,V_avg,E_avg);
+
+  for (int i=1; i<=np; i++)
+  {
+    for (int j=0; j<=np; j++)
+    {
+      REQUIRE(Left(i,j) == Approx(Lref(i,j)));
+      REQUIRE(Right(i,j) == Approx(Rref(i,j)));
+      REQUIRE(Left(j,i) == Approx(Lref(j,i)));
+      REQUIRE(Right(j,i) == Approx(Rref(j,i)));
+    }
+  }
+}
+
+TEST_CASE("LinearMethodMoments energy", "[drivers][optimize]")
+{
+  check_moments(false,0.0,0.0);
+  check_moments(true,0.0,0.0);
+}
+
+TEST_CASE("LinearMethodMoments variance", "[drivers][optimize]")
+{
+  check_moments(false,0.0,0.4);
+  check_moments(true,0.4,0.0);
+}
+
+}
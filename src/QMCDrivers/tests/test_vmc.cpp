@@ -126,5 +126,94 @@ TEST_CASE("VMC Particle-by-Particle advanceWalkers", "[drivers][vmc]")
   REQUIRE(elec.R[1][2] == Approx(1.0));
 
 }
-}
+TEST_CASE("VMC Particle-by-Particle crowd advanceWalkers", "[drivers][vmc]")
+{
+
+  Communicate *c;
+  OHMMS::Controller->initialize(0, NULL);
+  c = OHMMS::Controller;
+  OhmmsInfo("testlogfile");
+
+  ParticleSet ions;
+  MCWalkerConfiguration elec;
+
+  ions.setName("ion");
+  ions.create(1);
+  ions.R[0][0] = 0.0;
+  ions.R[0][1] = 0.0;
+  ions.R[0][2] = 0.0;
+
+  elec.setName("elec");
+  elec.setBoundBox(false);
+  std::vector<int> agroup(1);
+  agroup[0] = 2;
+  elec.create(agroup);
+  elec.R[0][0] = 1.0;
+  elec.R[0][1] = 0.0;
+  elec.R[0][2] = 0.0;
+  elec.R[1][0] = 0.0;
+  elec.R[1][1] = 0.0;
+  elec.R[1][2] = 1.0;
+  // a full crowd and a partial one
+  const int nw = 3;
+  elec.createWalkers(nw);
+  // the phase, log value, gradients and laplacians written by updateBuffer
+  for (int iw = 0; iw < nw; iw++)
+    elec.WalkerList[iw]->DataSet.resize(2 + 4*elec.getTotalNum());
+
+
+  SpeciesSet &tspecies =  elec.getSpeciesSet();
+  int upIdx = tspecies.addSpecies("u");
+  int downIdx = tspecies.addSpecies("d");
+  int chargeIdx = tspecies.addAttribute("charge");
+  int massIdx = tspecies.addAttribute("mass");
+  tspecies(chargeIdx, upIdx) = -1;
+  tspecies(chargeIdx, downIdx) = -1;
+  tspecies(massIdx, upIdx) = 1.0;
+  tspecies(massIdx, downIdx) = 1.0;
+
+  elec.addTable(ions);
+  elec.update();
 
+
+  TrialWaveFunction psi = TrialWaveFunction(c);
+  ConstantOrbital *orb = new ConstantOrbital;
+  psi.addOrbital(orb, "Constant");
+
+  FakeRandom rg;
+
+  QMCHamiltonian h;
+  h.addOperator(new BareKineticEnergy<double>(elec),"Kinetic");
+  h.addObservables(elec); // get double free error on 'h.Observables' w/o this
+
+  elec.resetWalkerProperty(); // get memory corruption w/o this
+
+  VMCUpdatePbyPCrowd vmc(elec, psi, h, rg, 2, false);
+  EstimatorManager EM;
+  SimpleFixedNodeBranch branch(0.1, 1);
+  TraceManager TM;
+  vmc.resetRun(&branch, &EM, &TM);
+  vmc.startBlock(1);
+
+  VMCUpdatePbyPCrowd::WalkerIter_t begin = elec.begin();
+  VMCUpdatePbyPCrowd::WalkerIter_t end = elec.end();
+  vmc.advanceWalkers(begin, end, true);
+
+  // With the constant wavefunction, no moves should be rejected
+  REQUIRE(vmc.nReject == 0);
+  REQUIRE(vmc.nAccept == 2*nw);
+
+  // Every walker takes the same moves as the single walker of the test above
+  for (int iw = 0; iw < nw; iw++)
+  {
+    MCWalkerConfiguration::Walker_t::ParticlePos_t& R = elec.WalkerList[iw]->R;
+    REQUIRE(R[0][0] == Approx(0.6276702589209545));
+    REQUIRE(R[0][1] == Approx(0.0));
+    REQUIRE(R[0][2] == Approx(-0.3723297410790455));
+
+    REQUIRE(R[1][0] == Approx(0.0));
+    REQUIRE(R[1][1] == Approx(-0.3723297410790455));
+    REQUIRE(R[1][2] == Approx(1.0));
+  }
+}
+}
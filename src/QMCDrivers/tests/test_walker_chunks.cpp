@@ -0,0 +1,84 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "Utilities/RandomGenerator.h"
+#include "QMCDrivers/WalkerChunks.h"
+
+#include <vector>
+
+namespace qmcplusplus
+{
+
+TEST_CASE("WalkerChunks static partition", "[drivers]")
+{
+  std::vector<RandomGenerator_t*> rng(2);
+  rng[0]=new RandomGenerator_t;
+  rng[1]=new RandomGenerator_t;
+
+  WalkerChunks chunks;
+  chunks.setup(rng,0);
+  REQUIRE(!chunks.enabled());
+
+  delete rng[0];
+  delete rng[1];
+}
+
+TEST_CASE("WalkerChunks work stealing", "[drivers]")
+{
+  std::vector<RandomGenerator_t*> rng(2);
+  rng[0]=new RandomGenerator_t;
+  rng[1]=new RandomGenerator_t;
+  rng[0]->set_value(0.25);
+  rng[1]->set_value(0.75);
+
+  WalkerChunks chunks;
+  chunks.setup(rng,3);
+  REQUIRE(chunks.enabled());
+
+  chunks.partition(10);
+  REQUIRE(chunks.first(0) == 0);
+  REQUIRE(chunks.last(5) == 10);
+
+  // thread 1 takes its own chunks first and then steals those of thread 0
+  int expected[] = {3, 4, 5, 0, 1, 2};
+  int nw = 0;
+  for (int i = 0; i < 6; i++)
+  {
+    int ic = chunks.next(1);
+    REQUIRE(ic == expected[i]);
+    // the generator of the chunk is loaded into the thread
+    REQUIRE((*rng[1])() == Approx(ic<3?0.25:0.75));
+    nw += chunks.last(ic)-chunks.first(ic);
+    rng[1]->set_value(0.1*(ic+1));
+    chunks.release(1,ic);
+  }
+  REQUIRE(chunks.next(1) == -1);
+  REQUIRE(chunks.next(0) == -1);
+  REQUIRE(nw == 10);
+
+  // the queues are reset by partition and the chunk states persist
+  chunks.partition(10);
+  REQUIRE(chunks.next(0) == 0);
+  REQUIRE((*rng[0])() == Approx(0.1));
+
+  // the first chunks are copied back to the threads
+  chunks.finalize();
+  REQUIRE((*rng[0])() == Approx(0.1));
+  REQUIRE((*rng[1])() == Approx(0.4));
+
+  delete rng[0];
+  delete rng[1];
+}
+
+}
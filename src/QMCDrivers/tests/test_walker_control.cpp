@@ -0,0 +1,168 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Message/catch_mpi_main.hpp"
+
+#include "Utilities/OhmmsInfo.h"
+#include "Particle/MCWalkerConfiguration.h"
+#include "QMCDrivers/DMC/WalkerControlMPI.h"
+#include "Utilities/PhiloxRandom.h"
+
+
+#include <stdio.h>
+#include <string>
+#include <algorithm>
+
+
+namespace qmcplusplus
+{
+
+/** add nw walkers, every walker is tagged by its ID in R and DataSet
+ */
+void add_tagged_walkers(MCWalkerConfiguration& W, int nw, long first_id)
+{
+  int nw_old = W.getActiveWalkers();
+  W.createWalkers(nw);
+  for (int iw = nw_old; iw < W.getActiveWalkers(); iw++)
+  {
+    long id = first_id + iw - nw_old;
+    W[iw]->ID = id;
+    W[iw]->R[0][0] = id;
+    W[iw]->R[1][2] = -id;
+    W[iw]->DataSet.resize(4);
+    for (int k = 0; k < 4; k++)
+      W[iw]->DataSet[k] = id + 0.5*k;
+  }
+}
+
+/** emulate the global sum of WalkerControlMPI::branch and swap the walkers
+ * @return the sum of the walker IDs over all the ranks
+ */
+long swap_and_check(WalkerControlMPI& wc, MCWalkerConfiguration& W, Communicate* c)
+{
+  std::vector<int> nw(c->size(), 0);
+  nw[c->rank()] = W.getActiveWalkers();
+  c->allreduce(nw);
+  wc.Cur_pop = 0;
+  for (int ip = 0; ip < c->size(); ip++)
+  {
+    wc.NumPerNode[ip] = nw[ip];
+    wc.Cur_pop += nw[ip];
+  }
+  wc.swapWalkersNonblocking(W);
+
+  // the load differs by at most one walker
+  int fair = wc.FairOffSet[c->rank()+1] - wc.FairOffSet[c->rank()];
+  REQUIRE(W.getActiveWalkers() == fair);
+
+  // every walker arrives intact
+  long idsum = 0;
+  for (int iw = 0; iw < W.getActiveWalkers(); iw++)
+  {
+    long id = W[iw]->ID;
+    REQUIRE(W[iw]->R[0][0] == Approx(id));
+    REQUIRE(W[iw]->R[1][2] == Approx(-id));
+    REQUIRE(W[iw]->DataSet.size() == 4);
+    for (int k = 0; k < 4; k++)
+      REQUIRE(W[iw]->DataSet[k] == Approx(id + 0.5*k));
+    idsum += id;
+  }
+  std::vector<int> idsum_all(1, static_cast<int>(idsum));
+  c->allreduce(idsum_all);
+  return idsum_all[0];
+}
+
+TEST_CASE("WalkerControlMPI nonblocking swap", "[drivers][walkercontrol]")
+{
+  OHMMS::Controller->initialize(0, NULL);
+  Communicate *c = OHMMS::Controller;
+  OhmmsInfo("testlogfile");
+
+  MCWalkerConfiguration elec;
+  elec.setName("elec");
+  std::vector<int> agroup(1);
+  agroup[0] = 2;
+  elec.create(agroup);
+
+  const int rank = c->rank();
+  const int nranks = c->size();
+
+  // uneven population, rank r has 2r+1 walkers
+  add_tagged_walkers(elec, 2*rank+1, 1000*rank);
+  long expected = 0;
+  for (int ip = 0; ip < nranks; ip++)
+    for (int iw = 0; iw < 2*ip+1; iw++)
+      expected += 1000*ip + iw;
+
+  WalkerControlMPI wc(c);
+  REQUIRE(swap_and_check(wc, elec, c) == expected);
+
+  // second exchange in the other direction, reusing the persistent buffers
+  if (rank == 0)
+    add_tagged_walkers(elec, 2*nranks, 1000*nranks);
+  for (int iw = 0; iw < 2*nranks; iw++)
+    expected += 1000*nranks + iw;
+  REQUIRE(swap_and_check(wc, elec, c) == expected);
+}
+
+TEST_CASE("WalkerControlBase branched walkers have their own streams", "[drivers][walkercontrol]")
+{
+  Communicate *c = OHMMS::Controller;
+
+  MCWalkerConfiguration elec;
+  elec.setName("elec");
+  std::vector<int> agroup(1);
+  agroup[0] = 2;
+  elec.create(agroup);
+
+  const int rank = c->rank();
+  const int nranks = c->size();
+
+  // number the walkers as QMCDriver::setWalkerOffsets does
+  const int nw = 2;
+  add_tagged_walkers(elec, nw, nw*rank);
+  elec.resetWalkerIDs(nw*nranks);
+
+  // two branches, the first walker of a rank is copied twice every time
+  WalkerControlBase wc(c);
+  for (int ib = 0; ib < 2; ib++)
+  {
+    for (int iw = 0; iw < elec.getActiveWalkers(); iw++)
+    {
+      wc.good_w.push_back(elec[iw]);
+      wc.ncopy_w.push_back(iw == 0 ? 2 : 0);
+    }
+    wc.copyWalkers(elec);
+  }
+  const int nw_now = nw + 4;
+  REQUIRE(elec.getActiveWalkers() == nw_now);
+
+  std::vector<int> ids(nranks*nw_now, 0);
+  for (int iw = 0; iw < nw_now; iw++)
+    ids[rank*nw_now + iw] = elec[iw]->ID;
+  c->allreduce(ids);
+
+  // every walker of every rank draws its own numbers at the same step
+  std::vector<double> first(ids.size());
+  PhiloxRandom<double> rng;
+  for (int i = 0; i < ids.size(); i++)
+  {
+    rng.set_stream(ids[i], 7);
+    first[i] = rng();
+  }
+  std::sort(ids.begin(), ids.end());
+  REQUIRE(std::unique(ids.begin(), ids.end()) == ids.end());
+  std::sort(first.begin(), first.end());
+  REQUIRE(std::unique(first.begin(), first.end()) == first.end());
+}
+
+}
@@ -44,12 +44,14 @@ NonLocalECPComponent* NonLocalECPComponent::makeClone()
   return myclone;
 }
 
+/** create VP for the knots of this component
+ *
+ * Called at the first evaluation so that VP mirrors all the distance tables of qp.
+ */
 void NonLocalECPComponent::initVirtualParticle(ParticleSet* qp)
 {
-  //if(VP) 
-  //  VP->reset(qp);
-  //else
-  //  VP=new VirtualParticleSet(qp,nknot);
+  if(VP==0)
+    VP=new VirtualParticleSet(qp,nknot);
 }
 
 void NonLocalECPComponent::add(int l, RadialPotentialType* pp)
@@ -129,9 +129,9 @@ struct NonLocalECPComponent: public QMCTraits
   evaluate(ParticleSet& W, TrialWaveFunction& Psi,int iat, std::vector<NonLocalData>& Txy,
            PosType &force_iat);
 
-  /** compute with virtual moves */
-  RealType evaluateVP(const ParticleSet& W, int iat, TrialWaveFunction& Psi);
-  RealType evaluateVP(const ParticleSet& W, int iat, TrialWaveFunction& Psi,std::vector<NonLocalData>& Txy);
+  /** compute with virtual moves, all the knots of an electron-ion pair are evaluated together */
+  RealType evaluateVP(ParticleSet& W, int iat, TrialWaveFunction& Psi);
+  RealType evaluateVP(ParticleSet& W, int iat, TrialWaveFunction& Psi,std::vector<NonLocalData>& Txy);
 
   RealType
   evaluateValueAndDerivatives(ParticleSet& P,
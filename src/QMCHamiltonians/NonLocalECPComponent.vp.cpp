@@ -26,14 +26,16 @@ namespace qmcplusplus
  *
  * Currently, we assume that the ratio-only evaluation does not change the state
  * of the trial wavefunction and do not call psi.rejectMove(ieL).
+ * The ratios of all the knots are computed by one TrialWaveFunction::evaluateRatios call.
  */
 NonLocalECPComponent::RealType
-NonLocalECPComponent::evaluateVP(const ParticleSet& W, int iat, TrialWaveFunction& psi)
+NonLocalECPComponent::evaluateVP(ParticleSet& W, int iat, TrialWaveFunction& psi)
 {
   RealType esum=0.0;
   RealType pairpot;
   ParticleSet::ParticlePos_t deltarV(nknot);
   const DistanceTableData* myTable = W.DistTables[myTableIndex];
+  initVirtualParticle(&W);
 
   for(int nn=myTable->M[iat],iel=0; nn<myTable->M[iat+1]; nn++,iel++)
   {
@@ -45,7 +47,7 @@ NonLocalECPComponent::evaluateVP(const ParticleSet& W, int iat, TrialWaveFunctio
     // Compute ratio of wave functions
     for (int j=0; j < nknot ;j++) deltarV[j]=r*rrotsgrid_m[j]-dr;
     VP->makeMoves(iel,deltarV);
-    psi.evaluateRatios(*VP,psiratio);
+    psi.evaluateRatios(W,*VP,deltarV,psiratio);
     for(int j=0; j<nknot; ++j) psiratio[j]*=sgridweight_m[j];
 
     for(int ip=0; ip< nchannel; ip++) vrad[ip]=nlpp_m[ip]->splint(r)*wgt_angpp_m[ip];
@@ -92,11 +94,12 @@ NonLocalECPComponent::evaluateVP(const ParticleSet& W, int iat, TrialWaveFunctio
 
 
 NonLocalECPComponent::RealType
-NonLocalECPComponent::evaluateVP(const ParticleSet& W, int iat, TrialWaveFunction& psi,std::vector<NonLocalData>& Txy)
+NonLocalECPComponent::evaluateVP(ParticleSet& W, int iat, TrialWaveFunction& psi,std::vector<NonLocalData>& Txy)
 {
   const DistanceTableData* myTable = W.DistTables[myTableIndex];
   RealType esum=0.0;
   ParticleSet::ParticlePos_t deltarV(nknot);
+  initVirtualParticle(&W);
   for(int nn=myTable->M[iat],iel=0; nn<myTable->M[iat+1]; nn++,iel++)
   {
     register RealType r(myTable->r(nn));
@@ -106,7 +109,7 @@ NonLocalECPComponent::evaluateVP(const ParticleSet& W, int iat, TrialWaveFunctio
 
     for (int j=0; j < nknot ;j++) deltarV[j]=r*rrotsgrid_m[j]-dr;
     VP->makeMoves(iel,deltarV);
-    psi.evaluateRatios(*VP,psiratio);
+    psi.evaluateRatios(W,*VP,deltarV,psiratio);
     for(int j=0; j<nknot; ++j) psiratio[j]*=sgridweight_m[j];
 
     // Compute radial potential
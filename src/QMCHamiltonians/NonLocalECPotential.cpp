@@ -129,6 +129,17 @@ NonLocalECPotential::evaluate(ParticleSet& P)
                                    PulayTerm[iat]);
       }
   }
+  else if(Psi.hasRatiosForVP())
+  {
+    for(int iat=0; iat<NumIons; iat++)
+    {
+      if(PP[iat])
+      {
+        PP[iat]->randomize_grid(*(P.Sphere[iat]),UpdateMode[PRIMARY]);
+        Value += PP[iat]->evaluateVP(P,iat,Psi);
+      }
+    }
+  }
   else
   {
     for(int iat=0; iat<NumIons; iat++)
@@ -191,6 +202,17 @@ NonLocalECPotential::evaluate(ParticleSet& P, std::vector<NonLocalData>& Txy)
         Value += PP[iat]->evaluate(P,Psi,iat,Txy, forces[iat]);
       }
   }
+  else if(Psi.hasRatiosForVP())
+  {
+    for(int iat=0; iat<NumIons; iat++)
+    {
+      if(PP[iat])
+      {
+        PP[iat]->randomize_grid(*(P.Sphere[iat]),UpdateMode[PRIMARY]);
+        Value += PP[iat]->evaluateVP(P,iat,Psi,Txy);
+      }
+    }
+  }
   else
   {
     for(int iat=0; iat<NumIons; iat++)
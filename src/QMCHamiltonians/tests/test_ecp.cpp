@@ -15,6 +15,9 @@
 #include "OhmmsData/Libxml2Doc.h"
 #include "Utilities/OhmmsInfo.h"
 #include "QMCHamiltonians/ECPComponentBuilder.h"
+#include "QMCWaveFunctions/TrialWaveFunction.h"
+#include "QMCWaveFunctions/Jastrow/BsplineJastrowBuilder.h"
+#include "QMCWaveFunctions/Fermion/SlaterDet.h"
 
 
 #include <stdio.h>
@@ -117,5 +120,184 @@ TEST_CASE("ReadFileBuffer_reopen","[hamiltonian]")
   REQUIRE(buf.length > 14);
 }
 
+/** two analytic orbitals, exp(-r^2/2) and x exp(-r^2/2), for the virtual-move checks
+ */
+struct GaussianSPOSet: public SPOSetBase
+{
+  GaussianSPOSet()
+  {
+    className = "GaussianSPOSet";
+    OrbitalSetSize = 2;
+    HaveValuesForVP = true;
+    t_logpsi.resize(OrbitalSetSize, OrbitalSetSize);
+  }
+
+  SPOSetBase* makeClone() const { return new GaussianSPOSet(*this); }
+  void resetParameters(const opt_variables_type& optVariables) {}
+  void resetTargetParticleSet(ParticleSet& P) {}
+  void setOrbitalSetSize(int norbs) {}
+
+  void evaluate_vgl(const PosType& r, ValueType* psi, GradType* dpsi, ValueType* d2psi)
+  {
+    RealType g = std::exp(-0.5*dot(r,r));
+    psi[0] = g;
+    psi[1] = r[0]*g;
+    dpsi[0] = -g*r;
+    dpsi[1] = -r[0]*g*r;
+    dpsi[1][0] += g;
+    d2psi[0] = (dot(r,r)-3.0)*g;
+    d2psi[1] = r[0]*(dot(r,r)-5.0)*g;
+  }
+
+  void evaluate(const ParticleSet& P, int iat, ValueVector_t& psi)
+  {
+    GradType dpsi[2];
+    ValueType d2psi[2];
+    evaluate_vgl(P.R[iat], psi.data(), dpsi, d2psi);
+  }
+
+  void evaluateValues(const ParticleSet& VP, ValueMatrix_t& psiM)
+  {
+    GradType dpsi[2];
+    ValueType d2psi[2];
+    for (int k = 0; k < VP.getTotalNum(); k++)
+      evaluate_vgl(VP.R[k], psiM[k], dpsi, d2psi);
+  }
+
+  void evaluate(const ParticleSet& P, int iat,
+                ValueVector_t& psi, GradVector_t& dpsi, ValueVector_t& d2psi)
+  {
+    evaluate_vgl(P.R[iat], psi.data(), dpsi.data(), d2psi.data());
+  }
+
+  void evaluate(const ParticleSet& P, int iat,
+                ValueVector_t& psi, GradVector_t& dpsi, HessVector_t& grad_grad_psi)
+  {
+    APP_ABORT("GaussianSPOSet::evaluate with hessians not implemented");
+  }
+
+  void evaluate_notranspose(const ParticleSet& P, int first, int last,
+                            ValueMatrix_t& logdet, GradMatrix_t& dlogdet, ValueMatrix_t& d2logdet)
+  {
+    for (int iat = first, i = 0; iat < last; iat++, i++)
+      evaluate_vgl(P.R[iat], logdet[i], dlogdet[i], d2logdet[i]);
+  }
+};
+
+TEST_CASE("Evaluate_ecp_virtual_moves","[hamiltonian]")
+{
+  OHMMS::Controller->initialize(0, NULL);
+  Communicate *c = OHMMS::Controller;
+  OhmmsInfo("testlogfile");
+
+  ParticleSet ions;
+  ParticleSet elec;
+
+  ions.setName("ion");
+  ions.create(1);
+  ions.R[0] = 0.0;
+  SpeciesSet &ion_species = ions.getSpeciesSet();
+  int CIdx = ion_species.addSpecies("C");
+  int CChargeIdx = ion_species.addAttribute("charge");
+  ion_species(CChargeIdx, CIdx) = 4;
+  ions.resetGroups();
+
+  elec.setName("elec");
+  std::vector<int> ud(2);
+  ud[0] = ud[1] = 2;
+  elec.create(ud);
+  elec.R[0][0] =  0.5; elec.R[0][1] =  0.1; elec.R[0][2] =  0.2;
+  elec.R[1][0] = -0.3; elec.R[1][1] =  0.6; elec.R[1][2] =  0.1;
+  elec.R[2][0] =  0.2; elec.R[2][1] = -0.4; elec.R[2][2] =  0.7;
+  elec.R[3][0] =  0.9; elec.R[3][1] =  0.3; elec.R[3][2] = -0.2;
+  SpeciesSet &tspecies = elec.getSpeciesSet();
+  int upIdx = tspecies.addSpecies("u");
+  int downIdx = tspecies.addSpecies("d");
+  int chargeIdx = tspecies.addAttribute("charge");
+  tspecies(chargeIdx, upIdx) = -1;
+  tspecies(chargeIdx, downIdx) = -1;
+  elec.resetGroups();
+  int myTableIndex = elec.addTable(ions);
+
+  TrialWaveFunction psi(c);
+
+  // Slater determinants of the analytic orbitals
+  SPOSetBasePtr spo = new GaussianSPOSet;
+  SlaterDet *slater = new SlaterDet(elec);
+  DiracDeterminantBase *det_up = new DiracDeterminantBase(spo, 0);
+  det_up->set(0, 2);
+  slater->add(det_up, 0);
+  DiracDeterminantBase *det_dn = new DiracDeterminantBase(spo, 2);
+  det_dn->set(2, 2);
+  slater->add(det_dn, 1);
+  REQUIRE(slater->HaveRatiosForVP);
+  psi.addOrbital(slater, "SlaterDet", true);
+
+  const char *jastrows_xml = "<tmp> \
+<jastrow name=\"J1\" type=\"One-Body\" function=\"Bspline\" source=\"ion\"> \
+  <correlation elementType=\"C\" rcut=\"4\" size=\"4\"> \
+    <coefficients id=\"eC\" type=\"Array\"> -0.4 -0.3 -0.15 -0.05</coefficients> \
+  </correlation> \
+</jastrow> \
+<jastrow name=\"J2\" type=\"Two-Body\" function=\"Bspline\"> \
+  <correlation rcut=\"4\" size=\"4\" speciesA=\"u\" speciesB=\"d\"> \
+    <coefficients id=\"ud\" type=\"Array\"> 0.2 0.1 0.05 0.02</coefficients> \
+  </correlation> \
+  <correlation rcut=\"4\" size=\"4\" speciesA=\"u\" speciesB=\"u\"> \
+    <coefficients id=\"uu\" type=\"Array\"> 0.1 0.05 0.02 0.01</coefficients> \
+  </correlation> \
+</jastrow> \
+</tmp>";
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(jastrows_xml);
+  REQUIRE(okay);
+  xmlNodePtr j1_node = xmlFirstElementChild(doc.getRoot());
+  xmlNodePtr j2_node = xmlNextElementSibling(j1_node);
+  BsplineJastrowBuilder j1_builder(elec, psi, ions);
+  REQUIRE(j1_builder.put(j1_node));
+  BsplineJastrowBuilder j2_builder(elec, psi);
+  REQUIRE(j2_builder.put(j2_node));
+
+  elec.update();
+  psi.evaluateLog(elec);
+  REQUIRE(psi.hasRatiosForVP());
+
+  ECPComponentBuilder ecp("test_read_ecp", c);
+  okay = ecp.read_pp_file("C.BFD.xml");
+  REQUIRE(okay);
+  NonLocalECPComponent *nlpp = ecp.pp_nonloc;
+  nlpp->myTableIndex = myTableIndex;
+  // the knots of the quadrature without a random rotation
+  ParticleSet::ParticlePos_t sphere(nlpp->nknot);
+  for (int j = 0; j < nlpp->nknot; j++)
+    sphere[j] = nlpp->sgridxyz_m[j];
+  nlpp->randomize_grid(sphere, false);
+
+  // knot by knot
+  double v_knots = nlpp->evaluate(elec, 0, psi);
+  REQUIRE(v_knots != 0.0);
+
+  // all the knots of an electron at once
+  double v_vp = nlpp->evaluateVP(elec, 0, psi);
+  REQUIRE(v_vp == Approx(v_knots));
+
+  // the up determinant falls back to the moves knot by knot
+  det_up->HaveRatiosForVP = false;
+  double v_mixed = nlpp->evaluateVP(elec, 0, psi);
+  REQUIRE(v_mixed == Approx(v_knots));
+
+  std::vector<NonLocalData> Txy_knots, Txy_vp;
+  nlpp->evaluate(elec, psi, 0, Txy_knots);
+  det_up->HaveRatiosForVP = true;
+  nlpp->evaluateVP(elec, 0, psi, Txy_vp);
+  REQUIRE(Txy_vp.size() == Txy_knots.size());
+  for (int i = 0; i < Txy_vp.size(); i++)
+  {
+    REQUIRE(Txy_vp[i].PID == Txy_knots[i].PID);
+    REQUIRE(Txy_vp[i].Weight == Approx(Txy_knots[i].Weight));
+  }
+
+  delete nlpp;
 }
 
+}
@@ -32,6 +32,9 @@
 #endif
 #endif
 #include "QMCWaveFunctions/CompositeSPOSet.h"
+#if defined(HAVE_EINSPLINE) && !defined(QMC_COMPLEX) && OHMMS_DIM==3
+#include "QMCWaveFunctions/LocalizedSPOSet.h"
+#endif
 #include "QMCWaveFunctions/OptimizableSPOBuilder.h"
 #include "QMCWaveFunctions/AFMSPOBuilder.h"
 #include "Utilities/ProgressReportEngine.h"
@@ -166,6 +169,13 @@ BasisSetBuilder* BasisSetFactory::createBasisSet(xmlNodePtr cur,xmlNodePtr  root
     app_log() << "Composite SPO set with existing SPOSets." << std::endl;
     bb= new  CompositeSPOSetBuilder();
   }
+#if defined(HAVE_EINSPLINE) && !defined(QMC_COMPLEX) && OHMMS_DIM==3
+  else if (type == "localized")
+  {
+    app_log() << "Localized SPO set with an existing SPOSet." << std::endl;
+    bb= new  LocalizedSPOSetBuilder(targetPtcl);
+  }
+#endif
   else if (type == "jellium" || type == "heg")
   {
     app_log()<<"Electron gas SPO set"<< std::endl;
@@ -26,7 +26,8 @@
 namespace qmcplusplus
 {
   BsplineReaderBase::BsplineReaderBase(EinsplineSetBuilder* e)
-    : mybuilder(e), MeshSize(0), myFirstSPO(0),myNumOrbs(0),GridFactor(1),Rcut(0)
+    : mybuilder(e), MeshSize(0), myFirstSPO(0),myNumOrbs(0),GridFactor(1),Rcut(0),
+      UseSharedTable(true), NodeMem(0)
   {
     myComm=mybuilder->getCommunicator();
   }
@@ -51,6 +52,7 @@ namespace qmcplusplus
 
   BsplineReaderBase::~BsplineReaderBase() 
   {
+    delete NodeMem;
   }
 
   inline std::string make_bandinfo_filename(const std::string& root, int spin, int twist, const Tensor<int,3>& tilematrix, int gid)
@@ -83,10 +85,13 @@ namespace qmcplusplus
 
   void BsplineReaderBase::setCommon(xmlNodePtr cur)
   {
+    std::string shared("yes");
     OhmmsAttributeSet a;
     a.add(Rcut,"rmax_core");
     a.add(GridFactor,"dilation");
+    a.add(shared,"shared_table");
     a.put(cur);
+    UseSharedTable=(shared=="yes");
 
     app_log() << "Rcut = " << Rcut << std::endl;
     app_log() << "dilation = " << GridFactor << std::endl;
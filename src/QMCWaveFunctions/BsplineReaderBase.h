@@ -21,6 +21,9 @@
 #define QMCPLUSPLUS_BSPLINE_READER_BASE_H
 #include <mpi/collectives.h>
 #include <mpi/point2point.h>
+#include <Message/NodeSharedMemory.h>
+#include <spline/einspline_engine.hpp>
+#include <spline/einspline_util.hpp>
 namespace qmcplusplus
 {
 
@@ -55,6 +58,10 @@ struct BsplineReaderBase
   ///cutoff radius for multigrid or other things
   double Rcut;
   /** @}*/
+  ///share the spline tables among the tasks on a node
+  bool UseSharedTable;
+  ///memory shared on a node, created with the first shared table
+  NodeSharedMemory* NodeMem;
   ///map from spo index to band index
   std::vector<std::vector<int> > spo2band;
 
@@ -152,6 +159,103 @@ struct BsplineReaderBase
     app_log().flush();
   }
 
+  ///return true if the spline tables are shared by the tasks on a node
+  inline bool shared_table() const
+  {
+    return UseSharedTable && myComm->size()>1;
+  }
+
+  ///return true if this task writes to the spline tables
+  inline bool fill_table() const
+  {
+    return !shared_table() || NodeMem->isHead();
+  }
+
+  ///make the spline tables filled by the heads visible to all the tasks on a node
+  inline void sync_table()
+  {
+    if(shared_table())
+      NodeMem->barrier();
+  }
+
+  ///create the node groups on the first use, collective over myComm
+  inline NodeSharedMemory* node_memory()
+  {
+    if(NodeMem==0)
+      NodeMem=new NodeSharedMemory(myComm);
+    return NodeMem;
+  }
+
+  /** rank of this task among the tasks which read and exchange the bands
+   *
+   * Only the node heads read the bands of a shared table, -1 on the other tasks.
+   */
+  inline int reader_rank()
+  {
+    return shared_table()?node_memory()->headRank():myComm->rank();
+  }
+
+  ///number of the tasks which read and exchange the bands
+  inline int num_readers()
+  {
+    return shared_table()?node_memory()->numHeads():myComm->size();
+  }
+
+  /** bcast the coefficients of a band among the readers
+   * @param coefs coefficients of a single spline
+   * @param n number of the coefficients
+   * @param root reader_rank of the sender
+   */
+  template<typename T>
+  inline void bcast_band(T* coefs, size_t n, int root)
+  {
+    if(shared_table())
+      node_memory()->bcastHeads(coefs,n*sizeof(T),root);
+    else
+      mpi::bcast(*myComm,coefs,static_cast<int>(n),root);
+  }
+
+  /** number of the single splines to receive the bands of the other tasks
+   *
+   * One band is received and copied at a time, none in a serial run.
+   */
+  inline int num_band_buffers() const
+  {
+    return (myComm->size()>1)?1:0;
+  }
+
+  /** move the coefficients of a spline table to the memory shared on a node
+   * @param spline table created by einspline, collective over myComm
+   *
+   * Only the root and the heads of the other nodes may write to a shared
+   * table and it has to be distributed by bcast_spline.
+   */
+  template<typename ENGT>
+  inline void share_spline(ENGT* spline)
+  {
+    if(!shared_table())
+      return;
+    size_t nbytes=spline->coefs_size*sizeof(*(spline->coefs));
+    void* shared=node_memory()->allocate(nbytes);
+    free(spline->coefs);
+    spline->coefs=static_cast<decltype(spline->coefs)>(shared);
+    app_log() << "  Sharing " << (nbytes>>20) << " MB spline table among "
+              << NodeMem->nodeSize() << " tasks on a node" << std::endl;
+  }
+
+  /** bcast a spline table from the root
+   *
+   * A shared table is sent to the heads of the nodes only.
+   */
+  template<typename ENGT>
+  inline void bcast_spline(ENGT* spline)
+  {
+    if(shared_table())
+      NodeMem->bcast(spline->coefs,spline->coefs_size*sizeof(*(spline->coefs)));
+    else
+      chunked_bcast(myComm,spline);
+  }
+
   /** return the path name in hdf5
    */
   inline std::string psi_g_path(int ti, int spin, int ib)
@@ -99,6 +99,13 @@ public:
 
   virtual void copyFromBuffer(ParticleSet& P, BufferType& buf) {}
 
+  virtual OrbitalBasePtr makeClone(ParticleSet& tqp) const
+  {
+    ConstantOrbital* myclone=new ConstantOrbital;
+    myclone->FakeGradRatio=FakeGradRatio;
+    return myclone;
+  }
+
 };
 
 
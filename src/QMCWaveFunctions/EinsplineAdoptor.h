@@ -21,6 +21,8 @@
  * - evaluate_v    value only
  * - evaluate_vgl  vgl
  * - evaluate_vgh  vgh
+ * BsplineSet<SplineAdoptor>::mw_evaluate evaluates a moved particle of many walkers,
+ * one walker at a time.
  * Specializations are implemented  in Spline*Adoptor.h and include
  * - SplineC2RAdoptor<ST,TT,D> : real wavefunction using complex einspline, tiling
  * - SplineC2CAdoptor<ST,TT,D> : complex wavefunction using complex einspline, tiling
@@ -184,8 +186,12 @@ struct BsplineSet: public SPOSetBase, public SplineAdoptor
   typedef typename SplineAdoptor::SplineType SplineType;
   typedef typename SplineAdoptor::PointType  PointType;
 
-  ///** default constructor */
-  //BsplineSet() { }
+  ///default constructor
+  BsplineSet()
+  {
+    HaveValuesForVP=true;
+    CanBatchWalkers=true;
+  }
 
   SPOSetBase* makeClone() const
   {
@@ -233,6 +239,28 @@ struct BsplineSet: public SPOSetBase, public SplineAdoptor
     SplineAdoptor::evaluate_vgh(P.R[iat],psi,dpsi,grad_grad_psi);
   }
 
+  /** evaluate the values of the iat-th particle of many walkers
+   *
+   * Only the multi-walker interface: each walker is evaluated by the
+   * single-point kernel of SplineAdoptor and nothing is shared between the
+   * walkers. A faster version needs multi-point kernels in einspline.
+   */
+  void mw_evaluate(const std::vector<ParticleSet*>& P_list, int iat,
+                   const std::vector<ValueVector_t*>& psi_list)
+  {
+    for(int iw=0; iw<P_list.size(); ++iw)
+      SplineAdoptor::evaluate_v(P_list[iw]->R[iat],*psi_list[iw]);
+  }
+
+  void mw_evaluate(const std::vector<ParticleSet*>& P_list, int iat,
+                   const std::vector<ValueVector_t*>& psi_list,
+                   const std::vector<GradVector_t*>& dpsi_list,
+                   const std::vector<ValueVector_t*>& d2psi_list)
+  {
+    for(int iw=0; iw<P_list.size(); ++iw)
+      SplineAdoptor::evaluate_vgl(P_list[iw]->R[iat],*psi_list[iw],*dpsi_list[iw],*d2psi_list[iw]);
+  }
+
   void resetParameters(const opt_variables_type& active)
   { }
 
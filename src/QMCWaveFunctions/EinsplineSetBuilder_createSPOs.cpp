@@ -263,6 +263,11 @@ EinsplineSetBuilder::createSPOSetFromXML(xmlNodePtr cur)
   if(spinSet==0) TileIons();
 
   bool use_single= (spo_prec == "single" || spo_prec == "float");
+  if(use_single)
+  {
+    qmc_common.use_single_spo=true;
+    app_log() << "  Using single-precision spline coefficients" << std::endl;
+  }
 
   if (UseRealOrbitals)
   {
@@ -0,0 +1,193 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/**@file DelayedUpdate.h
+ * @brief Declaration of DelayedUpdate, the rank-k (Woodbury) inverse update engine
+ */
+#ifndef QMCPLUSPLUS_DELAYED_UPDATE_H
+#define QMCPLUSPLUS_DELAYED_UPDATE_H
+
+#include "OhmmsPETE/OhmmsVector.h"
+#include "OhmmsPETE/OhmmsMatrix.h"
+#include "Numerics/OhmmsBlas.h"
+#include <algorithm>
+
+namespace qmcplusplus
+{
+
+/** implements delayed update of the inverse of a Slater matrix
+ *
+ * The matrix Ainv follows the convention of DiracDeterminantBase::psiM,
+ * the row-major storage of the transposed inverse, so that the ratio of a
+ * row replacement is the dot product of Ainv[row] and the new orbital row.
+ *
+ * Up to K accepted row replacements are kept in U (new orbital rows) and
+ * V (the stale rows of Ainv). With \f$B_{lm}=V_l\cdot U_m\f$, the current
+ * inverse is \f$Ainv - (Ainv U^T - E) B^{-1} V\f$ where E selects the
+ * replaced rows. Ratios and gradients use the corrected row via getInvRow,
+ * and Ainv itself is brought up to date with three GEMMs by updateInvMat
+ * once K rows are delayed or a consumer needs the full matrix.
+ */
+template<typename T>
+class DelayedUpdate
+{
+  ///orbital values of the delayed rows, delay x norb
+  Matrix<T> U;
+  ///stale rows of Ainv of the delayed rows, delay x norb
+  Matrix<T> V;
+  ///inverse of B, at most delay x delay
+  Matrix<T> Binv;
+  ///scratch space, norb x delay
+  Matrix<T> tempMat;
+  ///scratch vectors of size delay
+  Vector<T> p, q, w;
+  ///row indices of the delayed rows
+  std::vector<int> delay_list;
+  ///current number of delayed rows
+  int delay_count;
+
+public:
+  DelayedUpdate(): delay_count(0) {}
+
+  ///return the maximum number of delayed rows
+  inline int delay() const
+  {
+    return Binv.cols();
+  }
+
+  ///return the current number of delayed rows
+  inline int pending() const
+  {
+    return delay_count;
+  }
+
+  /** resize the internal storage
+   * @param norb number of orbitals (rows of Ainv)
+   * @param delay maximum number of delayed rows
+   */
+  inline void resize(int norb, int delay)
+  {
+    U.resize(delay,norb);
+    V.resize(delay,norb);
+    Binv.resize(delay,delay);
+    tempMat.resize(norb,delay);
+    p.resize(delay);
+    q.resize(delay);
+    w.resize(delay);
+    delay_list.resize(delay);
+    delay_count=0;
+  }
+
+  ///discard delayed rows when Ainv has been recomputed or restored
+  inline void initializeInv(const Matrix<T>& Ainv)
+  {
+    delay_count=0;
+  }
+
+  /** compute the up-to-date row of the inverse
+   * @param Ainv stale inverse
+   * @param rowchanged row index
+   * @param invRow output row of the current inverse
+   */
+  template<typename VVT>
+  inline void getInvRow(const Matrix<T>& Ainv, int rowchanged, VVT& invRow)
+  {
+    const int norb=Ainv.rows();
+    std::copy(Ainv[rowchanged],Ainv[rowchanged]+norb,invRow.data());
+    if(delay_count==0)
+      return;
+    const T cone(1);
+    const T czero(0);
+    const int lda_Binv=Binv.cols();
+    BLAS::gemv('T',norb,delay_count,cone,U.data(),norb,invRow.data(),1,czero,p.data(),1);
+    for(int l=0; l<delay_count; ++l)
+      if(delay_list[l]==rowchanged)
+        p[l]-=cone;
+    BLAS::gemv('N',delay_count,delay_count,cone,Binv.data(),lda_Binv,p.data(),1,czero,q.data(),1);
+    BLAS::gemv('N',norb,delay_count,-cone,V.data(),norb,q.data(),1,cone,invRow.data(),1);
+  }
+
+  /** accept a row replacement and delay its application to Ainv
+   * @param Ainv stale inverse, updated when the delay buffer is full
+   * @param rowchanged row index
+   * @param psiV new orbital row
+   */
+  template<typename VVT>
+  inline void acceptRow(Matrix<T>& Ainv, int rowchanged, const VVT& psiV)
+  {
+    //the Woodbury form holds for distinct rows only
+    for(int l=0; l<delay_count; ++l)
+      if(delay_list[l]==rowchanged)
+      {
+        updateInvMat(Ainv);
+        break;
+      }
+    const T cone(1);
+    const T czero(0);
+    const int norb=Ainv.rows();
+    const int lda_Binv=Binv.cols();
+    const int k=delay_count;
+    std::copy(Ainv[rowchanged],Ainv[rowchanged]+norb,V[k]);
+    std::copy(psiV.data(),psiV.data()+norb,U[k]);
+    delay_list[k]=rowchanged;
+    // p_l = V_l . u for l<=k, p_k is the bare ratio
+    BLAS::gemv('T',norb,k+1,cone,V.data(),norb,psiV.data(),1,czero,p.data(),1);
+    T s=p[k];
+    if(k>0)
+    {
+      // q = B^{-T} U V_k, w = B^{-1} p
+      BLAS::gemv('T',norb,k,cone,U.data(),norb,V[k],1,czero,w.data(),1);
+      BLAS::gemv('N',k,k,cone,Binv.data(),lda_Binv,w.data(),1,czero,q.data(),1);
+      BLAS::gemv('T',k,k,cone,Binv.data(),lda_Binv,p.data(),1,czero,w.data(),1);
+      for(int l=0; l<k; ++l)
+        s-=q[l]*p[l];
+    }
+    // grow B^{-1} by the Schur complement s
+    const T sinv=cone/s;
+    if(k>0)
+      BLAS::ger(k,k,sinv,q.data(),1,w.data(),1,Binv.data(),lda_Binv);
+    for(int l=0; l<k; ++l)
+    {
+      Binv(k,l)=-sinv*q[l];
+      Binv(l,k)=-sinv*w[l];
+    }
+    Binv(k,k)=sinv;
+    delay_count++;
+    if(delay_count==lda_Binv)
+      updateInvMat(Ainv);
+  }
+
+  /** apply all the delayed rows to Ainv
+   * @param Ainv inverse, up to date on exit
+   */
+  inline void updateInvMat(Matrix<T>& Ainv)
+  {
+    if(delay_count==0)
+      return;
+    const T cone(1);
+    const T czero(0);
+    const int norb=Ainv.rows();
+    const int lda_Binv=Binv.cols();
+    // tempMat = Ainv U^T - E
+    BLAS::gemm('T','N',delay_count,norb,norb,cone,U.data(),norb,Ainv.data(),norb,czero,tempMat.data(),lda_Binv);
+    for(int l=0; l<delay_count; ++l)
+      tempMat(delay_list[l],l)-=cone;
+    // U = B^{-1} V, U is no longer needed
+    BLAS::gemm('N','N',norb,delay_count,delay_count,cone,V.data(),norb,Binv.data(),lda_Binv,czero,U.data(),norb);
+    // Ainv -= tempMat U
+    BLAS::gemm('N','N',norb,norb,delay_count,-cone,U.data(),norb,tempMat.data(),lda_Binv,cone,Ainv.data(),norb);
+    delay_count=0;
+  }
+};
+
+}
+#endif
@@ -32,7 +32,7 @@ namespace qmcplusplus
  *@param first index of the first particle
  */
 DiracDeterminantBase::DiracDeterminantBase(SPOSetBasePtr const &spos, int first):
-  NP(0), Phi(spos), FirstIndex(first)
+  NP(0), Phi(spos), FirstIndex(first), DelayRank(1)
   ,UpdateTimer("DiracDeterminantBase::update",timer_level_fine)
   ,RatioTimer("DiracDeterminantBase::ratio",timer_level_fine)
   ,InverseTimer("DiracDeterminantBase::inverse",timer_level_fine)
@@ -44,6 +44,7 @@ DiracDeterminantBase::DiracDeterminantBase(SPOSetBasePtr const &spos, int first)
   if(Phi->Optimizable)
     Optimizable=true;
   OrbitalName="DiracDeterminantBase";
+  HaveRatiosForVP=Phi->HaveValuesForVP;
   registerTimers();
 }
 
@@ -67,6 +68,13 @@ void DiracDeterminantBase::set(int first, int nel)
   resize(nel,nel);
 }
 
+void DiracDeterminantBase::setDelayRank(int delay)
+{
+  DelayRank=std::max(1,std::min(delay,NumOrbitals));
+  if(DelayRank>1)
+    UpdateEngine.resize(NumOrbitals,DelayRank);
+}
+
 
 ///reset the size: with the number of particles and number of orbtials
 void DiracDeterminantBase::resize(int nel, int morb)
@@ -82,6 +90,9 @@ void DiracDeterminantBase::resize(int nel, int morb)
   d2psiM_temp.resize(nel,norb);
   psiMinv.resize(nel,norb);
   psiV.resize(norb);
+  invRow.resize(norb);
+  if(DelayRank>1)
+    UpdateEngine.resize(norb,DelayRank);
 #ifdef MIXED_PRECISION
   psiM_hp.resize(nel,norb);
   WorkSpace_hp.resize(nel);
@@ -158,6 +169,9 @@ DiracDeterminantBase::RealType DiracDeterminantBase::updateBuffer(ParticleSet& P
   }
   else
   {
+    UpdateTimer.start();
+    completeUpdates();
+    UpdateTimer.stop();
     if(UpdateMode == ORB_PBYP_RATIO)
     {
       SPOVGLTimer.start();
@@ -201,6 +215,7 @@ DiracDeterminantBase::RealType DiracDeterminantBase::updateBuffer(ParticleSet& P
   //copy psiM to psiM_temp
   //psiM_temp=psiM;
   simd::copy(psiM_temp.data(),psiM.data(),psiM.size());
+  //the matrices own their storage and cannot view a slot of buf, copy them
   buf.put(psiM.first_address(),psiM.last_address());
   buf.put(FirstAddressOfdV,LastAddressOfdV);
   buf.put(d2psiM.first_address(),d2psiM.last_address());
@@ -215,6 +230,7 @@ DiracDeterminantBase::RealType DiracDeterminantBase::updateBuffer(ParticleSet& P
 void DiracDeterminantBase::copyFromBuffer(ParticleSet& P, PooledData<RealType>& buf)
 {
   BufferTimer.start();
+  //copied as in updateBuffer, unlike the lent slots of J2OrbitalSoA
   buf.get(psiM.first_address(),psiM.last_address());
   buf.get(FirstAddressOfdV,LastAddressOfdV);
   buf.get(d2psiM.first_address(),d2psiM.last_address());
@@ -222,6 +238,8 @@ void DiracDeterminantBase::copyFromBuffer(ParticleSet& P, PooledData<RealType>&
   buf.get(FirstAddressOfG,LastAddressOfG);
   buf.get(LogValue);
   buf.get(PhaseValue);
+  if(DelayRank>1)
+    UpdateEngine.initializeInv(psiM);
   //re-evaluate it for testing
   //Phi.evaluate(P, FirstIndex, LastIndex, psiM, dpsiM, d2psiM);
   //CurrentDet = Invert(psiM.data(),NumPtcls,NumOrbitals);
@@ -263,16 +281,39 @@ DiracDeterminantBase::ValueType DiracDeterminantBase::ratio(ParticleSet& P, int
   Phi->evaluate(P, iat, psiV);
   SPOVTimer.stop();
   RatioTimer.start();
-  curRatio = DetRatioByRow(psiM, psiV,WorkingIndex);
+  const std::vector<int>* active=Phi->ActiveOrbitals;
+  if(DelayRank>1)
+  {
+    UpdateEngine.getInvRow(psiM,WorkingIndex,invRow);
+    if(active)
+      curRatio=simd::dot(invRow.data(),psiV.data(),active->data(),active->size());
+    else
+      curRatio=simd::dot(invRow.data(),psiV.data(),NumOrbitals);
+  }
+  else if(active)
+    curRatio=simd::dot(psiM[WorkingIndex],psiV.data(),active->data(),active->size());
+  else
+    curRatio = DetRatioByRow(psiM, psiV,WorkingIndex);
   RatioTimer.stop();
   return curRatio;
 }
 
 void DiracDeterminantBase::evaluateRatios(VirtualParticleSet& VP, std::vector<ValueType>& ratios)
 {
-  Matrix<ValueType> psiT(ratios.size(),NumOrbitals);
-  Phi->evaluateValues(VP,psiT);
-  MatrixOperators::product(psiT,psiM[VP.activePtcl-FirstIndex],&ratios[0]);
+  RatioTimer.start();
+  if(psiVP.rows()!=ratios.size())
+    psiVP.resize(ratios.size(),NumOrbitals);
+  SPOVTimer.start();
+  Phi->evaluateValues(VP,psiVP);
+  SPOVTimer.stop();
+  if(DelayRank>1)
+  {
+    UpdateEngine.getInvRow(psiM,VP.activePtcl-FirstIndex,invRow);
+    MatrixOperators::product(psiVP,invRow.data(),&ratios[0]);
+  }
+  else
+    MatrixOperators::product(psiVP,psiM[VP.activePtcl-FirstIndex],&ratios[0]);
+  RatioTimer.stop();
 }
 
 void DiracDeterminantBase::get_ratios(ParticleSet& P, std::vector<ValueType>& ratios)
@@ -280,6 +321,7 @@ void DiracDeterminantBase::get_ratios(ParticleSet& P, std::vector<ValueType>& ra
   SPOVTimer.start();
   Phi->evaluate(P, 0, psiV);
   SPOVTimer.stop();
+  completeUpdates();
   MatrixOperators::product(psiM,psiV.data(),&ratios[FirstIndex]);
 }
 
@@ -289,7 +331,14 @@ DiracDeterminantBase::evalGrad(ParticleSet& P, int iat)
 {
   WorkingIndex = iat-FirstIndex;
   RatioTimer.start();
-  DiracDeterminantBase::GradType g = simd::dot(psiM[WorkingIndex],dpsiM[WorkingIndex],NumOrbitals);
+  DiracDeterminantBase::GradType g;
+  if(DelayRank>1)
+  {
+    UpdateEngine.getInvRow(psiM,WorkingIndex,invRow);
+    g = simd::dot(invRow.data(),dpsiM[WorkingIndex],NumOrbitals);
+  }
+  else
+    g = simd::dot(psiM[WorkingIndex],dpsiM[WorkingIndex],NumOrbitals);
   RatioTimer.stop();
   return g;
 }
@@ -298,6 +347,7 @@ DiracDeterminantBase::GradType
 DiracDeterminantBase::evalGradSource(ParticleSet& P, ParticleSet& source,
                                      int iat)
 {
+  completeUpdates();
   Phi->evaluateGradSource (P, FirstIndex, LastIndex, source, iat, grad_source_psiM);
 //     Phi->evaluate(P, FirstIndex, LastIndex, psiM, dpsiM, d2psiM);
 //     LogValue=InvertWithLog(psiM.data(),NumPtcls,NumOrbitals,WorkSpace.data(),Pivot.data(),PhaseValue);
@@ -327,6 +377,8 @@ DiracDeterminantBase::evalGradSourcep
   LogValue=InvertWithLog(psiM.data(),NumPtcls,NumOrbitals,
                          WorkSpace.data(),Pivot.data(),PhaseValue);
   InverseTimer.stop();
+  if(DelayRank>1)
+    UpdateEngine.initializeInv(psiM);
   GradMatrix_t &Phi_alpha(grad_source_psiM);
   GradMatrix_t &Grad_phi(dpsiM);
   ValueMatrix_t &Grad2_phi(d2psiM);
@@ -456,7 +508,8 @@ void DiracDeterminantBase::evaluateHessian(ParticleSet& P, HessVector_t& grad_gr
       grad_grad_psi[iat]=hess_tmp-outerProduct(rv,rv);
     }
 	 psiM_temp = psiM;
-	
+  if(DelayRank>1)
+    UpdateEngine.initializeInv(psiM);
 }
 
 DiracDeterminantBase::GradType
@@ -468,6 +521,7 @@ DiracDeterminantBase::evalGradSource
   Phi->evaluateGradSource (P, FirstIndex, LastIndex, source, iat,
                            grad_source_psiM, grad_grad_source_psiM,
                            grad_lapl_source_psiM);
+  completeUpdates();
   // HACK HACK HACK
   // Phi->evaluate(P, FirstIndex, LastIndex, psiM, dpsiM, d2psiM);
   // psiM_temp = psiM;
@@ -562,11 +616,62 @@ DiracDeterminantBase::ratioGrad(ParticleSet& P, int iat, GradType& grad_iat)
   SPOVGLTimer.start();
   Phi->evaluate(P, iat, psiV, dpsiV, d2psiV);
   SPOVGLTimer.stop();
+  return ratioGradFromOrbitals(iat,grad_iat);
+}
+
+void
+DiracDeterminantBase::mw_ratioGrad(const std::vector<OrbitalBase*>& WFC_list,
+                                   const std::vector<ParticleSet*>& P_list, int iat,
+                                   std::vector<ValueType>& ratios, std::vector<GradType>& grad_new)
+{
+  if(!Phi->CanBatchWalkers)
+  {
+    //the orbitals use the data bound to the ParticleSet of each walker
+    OrbitalBase::mw_ratioGrad(WFC_list,P_list,iat,ratios,grad_new);
+    return;
+  }
+  const int nw=WFC_list.size();
+  std::vector<ValueVector_t*> psi_list(nw), d2psi_list(nw);
+  std::vector<GradVector_t*> dpsi_list(nw);
+  for(int iw=0; iw<nw; ++iw)
+  {
+    DiracDeterminantBase* det=static_cast<DiracDeterminantBase*>(WFC_list[iw]);
+    psi_list[iw]=&(det->psiV);
+    dpsi_list[iw]=&(det->dpsiV);
+    d2psi_list[iw]=&(det->d2psiV);
+  }
+  SPOVGLTimer.start();
+  Phi->mw_evaluate(P_list, iat, psi_list, dpsi_list, d2psi_list);
+  SPOVGLTimer.stop();
+  for(int iw=0; iw<nw; ++iw)
+    ratios[iw]=static_cast<DiracDeterminantBase*>(WFC_list[iw])->ratioGradFromOrbitals(iat,grad_new[iw]);
+}
+
+DiracDeterminantBase::ValueType
+DiracDeterminantBase::ratioGradFromOrbitals(int iat, GradType& grad_iat)
+{
   RatioTimer.start();
   WorkingIndex = iat-FirstIndex;
   UpdateMode=ORB_PBYP_PARTIAL;
-  curRatio=simd::dot(psiM[WorkingIndex],psiV.data(),NumOrbitals);
-  GradType rv=simd::dot(psiM[WorkingIndex],dpsiV.data(),NumOrbitals);
+  GradType rv;
+  //the sparse rows of a localized SPO set have nonzeros only for the active orbitals
+  const std::vector<int>* active=Phi->ActiveOrbitals;
+  const ValueType* restrict row=psiM[WorkingIndex];
+  if(DelayRank>1)
+  {
+    UpdateEngine.getInvRow(psiM,WorkingIndex,invRow);
+    row=invRow.data();
+  }
+  if(active)
+  {
+    curRatio=simd::dot(row,psiV.data(),active->data(),active->size());
+    rv=simd::dot(row,dpsiV.data(),active->data(),active->size());
+  }
+  else
+  {
+    curRatio=simd::dot(row,psiV.data(),NumOrbitals);
+    rv=simd::dot(row,dpsiV.data(),NumOrbitals);
+  }
   grad_iat += ((RealType)1.0/curRatio) * rv;
   RatioTimer.stop();
   return curRatio;
@@ -611,6 +716,12 @@ DiracDeterminantBase::ValueType DiracDeterminantBase::ratio(ParticleSet& P, int
     ParticleSet::ParticleLaplacian_t& dL)
 {
   UpdateMode=ORB_PBYP_ALL;
+  if(DelayRank>1)
+  {
+    //psiM_temp is updated by the rank-1 path, flush the delayed rows first
+    completeUpdates();
+    simd::copy(psiM_temp.data(),psiM.data(),psiM.size());
+  }
   SPOVGLTimer.start();
   Phi->evaluate(P, iat, psiV, dpsiV, d2psiV);
   SPOVGLTimer.stop();
@@ -670,10 +781,16 @@ void DiracDeterminantBase::acceptMove(ParticleSet& P, int iat)
   switch(UpdateMode)
   {
   case ORB_PBYP_RATIO:
-    InverseUpdateByRow(psiM,psiV,workV1,workV2,WorkingIndex,curRatio);
+    if(DelayRank>1)
+      UpdateEngine.acceptRow(psiM,WorkingIndex,psiV);
+    else
+      InverseUpdateByRow(psiM,psiV,workV1,workV2,WorkingIndex,curRatio);
     break;
   case ORB_PBYP_PARTIAL:
-    InverseUpdateByRow(psiM,psiV,workV1,workV2,WorkingIndex,curRatio);
+    if(DelayRank>1)
+      UpdateEngine.acceptRow(psiM,WorkingIndex,psiV);
+    else
+      InverseUpdateByRow(psiM,psiV,workV1,workV2,WorkingIndex,curRatio);
     //std::copy(dpsiV.begin(),dpsiV.end(),dpsiM[WorkingIndex]);
     //std::copy(d2psiV.begin(),d2psiV.end(),d2psiM[WorkingIndex]);
     simd::copy(dpsiM[WorkingIndex],  dpsiV.data(),  NumOrbitals);
@@ -721,6 +838,7 @@ void DiracDeterminantBase::update(ParticleSet& P,
                                   int iat)
 {
   UpdateTimer.start();
+  completeUpdates();
   InverseUpdateByRow(psiM,psiV,workV1,workV2,WorkingIndex,curRatio);
   //for(int j=0; j<NumOrbitals; j++) {
   //  dpsiM(WorkingIndex,j)=dpsiV[j];
@@ -750,6 +868,7 @@ void DiracDeterminantBase::update(ParticleSet& P,
 DiracDeterminantBase::RealType
 DiracDeterminantBase::evaluateLog(ParticleSet& P, PooledData<RealType>& buf)
 {
+  completeUpdates();
   buf.put(psiM.first_address(),psiM.last_address());
   buf.put(FirstAddressOfdV,LastAddressOfdV);
   buf.put(d2psiM.first_address(),d2psiM.last_address());
@@ -783,6 +902,7 @@ void DiracDeterminantBase::registerDataForDerivatives(ParticleSet& P, PooledData
 
 void DiracDeterminantBase::copyToDerivativeBuffer(ParticleSet& P, PooledData<RealType>& buf)
 {
+  completeUpdates();
   if(DerivStorageType==0)
   {
     buf.put(psiM.first_address(),psiM.last_address());
@@ -907,6 +1027,8 @@ DiracDeterminantBase::evaluateLog(ParticleSet& P,
     RatioTimer.stop();
   }
   psiM_temp = psiM;
+  if(DelayRank>1)
+    UpdateEngine.initializeInv(psiM);
   return LogValue;
 }
 
@@ -936,11 +1058,12 @@ DiracDeterminantBase* DiracDeterminantBase::makeCopy(SPOSetBasePtr spo) const
 {
   DiracDeterminantBase* dclone= new DiracDeterminantBase(spo);
   dclone->set(FirstIndex,LastIndex-FirstIndex);
+  dclone->setDelayRank(DelayRank);
   return dclone;
 }
 
 DiracDeterminantBase::DiracDeterminantBase(const DiracDeterminantBase& s)
-  : OrbitalBase(s), NP(0),Phi(s.Phi),FirstIndex(s.FirstIndex)
+  : OrbitalBase(s), NP(0),Phi(s.Phi),FirstIndex(s.FirstIndex),DelayRank(1)
   ,UpdateTimer(s.UpdateTimer)
   ,RatioTimer(s.RatioTimer)
   ,InverseTimer(s.InverseTimer)
@@ -950,6 +1073,7 @@ DiracDeterminantBase::DiracDeterminantBase(const DiracDeterminantBase& s)
 {
   registerTimers();
   this->resize(s.NumPtcls,s.NumOrbitals);
+  setDelayRank(s.DelayRank);
 }
 
 //SPOSetBasePtr  DiracDeterminantBase::clonePhi() const
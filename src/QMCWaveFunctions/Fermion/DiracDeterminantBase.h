@@ -25,6 +25,7 @@
 #include "QMCWaveFunctions/SPOSetBase.h"
 #include "Utilities/NewTimer.h"
 #include "QMCWaveFunctions/Fermion/BackflowTransformation.h"
+#include "QMCWaveFunctions/Fermion/DelayedUpdate.h"
 
 namespace qmcplusplus
 {
@@ -101,6 +102,21 @@ public:
    *@param nel number of particles in the determinant
    */
   virtual void set(int first, int nel);
+
+  /** set the number of accepted moves to delay before updating the inverse
+   *@param delay rank of the delayed update, 1 uses the Sherman-Morrison update
+   *
+   * Must be called after set.
+   */
+  void setDelayRank(int delay);
+
+  /** apply the delayed row updates to psiM
+   */
+  inline void completeUpdates()
+  {
+    if(DelayRank>1)
+      UpdateEngine.updateInvMat(psiM);
+  }
   virtual RealType getAlternatePhaseDiff()
   {
     return 0.0;
@@ -203,6 +219,9 @@ public:
   virtual ValueType ratio(ParticleSet& P, int iat);
 
   /** compute multiple ratios for a particle move
+   *
+   * Available when Phi->HaveValuesForVP: the orbitals of all the virtual moves
+   * are evaluated by one call to Phi and contracted with a row of the inverse.
    */
   virtual void evaluateRatios(VirtualParticleSet& VP, std::vector<ValueType>& ratios);
 
@@ -225,6 +244,16 @@ public:
 
 
   virtual ValueType ratioGrad(ParticleSet& P, int iat, GradType& grad_iat);
+  /** evaluate the orbitals of the walkers by SPOSetBase::mw_evaluate and the ratios
+   * with the inverse of each walker
+   *
+   * Uses ratioGrad of each walker unless Phi->CanBatchWalkers.
+   */
+  virtual void mw_ratioGrad(const std::vector<OrbitalBase*>& WFC_list,
+                            const std::vector<ParticleSet*>& P_list, int iat,
+                            std::vector<ValueType>& ratios, std::vector<GradType>& grad_new);
+  ///ratio and gradient with the orbitals of the new position in psiV and dpsiV
+  ValueType ratioGradFromOrbitals(int iat, GradType& grad_iat);
   virtual GradType evalGrad(ParticleSet& P, int iat);
   virtual GradType evalGradSource(ParticleSet &P, ParticleSet &source,
                                   int iat);
@@ -299,6 +328,8 @@ public:
   int LastIndex;
   ///index of the particle (or row)
   int WorkingIndex;
+  ///maximum number of accepted moves delayed before updating psiM
+  int DelayRank;
   ///a set of single-particle orbitals used to fill in the  values of the matrix
   SPOSetBasePtr Phi;
 
@@ -324,10 +355,17 @@ public:
   ValueMatrix_t lapl_phi_Minv;
   HessMatrix_t grad_phi_alpha_Minv;
 
+  ///engine for the delayed updates of psiM, used when DelayRank>1
+  DelayedUpdate<ValueType> UpdateEngine;
+  ///up-to-date row of the inverse with the delayed updates applied
+  ValueVector_t invRow;
+
   /// value of single-particle orbital for particle-by-particle update
   ValueVector_t psiV;
   GradVector_t dpsiV;
   ValueVector_t d2psiV;
+  ///values of single-particle orbitals for the virtual moves, psiVP(k,j) for the k-th move
+  ValueMatrix_t psiVP;
   ValueVector_t workV1, workV2;
   GradVector_t workG;
 
@@ -30,6 +30,7 @@ namespace qmcplusplus
 DiracDeterminantIterative::DiracDeterminantIterative(SPOSetBasePtr const &spos, int first):
   DiracDeterminantBase(spos,first)
 {
+  HaveRatiosForVP=false;
 }
 
 ///default destructor
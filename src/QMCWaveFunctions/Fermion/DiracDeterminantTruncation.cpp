@@ -34,6 +34,7 @@ namespace qmcplusplus
 DiracDeterminantTruncation::DiracDeterminantTruncation(SPOSetBasePtr const &spos, int first):
   DiracDeterminantBase(spos,first)
 {
+  HaveRatiosForVP=false;
 }
 
 ///default destructor
@@ -34,6 +34,8 @@ DiracDeterminantWithBackflow::DiracDeterminantWithBackflow(ParticleSet &ptcl, SP
   Optimizable=true;
   usingDerivBuffer=false;
   OrbitalName="DiracDeterminantWithBackflow";
+  //a virtual move displaces all the quasiparticles, TrialWaveFunction moves the knots one by one
+  HaveRatiosForVP=false;
   registerTimers();
   BFTrans=BF;
   NumParticles = ptcl.getTotalNum();
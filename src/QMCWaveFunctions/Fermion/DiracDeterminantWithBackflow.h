@@ -133,6 +133,12 @@ public:
                   ParticleSet::ParticleLaplacian_t& dL);
 
   ValueType ratioGrad(ParticleSet& P, int iat, GradType& grad_iat);
+  void mw_ratioGrad(const std::vector<OrbitalBase*>& WFC_list,
+                    const std::vector<ParticleSet*>& P_list, int iat,
+                    std::vector<ValueType>& ratios, std::vector<GradType>& grad_new)
+  {
+    OrbitalBase::mw_ratioGrad(WFC_list,P_list,iat,ratios,grad_new);
+  }
   GradType evalGrad(ParticleSet& P, int iat);
   GradType evalGradSource(ParticleSet &P, ParticleSet &source,
                           int iat);
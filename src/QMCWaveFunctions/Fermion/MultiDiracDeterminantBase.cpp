@@ -58,6 +58,7 @@ void MultiDiracDeterminantBase::createDetData(ci_configuration2& ref, std::vecto
   std::vector<int> pos(NumPtcls);
   std::vector<int> ocp(NumPtcls);
   std::vector<int> uno(NumPtcls);
+  std::vector<bool> newPair(NumPtcls*NumOrbitals,true);
   data.clear();
   sign.resize(nci);
   pairs.clear();
@@ -79,11 +80,49 @@ void MultiDiracDeterminantBase::createDetData(ci_configuration2& ref, std::vecto
       {
 //           std::pair<int,int> temp(ocp[k1],uno[k2]);
         std::pair<int,int> temp(pos[k1],uno[k2]);
-        if(find(pairs.begin(),pairs.end(),temp) == pairs.end()) //pair is new
+        if(newPair[pos[k1]*NumOrbitals+uno[k2]])
+        {
+          newPair[pos[k1]*NumOrbitals+uno[k2]]=false;
           pairs.push_back(temp);
+        }
       }
   }
   app_log()<<"Number of terms in pairs array: " <<pairs.size() << std::endl;
+  // group the determinants other than the reference by the excitation level
+  std::vector<int> counts;
+  std::vector<int>::const_iterator it(data.begin());
+  for(int i=0; i<nci; i++)
+  {
+    nex=*it;
+    if(i != ReferenceDeterminant)
+    {
+      if(nex>=counts.size())
+        counts.resize(nex+1,0);
+      counts[nex]++;
+    }
+    it+=3*nex+1;
+  }
+  ExcitationGroups.resize(counts.size());
+  for(int l=0; l<counts.size(); l++)
+  {
+    ExcitationGroups[l].resize(l,counts[l]);
+    counts[l]=0;
+  }
+  it=data.begin();
+  for(int i=0; i<nci; i++)
+  {
+    nex=*it;
+    if(i != ReferenceDeterminant)
+      ExcitationGroups[nex].set(counts[nex]++,i,sign[i],it+1);
+    it+=3*nex+1;
+  }
+  for(int l=0; l<counts.size(); l++)
+    if(counts[l])
+      app_log()<<"  Number of determinants with " <<l <<" excitations: " <<counts[l] << std::endl;
+  // the full table by a GEMM is cheaper if the unique pairs cover a large part of it
+  UseTableGEMM = (4*pairs.size() > NumPtcls*NumOrbitals);
+  // the excitation groups replace the linear encoding, release it
+  std::vector<int>().swap(data);
   /*
        std::cout <<"ref: " <<ref << std::endl;
        std::cout <<"list: " << std::endl;
@@ -376,6 +415,7 @@ MultiDiracDeterminantBase::MultiDiracDeterminantBase(SPOSetBasePtr const &spos,
   ExtraStuffTimer("MultiDiracDeterminantBase::ExtraStuff")
 {
   Optimizable=true;
+  UseTableGEMM=false;
   OrbitalName="MultiDiracDeterminantBase";
   registerTimers();
 }
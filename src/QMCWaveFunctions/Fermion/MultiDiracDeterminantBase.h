@@ -147,6 +147,31 @@ public:
     dets += NumDets*(1 + 4*NumPtcls);
   }
 
+  /** report the memory of the expansion data shared by the walkers
+   * @param os output stream
+   * @return bytes of the expansion data
+   */
+  size_t reportMemory(std::ostream& os) const
+  {
+    size_t strings=0;
+    for(int i=0; i<confgList.size(); ++i)
+      strings+=confgList[i].occup.size()*sizeof(int);
+    size_t excitations=DetSigns.size()*sizeof(RealType)+uniquePairs.size()*sizeof(std::pair<int,int>);
+    for(int l=0; l<ExcitationGroups.size(); ++l)
+    {
+      const ExcitationGroup<ValueType,RealType>& g=ExcitationGroups[l];
+      excitations+=g.Dets.size()*(sizeof(int)+sizeof(RealType)+sizeof(ValueType))+g.Index.size()*sizeof(int);
+    }
+    size_t table=dotProducts.size()*sizeof(ValueType);
+    size_t values=(detValues.size()+new_detValues.size()+lapls.size()+new_lapls.size())*sizeof(ValueType)
+                  +(grads.size()+new_grads.size())*sizeof(GradType);
+    os << "    unique strings       " << NumDets << " : " << strings/1.0e6 << " MB" << std::endl;
+    os << "    excitation lists     " << excitations/1.0e6 << " MB" << std::endl;
+    os << "    table of reference   " << table/1.0e6 << " MB" << std::endl;
+    os << "    values, grads, lapls " << values/1.0e6 << " MB" << std::endl;
+    return strings+excitations+table+values;
+  }
+
   void copyToDerivativeBuffer(ParticleSet& P, PooledData<RealType>& buf);
 
   void copyFromDerivativeBuffer(ParticleSet& P, PooledData<RealType>& buf);
@@ -465,39 +490,47 @@ public:
       }
   */
 
-  inline void BuildDotProductsAndCalculateRatios(int ref, int iat, ValueVector_t& ratios, ValueMatrix_t &psiinv, ValueMatrix_t &psi, ValueMatrix_t& dotProducts, std::vector<int>& data, std::vector<std::pair<int,int> >& pairs, std::vector<RealType>& sign)
+  /** fill the table dotProducts(i,a) of the reference
+   *
+   * dotProducts(i,a) is the ratio of the reference with the i-th row replaced by the a-th orbital.
+   * The whole table is computed by a GEMM when the unique pairs cover a large part of it.
+   */
+  inline void BuildDotProducts(ValueMatrix_t& psiinv, ValueMatrix_t& psi, ValueMatrix_t& dotProducts, std::vector<std::pair<int,int> >& pairs)
   {
-    ValueType det0 = ratios[ref];
-    buildTableTimer.start();
     int num=psi.extent(1);
+    if(UseTableGEMM)
+    {
+      BLAS::gemm('T','N',psi.extent(0),num,num,ValueType(1.0),psi.data(),num,psiinv.data(),num,ValueType(0.0),dotProducts.data(),dotProducts.cols());
+      return;
+    }
     std::vector<std::pair<int,int> >::iterator it(pairs.begin()), last(pairs.end());
     while(it != last)
     {
       dotProducts((*it).first,(*it).second) = simd::dot(psiinv[(*it).first],psi[(*it).second],num);
       it++;
     }
+  }
+
+  /** evaluate the ratios of all but the reference by the excitation level
+   * @param dots table of the reference
+   * @param det0 value of the reference
+   * @param ratios ratios[i*stride] is assigned for the i-th determinant
+   * @param stride stride of ratios
+   */
+  inline void CalculateRatiosByLevel(ValueMatrix_t& dots, ValueType det0, ValueType* ratios, int stride)
+  {
+    for(int l=0; l<ExcitationGroups.size(); ++l)
+      ExcitationGroups[l].evaluate(dots,det0,ratios,stride,DetCalculator);
+  }
+
+  inline void BuildDotProductsAndCalculateRatios(int ref, int iat, ValueVector_t& ratios, ValueMatrix_t &psiinv, ValueMatrix_t &psi, ValueMatrix_t& dotProducts, std::vector<int>& data, std::vector<std::pair<int,int> >& pairs, std::vector<RealType>& sign)
+  {
+    ValueType det0 = ratios[ref];
+    buildTableTimer.start();
+    BuildDotProducts(psiinv,psi,dotProducts,pairs);
     buildTableTimer.stop();
     readMatTimer.start();
-    std::vector<int>::iterator it2 = data.begin();
-    //ValueVector_t::iterator itr = ratios.begin();
-    //vector<RealType>::iterator its = sign.begin();
-    int count= 0;  // number of determinants processed
-    while(it2 != data.end())
-    {
-      int n = *it2; // number of excitations
-      if(count == ref)
-      {
-        it2+=3*n+1;  // number of integers used to encode the current excitation
-        //itr++;
-        //its++;
-        count++;
-        continue;
-      }
-      ratios[count] = sign[count]*det0*CalculateRatioFromMatrixElements(n,dotProducts,it2+1);
-      //*(itr++) = *(its++)*det0*CalculateRatioFromMatrixElements(n,dotProducts,it2+1);
-      count++;
-      it2+=3*n+1;
-    }
+    CalculateRatiosByLevel(dotProducts,det0,ratios.data(),1);
     readMatTimer.stop();
   }
 
@@ -505,58 +538,18 @@ public:
   {
     ValueType det0 = ratios(ref,iat)[dx];
     buildTableGradTimer.start();
-    int num=psi.extent(1);
-    std::vector<std::pair<int,int> >::iterator it(pairs.begin()), last(pairs.end());
-    while(it != last)
-    {
-      dotProducts((*it).first,(*it).second) = simd::dot(psiinv[(*it).first],psi[(*it).second],num);
-      it++;
-    }
+    BuildDotProducts(psiinv,psi,dotProducts,pairs);
     buildTableGradTimer.stop();
     readMatGradTimer.start();
-    std::vector<int>::iterator it2 = data.begin();
-    int count= 0;  // number of determinants processed
-    while(it2 != data.end())
-    {
-      int n = *it2; // number of excitations
-      if(count == ref)
-      {
-        it2+=3*n+1;  // number of integers used to encode the current excitation
-        count++;
-        continue;
-      }
-      ratios(count,iat)[dx] = sign[count]*det0*CalculateRatioFromMatrixElements(n,dotProducts,it2+1);
-      count++;
-      it2+=3*n+1;
-    }
+    CalculateRatiosByLevel(dotProducts,det0,&(ratios(0,iat)[dx]),ratios.cols()*DIM);
     readMatGradTimer.stop();
   }
 
   inline void BuildDotProductsAndCalculateRatios(int ref, int iat, ValueMatrix_t& ratios, ValueMatrix_t& psiinv, ValueMatrix_t& psi, ValueMatrix_t& dotProducts, std::vector<int>& data, std::vector<std::pair<int,int> >& pairs, std::vector<RealType>& sign)
   {
     ValueType det0 = ratios(ref,iat);
-    int num=psi.extent(1);
-    std::vector<std::pair<int,int> >::iterator it(pairs.begin()), last(pairs.end());
-    while(it != last)
-    {
-      dotProducts((*it).first,(*it).second) = simd::dot(psiinv[(*it).first],psi[(*it).second],num);
-      it++;
-    }
-    std::vector<int>::iterator it2 = data.begin();
-    int count= 0;  // number of determinants processed
-    while(it2 != data.end())
-    {
-      int n = *it2; // number of excitations
-      if(count == ref)
-      {
-        it2+=3*n+1;  // number of integers used to encode the current excitation
-        count++;
-        continue;
-      }
-      ratios(count,iat) = sign[count]*det0*CalculateRatioFromMatrixElements(n,dotProducts,it2+1);
-      count++;
-      it2+=3*n+1;
-    }
+    BuildDotProducts(psiinv,psi,dotProducts,pairs);
+    CalculateRatiosByLevel(dotProducts,det0,&ratios(0,iat),ratios.cols());
   }
 
 //   Finish this at some point
@@ -596,6 +589,43 @@ public:
     evalOrbTimer.start();
     Phi->evaluate(P,iat,psiV);
     evalOrbTimer.stop();
+    evaluateDetsForNewRow(iat);
+    RatioTimer.stop();
+  }
+
+  /** evaluate the determinants of all the configurations for the virtual moves of VP
+   * @param VP virtual moves of the active particle
+   * @param dets dets(k,i) value of the i-th configuration with the k-th virtual move
+   *
+   * The orbitals of all the moves are evaluated by one call to Phi->evaluateValues.
+   */
+  inline void
+  evaluateDetsForVirtualMoves(VirtualParticleSet& VP, ValueMatrix_t& dets)
+  {
+    UpdateMode=ORB_PBYP_RATIO;
+    RatioTimer.start();
+    const int nk=VP.getTotalNum();
+    if(psiVP.rows()!=nk)
+      psiVP.resize(nk,NumOrbitals);
+    evalOrbTimer.start();
+    Phi->evaluateValues(VP,psiVP);
+    evalOrbTimer.stop();
+    if(dets.rows()!=nk || dets.cols()!=new_detValues.size())
+      dets.resize(nk,new_detValues.size());
+    for(int k=0; k<nk; ++k)
+    {
+      std::copy(psiVP[k],psiVP[k]+NumOrbitals,psiV.begin());
+      evaluateDetsForNewRow(VP.activePtcl);
+      std::copy(new_detValues.begin(),new_detValues.end(),dets[k]);
+    }
+    RatioTimer.stop();
+  }
+
+  /** evaluate new_detValues of all the configurations when the iat-th row is replaced by psiV
+   */
+  inline void
+  evaluateDetsForNewRow(int iat)
+  {
     WorkingIndex = iat-FirstIndex;
     if(NumPtcls==1)
     {
@@ -632,7 +662,6 @@ public:
       for(int i=0; i<NumOrbitals; i++)
         TpsiM(i,WorkingIndex) = psiM(WorkingIndex,i);
     }
-    RatioTimer.stop();
   }
 
   inline void
@@ -906,6 +935,8 @@ public:
   GradVector_t dpsiV;
   ValueVector_t d2psiV;
   ValueVector_t workV1, workV2;
+  ///values of single-particle orbitals for the virtual moves, psiVP(k,j) for the k-th move
+  ValueMatrix_t psiVP;
 
   ValueMatrix_t dotProducts;
 
@@ -929,6 +960,10 @@ public:
   std::vector<int> detData;
   std::vector<std::pair<int,int> > uniquePairs;
   std::vector<RealType> DetSigns;
+  ///determinants other than the reference grouped by the excitation level
+  std::vector<ExcitationGroup<ValueType,RealType> > ExcitationGroups;
+  ///if true, the table of the reference is computed by a GEMM
+  bool UseTableGEMM;
 
   int backup_reference;
   std::vector<int> backup_detData;
@@ -104,5 +104,133 @@ struct MyDeterminant
 
 };
 
+/** determinants of the same excitation level with respect to the reference
+ *
+ * The ratios of the determinants in a group are evaluated together from the table
+ * dots(i,a) of the reference. The orbital indices are stored in SoA so that the
+ * closed-form 1x1, 2x2 and 3x3 determinants are vectorized across the group:
+ * Index[k] holds the k-th replaced row i_k for k<Level and the excited orbital
+ * a_{k-Level} for k>=Level of all the determinants.
+ */
+template <typename T, typename RT>
+struct ExcitationGroup
+{
+  ///number of excitations
+  int Level;
+  ///index of the determinants in the full list
+  std::vector<int> Dets;
+  ///signs of the determinants with respect to the reference
+  std::vector<RT> Signs;
+  ///orbital indices [2*Level][Dets.size()]
+  Matrix<int> Index;
+  ///ratios of the determinants in the group
+  std::vector<T> Ratios;
+  ///indices of a determinant for the LU evaluation
+  std::vector<int> Work;
+
+  ExcitationGroup(): Level(0) {}
+
+  ///allocate n determinants with level excitations
+  void resize(int level, int n)
+  {
+    Level=level;
+    Dets.resize(n);
+    Signs.resize(n);
+    Index.resize(std::max(2*level,1),n);
+    Ratios.resize(n);
+    Work.resize(2*level);
+  }
+
+  /** assign the k-th determinant of the group
+   * @param k index in the group
+   * @param det index of the determinant
+   * @param sign of the determinant
+   * @param it iterator to i_1,...,i_n,a_1,...,a_n
+   */
+  void set(int k, int det, RT sign, std::vector<int>::const_iterator it)
+  {
+    Dets[k]=det;
+    Signs[k]=sign;
+    for(int l=0; l<2*Level; ++l)
+      Index(l,k)=*(it+l);
+  }
+
+  /** evaluate the ratios of the group
+   * @param dots table of the reference
+   * @param det0 value of the reference
+   * @param ratios ratios[Dets[k]*stride] is assigned
+   * @param stride stride of ratios
+   * @param calc LU evaluation for Level>3
+   */
+  void evaluate(Matrix<T>& dots, T det0, T* ratios, int stride, MyDeterminant<T>& calc)
+  {
+    const int n=Dets.size();
+    const int ld=dots.cols();
+    const T* restrict dp=dots.data();
+    T* restrict r=Ratios.data();
+    switch(Level)
+    {
+    case 0:
+      for(int k=0; k<n; ++k)
+        r[k]=T(1);
+      break;
+    case 1:
+    {
+      const int* restrict i1=Index[0];
+      const int* restrict a1=Index[1];
+      #pragma omp simd
+      for(int k=0; k<n; ++k)
+        r[k]=dp[i1[k]*ld+a1[k]];
+      break;
+    }
+    case 2:
+    {
+      const int* restrict i1=Index[0];
+      const int* restrict i2=Index[1];
+      const int* restrict a1=Index[2];
+      const int* restrict a2=Index[3];
+      #pragma omp simd
+      for(int k=0; k<n; ++k)
+      {
+        const T* restrict r1=dp+i1[k]*ld;
+        const T* restrict r2=dp+i2[k]*ld;
+        r[k]=r1[a1[k]]*r2[a2[k]]-r1[a2[k]]*r2[a1[k]];
+      }
+      break;
+    }
+    case 3:
+    {
+      const int* restrict i1=Index[0];
+      const int* restrict i2=Index[1];
+      const int* restrict i3=Index[2];
+      const int* restrict a1=Index[3];
+      const int* restrict a2=Index[4];
+      const int* restrict a3=Index[5];
+      #pragma omp simd
+      for(int k=0; k<n; ++k)
+      {
+        const T* restrict r1=dp+i1[k]*ld;
+        const T* restrict r2=dp+i2[k]*ld;
+        const T* restrict r3=dp+i3[k]*ld;
+        const T b11=r1[a1[k]], b12=r1[a2[k]], b13=r1[a3[k]];
+        const T b21=r2[a1[k]], b22=r2[a2[k]], b23=r2[a3[k]];
+        const T b31=r3[a1[k]], b32=r3[a2[k]], b33=r3[a3[k]];
+        r[k]=b11*(b22*b33-b32*b23)-b21*(b12*b33-b32*b13)+b31*(b12*b23-b22*b13);
+      }
+      break;
+    }
+    default:
+      for(int k=0; k<n; ++k)
+      {
+        for(int l=0; l<2*Level; ++l)
+          Work[l]=Index(l,k);
+        r[k]=calc.evaluate(dots,Work.begin(),Level);
+      }
+    }
+    for(int k=0; k<n; ++k)
+      ratios[Dets[k]*stride]=Signs[k]*det0*r[k];
+  }
+};
+
 }
 #endif
@@ -54,6 +54,7 @@ MultiSlaterDeterminantFast::MultiSlaterDeterminantFast(ParticleSet& targetPtcl,
       DetID[j]=i;
   usingBF=false;
   BFTrans=0;
+  HaveRatiosForVP=up->getPhi()->HaveValuesForVP && dn->getPhi()->HaveValuesForVP;
 }
 
 OrbitalBasePtr MultiSlaterDeterminantFast::makeClone(ParticleSet& tqp) const
@@ -566,6 +567,33 @@ OrbitalBase::ValueType MultiSlaterDeterminantFast::ratio(ParticleSet& P, int iat
   }
 }
 
+/** compute the ratios of all the virtual moves of VP
+ *
+ * The determinants of the moved spin are evaluated for all the moves at once and
+ * combined with the unchanged determinants of the other spin. curRatio is not modified.
+ */
+void MultiSlaterDeterminantFast::evaluateRatios(VirtualParticleSet& VP, std::vector<ValueType>& ratios)
+{
+  RatioTimer.start();
+  const int det_id=DetID[VP.activePtcl];
+  Ratio1Timer.start();
+  Dets[det_id]->evaluateDetsForVirtualMoves(VP,detValuesVP);
+  Ratio1Timer.stop();
+  const ValueVector_t& detValues_other = Dets[1-det_id]->detValues;
+  const std::vector<int>& C2node_moved = (det_id==0)? C2node_up:C2node_dn;
+  const std::vector<int>& C2node_other = (det_id==0)? C2node_dn:C2node_up;
+  const ValueType psiinv=1.0/psiCurrent;
+  for(int k=0; k<ratios.size(); ++k)
+  {
+    const ValueType* restrict detValues_moved=detValuesVP[k];
+    ValueType psiNew=0.0;
+    for(int i=0; i<C.size(); ++i)
+      psiNew += C[i]*detValues_moved[C2node_moved[i]]*detValues_other[C2node_other[i]];
+    ratios[k]=psiNew*psiinv;
+  }
+  RatioTimer.stop();
+}
+
 void MultiSlaterDeterminantFast::acceptMove(ParticleSet& P, int iat)
 {
 // this should depend on the type of update, ratio / ratioGrad
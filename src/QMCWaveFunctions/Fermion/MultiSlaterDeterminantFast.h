@@ -65,6 +65,7 @@ public:
   typedef OrbitalSetTraits<ValueType>::IndexVector_t IndexVector_t;
   typedef OrbitalSetTraits<ValueType>::ValueVector_t ValueVector_t;
   typedef OrbitalSetTraits<ValueType>::GradVector_t  GradVector_t;
+  typedef OrbitalSetTraits<ValueType>::ValueMatrix_t ValueMatrix_t;
   typedef OrbitalSetTraits<ValueType>::HessMatrix_t  HessMatrix_t;
   typedef OrbitalSetTraits<ValueType>::HessType      HessType;
   typedef Array<HessType,3>                          HessArray_t;
@@ -91,6 +92,7 @@ public:
   void setBF(BackflowTransformation* bf)
   {
     usingBF=true;
+    HaveRatiosForVP=false;
     BFTrans=bf;
     Dets[0]->setBF(bf);
     Dets[1]->setBF(bf);
@@ -120,6 +122,7 @@ public:
                   , ParticleSet::ParticleGradient_t& dG,ParticleSet::ParticleLaplacian_t& dL);
 
   ValueType ratio(ParticleSet& P, int iat);
+  void evaluateRatios(VirtualParticleSet& VP, std::vector<ValueType>& ratios);
   void acceptMove(ParticleSet& P, int iat);
   void restore(int iat);
 
@@ -134,6 +137,24 @@ public:
     Dets[0]->memoryUsage_DataForDerivatives(P,orbs_only,orbs,invs,dets);
     Dets[1]->memoryUsage_DataForDerivatives(P,orbs_only,orbs,invs,dets);
   }
+  /** report the memory of the CI expansion by component
+   * @param os output stream
+   *
+   * Called once by the builder.
+   */
+  void reportMemory(std::ostream& os) const
+  {
+    size_t coefs=(C.size()+CSFcoeff.size()+CSFexpansion.size())*sizeof(RealType)+DetsPerCSF.size()*sizeof(int);
+    size_t maps=(C2node_up.size()+C2node_dn.size())*sizeof(int);
+    os << "  MultiSlaterDeterminantFast memory of the CI expansion" << std::endl;
+    os << "    CI coefficients      " << C.size() << " : " << coefs/1.0e6 << " MB" << std::endl;
+    os << "    C2node maps          " << maps/1.0e6 << " MB" << std::endl;
+    os << "  up determinants" << std::endl;
+    size_t total=coefs+maps+Dets[0]->reportMemory(os);
+    os << "  down determinants" << std::endl;
+    total+=Dets[1]->reportMemory(os);
+    os << "  Total                  " << total/1.0e6 << " MB" << std::endl;
+  }
   RealType updateBuffer(ParticleSet& P, BufferType& buf, bool fromscratch=false);
   void copyFromBuffer(ParticleSet& P, BufferType& buf);
 
@@ -182,6 +203,8 @@ public:
   ParticleSet::ParticleLaplacian_t myL,myL_temp;
   ValueVector_t laplSum_up;
   ValueVector_t laplSum_dn;
+  ///determinants of the moved spin for the virtual moves, detValuesVP(k,i) for the k-th move
+  ValueMatrix_t detValuesVP;
 
   opt_variables_type myVars;
 
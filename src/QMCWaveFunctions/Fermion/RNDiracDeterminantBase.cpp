@@ -30,6 +30,7 @@ RNDiracDeterminantBase::RNDiracDeterminantBase(SPOSetBasePtr const &spos, int fi
   DiracDeterminantBase(spos, first), logepsilon(0.0)
 {
   OrbitalName="RNDiracDeterminantBase";
+  HaveRatiosForVP=false;
 }
 
 RNDiracDeterminantBase::RNDiracDeterminantBase(const RNDiracDeterminantBase& s):
@@ -30,6 +30,7 @@ RNDiracDeterminantBaseAlternate::RNDiracDeterminantBaseAlternate(SPOSetBasePtr c
   DiracDeterminantBase(spos, first), logepsilon(0.0)
 {
   OrbitalName="RNDiracDeterminantBaseAlternate";
+  HaveRatiosForVP=false;
 }
 
 RNDiracDeterminantBaseAlternate::RNDiracDeterminantBaseAlternate(const RNDiracDeterminantBaseAlternate& s):
@@ -28,6 +28,7 @@ SlaterDet::SlaterDet(ParticleSet& targetPtcl)
 {
   Optimizable = false;
   OrbitalName = "SlaterDet";
+  HaveRatiosForVP = true;
   M.resize(targetPtcl.groups() + 1, 0);
   for (int i = 0; i < M.size(); ++i)
     M[i] = targetPtcl.first(i);
@@ -69,6 +70,7 @@ void SlaterDet::add(Determinant_t* det, int ispin)
   else
     Dets[ispin] = det;
   Optimizable = Optimizable || det->Optimizable;
+  HaveRatiosForVP = HaveRatiosForVP && det->HaveRatiosForVP;
   //int last=Dets.size();
   //Dets.push_back(det);
   //M[last+1]=M[last]+Dets[last]->rows();
@@ -153,7 +153,7 @@ public:
   virtual
   inline void evaluateRatios(VirtualParticleSet& VP, std::vector<ValueType>& ratios)
   {
-    return Dets[VP.activeGroup]->evaluateRatios(VP,ratios);
+    return Dets[DetID[VP.activePtcl]]->evaluateRatios(VP,ratios);
   }
 
   virtual
@@ -168,6 +168,29 @@ public:
     return Dets[DetID[iat]]->alternateRatioGrad(P,iat,grad_iat);
   }
 
+  ///dispatch to the determinants of the walkers which own iat
+  virtual void mw_ratioGrad(const std::vector<OrbitalBase*>& WFC_list,
+                            const std::vector<ParticleSet*>& P_list, int iat,
+                            std::vector<ValueType>& ratios, std::vector<GradType>& grad_new)
+  {
+    const int id=DetID[iat];
+    std::vector<OrbitalBase*> det_list(WFC_list.size());
+    for(int iw=0; iw<WFC_list.size(); ++iw)
+      det_list[iw]=static_cast<SlaterDet*>(WFC_list[iw])->Dets[id];
+    Dets[id]->mw_ratioGrad(det_list,P_list,iat,ratios,grad_new);
+  }
+
+  ///dispatch to the determinants of the walkers which own iat
+  virtual void mw_acceptMove(const std::vector<OrbitalBase*>& WFC_list,
+                             const std::vector<ParticleSet*>& P_list, int iat)
+  {
+    const int id=DetID[iat];
+    std::vector<OrbitalBase*> det_list(WFC_list.size());
+    for(int iw=0; iw<WFC_list.size(); ++iw)
+      det_list[iw]=static_cast<SlaterDet*>(WFC_list[iw])->Dets[id];
+    Dets[id]->mw_acceptMove(det_list,P_list,iat);
+  }
+
   virtual
   GradType evalGrad(ParticleSet& P, int iat)
   {
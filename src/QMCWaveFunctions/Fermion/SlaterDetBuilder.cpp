@@ -21,6 +21,11 @@
 #include "QMCWaveFunctions/Fermion/SlaterDetBuilder.h"
 #include "Utilities/ProgressReportEngine.h"
 #include "OhmmsData/AttributeSet.h"
+#include "Message/CommOperators.h"
+#if defined(HAVE_LIBHDF5)
+#include "io/hdf_archive.h"
+#endif
+#include <map>
 
 #include "QMCWaveFunctions/Fermion/MultiSlaterDeterminant.h"
 #include "QMCWaveFunctions/Fermion/MultiSlaterDeterminantFast.h"
@@ -324,6 +329,8 @@ bool SlaterDetBuilder::put(xmlNodePtr cur)
         //          dn_det->usingBF = UseBackflow;
         //          multislaterdetfast_0->usingBF = UseBackflow;
         success = createMSDFast(multislaterdetfast_0,cur);
+        if(success)
+          multislaterdetfast_0->reportMemory(app_log());
         // debug, erase later
         //          SPOSetProxyForMSD* spo_up;
         //          SPOSetProxyForMSD* spo_dn;
@@ -449,11 +456,13 @@ bool SlaterDetBuilder::putDeterminant(xmlNodePtr cur, int spin_group)
   std::string s_radius("0.0");
   int s_smallnumber(-999999);
   int rntype(0);
+  int delay_rank(1);
   aAttrib.add(s_cutoff,"Cutoff");
   aAttrib.add(s_radius,"Radius");
   aAttrib.add(s_smallnumber,"smallnumber");
   aAttrib.add(s_smallnumber,"eps");
   aAttrib.add(rntype,"primary");
+  aAttrib.add(delay_rank,"delay_rank");
   aAttrib.add(spin_name,"group");
   aAttrib.put(cur);
 
@@ -545,6 +554,7 @@ bool SlaterDetBuilder::putDeterminant(xmlNodePtr cur, int spin_group)
   std::string dname;
   getNodeName(dname,cur);
   DiracDeterminantBase* adet=0;
+  bool delayedUpdate=false;
 #if !defined(QMC_COMPLEX)
   if (rn_tag == dname)
   {
@@ -572,10 +582,23 @@ bool SlaterDetBuilder::putDeterminant(xmlNodePtr cur, int spin_group)
     else if (psi->Optimizable)
       adet = new DiracDeterminantOpt(targetPtcl, psi, firstIndex);
     else
+    {
       adet = new DiracDeterminantBase(psi,firstIndex);
+      delayedUpdate=true;
+    }
 #endif
   }
   adet->set(firstIndex,lastIndex-firstIndex);
+  if(delay_rank>1)
+  {
+    if(delayedUpdate)
+    {
+      adet->setDelayRank(delay_rank);
+      app_log() << "  Using delayed updates of rank " << adet->DelayRank << " for the inverse" << std::endl;
+    }
+    else
+      app_warning() << "  delay_rank=" << delay_rank << " is ignored. Delayed updates are only implemented by DiracDeterminantBase." << std::endl;
+  }
   slaterdet_0->add(adet,spin_group);
   if (psi->Optimizable)
     slaterdet_0->Optimizable = true;
@@ -898,6 +921,8 @@ bool SlaterDetBuilder::readDetList(xmlNodePtr cur, std::vector<ci_configuration>
   spoAttrib.add (zero_cutoff,"zero_cutoff");
   spoAttrib.add (zero_cutoff,"zerocutoff");
   spoAttrib.add (CSFChoice,"sortby");
+  std::string href;
+  spoAttrib.add (href,"href");
   spoAttrib.put(DetListNode);
   if(ndets==0)
   {
@@ -927,6 +952,22 @@ bool SlaterDetBuilder::readDetList(xmlNodePtr cur, std::vector<ci_configuration>
   dummyC_beta.occup.resize(NCB+nstates,false);
   for(int i=0; i<NCB+NEB; i++)
     dummyC_beta.occup[i]=true;
+  if(!href.empty())
+  {
+    if(usingCSF)
+    {
+      APP_ABORT("The packed CI expansion in hdf5 supports type=\"DETS\" only.\n");
+    }
+    if(cutoff>0)
+      app_log()<<"  The cutoff is not applied to the packed CI expansion."<< std::endl;
+    success=readDetListH5(href,dummyC_alpha,dummyC_beta,NCA,NCB,nstates,NEA,NEB,zero_cutoff,uniqueConfg_up,uniqueConfg_dn,C2node_up,C2node_dn,CItags,coeff);
+    if(coeff.size() != ndets)
+    {
+      std::cerr <<"count, ndets: " <<coeff.size() <<"  " <<ndets << std::endl;
+      APP_ABORT("Problems reading determinant ci_configurations. Found a number of determinants inconsistent with xml file size parameter.\n");
+    }
+    return success;
+  }
   RealType sumsq_qc=0.0;
   //app_log() <<"alpha reference: \n" <<dummyC_alpha;
   //app_log() <<"beta reference: \n" <<dummyC_beta;
@@ -1152,59 +1193,158 @@ bool SlaterDetBuilder::readDetList(xmlNodePtr cur, std::vector<ci_configuration>
     sumsq += coeff[i]*coeff[i];
   app_log() <<"Norm of ci vector (sum of ci^2): " <<sumsq << std::endl;
   app_log() <<"Norm of qchem ci vector (sum of qchem_ci^2): " <<sumsq_qc << std::endl;
+  // map the strings to the unique lists in the order of the first appearance
+  std::map<packed_occupation,int> unique_up, unique_dn;
   for(int i=0; i<confgList_up.size(); i++)
   {
-    bool found=false;
-    int k=-1;
-    for(int j=0; j<uniqueConfg_up.size(); j++)
+    std::map<packed_occupation,int>::iterator it=unique_up.find(confgList_up[i].occup);
+    if(it == unique_up.end())
     {
-      if(confgList_up[i] == uniqueConfg_up[j])
-      {
-        found=true;
-        k=j;
-        break;
-      }
+      C2node_up[i]=uniqueConfg_up.size();
+      unique_up[confgList_up[i].occup]=C2node_up[i];
+      uniqueConfg_up.push_back(confgList_up[i]);
     }
-    if(found)
+    else
+      C2node_up[i]=it->second;
+  }
+  for(int i=0; i<confgList_dn.size(); i++)
+  {
+    std::map<packed_occupation,int>::iterator it=unique_dn.find(confgList_dn[i].occup);
+    if(it == unique_dn.end())
     {
-      C2node_up[i]=k;
+      C2node_dn[i]=uniqueConfg_dn.size();
+      unique_dn[confgList_dn[i].occup]=C2node_dn[i];
+      uniqueConfg_dn.push_back(confgList_dn[i]);
     }
     else
+      C2node_dn[i]=it->second;
+  }
+  app_log() <<"Found " <<uniqueConfg_up.size() <<" unique up determinants.\n";
+  app_log() <<"Found " <<uniqueConfg_dn.size() <<" unique down determinants.\n";
+  return success;
+}
+
+
+
+bool SlaterDetBuilder::readDetListH5(const std::string& fname, const ci_configuration& ref_up, const ci_configuration& ref_dn, int ncore_up, int ncore_dn, int nstates, int nea, int neb, RealType zero_cutoff, std::vector<ci_configuration>& uniqueConfg_up, std::vector<ci_configuration>& uniqueConfg_dn, std::vector<int>& C2node_up, std::vector<int>& C2node_dn, std::vector<std::string>& CItags, std::vector<RealType>& coeff)
+{
+#if defined(HAVE_LIBHDF5)
+  app_log() <<"Reading CI expansion from " <<fname << std::endl;
+  // sizes: NbDet, nstate, Nbits, number of unique alpha and beta strings
+  int sizes[5]= {0,0,0,0,0};
+  std::vector<unsigned long> bits_up, bits_dn;
+  std::vector<double> ci;
+  // the master reads the packed arrays and broadcasts them
+  if(myComm->rank()==0)
+  {
+    hdf_archive hin(0);
+    if(!hin.open(fname,H5F_ACC_RDONLY))
     {
-      uniqueConfg_up.push_back(confgList_up[i]);
-      C2node_up[i]=uniqueConfg_up.size()-1;
+      APP_ABORT("SlaterDetBuilder::readDetListH5 cannot open "+fname);
+    }
+    hin.push("MultiDet",false);
+    hin.read(sizes[0],"NbDet");
+    hin.read(sizes[1],"nstate");
+    hin.read(sizes[2],"Nbits");
+    hin.read(ci,"Coeff");
+    hin.read(bits_up,"CI_Alpha");
+    hin.read(bits_dn,"CI_Beta");
+    hin.read(C2node_up,"C2node_Alpha");
+    hin.read(C2node_dn,"C2node_Beta");
+    hin.close();
+    if(sizes[2]>0)
+    {
+      sizes[3]=bits_up.size()/sizes[2];
+      sizes[4]=bits_dn.size()/sizes[2];
+    }
+    if(ci.size()!=sizes[0] || C2node_up.size()!=sizes[0] || C2node_dn.size()!=sizes[0])
+    {
+      APP_ABORT("SlaterDetBuilder::readDetListH5 inconsistent sizes of Coeff and C2node in "+fname);
     }
   }
-  for(int i=0; i<confgList_dn.size(); i++)
+  myComm->bcast(sizes,5);
+  const int ndets=sizes[0], nbits=sizes[2];
+  if(ndets <= 0 || sizes[3] <= 0 || sizes[4] <= 0)
   {
-    bool found=false;
-    int k=-1;
-    for(int j=0; j<uniqueConfg_dn.size(); j++)
+    APP_ABORT("SlaterDetBuilder::readDetListH5 no determinant in "+fname);
+  }
+  if(sizes[1] != nstates)
+  {
+    APP_ABORT("SlaterDetBuilder::readDetListH5 nstate in the file differs from nstates of detlist");
+  }
+  if(nbits*64 < nstates)
+  {
+    APP_ABORT("SlaterDetBuilder::readDetListH5 Nbits is too small for nstate");
+  }
+  ci.resize(ndets);
+  C2node_up.resize(ndets);
+  C2node_dn.resize(ndets);
+  bits_up.resize(sizes[3]*nbits);
+  bits_dn.resize(sizes[4]*nbits);
+  myComm->bcast(ci.data(),ndets);
+  myComm->bcast(C2node_up.data(),ndets);
+  myComm->bcast(C2node_dn.data(),ndets);
+  myComm->bcast(reinterpret_cast<char*>(bits_up.data()),bits_up.size()*sizeof(unsigned long));
+  myComm->bcast(reinterpret_cast<char*>(bits_dn.data()),bits_dn.size()*sizeof(unsigned long));
+  // unpack the active orbitals on top of the core of the reference
+  uniqueConfg_up.resize(sizes[3],ref_up);
+  for(int s=0; s<sizes[3]; s++)
+  {
+    int nq=0;
+    for(int i=0; i<nstates; i++)
     {
-      if(confgList_dn[i] == uniqueConfg_dn[j])
-      {
-        found=true;
-        k=j;
-        break;
-      }
+      uniqueConfg_up[s].occup[ncore_up+i]=(bits_up[s*nbits+i/64]>>(i%64))&1UL;
+      if(uniqueConfg_up[s].occup[ncore_up+i])
+        nq++;
     }
-    if(found)
+    if(nq != nea)
     {
-      C2node_dn[i]=k;
+      std::cerr <<"alpha string " <<s <<" occupies " <<nq <<" active orbitals" << std::endl;
+      APP_ABORT("SlaterDetBuilder::readDetListH5 Found incorrect alpha determinant label. noccup != nca+nea");
     }
-    else
+  }
+  uniqueConfg_dn.resize(sizes[4],ref_dn);
+  for(int s=0; s<sizes[4]; s++)
+  {
+    int nq=0;
+    for(int i=0; i<nstates; i++)
     {
-      uniqueConfg_dn.push_back(confgList_dn[i]);
-      C2node_dn[i]=uniqueConfg_dn.size()-1;
+      uniqueConfg_dn[s].occup[ncore_dn+i]=(bits_dn[s*nbits+i/64]>>(i%64))&1UL;
+      if(uniqueConfg_dn[s].occup[ncore_dn+i])
+        nq++;
+    }
+    if(nq != neb)
+    {
+      std::cerr <<"beta string " <<s <<" occupies " <<nq <<" active orbitals" << std::endl;
+      APP_ABORT("SlaterDetBuilder::readDetListH5 Found incorrect beta determinant label. noccup != ncb+neb");
     }
   }
+  coeff.resize(ndets);
+  CItags.resize(ndets);
+  RealType sumsq=0.0;
+  for(int i=0; i<ndets; i++)
+  {
+    if(C2node_up[i]<0 || C2node_up[i]>=sizes[3] || C2node_dn[i]<0 || C2node_dn[i]>=sizes[4])
+    {
+      APP_ABORT("SlaterDetBuilder::readDetListH5 C2node out of the range of the unique strings");
+    }
+    coeff[i]=(std::abs(ci[i]) < zero_cutoff)?0.0:ci[i];
+    sumsq += coeff[i]*coeff[i];
+    std::ostringstream tag;
+    tag << "CIcoeff_" << i;
+    CItags[i]=tag.str();
+  }
+  app_log() <<"Found " <<coeff.size() <<" terms in the MSD expansion.\n";
+  app_log() <<"Norm of ci vector (sum of ci^2): " <<sumsq << std::endl;
   app_log() <<"Found " <<uniqueConfg_up.size() <<" unique up determinants.\n";
   app_log() <<"Found " <<uniqueConfg_dn.size() <<" unique down determinants.\n";
-  return success;
+  return true;
+#else
+  APP_ABORT("SlaterDetBuilder::readDetListH5 HDF5 is disabled.");
+  return false;
+#endif
 }
 
-
-
 // void SlaterDetBuilder::buildMultiSlaterDetermiant()
 // {
 //   MultiSlaterDeterminant *multidet= new MultiSlaterDeterminant;
@@ -56,6 +56,23 @@ public:
    */
   bool put(xmlNodePtr cur);
 
+  /** read the packed CI expansion from a hdf5 file
+   * @param fname name of the hdf5 file
+   * @param ref_up reference of the up strings, core and active orbitals
+   * @param ref_dn reference of the down strings, core and active orbitals
+   * @param ncore_up number of the core up orbitals
+   * @param ncore_dn number of the core down orbitals
+   * @param nstates number of the active orbitals
+   *
+   * The file holds the unique alpha and beta strings of the active orbitals as bits
+   * packed in 64-bit words and the maps of the determinants to the unique strings:
+   * - /MultiDet/NbDet, /MultiDet/nstate, /MultiDet/Nbits : number of determinants, active orbitals and words per string
+   * - /MultiDet/Coeff[NbDet] : CI coefficients
+   * - /MultiDet/CI_Alpha, /MultiDet/CI_Beta : unique strings, the reference first
+   * - /MultiDet/C2node_Alpha[NbDet], /MultiDet/C2node_Beta[NbDet] : index of the strings of a determinant
+   */
+  bool readDetListH5(const std::string& fname, const ci_configuration& ref_up, const ci_configuration& ref_dn, int ncore_up, int ncore_dn, int nstates, int nea, int neb, RealType zero_cutoff, std::vector<ci_configuration>& uniqueConfg_up, std::vector<ci_configuration>& uniqueConfg_dn, std::vector<int>& C2node_up, std::vector<int>& C2node_dn, std::vector<std::string>& CItags, std::vector<RealType>& coeff);
+
 private:
 
   ///reference to a PtclPoolType
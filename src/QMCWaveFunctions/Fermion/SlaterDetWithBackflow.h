@@ -129,6 +129,20 @@ public:
     return ValueType();
   }
 
+  ///a move changes all the determinants, use ratioGrad of each walker
+  void mw_ratioGrad(const std::vector<OrbitalBase*>& WFC_list,
+                    const std::vector<ParticleSet*>& P_list, int iat,
+                    std::vector<ValueType>& ratios, std::vector<GradType>& grad_new)
+  {
+    OrbitalBase::mw_ratioGrad(WFC_list,P_list,iat,ratios,grad_new);
+  }
+
+  void mw_acceptMove(const std::vector<OrbitalBase*>& WFC_list,
+                     const std::vector<ParticleSet*>& P_list, int iat)
+  {
+    OrbitalBase::mw_acceptMove(WFC_list,P_list,iat);
+  }
+
   GradType evalGrad(ParticleSet& P, int iat)
   {
     QMCTraits::GradType g;
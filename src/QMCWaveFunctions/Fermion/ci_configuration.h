@@ -16,21 +16,128 @@
 #define QMCPLUSPLUS_CI_CONFIGURATION_H
 #include <vector>
 #include <iostream>
+#include <stdint.h>
 
 namespace qmcplusplus
 {
 
+/** occupations of the orbitals packed in 64-bit words
+ *
+ * Used in place of std::vector<bool> so that the strings of a large expansion
+ * are compared, ordered and counted a word at a time. The bits past size()
+ * are always zero.
+ */
+class packed_occupation
+{
+public:
+  typedef uint64_t word_type;
+
+  ///reference to a bit
+  class reference
+  {
+  public:
+    reference(word_type& w, word_type m): word(w), mask(m) {}
+    inline operator bool() const
+    {
+      return (word&mask) != 0;
+    }
+    inline reference& operator=(bool v)
+    {
+      if(v)
+        word |= mask;
+      else
+        word &= ~mask;
+      return *this;
+    }
+    inline reference& operator=(const reference& r)
+    {
+      return *this=static_cast<bool>(r);
+    }
+  private:
+    word_type& word;
+    word_type mask;
+  };
+
+  packed_occupation(): nbits(0) {}
+
+  ///return the number of orbitals
+  inline size_t size() const
+  {
+    return nbits;
+  }
+
+  ///resize to n orbitals, the new orbitals are occupied if v
+  void resize(size_t n, bool v=false)
+  {
+    size_t old=nbits;
+    words.resize((n+63)/64,0);
+    nbits=n;
+    for(size_t i=old; i<n; i++)
+      (*this)[i]=v;
+    clear_tail();
+  }
+
+  inline bool operator[](size_t i) const
+  {
+    return (words[i/64]>>(i%64))&1;
+  }
+
+  inline reference operator[](size_t i)
+  {
+    return reference(words[i/64],word_type(1)<<(i%64));
+  }
+
+  ///return the number of the occupied orbitals
+  int count() const
+  {
+    int res=0;
+    for(size_t w=0; w<words.size(); w++)
+      res+=__builtin_popcountll(words[w]);
+    return res;
+  }
+
+  inline bool operator==(const packed_occupation& c) const
+  {
+    return nbits==c.nbits && words==c.words;
+  }
+
+  ///order by the size and then by the words, for the maps of the unique strings
+  inline bool operator<(const packed_occupation& c) const
+  {
+    if(nbits != c.nbits)
+      return nbits<c.nbits;
+    return words<c.words;
+  }
+
+private:
+  ///number of orbitals
+  size_t nbits;
+  ///packed bits, orbital i is bit i%64 of word i/64
+  std::vector<word_type> words;
+
+  inline void clear_tail()
+  {
+    if(nbits%64)
+      words.back() &= (word_type(1)<<(nbits%64))-1;
+  }
+};
+
 // Defines a single CI ci_configuration, with respect to the hartree fock ci_configuration.
 struct ci_configuration
 {
-  // vector of bits, each bit determines whether the corresponding state is occupied or not
-  std::vector<bool> occup;
+  // packed bits, each bit determines whether the corresponding state is occupied or not
+  packed_occupation occup;
   bool taken;
   int nExct; // with respect to base ci_configuration, which we assume is hf
 
   ci_configuration(): taken(false),nExct(0) {}
 
-  ci_configuration(std::vector<bool> &v, int n): occup(v),taken(false),nExct(n) {}
+  ci_configuration(std::vector<bool> &v, int n): taken(false),nExct(n)
+  {
+    occup.resize(v.size());
+    for(int i=0; i<v.size(); i++)
+      occup[i]=v[i];
+  }
   ci_configuration(const ci_configuration& c):occup(c.occup),taken(c.taken),nExct(c.nExct) {}
 
   ~ci_configuration() {}
@@ -56,14 +163,7 @@ struct ci_configuration
       app_log() << std::endl;
       APP_ABORT("ci_configuration::operator==() - ci_configurations are not compatible. Unequal number of occupied states. ");
     }
-    for(int i=0; i<occup.size(); i++)
-    {
-      if(occup[i]^c.occup[i])
-      {
-        return false;
-      }
-    }
-    return true;
+    return occup==c.occup;
   }
 
   // this has a very specific use below
@@ -108,11 +208,7 @@ struct ci_configuration
 
   int count() const
   {
-    int res=0;
-    for(int i=0; i<occup.size(); i++)
-      if(occup[i])
-        res++;
-    return res;
+    return occup.count();
   }
 
 };
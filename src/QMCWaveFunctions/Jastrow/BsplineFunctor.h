@@ -189,6 +189,96 @@ struct BsplineFunctor: public OptimizableFunctorBase
        SplineCoefs[i+3]*(A[12]*tp[0] + A[13]*tp[1] + A[14]*tp[2] + A[15]*tp[3]));
   }
 
+  /** evaluate the sum of u(r) over the distances [iStart,iEnd)
+   * @param iStart first index
+   * @param iEnd last index
+   * @param _distArray distances
+   * @param distArrayCompressed scratch of iEnd-iStart distances
+   * @return sum of u(r) of the distances within the cutoff
+   *
+   * The distances within the cutoff are compacted first without a branch
+   * so that the spline evaluation is a single vectorized loop.
+   */
+  inline real_type evaluateV(const int iStart, const int iEnd,
+                             const T* restrict _distArray, T* restrict distArrayCompressed) const
+  {
+    const real_type* restrict coefs=SplineCoefs.data();
+    const real_type rcut=cutoff_radius;
+    int nc=0;
+    for(int jat=iStart; jat<iEnd; ++jat)
+    {
+      distArrayCompressed[nc]=_distArray[jat];
+      nc+=(_distArray[jat]<rcut);
+    }
+    real_type d=0.0;
+    #pragma omp simd reduction(+:d)
+    for(int jat=0; jat<nc; ++jat)
+    {
+      const real_type r=distArrayCompressed[jat]*DeltaRInv;
+      const int i=static_cast<int>(r);
+      const real_type t=r-static_cast<real_type>(i);
+      const real_type tp0=t*t*t, tp1=t*t, tp2=t;
+      d+= coefs[i+0]*(A[ 0]*tp0 + A[ 1]*tp1 + A[ 2]*tp2 + A[ 3])
+         +coefs[i+1]*(A[ 4]*tp0 + A[ 5]*tp1 + A[ 6]*tp2 + A[ 7])
+         +coefs[i+2]*(A[ 8]*tp0 + A[ 9]*tp1 + A[10]*tp2 + A[11])
+         +coefs[i+3]*(A[12]*tp0 + A[13]*tp1 + A[14]*tp2 + A[15]);
+    }
+    return d;
+  }
+
+  /** evaluate u(r), du/dr/r and d2u/dr2 of the distances [iStart,iEnd)
+   * @param iStart first index
+   * @param iEnd last index
+   * @param _distArray distances
+   * @param _valArray u(r)
+   * @param _gradArray du/dr divided by r
+   * @param _laplArray d2u/dr2
+   * @param distArrayCompressed scratch of iEnd-iStart distances
+   * @param distIndices scratch of iEnd-iStart indices
+   *
+   * The outputs of the distances beyond the cutoff are set to zero.
+   */
+  inline void evaluateVGL(const int iStart, const int iEnd, const T* restrict _distArray,
+                          T* restrict _valArray, T* restrict _gradArray, T* restrict _laplArray,
+                          T* restrict distArrayCompressed, int* restrict distIndices) const
+  {
+    const real_type* restrict coefs=SplineCoefs.data();
+    const real_type rcut=cutoff_radius;
+    const real_type dinv2=DeltaRInv*DeltaRInv;
+    int nc=0;
+    for(int jat=iStart; jat<iEnd; ++jat)
+    {
+      _valArray[jat]=_gradArray[jat]=_laplArray[jat]=T();
+      distArrayCompressed[nc]=_distArray[jat];
+      distIndices[nc]=jat;
+      nc+=(_distArray[jat]<rcut);
+    }
+    #pragma omp simd
+    for(int j=0; j<nc; ++j)
+    {
+      const real_type rinv=1.0/distArrayCompressed[j];
+      const real_type r=distArrayCompressed[j]*DeltaRInv;
+      const int i=static_cast<int>(r);
+      const real_type t=r-static_cast<real_type>(i);
+      const real_type tp0=t*t*t, tp1=t*t, tp2=t;
+      const int jat=distIndices[j];
+      _valArray[jat]= coefs[i+0]*(A[ 0]*tp0 + A[ 1]*tp1 + A[ 2]*tp2 + A[ 3])
+                     +coefs[i+1]*(A[ 4]*tp0 + A[ 5]*tp1 + A[ 6]*tp2 + A[ 7])
+                     +coefs[i+2]*(A[ 8]*tp0 + A[ 9]*tp1 + A[10]*tp2 + A[11])
+                     +coefs[i+3]*(A[12]*tp0 + A[13]*tp1 + A[14]*tp2 + A[15]);
+      _gradArray[jat]=rinv*DeltaRInv*
+                     (coefs[i+0]*(dA[ 1]*tp1 + dA[ 2]*tp2 + dA[ 3])
+                     +coefs[i+1]*(dA[ 5]*tp1 + dA[ 6]*tp2 + dA[ 7])
+                     +coefs[i+2]*(dA[ 9]*tp1 + dA[10]*tp2 + dA[11])
+                     +coefs[i+3]*(dA[13]*tp1 + dA[14]*tp2 + dA[15]));
+      _laplArray[jat]=dinv2*
+                     (coefs[i+0]*(d2A[ 2]*tp2 + d2A[ 3])
+                     +coefs[i+1]*(d2A[ 6]*tp2 + d2A[ 7])
+                     +coefs[i+2]*(d2A[10]*tp2 + d2A[11])
+                     +coefs[i+3]*(d2A[14]*tp2 + d2A[15]));
+    }
+  }
+
 
   inline real_type
   evaluate(real_type r, real_type& dudr, real_type& d2udr2, real_type &d3udr3)
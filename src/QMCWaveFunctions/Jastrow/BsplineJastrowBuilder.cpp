@@ -24,6 +24,7 @@
 #include "QMCWaveFunctions/Jastrow/DiffOneBodySpinJastrowOrbital.h"
 #include "QMCWaveFunctions/Jastrow/TwoBodyJastrowOrbital.h"
 #include "QMCWaveFunctions/Jastrow/DiffTwoBodyJastrowOrbital.h"
+#include "QMCWaveFunctions/Jastrow/J2OrbitalSoA.h"
 #ifdef QMC_CUDA
 #include "QMCWaveFunctions/Jastrow/OneBodyJastrowOrbitalBspline.h"
 #include "QMCWaveFunctions/Jastrow/TwoBodyJastrowOrbitalBspline.h"
@@ -171,6 +172,103 @@ struct BsplineInitializer
   }
 };
 
+template<typename J2Type>
+bool BsplineJastrowBuilder::createTwoBodyJastrow(xmlNodePtr cur)
+{
+  ReportEngine PRE(ClassName,"createTwoBodyJastrow(xmlNodePtr)");
+  typedef BsplineFunctor<RealType> RadFuncType;
+  std::string init_mode("0");
+  {
+    OhmmsAttributeSet hAttrib;
+    hAttrib.add(init_mode,"init");
+    hAttrib.put(cur);
+  }
+  BsplineInitializer<RealType> j2Initializer;
+  xmlNodePtr kids = cur->xmlChildrenNode;
+  typedef DiffTwoBodyJastrowOrbital<BsplineFunctor<RealType> > dJ2Type;
+  int taskid=(targetPsi.is_manager())?targetPsi.getGroupID():-1;
+  J2Type *J2 = new J2Type(targetPtcl,taskid);
+  dJ2Type *dJ2 = new dJ2Type(targetPtcl);
+  SpeciesSet& species(targetPtcl.getSpeciesSet());
+  int chargeInd=species.addAttribute("charge");
+  //std::map<std::string,RadFuncType*> functorMap;
+  bool Opt(false);
+  while (kids != NULL)
+  {
+    std::string kidsname((const char*)kids->name);
+    if (kidsname == "correlation")
+    {
+      OhmmsAttributeSet rAttrib;
+      RealType cusp=-1e10;
+      std::string pairType("0");
+      std::string spA(species.speciesName[0]);
+      std::string spB(species.speciesName[0]);
+      rAttrib.add(spA,"speciesA");
+      rAttrib.add(spB,"speciesB");
+      rAttrib.add(pairType,"pairType");
+      rAttrib.add(cusp,"cusp");
+      rAttrib.put(kids);
+      if(pairType[0]=='0')
+      {
+        pairType=spA+spB;
+      }
+      else
+      {
+        PRE.warning("pairType is deprecated. Use speciesA/speciesB");
+        //overwrite the species
+        spA=pairType[0];
+        spB=pairType[1];
+      }
+      int ia = species.findSpecies(spA);
+      int ib = species.findSpecies(spB);
+      if(ia==species.size() || ib == species.size())
+      {
+        PRE.error("Failed. Species are incorrect.",true);
+      }
+      // prevent adding uu/dd correlation if there is only 1 u/d electron.
+      if(ia==ib && (targetPtcl.last(ia)-targetPtcl.first(ia)==1))
+        PRE.error("Failed to add "+spA+spB+" correlation for only 1 "+spA+" particle. Please remove it from two-body Jastrow.",true);
+      if(cusp<-1e6)
+      {
+        RealType qq=species(chargeInd,ia)*species(chargeInd,ib);
+        cusp = (ia==ib)? -0.25*qq:-0.5*qq;
+      }
+      app_log() << "  BsplineJastrowBuilder adds a functor with cusp = " << cusp << std::endl;
+      RadFuncType *functor = new RadFuncType(cusp);
+      functor->periodic      = targetPtcl.Lattice.SuperCellEnum != SUPERCELL_OPEN;
+      functor->cutoff_radius = targetPtcl.Lattice.WignerSeitzRadius;
+      bool initialized_p=functor->put(kids);
+      functor->elementType=pairType;
+      //RPA INIT
+      if(!initialized_p && init_mode =="rpa")
+      {
+        app_log() << "  Initializing Two-Body with RPA Jastrow " << std::endl;
+        j2Initializer.initWithRPA(targetPtcl,*functor,-cusp/0.5);
+      }
+      J2->addFunc(ia,ib,functor);
+      dJ2->addFunc(ia,ib,functor);
+      Opt=(!functor->notOpt or Opt);
+      if(qmc_common.io_node)
+      {
+        char fname[32];
+        if(qmc_common.mpi_groups>1)
+          sprintf(fname,"J2.%s.g%03d.dat",pairType.c_str(),taskid);
+        else
+          sprintf(fname,"J2.%s.dat",pairType.c_str());
+        functor->setReportLevel(ReportLevel,fname);
+        functor->print();
+      }
+    }
+    kids = kids->next;
+  }
+  //dJ2->initialize();
+  //J2->setDiffOrbital(dJ2);
+  J2->dPsi=dJ2;
+  targetPsi.addOrbital(J2,"J2_bspline");
+  J2->setOptimizable(Opt);
+  return true;
+}
+
 bool BsplineJastrowBuilder::put(xmlNodePtr cur)
 {
   ReportEngine PRE(ClassName,"put(xmlNodePtr)");
@@ -204,100 +302,16 @@ bool BsplineJastrowBuilder::put(xmlNodePtr cur)
   }
   else // Create a two-body Jastrow
   {
-    std::string init_mode("0");
-    {
-      OhmmsAttributeSet hAttrib;
-      hAttrib.add(init_mode,"init");
-      hAttrib.put(cur);
-    }
-    BsplineInitializer<RealType> j2Initializer;
-    xmlNodePtr kids = cur->xmlChildrenNode;
 #ifdef QMC_CUDA
-    typedef TwoBodyJastrowOrbitalBspline J2Type;
+    return createTwoBodyJastrow<TwoBodyJastrowOrbitalBspline>(cur);
 #else
-    typedef TwoBodyJastrowOrbital<BsplineFunctor<RealType> > J2Type;
-#endif
-    typedef DiffTwoBodyJastrowOrbital<BsplineFunctor<RealType> > dJ2Type;
-    int taskid=(targetPsi.is_manager())?targetPsi.getGroupID():-1;
-    J2Type *J2 = new J2Type(targetPtcl,taskid);
-    dJ2Type *dJ2 = new dJ2Type(targetPtcl);
-    SpeciesSet& species(targetPtcl.getSpeciesSet());
-    int chargeInd=species.addAttribute("charge");
-    //std::map<std::string,RadFuncType*> functorMap;
-    bool Opt(false);
-    while (kids != NULL)
+    if(targetPtcl.UseSoADistanceTables)
     {
-      std::string kidsname((const char*)kids->name);
-      if (kidsname == "correlation")
-      {
-        OhmmsAttributeSet rAttrib;
-        RealType cusp=-1e10;
-        std::string pairType("0");
-        std::string spA(species.speciesName[0]);
-        std::string spB(species.speciesName[0]);
-        rAttrib.add(spA,"speciesA");
-        rAttrib.add(spB,"speciesB");
-        rAttrib.add(pairType,"pairType");
-        rAttrib.add(cusp,"cusp");
-        rAttrib.put(kids);
-        if(pairType[0]=='0')
-        {
-          pairType=spA+spB;
-        }
-        else
-        {
-          PRE.warning("pairType is deprecated. Use speciesA/speciesB");
-          //overwrite the species
-          spA=pairType[0];
-          spB=pairType[1];
-        }
-        int ia = species.findSpecies(spA);
-        int ib = species.findSpecies(spB);
-        if(ia==species.size() || ib == species.size())
-        {
-          PRE.error("Failed. Species are incorrect.",true);
-        }
-        // prevent adding uu/dd correlation if there is only 1 u/d electron.
-        if(ia==ib && (targetPtcl.last(ia)-targetPtcl.first(ia)==1))
-          PRE.error("Failed to add "+spA+spB+" correlation for only 1 "+spA+" particle. Please remove it from two-body Jastrow.",true);
-        if(cusp<-1e6)
-        {
-          RealType qq=species(chargeInd,ia)*species(chargeInd,ib);
-          cusp = (ia==ib)? -0.25*qq:-0.5*qq;
-        }
-        app_log() << "  BsplineJastrowBuilder adds a functor with cusp = " << cusp << std::endl;
-        RadFuncType *functor = new RadFuncType(cusp);
-        functor->periodic      = targetPtcl.Lattice.SuperCellEnum != SUPERCELL_OPEN;
-        functor->cutoff_radius = targetPtcl.Lattice.WignerSeitzRadius;
-        bool initialized_p=functor->put(kids);
-        functor->elementType=pairType;
-        //RPA INIT
-        if(!initialized_p && init_mode =="rpa")
-        {
-          app_log() << "  Initializing Two-Body with RPA Jastrow " << std::endl;
-          j2Initializer.initWithRPA(targetPtcl,*functor,-cusp/0.5);
-        }
-        J2->addFunc(ia,ib,functor);
-        dJ2->addFunc(ia,ib,functor);
-        Opt=(!functor->notOpt or Opt);
-        if(qmc_common.io_node)
-        {
-          char fname[32];
-          if(qmc_common.mpi_groups>1)
-            sprintf(fname,"J2.%s.g%03d.dat",pairType.c_str(),taskid);
-          else
-            sprintf(fname,"J2.%s.dat",pairType.c_str());
-          functor->setReportLevel(ReportLevel,fname);
-          functor->print();
-        }
-      }
-      kids = kids->next;
+      app_log() << "  Creating J2OrbitalSoA<BsplineFunctor> on the SoA distance table" << std::endl;
+      return createTwoBodyJastrow<J2OrbitalSoA<RadFuncType> >(cur);
     }
-    //dJ2->initialize();
-    //J2->setDiffOrbital(dJ2);
-    J2->dPsi=dJ2;
-    targetPsi.addOrbital(J2,"J2_bspline");
-    J2->setOptimizable(Opt);
+    return createTwoBodyJastrow<TwoBodyJastrowOrbital<RadFuncType> >(cur);
+#endif
   }
   return true;
 }
@@ -44,6 +44,12 @@ struct BsplineJastrowBuilder: public OrbitalBuilderBase
   template<typename OBJT, typename DOBJT>
   bool createOneBodyJastrow(xmlNodePtr cur);
 
+  /** create two-body Jastrow
+   * @tparm J2Type two-body jastrow orbital class
+   */
+  template<typename J2Type>
+  bool createTwoBodyJastrow(xmlNodePtr cur);
+
   bool put(xmlNodePtr cur);
 };
 
@@ -0,0 +1,744 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_TWOBODYJASTROW_SOA_H
+#define QMCPLUSPLUS_TWOBODYJASTROW_SOA_H
+#include "Configuration.h"
+#include  <map>
+#include  <numeric>
+#include "QMCWaveFunctions/OrbitalBase.h"
+#include "QMCWaveFunctions/Jastrow/DiffTwoBodyJastrowOrbital.h"
+#include "Particle/DistanceTableData.h"
+#include "Particle/DistanceTable.h"
+#include "LongRange/StructFact.h"
+#include "OhmmsSoA/VectorSoaContainer.h"
+#include <qmc_common.h>
+
+namespace qmcplusplus
+{
+
+/** @ingroup OrbitalComponent
+ *  @brief Two-body Jastrow function on the structure-of-arrays distance tables
+ *
+ * The pair functions are evaluated by the rows of the SoA distance table,
+ * one block of sources per species, with the batched kernels of the functor,
+ * FT::evaluateV and FT::evaluateVGL. Only the per-particle sums are stored:
+ * - Uat[i] = \f$\sum_{j\neq i} u(r_{ij})\f$
+ * - dUat[i] = \f${\bf \nabla}_i J\f$
+ * - d2Uat[i] = \f$\nabla^2_i J\f$
+ *
+ * The pairs of the old position of a particle are cached by its first ratio,
+ * while the row of the moved particle is still valid, and reused by the
+ * other ratios of the particle until a move is accepted. The sums are updated
+ * when a move is accepted. Hence the memory and the buffer are O(N) instead of
+ * O(N^2) of TwoBodyJastrowOrbital. ParticleSet::DistTables[0] must be of DT_SOA type.
+ */
+template<class FT>
+class J2OrbitalSoA: public OrbitalBase
+{
+protected:
+  typedef VectorSoaContainer<RealType,OHMMS_DIM> GradContainer_t;
+
+  ///number of particles
+  int N;
+  ///number of groups of the target particleset
+  int NumGroups;
+  ///task id
+  int TaskID;
+  ///log of the ratio of the current move
+  RealType DiffVal, DiffValSum;
+  ///Uat of the proposed move
+  RealType cur_Uat;
+  /** per-particle sums, rows of a block [Uat,d2Uat,dUat]
+   *
+   * The block is UatStorage or the slot of the current walker buffer,
+   * see bindState.
+   */
+  RealType* Uat;
+  RealType* d2Uat;
+  GradContainer_t dUat;
+  ///own storage of the per-particle sums
+  aligned_vector<RealType> UatStorage;
+  ///pair values of the proposed move and of the old position
+  aligned_vector<RealType> cur_u, cur_du, cur_d2u;
+  aligned_vector<RealType> old_u, old_du, old_d2u;
+  ///displacements of the old position, the table row is updated before acceptMove
+  GradContainer_t old_dr;
+  ///particle of the cached old pairs, -1 if they are not valid
+  int OldIat;
+  ///scratch of the compacted distances and indices
+  aligned_vector<RealType> DistCompressed;
+  aligned_vector<int> DistIndices;
+
+  std::map<std::string,FT*> J2Unique;
+  ParticleSet *PtclRef;
+  bool FirstTime;
+  RealType KEcorr;
+  bool first_addFunc;
+
+public:
+
+  typedef FT FuncType;
+
+  ///container for the Jastrow functions, F[ig*NumGroups+jg]
+  std::vector<FT*> F;
+
+  J2OrbitalSoA(ParticleSet& p, int tid)
+    : TaskID(tid), DiffVal(0.0), DiffValSum(0.0), cur_Uat(0.0), OldIat(-1), KEcorr(0.0)
+  {
+    PtclRef = &p;
+    init(p);
+    FirstTime = true;
+    first_addFunc = true;
+    OrbitalName = "J2OrbitalSoA";
+    HaveRatiosForVP = true;
+  }
+
+  ~J2OrbitalSoA() { }
+
+  void init(ParticleSet& p)
+  {
+    if(p.addTable(p)!=0 || p.DistTables[0]->DTType!=DistanceTableData::DT_SOA)
+    {
+      APP_ABORT("J2OrbitalSoA::init requires the SoA distance table of the target particleset");
+    }
+    N=p.getTotalNum();
+    NumGroups=p.groups();
+    UatStorage.resize(stateSize());
+    bindState(UatStorage.data());
+    cur_u.resize(N);
+    cur_du.resize(N);
+    cur_d2u.resize(N);
+    old_u.resize(N);
+    old_du.resize(N);
+    old_d2u.resize(N);
+    old_dr.resize(N);
+    DistCompressed.resize(N);
+    DistIndices.resize(N);
+    F.resize(NumGroups*NumGroups,0);
+  }
+
+  ///return the size of the block [Uat,d2Uat,dUat], each row padded
+  inline size_t stateSize() const
+  {
+    return (OHMMS_DIM+2)*getAlignedSize<RealType>(N);
+  }
+
+  /** use a block of stateSize() aligned elements for Uat, d2Uat and dUat
+   * @param ref UatStorage.data() or a slot of a walker buffer
+   */
+  inline void bindState(RealType* ref)
+  {
+    const size_t nA=getAlignedSize<RealType>(N);
+    OldIat=-1;
+    Uat=ref;
+    d2Uat=ref+nA;
+    dUat.attachReference(N,ref+2*nA);
+  }
+
+  void addFunc(int ia, int ib, FT* j)
+  {
+    // make all pair terms equal to the first one initially
+    //   in case some terms are not provided explicitly
+    if(first_addFunc)
+    {
+      int ij=0;
+      for(int ig=0; ig<NumGroups; ++ig)
+        for(int jg=0; jg<NumGroups; ++jg, ++ij)
+          if(F[ij]==0)
+            F[ij]=j;
+      first_addFunc = false;
+    }
+    F[ia*NumGroups+ib]=j;
+    // enforce exchange symmetry
+    if(ia!=ib)
+      F[ib*NumGroups+ia]=j;
+    std::stringstream aname;
+    aname<<ia<<ib;
+    J2Unique[aname.str()]=j;
+    ChiesaKEcorrection();
+    FirstTime = false;
+  }
+
+  void resetTargetParticleSet(ParticleSet& P)
+  {
+    PtclRef = &P;
+    if(dPsi)
+      dPsi->resetTargetParticleSet(P);
+  }
+
+  void checkInVariables(opt_variables_type& active)
+  {
+    myVars.clear();
+    typename std::map<std::string,FT*>::iterator it(J2Unique.begin()),it_end(J2Unique.end());
+    while(it != it_end)
+    {
+      (*it).second->checkInVariables(active);
+      (*it).second->checkInVariables(myVars);
+      ++it;
+    }
+  }
+
+  void checkOutVariables(const opt_variables_type& active)
+  {
+    myVars.getIndex(active);
+    Optimizable=myVars.is_optimizable();
+    typename std::map<std::string,FT*>::iterator it(J2Unique.begin()),it_end(J2Unique.end());
+    while(it != it_end)
+    {
+      (*it).second->checkOutVariables(active);
+      ++it;
+    }
+    if(dPsi)
+      dPsi->checkOutVariables(active);
+  }
+
+  void resetParameters(const opt_variables_type& active)
+  {
+    if(!Optimizable)
+      return;
+    typename std::map<std::string,FT*>::iterator it(J2Unique.begin()),it_end(J2Unique.end());
+    while(it != it_end)
+    {
+      (*it).second->resetParameters(active);
+      ++it;
+    }
+    if(dPsi)
+      dPsi->resetParameters( active );
+    for(int i=0; i<myVars.size(); ++i)
+    {
+      int ii=myVars.Index[i];
+      if(ii>=0)
+        myVars[i]= active[ii];
+    }
+  }
+
+  void reportStatus(std::ostream& os)
+  {
+    typename std::map<std::string,FT*>::iterator it(J2Unique.begin()),it_end(J2Unique.end());
+    while(it != it_end)
+    {
+      (*it).second->myVars.print(os);
+      ++it;
+    }
+    ChiesaKEcorrection();
+  }
+
+  /** sum of u(r) of iat with the sources [0,N) of a row
+   * @param P target particleset
+   * @param iat particle index
+   * @param dist row of the distances, the self distance is beyond the cutoff
+   */
+  inline RealType computeU(const ParticleSet& P, int iat, const RealType* restrict dist)
+  {
+    RealType curUat=0.0;
+    const int igt=P.GroupID[iat]*NumGroups;
+    for(int jg=0; jg<NumGroups; ++jg)
+      curUat+=F[igt+jg]->evaluateV(P.first(jg),P.last(jg),dist,DistCompressed.data());
+    return curUat;
+  }
+
+  /** u(r), du/dr/r and d2u/dr2 of iat with the sources [0,N) of a row */
+  inline void computeU3(const ParticleSet& P, int iat, const RealType* restrict dist,
+                        RealType* restrict u, RealType* restrict du, RealType* restrict d2u)
+  {
+    const int igt=P.GroupID[iat]*NumGroups;
+    for(int jg=0; jg<NumGroups; ++jg)
+      F[igt+jg]->evaluateVGL(P.first(jg),P.last(jg),dist,u,du,d2u,DistCompressed.data(),DistIndices.data());
+  }
+
+  ///return \f$\sum_j du_j\, dr_j\f$
+  inline PosType accumulateG(const RealType* restrict du, const GradContainer_t& displ) const
+  {
+    PosType grad;
+    for(int idim=0; idim<OHMMS_DIM; ++idim)
+    {
+      const RealType* restrict dX=displ.data(idim);
+      RealType s=0.0;
+      #pragma omp simd reduction(+:s)
+      for(int jat=0; jat<N; ++jat)
+        s+=du[jat]*dX[jat];
+      grad[idim]=s;
+    }
+    return grad;
+  }
+
+  ///return \f$-\sum_j (d2u_j+(D-1)du_j)\f$
+  inline RealType accumulateL(const RealType* restrict du, const RealType* restrict d2u) const
+  {
+    const RealType lapfac=OHMMS_DIM-1.0;
+    RealType s=0.0;
+    #pragma omp simd reduction(+:s)
+    for(int jat=0; jat<N; ++jat)
+      s+=d2u[jat]+lapfac*du[jat];
+    return -s;
+  }
+
+  /** recompute Uat, dUat, d2Uat and LogValue from the distance table */
+  inline void recomputeAll(ParticleSet& P)
+  {
+    if (FirstTime)
+    {
+      FirstTime = false;
+      ChiesaKEcorrection();
+    }
+    const DistanceTableData* d_table=P.DistTables[0];
+    RealType usum=0.0;
+    OldIat=-1;
+    for(int iat=0; iat<N; ++iat)
+    {
+      computeU3(P,iat,d_table->Distances[iat].data(),cur_u.data(),cur_du.data(),cur_d2u.data());
+      Uat[iat]=std::accumulate(cur_u.begin(),cur_u.end(),RealType());
+      dUat.set(iat,accumulateG(cur_du.data(),d_table->Displacements[iat]));
+      d2Uat[iat]=accumulateL(cur_du.data(),cur_d2u.data());
+      usum+=Uat[iat];
+    }
+    LogValue=-0.5*usum;
+  }
+
+  ///recompute the per-particle sums in the bound block and add them to G and L
+  inline void recomputeGL(ParticleSet& P,
+                          ParticleSet::ParticleGradient_t& G,
+                          ParticleSet::ParticleLaplacian_t& L)
+  {
+    recomputeAll(P);
+    for(int iat=0; iat<N; ++iat)
+    {
+      G[iat]+=dUat[iat];
+      L[iat]+=d2Uat[iat];
+    }
+  }
+
+  /** evaluate the log value from scratch in the own storage
+   *
+   * The walker buffer bound by the last copyFromBuffer may be gone.
+   */
+  RealType evaluateLog(ParticleSet& P,
+                       ParticleSet::ParticleGradient_t& G,
+                       ParticleSet::ParticleLaplacian_t& L)
+  {
+    bindState(UatStorage.data());
+    recomputeGL(P,G,L);
+    return LogValue;
+  }
+
+  ValueType evaluate(ParticleSet& P,
+                     ParticleSet::ParticleGradient_t& G,
+                     ParticleSet::ParticleLaplacian_t& L)
+  {
+    return std::exp(evaluateLog(P,G,L));
+  }
+
+  void evaluateHessian(ParticleSet& P, HessVector_t& grad_grad_psi)
+  {
+    const DistanceTableData* d_table=P.DistTables[0];
+    Tensor<RealType,OHMMS_DIM> ident;
+    grad_grad_psi=0.0;
+    ident.diagonal(1.0);
+    LogValue=0.0;
+    for(int iat=0; iat<N; ++iat)
+    {
+      const RealType* dist=d_table->Distances[iat].data();
+      const GradContainer_t& displ=d_table->Displacements[iat];
+      const int igt=P.GroupID[iat]*NumGroups;
+      for(int jat=0; jat<N; ++jat)
+      {
+        FT& func=*F[igt+P.GroupID[jat]];
+        if(jat==iat || dist[jat]>=func.cutoff_radius)
+          continue;
+        RealType dudr, d2udr2;
+        LogValue-=0.5*func.evaluate(dist[jat],dudr,d2udr2);
+        RealType rinv=1.0/dist[jat];
+        PosType dr=displ[jat];
+        grad_grad_psi[iat]-=rinv*rinv*outerProduct(dr,dr)*(d2udr2-dudr*rinv)+ident*dudr*rinv;
+      }
+    }
+  }
+
+  ValueType ratio(ParticleSet& P, int iat)
+  {
+    UpdateMode=ORB_PBYP_RATIO;
+    computeOld(P,iat);
+    cur_Uat=computeU(P,iat,P.DistTables[0]->Temp_r.data());
+    DiffVal=Uat[iat]-cur_Uat;
+    return std::exp(DiffVal);
+  }
+
+  /** ratios of the quadrature points of iat
+   *
+   * With the SoA table of VP, the rows of the points are evaluated in the
+   * species blocks with iat excluded. Otherwise the AoS pairs are used.
+   */
+  inline void evaluateRatios(VirtualParticleSet& VP, std::vector<ValueType>& ratios)
+  {
+    const int iat=VP.activePtcl;
+    const DistanceTableData* d_table=VP.DistTables[0];
+    const int igt=PtclRef->GroupID[iat]*NumGroups;
+    const int jg_iat=PtclRef->GroupID[iat];
+    if(d_table->DTType==DistanceTableData::DT_SOA)
+    {
+      for(int k=0; k<ratios.size(); ++k)
+      {
+        const RealType* dist=d_table->Distances[k].data();
+        RealType u=0.0;
+        for(int jg=0; jg<NumGroups; ++jg)
+        {
+          const FT& func=*F[igt+jg];
+          if(jg==jg_iat)
+          {
+            u+=func.evaluateV(PtclRef->first(jg),iat,dist,DistCompressed.data());
+            u+=func.evaluateV(iat+1,PtclRef->last(jg),dist,DistCompressed.data());
+          }
+          else
+            u+=func.evaluateV(PtclRef->first(jg),PtclRef->last(jg),dist,DistCompressed.data());
+        }
+        ratios[k]=std::exp(Uat[iat]-u);
+      }
+    }
+    else
+    {
+      std::vector<RealType> myr(ratios.size(),Uat[iat]);
+      for (int i=0; i<d_table->size(SourceIndex); ++i)
+      {
+        if(i!=iat)
+        {
+          FuncType* func=F[igt+PtclRef->GroupID[i]];
+          for (int nn=d_table->M[i],j=0; nn<d_table->M[i+1]; ++nn,++j)
+            myr[j]-=func->evaluate(d_table->r(nn));
+        }
+      }
+      for(int k=0; k<ratios.size(); ++k)
+        ratios[k]=std::exp(myr[k]);
+    }
+  }
+
+  /** ratios of moving every particle to the proposed position
+   *
+   * The SoA row of the proposed move excludes the active particle, its
+   * distance to the proposed position is taken from the AoS data.
+   */
+  inline void get_ratios(ParticleSet& P, std::vector<ValueType>& ratios)
+  {
+    const DistanceTableData* d_table=P.DistTables[0];
+    const int kat=d_table->activePtcl;
+    const RealType* dist=d_table->Temp_r.data();
+    for (int i=0; i<N; ++i)
+    {
+      const int igt=P.GroupID[i]*NumGroups;
+      RealType res=Uat[i];
+      for(int j=0; j<N; ++j)
+        if(i!=j)
+          res-=F[igt+P.GroupID[j]]->evaluate((j==kat)?d_table->Temp[j].r1:dist[j]);
+      ratios[i]=std::exp(res);
+    }
+  }
+
+  /** ratio with the differential gradients and laplacians of all the particles */
+  ValueType ratio(ParticleSet& P, int iat,
+                  ParticleSet::ParticleGradient_t& dG,
+                  ParticleSet::ParticleLaplacian_t& dL)
+  {
+    UpdateMode=ORB_PBYP_ALL;
+    const DistanceTableData* d_table=P.DistTables[0];
+    computeOld(P,iat);
+    computeU3(P,iat,d_table->Temp_r.data(),cur_u.data(),cur_du.data(),cur_d2u.data());
+    cur_Uat=std::accumulate(cur_u.begin(),cur_u.end(),RealType());
+    DiffVal=Uat[iat]-cur_Uat;
+    accumulateDeltaGL(P,iat,dG,dL);
+    return std::exp(DiffVal);
+  }
+
+  GradType evalGrad(ParticleSet& P, int iat)
+  {
+    return GradType(dUat[iat]);
+  }
+
+  ValueType ratioGrad(ParticleSet& P, int iat, GradType& grad_iat)
+  {
+    UpdateMode=ORB_PBYP_PARTIAL;
+    const DistanceTableData* d_table=P.DistTables[0];
+    computeOld(P,iat);
+    computeU3(P,iat,d_table->Temp_r.data(),cur_u.data(),cur_du.data(),cur_d2u.data());
+    cur_Uat=std::accumulate(cur_u.begin(),cur_u.end(),RealType());
+    DiffVal=Uat[iat]-cur_Uat;
+    grad_iat+=accumulateG(cur_du.data(),d_table->Temp_dr);
+    return std::exp(DiffVal);
+  }
+
+  inline void restore(int iat) {}
+
+  /** update Uat, dUat and d2Uat of all the particles
+   *
+   * The pairs of the old position were cached by the ratio, the drivers
+   * accept the move of P, which overwrites the row of iat, before this call.
+   * The proposed pairs are evaluated from the temporary row.
+   */
+  void acceptMove(ParticleSet& P, int iat)
+  {
+    const DistanceTableData* d_table=P.DistTables[0];
+    if(UpdateMode==ORB_PBYP_RATIO)
+      computeU3(P,iat,d_table->Temp_r.data(),cur_u.data(),cur_du.data(),cur_d2u.data());
+    const RealType lapfac=OHMMS_DIM-1.0;
+    RealType cur_d2Uat=0.0;
+    for(int jat=0; jat<N; ++jat)
+    {
+      const RealType newl=cur_d2u[jat]+lapfac*cur_du[jat];
+      const RealType oldl=old_d2u[jat]+lapfac*old_du[jat];
+      Uat[jat]+=cur_u[jat]-old_u[jat];
+      d2Uat[jat]+=oldl-newl;
+      cur_d2Uat-=newl;
+    }
+    PosType cur_dUat;
+    for(int idim=0; idim<OHMMS_DIM; ++idim)
+    {
+      const RealType* restrict new_dX=d_table->Temp_dr.data(idim);
+      const RealType* restrict old_dX=old_dr.data(idim);
+      RealType* restrict save_g=dUat.data(idim);
+      RealType cur_g=0.0;
+      #pragma omp simd reduction(+:cur_g)
+      for(int jat=0; jat<N; ++jat)
+      {
+        const RealType newg=cur_du[jat]*new_dX[jat];
+        save_g[jat]-=newg-old_du[jat]*old_dX[jat];
+        cur_g+=newg;
+      }
+      cur_dUat[idim]=cur_g;
+    }
+    DiffVal=Uat[iat]-cur_Uat;
+    DiffValSum+=DiffVal;
+    LogValue+=DiffVal;
+    Uat[iat]=cur_Uat;
+    dUat.set(iat,cur_dUat);
+    d2Uat[iat]=cur_d2Uat;
+    //the pairs of all the particles with iat have changed
+    OldIat=-1;
+  }
+
+  inline void update(ParticleSet& P,
+                     ParticleSet::ParticleGradient_t& dG,
+                     ParticleSet::ParticleLaplacian_t& dL,
+                     int iat)
+  {
+    if(UpdateMode==ORB_PBYP_RATIO)
+    {
+      const DistanceTableData* d_table=P.DistTables[0];
+      computeU3(P,iat,d_table->Temp_r.data(),cur_u.data(),cur_du.data(),cur_d2u.data());
+      UpdateMode=ORB_PBYP_ALL;
+    }
+    accumulateDeltaGL(P,iat,dG,dL);
+    acceptMove(P,iat);
+  }
+
+  inline void evaluateLogAndStore(ParticleSet& P,
+                                  ParticleSet::ParticleGradient_t& dG,
+                                  ParticleSet::ParticleLaplacian_t& dL)
+  {
+    evaluateLog(P,dG,dL);
+  }
+
+  /** register the block [Uat,d2Uat,dUat] as an aligned slot and LogValue
+   *
+   * The slot is not bound here, the buffer grows with the other components.
+   */
+  inline RealType registerData(ParticleSet& P, PooledData<RealType>& buf)
+  {
+    evaluateLogAndStore(P,P.G,P.L);
+    DEBUG_PSIBUFFER(" J2OrbitalSoA::registerData ",buf.current());
+    RealType* ref=buf.addSlot(stateSize());
+    std::copy(Uat,Uat+stateSize(),ref);
+    buf.add(LogValue);
+    DEBUG_PSIBUFFER(" J2OrbitalSoA::registerData ",buf.current());
+    return LogValue;
+  }
+
+  ///recompute the per-particle sums directly in the slot of buf
+  inline RealType updateBuffer(ParticleSet& P, PooledData<RealType>& buf,
+                               bool fromscratch=false)
+  {
+    DEBUG_PSIBUFFER(" J2OrbitalSoA::updateBuffer ",buf.current());
+    bindState(buf.lendReference(stateSize()));
+    recomputeGL(P,P.G,P.L);
+    buf.put(LogValue);
+    DEBUG_PSIBUFFER(" J2OrbitalSoA::updateBuffer ",buf.current());
+    return LogValue;
+  }
+
+  ///bind the slot of buf, the moves update the walker buffer in place
+  inline void copyFromBuffer(ParticleSet& P, PooledData<RealType>& buf)
+  {
+    DEBUG_PSIBUFFER(" J2OrbitalSoA::copyFromBuffer ",buf.current());
+    bindState(buf.lendReference(stateSize()));
+    buf.get(LogValue);
+    DEBUG_PSIBUFFER(" J2OrbitalSoA::copyFromBuffer ",buf.current());
+    DiffValSum=0.0;
+  }
+
+  inline RealType evaluateLog(ParticleSet& P, PooledData<RealType>& buf)
+  {
+    DEBUG_PSIBUFFER(" J2OrbitalSoA::evaluateLog ",buf.current());
+    RealType* ref=buf.lendReference(stateSize());
+    if(ref!=Uat)
+    {
+      std::copy(Uat,Uat+stateSize(),ref);
+      bindState(ref);
+    }
+    buf.put(LogValue);
+    DEBUG_PSIBUFFER(" J2OrbitalSoA::evaluateLog ",buf.current());
+    return LogValue;
+  }
+
+  OrbitalBasePtr makeClone(ParticleSet& tqp) const
+  {
+    J2OrbitalSoA<FT>* j2copy=new J2OrbitalSoA<FT>(tqp,-1);
+    if (dPsi)
+      j2copy->dPsi = dPsi->makeClone(tqp);
+    std::map<const FT*,FT*> fcmap;
+    for(int ig=0; ig<NumGroups; ++ig)
+      for(int jg=ig; jg<NumGroups; ++jg)
+      {
+        int ij=ig*NumGroups+jg;
+        if(F[ij]==0)
+          continue;
+        typename std::map<const FT*,FT*>::iterator fit=fcmap.find(F[ij]);
+        if(fit == fcmap.end())
+        {
+          FT* fc=new FT(*F[ij]);
+          j2copy->addFunc(ig,jg,fc);
+          fcmap[F[ij]]=fc;
+        }
+      }
+    j2copy->Optimizable = Optimizable;
+    return j2copy;
+  }
+
+  void copyFrom(const OrbitalBase& old)
+  {
+    //nothing to do
+  }
+
+  RealType ChiesaKEcorrection()
+  {
+    if ((!PtclRef->Lattice.SuperCellEnum))
+      return 0.0;
+    const int numPoints = 1000;
+    RealType vol = PtclRef->Lattice.Volume;
+    int nsp = PtclRef->groups();
+    FILE *fout=0;
+    if(qmc_common.io_node && TaskID > -1) //taskid=-1
+    {
+      char fname[16];
+      sprintf(fname,"uk.g%03d.dat",TaskID);
+      fout=fopen(fname,"w");
+    }
+    for (int iG=0; iG<PtclRef->SK->KLists.ksq.size(); iG++)
+    {
+      RealType Gmag = std::sqrt(PtclRef->SK->KLists.ksq[iG]);
+      RealType sum=0.0;
+      RealType uk = 0.0;
+      for (int i=0; i<PtclRef->groups(); i++)
+      {
+        int Ni = PtclRef->last(i) - PtclRef->first(i);
+        RealType aparam = 0.0;
+        for (int j=0; j<PtclRef->groups(); j++)
+        {
+          int Nj = PtclRef->last(j) - PtclRef->first(j);
+          if (F[i*nsp+j])
+          {
+            FT& ufunc = *(F[i*nsp+j]);
+            RealType radius = ufunc.cutoff_radius;
+            RealType k = Gmag;
+            RealType dr = radius/(RealType)(numPoints-1);
+            for (int ir=0; ir<numPoints; ir++)
+            {
+              RealType r = dr * (RealType)ir;
+              RealType u = ufunc.evaluate(r);
+#if(OHMMS_DIM==3)
+              aparam += (1.0/4.0)*k*k*
+                        4.0*M_PI*r*std::sin(k*r)/k*u*dr;
+              uk += 0.5*4.0*M_PI*r*std::sin(k*r)/k * u * dr *
+                    (RealType)Nj / (RealType)(Ni+Nj);
+#endif
+#if(OHMMS_DIM==2)
+              uk += 0.5*2.0*M_PI*std::sin(k*r)/k * u * dr *
+                    (RealType)Nj / (RealType)(Ni+Nj);
+#endif
+            }
+          }
+        }
+        sum += Ni * aparam / vol;
+      }
+      if (iG == 0)
+      {
+        RealType a = 1.0;
+        for (int iter=0; iter<20; iter++)
+          a = uk / (4.0*M_PI*(1.0/(Gmag*Gmag) - 1.0/(Gmag*Gmag + 1.0/a)));
+        KEcorr = 4.0*M_PI*a/(4.0*vol) * PtclRef->getTotalNum();
+      }
+      if(fout)
+        fprintf (fout, "%1.8f %1.12e %1.12e\n", Gmag, uk, sum);
+    }
+    if(fout)
+      fclose(fout);
+    return KEcorr;
+  }
+
+  void finalizeOptimization()
+  {
+    ChiesaKEcorrection();
+  }
+
+  RealType KECorrection()
+  {
+    return KEcorr;
+  }
+
+private:
+  /** cache the pairs and the displacements of the old position of iat
+   *
+   * Called by the ratios while the row of iat in the table is still valid.
+   * Nothing is done if they are cached already: a rejected move or another
+   * ratio of iat leaves the table unchanged.
+   */
+  inline void computeOld(const ParticleSet& P, int iat)
+  {
+    if(iat==OldIat)
+      return;
+    OldIat=iat;
+    const DistanceTableData* d_table=P.DistTables[0];
+    computeU3(P,iat,d_table->Distances[iat].data(),old_u.data(),old_du.data(),old_d2u.data());
+    old_dr=d_table->Displacements[iat];
+  }
+
+  /** add the changes of the gradients and laplacians of the proposed move
+   *
+   * cur_u, cur_du and cur_d2u hold the pairs of the proposed move, old_u,
+   * old_du, old_d2u and old_dr those of the old position.
+   */
+  inline void accumulateDeltaGL(ParticleSet& P, int iat,
+                                ParticleSet::ParticleGradient_t& dG,
+                                ParticleSet::ParticleLaplacian_t& dL)
+  {
+    const DistanceTableData* d_table=P.DistTables[0];
+    const RealType lapfac=OHMMS_DIM-1.0;
+    const GradContainer_t& new_dr=d_table->Temp_dr;
+    for(int jat=0; jat<N; ++jat)
+    {
+      dG[jat]-=cur_du[jat]*new_dr[jat]-old_du[jat]*old_dr[jat];
+      dL[jat]+=old_d2u[jat]+lapfac*old_du[jat]-cur_d2u[jat]-lapfac*cur_du[jat];
+    }
+    dG[iat]+=accumulateG(cur_du.data(),new_dr)-dUat[iat];
+    dL[iat]+=accumulateL(cur_du.data(),cur_d2u.data())-d2Uat[iat];
+  }
+};
+
+}
+#endif
@@ -103,6 +103,7 @@ public:
     Funique.resize(CenterRef.getSpeciesSet().getTotalNum(),0);
     Fs.resize(CenterRef.getTotalNum(),0);
     OrbitalName = "OneBodyJastrow";
+    HaveRatiosForVP = true;
   }
 
   ~OneBodyJastrowOrbital() { }
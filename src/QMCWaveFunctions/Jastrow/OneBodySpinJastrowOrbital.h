@@ -74,6 +74,7 @@ public:
     : Spin(false), CenterRef(centers), FirstAddressOfdU(0), LastAddressOfdU(0)
   {
     OrbitalName = "OneBodySpinJastrow";
+    HaveRatiosForVP = true;
     U.resize(els.getTotalNum());
     myTableIndex=els.addTable(CenterRef);
     //allocate vector of proper size  and set them to 0
@@ -82,6 +82,7 @@ public:
     FirstTime = true;
     first_addFunc = true;
     OrbitalName = "TwoBodyJastrow";
+    HaveRatiosForVP = true;
   }
 
   ~TwoBodyJastrowOrbital() { }
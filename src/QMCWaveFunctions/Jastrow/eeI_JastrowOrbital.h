@@ -116,6 +116,7 @@ public:
     init(elecs);
     FirstTime = true;
     NumVars=0;
+    HaveRatiosForVP = true;
   }
 
   ~eeI_JastrowOrbital() { }
@@ -186,6 +186,9 @@ public:
   ///temporary matricies
   ValueMatrix_t Temp;
   ValueMatrix_t Tempv;
+  ///temporary matricies of the particles of evaluate_notranspose
+  ValueMatrix_t TempAll;
+  ValueMatrix_t TempvAll;
 
   ///algorithm switch
   int Algo;
@@ -197,6 +200,7 @@ public:
   LCOrbitalSet(BS* bs=0,int rl=0, std::string algorithm=""): myBasisSet(0), ReportLevel(rl)
   {
     NeedsDistanceTable=true;
+    HaveValuesForVP=true;
     if(algorithm=="legacy_gemv")
     {
       Algo=0;
@@ -341,42 +345,65 @@ public:
 //#endif
   }
 
+  /** evaluate the orbitals of the particles [first,last)
+   *
+   * With Algo==1, the basis functions of all the particles are stacked in
+   * TempAll, five rows per particle as in Temp, and transformed by a single
+   * dgemm to TempvAll.
+   */
   void evaluate_notranspose(const ParticleSet& P, int first, int last,
                             ValueMatrix_t& logdet, GradMatrix_t& dlogdet, ValueMatrix_t& d2logdet)
   {
-    const ValueType* restrict cptr=C.data();
-    for(int i=0,ij=0, iat=first; iat<last; i++,iat++)
+    if(Algo==1)
     {
-      myBasisSet->evaluateForWalkerMove(P,iat);
-
-      if(Algo==1)
+      const int nptcl=last-first;
+      if(TempAll.rows()!=5*nptcl || TempAll.cols()!=BasisSetSize || TempvAll.cols()!=OrbitalSetSize)
       {
-        // Fast algorithm, using a single dgemm
-        // Temp stores SOA BasisSet
-        simd::copy(Temp.data(), myBasisSet->Phi.data(), BasisSetSize);
-        simd::copy(Temp.data() + BasisSetSize, myBasisSet->d2Phi.data(), BasisSetSize);
+        TempAll.resize(5*nptcl,BasisSetSize);
+        TempvAll.resize(5*nptcl,OrbitalSetSize);
+      }
+      for(int i=0, iat=first; iat<last; i++,iat++)
+      {
+        myBasisSet->evaluateForWalkerMove(P,iat);
+        // TempAll stores SOA BasisSet of each particle
+        simd::copy(TempAll[5*i], myBasisSet->Phi.data(), BasisSetSize);
+        simd::copy(TempAll[5*i+1], myBasisSet->d2Phi.data(), BasisSetSize);
+        ValueType* restrict gx=TempAll[5*i+2];
+        ValueType* restrict gy=TempAll[5*i+3];
+        ValueType* restrict gz=TempAll[5*i+4];
         for(int k=0; k<BasisSetSize; k++)
         {
-          Temp[2][k]=myBasisSet->dPhi[k][0];
-          Temp[3][k]=myBasisSet->dPhi[k][1];
-          Temp[4][k]=myBasisSet->dPhi[k][2];
+          gx[k]=myBasisSet->dPhi[k][0];
+          gy[k]=myBasisSet->dPhi[k][1];
+          gz[k]=myBasisSet->dPhi[k][2];
         }
+      }
 
-        MatrixOperators::product_ABt(Temp,C,Tempv);
+      MatrixOperators::product_ABt(TempAll,C,TempvAll);
 
-        // Tempv stores SOA SPOset
-        simd::copy(logdet[i], Tempv.data(), OrbitalSetSize);
-        simd::copy(d2logdet[i], Tempv.data() + OrbitalSetSize, OrbitalSetSize);
+      // TempvAll stores SOA SPOset of each particle
+      for(int i=0; i<nptcl; i++)
+      {
+        simd::copy(logdet[i], TempvAll[5*i], OrbitalSetSize);
+        simd::copy(d2logdet[i], TempvAll[5*i+1], OrbitalSetSize);
+        const ValueType* restrict gx=TempvAll[5*i+2];
+        const ValueType* restrict gy=TempvAll[5*i+3];
+        const ValueType* restrict gz=TempvAll[5*i+4];
         for(int j=0; j<OrbitalSetSize; j++)
         {
-          dlogdet[i][j][0]=Tempv[2][j];
-          dlogdet[i][j][1]=Tempv[3][j];
-          dlogdet[i][j][2]=Tempv[4][j];
+          dlogdet[i][j][0]=gx[j];
+          dlogdet[i][j][1]=gy[j];
+          dlogdet[i][j][2]=gz[j];
         }
       }
-      else
+    }
+    else
+    {
+      // legacy algorithm
+      const ValueType* restrict cptr=C.data();
+      for(int i=0,ij=0, iat=first; iat<last; i++,iat++)
       {
-        // legacy algorithm
+        myBasisSet->evaluateForWalkerMove(P,iat);
         MatrixOperators::product(C,myBasisSet->Phi,logdet[i]);
         MatrixOperators::product(C,myBasisSet->d2Phi,d2logdet[i]);
         const typename BS::GradType* restrict dptr=myBasisSet->dPhi.data();
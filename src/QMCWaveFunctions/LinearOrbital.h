@@ -117,6 +117,13 @@ public:
 
   virtual void copyFromBuffer(ParticleSet& P, BufferType& buf) {}
 
+  virtual OrbitalBasePtr makeClone(ParticleSet& tqp) const
+  {
+    LinearOrbital* myclone=new LinearOrbital;
+    myclone->coeff=coeff;
+    return myclone;
+  }
+
 };
 
 
@@ -0,0 +1,354 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <QMCWaveFunctions/LocalizedSPOSet.h>
+#include <QMCWaveFunctions/BasisSetFactory.h>
+#include <OhmmsData/AttributeSet.h>
+#include <algorithm>
+
+namespace qmcplusplus
+{
+
+  LocalizedSPOSet::LocalizedSPOSet():
+    Threshold(1e-4), GridSize(32), NumCells(4), Owner(true)
+  {
+    className = "LocalizedSPOSet";
+    OrbitalSetSize = 0;
+  }
+
+  LocalizedSPOSet::~LocalizedSPOSet()
+  {
+    if(Owner)
+      for(int j=0; j<Splines.size(); ++j)
+        destroy_Bspline(Splines[j]);
+  }
+
+  SPOSetBase* LocalizedSPOSet::makeClone() const
+  {
+    LocalizedSPOSet* clone=new LocalizedSPOSet(*this);
+    clone->Owner=false;
+    clone->ActiveOrbitals=0;
+    return clone;
+  }
+
+  /** find the smallest periodic range of the grid points containing the marked points
+   * @param mark 1 for the points of the orbital
+   * @param pad number of the points added to both sides of the range
+   * @param first the first point of the range in [0,n)
+   * @return the number of the points of the range, n if it is the full axis
+   */
+  inline int find_box(const std::vector<int>& mark, int pad, int& first)
+  {
+    const int n=mark.size();
+    //the largest gap of the unmarked points
+    int gap=0, gap_end=0;
+    for(int i=0; i<n; ++i)
+    {
+      if(mark[i])
+        continue;
+      int len=1;
+      while(len<n && !mark[(i+len)%n])
+        ++len;
+      if(len>gap)
+      {
+        gap=len;
+        gap_end=i+len;
+      }
+    }
+    int len=n-gap+2*pad;
+    if(gap==0 || gap==n || len>=n)
+    {
+      first=0;
+      return n;
+    }
+    first=((gap_end-pad)%n+n)%n;
+    return len;
+  }
+
+  void LocalizedSPOSet::createSplines(ParticleSet& P, SPOSetBase& src)
+  {
+    if(P.Lattice.SuperCellEnum==SUPERCELL_OPEN)
+      APP_ABORT("LocalizedSPOSet::createSplines requires a periodic cell");
+    Lattice=P.Lattice;
+    GGt=dot(transpose(Lattice.G),Lattice.G);
+    OrbitalSetSize=src.size();
+    BasisSetSize=OrbitalSetSize;
+    const int norb=OrbitalSetSize;
+    const int npts=GridSize[0]*GridSize[1]*GridSize[2];
+    //sample the orbitals with the first particle of a copy of P
+    ParticleSet tmp(P);
+    tmp.update();
+    ValueVector_t psi(norb);
+    std::vector<std::vector<double> > samples(norb,std::vector<double>(npts));
+    std::vector<double> pmax(norb,0.0);
+    for(int i=0,ip=0; i<GridSize[0]; ++i)
+      for(int j=0; j<GridSize[1]; ++j)
+        for(int k=0; k<GridSize[2]; ++k,++ip)
+        {
+          TinyVector<RealType,3> u(RealType(i)/GridSize[0],RealType(j)/GridSize[1],RealType(k)/GridSize[2]);
+          tmp.makeMove(0,Lattice.toCart(u)-tmp.R[0]);
+          src.evaluate(tmp,0,psi);
+          tmp.rejectMove(0);
+          for(int n=0; n<norb; ++n)
+          {
+            samples[n][ip]=std::real(psi[n]);
+            pmax[n]=std::max(pmax[n],std::abs(samples[n][ip]));
+          }
+        }
+    //the boxes and the splines of the orbitals
+    const int pad=2;
+    std::vector<std::vector<int> > cell_mark(norb);
+    Splines.resize(norb);
+    BoxStart.resize(norb);
+    BoxEnd.resize(norb);
+    for(int n=0; n<norb; ++n)
+    {
+      std::vector<int> mark[3];
+      for(int d=0; d<3; ++d)
+        mark[d].resize(GridSize[d],0);
+      for(int i=0,ip=0; i<GridSize[0]; ++i)
+        for(int j=0; j<GridSize[1]; ++j)
+          for(int k=0; k<GridSize[2]; ++k,++ip)
+            if(std::abs(samples[n][ip])>Threshold*pmax[n])
+            {
+              mark[0][i]=1;
+              mark[1][j]=1;
+              mark[2][k]=1;
+            }
+      TinyVector<int,3> first, len;
+      Ugrid grid[3];
+      BCtype_d bc[3];
+      for(int d=0; d<3; ++d)
+      {
+        len[d]=find_box(mark[d],pad,first[d]);
+        BoxStart[n][d]=RealType(first[d])/GridSize[d];
+        if(len[d]==GridSize[d])
+        {
+          BoxEnd[n][d]=1.0;
+          grid[d].start=0.0;
+          grid[d].end=1.0;
+          bc[d].lCode=bc[d].rCode=PERIODIC;
+        }
+        else
+        {
+          BoxEnd[n][d]=RealType(first[d]+len[d]-1)/GridSize[d];
+          grid[d].start=BoxStart[n][d];
+          grid[d].end=BoxEnd[n][d];
+          bc[d].lCode=bc[d].rCode=NATURAL;
+        }
+        grid[d].num=len[d];
+      }
+      std::vector<double> data(len[0]*len[1]*len[2]);
+      for(int i=0,ip=0; i<len[0]; ++i)
+      {
+        const int ii=(first[0]+i)%GridSize[0];
+        for(int j=0; j<len[1]; ++j)
+        {
+          const int jj=(first[1]+j)%GridSize[1];
+          for(int k=0; k<len[2]; ++k,++ip)
+            data[ip]=samples[n][(ii*GridSize[1]+jj)*GridSize[2]+(first[2]+k)%GridSize[2]];
+        }
+      }
+      Splines[n]=create_UBspline_3d_d(grid[0],grid[1],grid[2],bc[0],bc[1],bc[2],data.data());
+      std::vector<double>().swap(samples[n]);
+    }
+    //the orbitals of the index cells
+    CellOrbitals.clear();
+    CellOrbitals.resize(NumCells[0]*NumCells[1]*NumCells[2]);
+    for(int n=0; n<norb; ++n)
+    {
+      std::vector<int> cells[3];
+      for(int d=0; d<3; ++d)
+      {
+        const int c0=static_cast<int>(BoxStart[n][d]*NumCells[d]);
+        const int c1=std::min(static_cast<int>(BoxEnd[n][d]*NumCells[d]),c0+NumCells[d]-1);
+        for(int c=c0; c<=c1; ++c)
+          cells[d].push_back(c%NumCells[d]);
+      }
+      for(int i=0; i<cells[0].size(); ++i)
+        for(int j=0; j<cells[1].size(); ++j)
+          for(int k=0; k<cells[2].size(); ++k)
+            CellOrbitals[(cells[0][i]*NumCells[1]+cells[1][j])*NumCells[2]+cells[2][k]].push_back(n);
+    }
+    Active.reserve(norb);
+    app_log() << "  LocalizedSPOSet " << norb << " orbitals, threshold=" << Threshold
+              << " grid=" << GridSize << " cells=" << NumCells
+              << " average orbitals per cell=" << averageActive() << std::endl;
+  }
+
+  LocalizedSPOSet::RealType LocalizedSPOSet::averageActive() const
+  {
+    RealType n=0;
+    for(int c=0; c<CellOrbitals.size(); ++c)
+      n+=CellOrbitals[c].size();
+    return (CellOrbitals.size())? n/CellOrbitals.size():0.0;
+  }
+
+  const std::vector<int>&
+  LocalizedSPOSet::findActive(const ParticleSet& P, int iat, TinyVector<RealType,3>& u)
+  {
+    u=Lattice.toUnit(P.R[iat]);
+    int c=0;
+    for(int d=0; d<3; ++d)
+    {
+      u[d]-=std::floor(u[d]);
+      c=c*NumCells[d]+std::min(static_cast<int>(u[d]*NumCells[d]),NumCells[d]-1);
+    }
+    return CellOrbitals[c];
+  }
+
+  void LocalizedSPOSet::evaluate(const ParticleSet& P, int iat, ValueVector_t& psi)
+  {
+    TinyVector<RealType,3> u, x;
+    const std::vector<int>& orbs=findActive(P,iat,u);
+    std::fill(psi.begin(),psi.end(),ValueType());
+    Active.clear();
+    for(int i=0; i<orbs.size(); ++i)
+    {
+      const int j=orbs[i];
+      if(!inBox(j,u,x))
+        continue;
+      double v;
+      eval_UBspline_3d_d(Splines[j],x[0],x[1],x[2],&v);
+      psi[j]=v;
+      Active.push_back(j);
+    }
+    ActiveOrbitals=&Active;
+  }
+
+  void LocalizedSPOSet::evaluate(const ParticleSet& P, int iat,
+                                 ValueVector_t& psi, GradVector_t& dpsi, ValueVector_t& d2psi)
+  {
+    TinyVector<RealType,3> u, x;
+    const std::vector<int>& orbs=findActive(P,iat,u);
+    std::fill(psi.begin(),psi.end(),ValueType());
+    std::fill(dpsi.begin(),dpsi.end(),GradType());
+    std::fill(d2psi.begin(),d2psi.end(),ValueType());
+    Active.clear();
+    for(int i=0; i<orbs.size(); ++i)
+    {
+      const int j=orbs[i];
+      if(!inBox(j,u,x))
+        continue;
+      double v;
+      TinyVector<double,3> g;
+      Tensor<double,3> h;
+      eval_UBspline_3d_d_vgh(Splines[j],x[0],x[1],x[2],&v,g.data(),h.data());
+      psi[j]=v;
+      dpsi[j]=dot(Lattice.G,g);
+      d2psi[j]=trace(h,GGt);
+      Active.push_back(j);
+    }
+    ActiveOrbitals=&Active;
+  }
+
+  void LocalizedSPOSet::evaluate(const ParticleSet& P, int iat,
+                                 ValueVector_t& psi, GradVector_t& dpsi, HessVector_t& grad_grad_psi)
+  {
+    TinyVector<RealType,3> u, x;
+    const std::vector<int>& orbs=findActive(P,iat,u);
+    std::fill(psi.begin(),psi.end(),ValueType());
+    std::fill(dpsi.begin(),dpsi.end(),GradType());
+    std::fill(grad_grad_psi.begin(),grad_grad_psi.end(),HessType());
+    Active.clear();
+    for(int i=0; i<orbs.size(); ++i)
+    {
+      const int j=orbs[i];
+      if(!inBox(j,u,x))
+        continue;
+      double v;
+      TinyVector<double,3> g;
+      Tensor<double,3> h;
+      eval_UBspline_3d_d_vgh(Splines[j],x[0],x[1],x[2],&v,g.data(),h.data());
+      psi[j]=v;
+      dpsi[j]=dot(Lattice.G,g);
+      grad_grad_psi[j]=dot(Lattice.G,dot(h,transpose(Lattice.G)));
+      Active.push_back(j);
+    }
+    ActiveOrbitals=&Active;
+  }
+
+  void LocalizedSPOSet::evaluate_notranspose(
+    const ParticleSet& P, int first, int last, ValueMatrix_t& logdet,
+    GradMatrix_t& dlogdet, ValueMatrix_t& d2logdet)
+  {
+    const int norb=OrbitalSetSize;
+    ValueVector_t v(norb), l(norb);
+    GradVector_t g(norb);
+    for(int iat=first, i=0; iat<last; ++iat,++i)
+    {
+      evaluate(P,iat,v,g,l);
+      std::copy(v.begin(),v.end(),logdet[i]);
+      std::copy(g.begin(),g.end(),dlogdet[i]);
+      std::copy(l.begin(),l.end(),d2logdet[i]);
+    }
+  }
+
+  void LocalizedSPOSet::evaluate_notranspose(
+    const ParticleSet& P, int first, int last, ValueMatrix_t& logdet,
+    GradMatrix_t& dlogdet, HessMatrix_t& grad_grad_logdet)
+  {
+    const int norb=OrbitalSetSize;
+    ValueVector_t v(norb);
+    GradVector_t g(norb);
+    HessVector_t h(norb);
+    for(int iat=first, i=0; iat<last; ++iat,++i)
+    {
+      evaluate(P,iat,v,g,h);
+      std::copy(v.begin(),v.end(),logdet[i]);
+      std::copy(g.begin(),g.end(),dlogdet[i]);
+      std::copy(h.begin(),h.end(),grad_grad_logdet[i]);
+    }
+  }
+
+  void LocalizedSPOSet::evaluate_notranspose(
+    const ParticleSet& P, int first, int last, ValueMatrix_t& logdet,
+    GradMatrix_t& dlogdet, HessMatrix_t& grad_grad_logdet,
+    GGGMatrix_t& grad_grad_grad_logdet)
+  {
+    not_implemented("evaluate_notranspose(P,first,last,logdet,dlogdet,ddlogdet,dddlogdet)");
+  }
+
+
+  SPOSetBase* LocalizedSPOSetBuilder::createSPOSetFromXML(xmlNodePtr cur)
+  {
+    std::string source("");
+    LocalizedSPOSet* spo_now=new LocalizedSPOSet;
+    int grid=spo_now->GridSize[0];
+    int cells=spo_now->NumCells[0];
+    OhmmsAttributeSet attrib;
+    attrib.add(source,"source");
+    attrib.add(spo_now->Threshold,"threshold");
+    attrib.add(grid,"grid");
+    attrib.add(cells,"cells");
+    attrib.put(cur);
+    SPOSetBase* spo=get_sposet(source);
+    if(spo==0)
+    {
+      APP_ABORT("LocalizedSPOSetBuilder::createSPOSetFromXML sposet "+source+" does not exist");
+    }
+    spo_now->GridSize=grid;
+    spo_now->NumCells=cells;
+    spo_now->createSplines(targetPtcl,*spo);
+    return spo_now;
+  }
+
+  SPOSetBase* LocalizedSPOSetBuilder::createSPOSet(xmlNodePtr cur,SPOSetInputInfo& input)
+  {
+    return createSPOSetFromXML(cur);
+  }
+
+  bool LocalizedSPOSetBuilder::put(xmlNodePtr cur)
+  {
+    return true;
+  }
+}
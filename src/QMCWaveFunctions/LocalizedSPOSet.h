@@ -0,0 +1,150 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file LocalizedSPOSet.h
+ * @brief localized orbitals stored within their bounding boxes
+ */
+#ifndef QMCPLUSPLUS_LOCALIZED_SPOSET_H
+#define QMCPLUSPLUS_LOCALIZED_SPOSET_H
+
+#include <QMCWaveFunctions/SPOSetBase.h>
+#include <QMCWaveFunctions/BasisSetBase.h>
+#include <einspline/bspline.h>
+
+namespace qmcplusplus
+{
+
+/** SPO set of localized orbitals, e.g. Wannier functions of an insulator
+ *
+ * Each orbital is sampled from a source SPO set on a grid over the cell and
+ * a B-spline is fitted only within the box, in reduced coordinates, where
+ * the orbital exceeds Threshold times its maximum. The cell is divided into
+ * index cells and CellOrbitals lists the orbitals whose boxes overlap a cell.
+ * The evaluation at a position computes only the orbitals of its index cell,
+ * the others are zero, and ActiveOrbitals points to the computed orbitals so
+ * that the determinant can use sparse rows.
+ */
+class LocalizedSPOSet : public SPOSetBase
+{
+public:
+  ///relative threshold of the orbitals to define the boxes
+  RealType Threshold;
+  ///number of the sampling points per lattice vector
+  TinyVector<int,3> GridSize;
+  ///number of the index cells per lattice vector
+  TinyVector<int,3> NumCells;
+
+  LocalizedSPOSet();
+  ~LocalizedSPOSet();
+
+  /** sample the orbitals of src and create the splines and the cell index
+   * @param P particle set defining the lattice, needed by src
+   * @param src source SPO set
+   */
+  void createSplines(ParticleSet& P, SPOSetBase& src);
+
+  ///return the average number of the orbitals per index cell
+  RealType averageActive() const;
+
+  //SPOSetBase interface methods
+  inline void setOrbitalSetSize(int norbs) { }
+
+  inline void resetTargetParticleSet(ParticleSet& P) { }
+
+  inline void resetParameters(const opt_variables_type& optVariables) { }
+
+  SPOSetBase* makeClone() const;
+
+  void evaluate(const ParticleSet& P, int iat, ValueVector_t& psi);
+
+  void evaluate(const ParticleSet& P, int iat,
+                ValueVector_t& psi, GradVector_t& dpsi, ValueVector_t& d2psi);
+
+  void evaluate_notranspose(const ParticleSet& P, int first, int last,
+                            ValueMatrix_t& logdet, GradMatrix_t& dlogdet,
+                            ValueMatrix_t& d2logdet);
+
+  ///unimplemented functions call this to abort
+  inline void not_implemented(const std::string& method)
+  {
+    APP_ABORT("LocalizedSPOSet::"+method+" has not been implemented");
+  }
+
+  void evaluate(const ParticleSet& P, int iat,
+                ValueVector_t& psi, GradVector_t& dpsi, HessVector_t& ddpsi);
+  void evaluate_notranspose(const ParticleSet& P, int first, int last,
+                            ValueMatrix_t& logdet, GradMatrix_t& dlogdet,
+                            HessMatrix_t& ddlogdet);
+  void evaluate_notranspose(const ParticleSet& P, int first, int last,
+                            ValueMatrix_t& logdet, GradMatrix_t& dlogdet,
+                            HessMatrix_t& ddlogdet, GGGMatrix_t& dddlogdet);
+
+private:
+  ///true if the splines are owned by this object
+  bool Owner;
+  ///lattice of the orbitals
+  CrystalLattice<RealType,3> Lattice;
+  ///G G^T to transform the hessians in the reduced coordinates
+  Tensor<RealType,3> GGt;
+  ///splines of the orbitals
+  std::vector<UBspline_3d_d*> Splines;
+  ///lower corner of the box of the orbitals in the reduced coordinates
+  std::vector<TinyVector<RealType,3> > BoxStart;
+  ///upper corner of the box of the orbitals in the reduced coordinates
+  std::vector<TinyVector<RealType,3> > BoxEnd;
+  ///orbitals overlapping each index cell
+  std::vector<std::vector<int> > CellOrbitals;
+  ///orbitals evaluated at the last position
+  std::vector<int> Active;
+
+  /** return the orbitals of the index cell of iat
+   * @param P particle set
+   * @param iat particle index
+   * @param u the reduced coordinates of iat in [0,1)
+   */
+  const std::vector<int>& findActive(const ParticleSet& P, int iat, TinyVector<RealType,3>& u);
+
+  ///map u into the box of orbital j, return false if it is outside
+  inline bool inBox(int j, const TinyVector<RealType,3>& u, TinyVector<RealType,3>& x) const
+  {
+    for(int d=0; d<3; ++d)
+    {
+      x[d]=u[d]-BoxStart[j][d];
+      x[d]=BoxStart[j][d]+(x[d]-std::floor(x[d]));
+      if(x[d]>BoxEnd[j][d])
+        return false;
+    }
+    return true;
+  }
+};
+
+/** builder of LocalizedSPOSet
+ *
+ * The source attribute names an existing sposet to be localized.
+ */
+struct LocalizedSPOSetBuilder : public BasisSetBuilder
+{
+  ///target particle set
+  ParticleSet& targetPtcl;
+
+  LocalizedSPOSetBuilder(ParticleSet& p): targetPtcl(p) {}
+
+  //BasisSetBuilder interface
+  SPOSetBase* createSPOSetFromXML(xmlNodePtr cur);
+
+  SPOSetBase* createSPOSet(xmlNodePtr cur,SPOSetInputInfo& input);
+
+  bool put(xmlNodePtr cur);
+};
+}
+
+#endif
@@ -14,10 +14,11 @@
     
     
 #include "QMCWaveFunctions/MolecularOrbitals/GTOBuilder.h"
+#include "OhmmsData/AttributeSet.h"
 namespace qmcplusplus
 {
 
-GTOBuilder::GTOBuilder(xmlNodePtr cur): Normalized(true), m_orbitals(0)
+GTOBuilder::GTOBuilder(xmlNodePtr cur): Normalized(true), Screening(1.0e-16), m_orbitals(0)
 {
   if(cur != NULL)
   {
@@ -33,6 +34,9 @@ bool GTOBuilder::putCommon(xmlNodePtr cur)
     if(xmlStrEqual(a,(const xmlChar*)"no"))
       Normalized=false;
   }
+  OhmmsAttributeSet aAttrib;
+  aAttrib.add(Screening,"screening");
+  aAttrib.put(cur);
   return true;
 }
 
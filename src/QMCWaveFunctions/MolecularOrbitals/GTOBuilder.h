@@ -15,8 +15,7 @@
 #define QMCPLUSPLUS_GTO_BUILDER_H
 
 #include "Configuration.h"
-#include "QMCWaveFunctions/SphericalBasisSet.h"
-#include "Numerics/GaussianBasisSet.h"
+#include "QMCWaveFunctions/MolecularOrbitals/GaussianShellBasisSet.h"
 
 namespace qmcplusplus
 {
@@ -27,10 +26,12 @@ class GTOBuilder: public QMCTraits
 public:
 
   typedef GaussianCombo<RealType>                    RadialOrbitalType;
-  typedef SphericalBasisSet<RadialOrbitalType>     CenteredOrbitalType;
+  typedef GaussianShellBasisSet<RealType>          CenteredOrbitalType;
 
   ///true, if the RadialOrbitalType is normalized
   bool Normalized;
+  ///tolerance of the screening radius of the shells
+  RealType Screening;
   ///the radial orbitals
   CenteredOrbitalType* m_orbitals;
   ///the species
@@ -42,6 +43,7 @@ public:
   void setOrbitalSet(CenteredOrbitalType* oset, const std::string& acenter)
   {
     m_orbitals = oset;
+    m_orbitals->Screening = Screening;
     m_species = acenter;
   }
 
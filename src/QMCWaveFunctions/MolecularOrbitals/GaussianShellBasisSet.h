@@ -0,0 +1,354 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file GaussianShellBasisSet.h
+ * @brief Gaussian atomic basis set of a center with the contracted shells in SoA
+ */
+#ifndef QMCPLUSPLUS_GAUSSIAN_SHELL_BASISSET_H
+#define QMCPLUSPLUS_GAUSSIAN_SHELL_BASISSET_H
+
+#include "QMCWaveFunctions/SphericalBasisSet.h"
+#include "Numerics/GaussianBasisSet.h"
+#include "simd/allocator.hpp"
+#include <cmath>
+#include <limits>
+
+namespace qmcplusplus
+{
+
+/** SphericalBasisSet of contracted Gaussian shells evaluated all at once
+ *
+ * The radial functors in Rnl are built as for SphericalBasisSet and are
+ * packed by pack() when the basis set is complete. The exponents and the
+ * contraction coefficients of all the primitives of a center are stored in
+ * aligned arrays, so that the exponentials of a distance are evaluated by a
+ * single vectorized loop and each shell is a sum over its slice.
+ *
+ * Each shell has a screening radius beyond which the magnitude of its
+ * basis functions, gradients and laplacians is below Screening. The shells
+ * out of range are set to zero and a center out of range of all its shells
+ * is skipped without evaluating the angular functions.
+ *
+ * The value, gradient and laplacian functions are specialized. The others,
+ * e.g., with the hessians, use the radial functors of SphericalBasisSet.
+ */
+template<class T>
+struct GaussianShellBasisSet: public SphericalBasisSet<GaussianCombo<T> >
+{
+  typedef SphericalBasisSet<GaussianCombo<T> > BaseType;
+  typedef typename BaseType::RealType      RealType;
+  typedef typename BaseType::ValueType     ValueType;
+  typedef typename BaseType::PosType       PosType;
+  typedef typename BaseType::GradType      GradType;
+  typedef typename BaseType::ValueVector_t ValueVector_t;
+  typedef typename BaseType::ValueMatrix_t ValueMatrix_t;
+  typedef typename BaseType::GradVector_t  GradVector_t;
+  typedef typename BaseType::GradMatrix_t  GradMatrix_t;
+
+  using BaseType::myTable;
+  using BaseType::useCartesian;
+  using BaseType::Ylm;
+  using BaseType::XYZ;
+  using BaseType::LM;
+  using BaseType::NL;
+  using BaseType::Rnl;
+  using BaseType::RnlID;
+  using BaseType::evaluateForWalkerMove;
+  using BaseType::evaluateAllForPtclMove;
+
+  ///tolerance of the screening radius
+  RealType Screening;
+  ///largest screening radius of the shells
+  RealType Rmax;
+  ///-exponent of the primitives
+  aligned_vector<RealType> MinusAlpha;
+  ///contraction coefficients of the primitives
+  aligned_vector<RealType> Coeff;
+  ///-2*exponent*coefficient
+  aligned_vector<RealType> CoeffP;
+  ///4*exponent^2*coefficient
+  aligned_vector<RealType> CoeffPP;
+  ///exponentials of the primitives for the current distance
+  aligned_vector<RealType> ExpPrim;
+  ///the primitives of the shell nl are [PrimOffset[nl],PrimOffset[nl+1])
+  std::vector<int> PrimOffset;
+  ///screening radius of the shells
+  std::vector<RealType> Rcut;
+  ///value, derivative and second derivative of the shells
+  std::vector<RealType> RY, RdY, Rd2Y;
+
+  explicit GaussianShellBasisSet(int lmax, bool addsignforM=false, bool useXYZ=false):
+    BaseType(lmax,addsignforM,useXYZ), Screening(1.0e-16), Rmax(0.0) { }
+
+  GaussianShellBasisSet<T>* makeClone() const
+  {
+    GaussianShellBasisSet<T>* myclone=new GaussianShellBasisSet<T>(*this);
+    for(int i=0; i<Rnl.size(); ++i)
+      myclone->Rnl[i]=dynamic_cast<GaussianCombo<T>*>(Rnl[i]->makeClone());
+    return myclone;
+  }
+
+  inline void setBasisSetSize(int n)
+  {
+    BaseType::setBasisSetSize(n);
+    pack();
+  }
+
+  inline void setTable(const DistanceTableData* atable)
+  {
+    BaseType::setTable(atable);
+    pack();
+  }
+
+  /** copy the primitives of Rnl to the SoA arrays and set the screening radii
+   */
+  void pack()
+  {
+    const int nshells=Rnl.size();
+    PrimOffset.resize(nshells+1);
+    PrimOffset[0]=0;
+    for(int nl=0; nl<nshells; ++nl)
+      PrimOffset[nl+1]=PrimOffset[nl]+Rnl[nl]->size();
+    const int nprims=PrimOffset[nshells];
+    MinusAlpha.resize(nprims);
+    Coeff.resize(nprims);
+    CoeffP.resize(nprims);
+    CoeffPP.resize(nprims);
+    ExpPrim.resize(nprims);
+    Rcut.resize(nshells);
+    RY.resize(nshells);
+    RdY.resize(nshells);
+    Rd2Y.resize(nshells);
+    Rmax=0.0;
+    for(int nl=0; nl<nshells; ++nl)
+    {
+      for(int ip=0, p=PrimOffset[nl]; p<PrimOffset[nl+1]; ++ip, ++p)
+      {
+        const typename GaussianCombo<T>::BasicGaussian& g(Rnl[nl]->gset[ip]);
+        MinusAlpha[p]=g.MinusSigma;
+        Coeff[p]=g.Coeff;
+        CoeffP[p]=g.CoeffP;
+        CoeffPP[p]=g.CoeffPP;
+      }
+      Rcut[nl]=screeningRadius(nl);
+      Rmax=std::max(Rmax,Rcut[nl]);
+    }
+  }
+
+  /** return the radius beyond which the shell nl is negligible
+   *
+   * A bound of the basis functions of angular momentum l and their first and
+   * second derivatives,
+   * \f$ \sum_p |c_p|(1+2\alpha_p r)^2 \max(1,r)^l e^{-\alpha_p r^2} \f$,
+   * decreases for \f$ r>\max(1,\sqrt{(l+2)/2\alpha_{min}}) \f$ and is
+   * scanned outward from there until it is below Screening.
+   */
+  RealType screeningRadius(int nl) const
+  {
+    const int l=(nl<RnlID.size())? RnlID[nl][q_l]:0;
+    RealType amin=std::numeric_limits<RealType>::max();
+    for(int p=PrimOffset[nl]; p<PrimOffset[nl+1]; ++p)
+      amin=std::min(amin,-MinusAlpha[p]);
+    if(PrimOffset[nl+1]==PrimOffset[nl] || amin<=0.0)
+      return std::numeric_limits<RealType>::max();
+    const RealType dr=0.1;
+    const RealType rlimit=1000.0;
+    RealType r=std::max(RealType(1),std::sqrt(RealType(l+2)/(2*amin)));
+    for(; r<rlimit; r+=dr)
+    {
+      RealType rl=std::pow(r,l);
+      RealType bound=0.0;
+      for(int p=PrimOffset[nl]; p<PrimOffset[nl+1]; ++p)
+      {
+        RealType d=1.0-2.0*MinusAlpha[p]*r;
+        bound += std::abs(Coeff[p])*d*d*rl*std::exp(MinusAlpha[p]*r*r);
+      }
+      if(bound<Screening)
+        break;
+    }
+    return r;
+  }
+
+  /** evaluate the radial functions of the shells at r
+   * @return false, if all the shells are screened
+   */
+  inline bool evaluateShells(RealType r)
+  {
+    if(r>=Rmax)
+      return false;
+    const RealType rr=r*r;
+    const int nprims=ExpPrim.size();
+    const RealType* restrict ma=MinusAlpha.data();
+    RealType* restrict e=ExpPrim.data();
+    #pragma omp simd
+    for(int p=0; p<nprims; ++p)
+      e[p]=std::exp(ma[p]*rr);
+    for(int nl=0; nl<Rcut.size(); ++nl)
+    {
+      RealType y=0.0, dy=0.0, d2y=0.0;
+      if(r<Rcut[nl])
+      {
+        #pragma omp simd reduction(+:y,dy,d2y)
+        for(int p=PrimOffset[nl]; p<PrimOffset[nl+1]; ++p)
+        {
+          y   += Coeff[p]*e[p];
+          dy  += CoeffP[p]*e[p];
+          d2y += (CoeffP[p]+CoeffPP[p]*rr)*e[p];
+        }
+      }
+      RY[nl]=y;
+      RdY[nl]=dy*r;
+      Rd2Y[nl]=d2y;
+    }
+    return true;
+  }
+
+  /** evaluate the values of the shells at r
+   * @return false, if all the shells are screened
+   */
+  inline bool evaluateShellValues(RealType r)
+  {
+    if(r>=Rmax)
+      return false;
+    const RealType rr=r*r;
+    const int nprims=ExpPrim.size();
+    const RealType* restrict ma=MinusAlpha.data();
+    RealType* restrict e=ExpPrim.data();
+    #pragma omp simd
+    for(int p=0; p<nprims; ++p)
+      e[p]=std::exp(ma[p]*rr);
+    for(int nl=0; nl<Rcut.size(); ++nl)
+    {
+      RealType y=0.0;
+      if(r<Rcut[nl])
+      {
+        #pragma omp simd reduction(+:y)
+        for(int p=PrimOffset[nl]; p<PrimOffset[nl+1]; ++p)
+          y += Coeff[p]*e[p];
+      }
+      RY[nl]=y;
+    }
+    return true;
+  }
+
+  ///combine the shells with the angular functions at dr
+  template<typename VV, typename GV, typename LV>
+  inline void combine(RealType rinv, const PosType& dr, VV* restrict psi, GV* restrict dpsi, LV* restrict d2psi)
+  {
+    if(useCartesian)
+      XYZ.evaluateAll(dr);
+    else
+      Ylm.evaluateAll(dr);
+    const std::vector<RealType>& valueYlm = useCartesian?XYZ.XYZ:Ylm.Ylm;
+    const std::vector<PosType>& gradYlm = useCartesian?XYZ.gradXYZ:Ylm.gradYlm;
+    const std::vector<RealType>& laplYlm = useCartesian?XYZ.laplXYZ:Ylm.laplYlm;
+    for(int ib=0; ib<NL.size(); ++ib)
+    {
+      const int nl(NL[ib]);
+      const int lm(LM[ib]);
+      RealType drnloverr(rinv*RdY[nl]);
+      ValueType ang(valueYlm[lm]);
+      PosType gr_rad(drnloverr*dr);
+      PosType gr_ang(gradYlm[lm]);
+      psi[ib]  = ang*RY[nl];
+      dpsi[ib] = ang*gr_rad+RY[nl]*gr_ang;
+      d2psi[ib] = ang*(2.0*drnloverr+Rd2Y[nl]) + 2.0*dot(gr_rad,gr_ang) + RY[nl]*laplYlm[lm];
+    }
+  }
+
+  ///combine the shell values with the angular functions at dr
+  inline void combineValues(const PosType& dr, ValueType* restrict psi)
+  {
+    if(useCartesian)
+    {
+      XYZ.evaluate(dr);
+      for(int ib=0; ib<NL.size(); ++ib)
+        psi[ib]=XYZ.XYZ[LM[ib]]*RY[NL[ib]];
+    }
+    else
+    {
+      Ylm.evaluate(dr);
+      for(int ib=0; ib<NL.size(); ++ib)
+        psi[ib]=Ylm.Ylm[LM[ib]]*RY[NL[ib]];
+    }
+  }
+
+  ///zero the basis functions of this center
+  template<typename VV, typename GV, typename LV>
+  inline void zero(VV* restrict psi, GV* restrict dpsi, LV* restrict d2psi)
+  {
+    for(int ib=0; ib<NL.size(); ++ib)
+    {
+      psi[ib]=0.0;
+      dpsi[ib]=0.0;
+      d2psi[ib]=0.0;
+    }
+  }
+
+  inline void
+  evaluateForWalkerMove(int c, int iat, int offset, ValueVector_t& psi, GradVector_t& dpsi, ValueVector_t& d2psi)
+  {
+    int nn = myTable->M[c]+iat;
+    if(evaluateShells(myTable->r(nn)))
+      combine(myTable->rinv(nn),myTable->dr(nn),psi.data()+offset,dpsi.data()+offset,d2psi.data()+offset);
+    else
+      zero(psi.data()+offset,dpsi.data()+offset,d2psi.data()+offset);
+  }
+
+  inline void
+  evaluateForWalkerMove(int source, int first, int nptcl, int offset, ValueMatrix_t& y, GradMatrix_t& dy, ValueMatrix_t& d2y)
+  {
+    int nn = myTable->M[source]+first;//first pair of the particle subset
+    for(int i=0, iat=first; i<nptcl; i++, iat++, nn++)
+    {
+      if(evaluateShells(myTable->r(nn)))
+        combine(myTable->rinv(nn),myTable->dr(nn),y[iat]+offset,dy[iat]+offset,d2y[iat]+offset);
+      else
+        zero(y[iat]+offset,dy[iat]+offset,d2y[iat]+offset);
+    }
+  }
+
+  inline void
+  evaluateForPtclMove(int source, int iat,  int offset, ValueVector_t& y)
+  {
+    if(evaluateShellValues(myTable->Temp[source].r1))
+      combineValues(myTable->Temp[source].dr1,y.data()+offset);
+    else
+      std::fill(y.data()+offset,y.data()+offset+NL.size(),ValueType());
+  }
+
+  inline void
+  evaluateAllForPtclMove(int source, int iat,  int offset, ValueVector_t& y,
+                         GradVector_t& dy, ValueVector_t& d2y)
+  {
+    if(evaluateShells(myTable->Temp[source].r1))
+      combine(myTable->Temp[source].rinv1,myTable->Temp[source].dr1,y.data()+offset,dy.data()+offset,d2y.data()+offset);
+    else
+      zero(y.data()+offset,dy.data()+offset,d2y.data()+offset);
+  }
+
+  void evaluateValues(const DistanceTableData* dt, int c, int offset, ValueMatrix_t& phiM)
+  {
+    int nn = dt->M[c];
+    for(int iat=0; iat<dt->targets(); iat++, nn++)
+    {
+      ValueType* restrict y = phiM[iat]+offset;
+      if(evaluateShellValues(dt->r(nn)))
+        combineValues(dt->dr(nn),y);
+      else
+        std::fill(y,y+NL.size(),ValueType());
+    }
+  }
+};
+
+}
+#endif
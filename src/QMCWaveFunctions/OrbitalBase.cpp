@@ -85,6 +85,21 @@ void OrbitalBase::evaluateDerivatives(ParticleSet& P,
 
 /*@todo makeClone should be a pure virtual function
  */
+void OrbitalBase::mw_ratioGrad(const std::vector<OrbitalBase*>& WFC_list,
+                               const std::vector<ParticleSet*>& P_list, int iat,
+                               std::vector<ValueType>& ratios, std::vector<GradType>& grad_new)
+{
+  for(int iw=0; iw<WFC_list.size(); ++iw)
+    ratios[iw]=WFC_list[iw]->ratioGrad(*P_list[iw],iat,grad_new[iw]);
+}
+
+void OrbitalBase::mw_acceptMove(const std::vector<OrbitalBase*>& WFC_list,
+                                const std::vector<ParticleSet*>& P_list, int iat)
+{
+  for(int iw=0; iw<WFC_list.size(); ++iw)
+    WFC_list[iw]->acceptMove(*P_list[iw],iat);
+}
+
 OrbitalBasePtr OrbitalBase::makeClone(ParticleSet& tpq) const
 {
   APP_ABORT("Implement OrbitalBase::makeClone "+OrbitalName+ " class.");
@@ -324,6 +324,30 @@ struct OrbitalBase: public QMCTraits
     return 1.0;
   }
 
+  /** evaluate the ratios and the gradients of the iat-th particle of many walkers
+   * @param WFC_list the same component of the wavefunctions of the walkers, including this
+   * @param P_list the active ParticleSets of the walkers
+   * @param iat the index of a particle
+   * @param ratios the ratios of the walkers
+   * @param grad_new the gradients of the walkers, accumulated
+   *
+   * The default calls ratioGrad of each walker. A derived class overwrites
+   * it to batch its kernels over the walkers.
+   */
+  virtual void mw_ratioGrad(const std::vector<OrbitalBase*>& WFC_list,
+                            const std::vector<ParticleSet*>& P_list, int iat,
+                            std::vector<ValueType>& ratios, std::vector<GradType>& grad_new);
+
+  /** accept the moves of the iat-th particle of many walkers
+   * @param WFC_list the same component of the wavefunctions of the walkers, including this
+   * @param P_list the ParticleSets of the walkers
+   * @param iat the index of the moved particle
+   *
+   * The default calls acceptMove of each walker.
+   */
+  virtual void mw_acceptMove(const std::vector<OrbitalBase*>& WFC_list,
+                             const std::vector<ParticleSet*>& P_list, int iat);
+
   virtual void alternateGrad(ParticleSet::ParticleGradient_t& G) {}
 
   /** evaluate the ratio of the new to old orbital value
@@ -66,6 +66,22 @@ void SPOSetBase::evaluateValues(const ParticleSet& P, ValueMatrix_t& psiM)
   APP_ABORT("SPOSetBase::evaluate(P,psiM) not implemented.");
 }
 
+void SPOSetBase::mw_evaluate(const std::vector<ParticleSet*>& P_list, int iat,
+                             const std::vector<ValueVector_t*>& psi_list)
+{
+  for(int iw=0; iw<P_list.size(); ++iw)
+    evaluate(*P_list[iw],iat,*psi_list[iw]);
+}
+
+void SPOSetBase::mw_evaluate(const std::vector<ParticleSet*>& P_list, int iat,
+                             const std::vector<ValueVector_t*>& psi_list,
+                             const std::vector<GradVector_t*>& dpsi_list,
+                             const std::vector<ValueVector_t*>& d2psi_list)
+{
+  for(int iw=0; iw<P_list.size(); ++iw)
+    evaluate(*P_list[iw],iat,*psi_list[iw],*dpsi_list[iw],*d2psi_list[iw]);
+}
+
 void SPOSetBase::evaluateThirdDeriv(const ParticleSet& P, int first, int last,
                                     GGGMatrix_t& grad_grad_grad_logdet)
 {
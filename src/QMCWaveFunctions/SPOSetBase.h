@@ -63,6 +63,10 @@ public:
   bool NeedsDistanceTable;
   ///flag to calculate ionic derivatives
   bool ionDerivs;
+  ///true if evaluateValues handles all the virtual moves of a VirtualParticleSet
+  bool HaveValuesForVP;
+  ///true if mw_evaluate can be called for the ParticleSets of other walkers
+  bool CanBatchWalkers;
   ///total number of orbitals
   IndexType TotalOrbitalSize;
   ///number of Single-particle orbitals
@@ -77,6 +81,12 @@ public:
   ValueMatrix_t C;
   ///occupation number
   Vector<RealType> Occ;
+  /** orbitals with nonzero values at the last position evaluated for a particle
+   *
+   * null, if all the orbitals are evaluated. Sparse sets point to their list
+   * in evaluate(P,iat,...) so that the determinant can skip the zeros.
+   */
+  const std::vector<int>* ActiveOrbitals;
   /// Optimizable variables
   opt_variables_type myVars;
   ///name of the basis set
@@ -92,7 +102,7 @@ public:
   SPOSetBase()
     :Identity(false),TotalOrbitalSize(0),OrbitalSetSize(0),BasisSetSize(0),
     NeedsDistanceTable(false),
-    ActivePtcl(-1),Optimizable(false),ionDerivs(false),builder_index(-1)
+    ActivePtcl(-1),ActiveOrbitals(0),Optimizable(false),ionDerivs(false),HaveValuesForVP(false),CanBatchWalkers(false),builder_index(-1)
   {
     className="invalid";
   }
@@ -229,6 +239,30 @@ public:
   evaluate(const ParticleSet& P, int iat,
            ValueVector_t& psi, GradVector_t& dpsi, HessVector_t& grad_grad_psi)=0;
 
+  /** evaluate the values of this single-particle orbital set for the iat-th particle of many walkers
+   * @param P_list ParticleSet of each walker
+   * @param iat active particle
+   * @param psi_list values of the SPO of each walker
+   *
+   * The default implementation calls evaluate(P,iat,psi) walker by walker.
+   */
+  virtual void
+  mw_evaluate(const std::vector<ParticleSet*>& P_list, int iat,
+              const std::vector<ValueVector_t*>& psi_list);
+
+  /** evaluate the values, gradients and laplacians for the iat-th particle of many walkers
+   * @param P_list ParticleSet of each walker
+   * @param iat active particle
+   * @param psi_list values of the SPO of each walker
+   * @param dpsi_list gradients of the SPO of each walker
+   * @param d2psi_list laplacians of the SPO of each walker
+   */
+  virtual void
+  mw_evaluate(const std::vector<ParticleSet*>& P_list, int iat,
+              const std::vector<ValueVector_t*>& psi_list,
+              const std::vector<GradVector_t*>& dpsi_list,
+              const std::vector<ValueVector_t*>& d2psi_list);
+
   /** evaluate the values, gradients and laplacians of this single-particle orbital for [first,last)particles
    * @param P current ParticleSet
    * @param first starting index of the particles
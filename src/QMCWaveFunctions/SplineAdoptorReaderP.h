@@ -154,6 +154,7 @@ struct SplineAdoptorReader: public BsplineReaderBase
       APP_ABORT("EinsplineAdoptorReader needs psi_g. Set precision=\"double\".");
     }
     bspline->create_spline(xyz_grid,xyz_bc);
+    share_spline(bspline->MultiSpline);
     int TwistNum = mybuilder->TwistNum;
     std::ostringstream oo;
     oo<<bandgroup.myName << ".g"<<MeshSize[0]<<"x"<<MeshSize[1]<<"x"<<MeshSize[2]<<".h5";
@@ -190,7 +191,7 @@ struct SplineAdoptorReader: public BsplineReaderBase
     {
       app_log() << "Use existing bspline tables in " << splinefile << std::endl;
       now.restart();
-      chunked_bcast(myComm, bspline->MultiSpline);
+      bcast_spline(bspline->MultiSpline);
       app_log() << "  SplineAdoptorReader bcast the full table " << now.elapsed() << " sec" << std::endl;
       app_log().flush();
     }
@@ -202,22 +203,24 @@ struct SplineAdoptorReader: public BsplineReaderBase
       int nz=MeshSize[2];
       if(havePsig)//perform FFT using FFTW
       {
-        int np=std::min(N,myComm->size());
+        int np=std::min(N,num_readers());
         OrbGroups.resize(np+1,0);
         FairDivideLow(N,np,OrbGroups);
-        int ip=myComm->rank();
-        int norbs_n=(ip<np)?OrbGroups[ip+1]-OrbGroups[ip]:0;
+        int ip=reader_rank();
+        int norbs_n=(ip>=0 && ip<np)?OrbGroups[ip+1]-OrbGroups[ip]:0;
+        //the bands of this task followed by the buffer for the bands of the others
+        int nbuf=num_band_buffers();
         TinyVector<double,3> start(0.0);
         TinyVector<double,3> end(1.0);
         splineData_r.resize(nx,ny,nz);
         if(bspline->is_complex)
           splineData_i.resize(nx,ny,nz);
         UBspline_3d_d* dummy=0;
-        spline_r.resize(norbs_n+1);
+        spline_r.resize(norbs_n+nbuf);
         for(int i=0; i<spline_r.size(); ++i)
           spline_r[i]=einspline::create(dummy,start,end,MeshSize,bspline->HalfG);
 
-        spline_i.resize(norbs_n+1,0);
+        spline_i.resize(norbs_n+nbuf,0);
         if(bspline->is_complex)
         {
           for(int i=0; i<spline_i.size(); ++i)
@@ -320,20 +323,26 @@ struct SplineAdoptorReader: public BsplineReaderBase
     }
   }
 
+  /** initialize the table with the bands read in parallel
+   *
+   * - each reader reads and splines a disjoint subset of the bands
+   * - every reader bcasts its bands to the other readers, which copy them to the table
+   * - only the node heads read and exchange the bands of a table shared on a node
+   */
   void initialize_spline_pio(int spin, const BandInfoGroup& bandgroup)
   {
-    int N=bandgroup.getNumDistinctOrbitals();
-    bool root=(myComm->rank()==0);
     bool foundit=true;
     int np=OrbGroups.size()-1;
-    if(myComm->rank()<np)
+    int me=reader_rank();
+    int norbs_n=(me>=0 && me<np)?OrbGroups[me+1]-OrbGroups[me]:0;
+    const std::vector<BandInfo>& cur_bands=bandgroup.myBands;
+    if(norbs_n)
     {
-      int iorb_first=OrbGroups[myComm->rank()];
-      int iorb_last =OrbGroups[myComm->rank()+1];
+      int iorb_first=OrbGroups[me];
+      int iorb_last =OrbGroups[me+1];
       hdf_archive h5f(myComm,false);
       h5f.open(mybuilder->H5FileName,H5F_ACC_RDONLY);
       Vector<std::complex<double> > cG(mybuilder->Gvecs[0].size());;
-      const std::vector<BandInfo>& cur_bands=bandgroup.myBands;
       for(int ib=0, iorb=iorb_first; iorb<iorb_last; ib++, iorb++)
       {
         int ti=cur_bands[iorb].TwistIndex;
@@ -341,63 +350,42 @@ struct SplineAdoptorReader: public BsplineReaderBase
         foundit &= h5f.read(cG,s);
         fft_spline(cG,ti,ib);
       }
-      if(root)
-      {
-        for(int iorb=OrbGroups[0],ib=0; iorb<OrbGroups[1]; ++iorb,++ib)
-        {
-          bspline->set_spline(spline_r[ib],spline_i[ib],cur_bands[iorb].TwistIndex,iorb,0);
-        }
-      }
-    }//root put splines to the big table
-    myComm->barrier();
-    myComm->bcast(foundit);
-    if(!foundit)
+    }
+    int nfound=foundit;
+    myComm->allreduce(nfound);
+    if(nfound<myComm->size())
       APP_ABORT("SplineAdoptorReader Failed to read band(s)");
-    //mpi needs int
-    int ng_big=static_cast<int>(spline_r[0]->coefs_size);
-    //send back to zero  using synchronous send/recv
-    for(int ip=1; ip<np; ++ip)
+    if(me>=0)
     {
-      int remote=0;
-      if(ip==myComm->rank())
-      {
-        for(int iorb=OrbGroups[ip],ib=0; iorb<OrbGroups[ip+1]; ++iorb,++ib)
-        {
-          mpi::send(*myComm,spline_r[ib]->coefs,ng_big,remote,iorb);
-          if(bspline->is_complex)
-            mpi::send(*myComm,spline_i[ib]->coefs,ng_big,remote,iorb+N);
-        }
-      }
-      else if(root)
+      size_t ng_big=spline_r[0]->coefs_size;
+      for(int ip=0; ip<np; ++ip)
       {
-        for(int iorb=OrbGroups[ip],ib=0; iorb<OrbGroups[ip+1]; ++iorb,++ib)
+        for(int iorb=OrbGroups[ip]; iorb<OrbGroups[ip+1]; ++iorb)
         {
-          mpi::recv(*myComm,spline_r[ib]->coefs,ng_big,ip,iorb);
+          //the bands of this task are in place, the others go to the buffer
+          int ib=(ip==me)?iorb-OrbGroups[ip]:norbs_n;
+          bcast_band(spline_r[ib]->coefs,ng_big,ip);
           if(bspline->is_complex)
-            mpi::recv(*myComm,spline_i[ib]->coefs,ng_big,ip,iorb+N);
-        }
-        const std::vector<BandInfo>& cur_bands=bandgroup.myBands;
-        for(int iorb=OrbGroups[ip],ib=0; iorb<OrbGroups[ip+1]; ++iorb,++ib)
-        {
+            bcast_band(spline_i[ib]->coefs,ng_big,ip);
           bspline->set_spline(spline_r[ib],spline_i[ib],cur_bands[iorb].TwistIndex,iorb,0);
         }
       }
     }
-    myComm->barrier();
-    chunked_bcast(myComm, bspline->MultiSpline);
+    sync_table();
   }
 
   void initialize_spline_pio_bcast(int spin, const BandInfoGroup& bandgroup)
   {
-    bool root=(myComm->rank()==0);
     int np=OrbGroups.size()-1;
+    int me=reader_rank();
+    int norbs_n=(me>=0 && me<np)?OrbGroups[me+1]-OrbGroups[me]:0;
     bool foundit=true;
     const std::vector<BandInfo>& cur_bands=bandgroup.myBands;
 
-    if(myComm->rank()<np)
+    if(norbs_n)
     {
-      int iorb_first=OrbGroups[myComm->rank()];
-      int iorb_last =OrbGroups[myComm->rank()+1];
+      int iorb_first=OrbGroups[me];
+      int iorb_last =OrbGroups[me+1];
       hdf_archive h5f(myComm,false);
       h5f.open(mybuilder->H5FileName,H5F_ACC_RDONLY);
       Vector<std::complex<double> > cG(mybuilder->Gvecs[0].size());;
@@ -413,33 +401,28 @@ struct SplineAdoptorReader: public BsplineReaderBase
     myComm->bcast(foundit);
     if(!foundit)
       APP_ABORT("SplineAdoptorReader Failed to read band(s)");
-    int ng_big=static_cast<int>(spline_r[0]->coefs_size);
-    //pointers to UBspline_3d_d for bcast without increaing mem
-    UBspline_3d_d *dense_r, *dense_i;
-    int iorb_target=(myComm->rank()<np)?(OrbGroups[myComm->rank()+1]-OrbGroups[myComm->rank()]):0;
-    for(int ip=0; ip<np; ++ip)
+    if(me>=0)
     {
-      for(int iorb=OrbGroups[ip], ib=0; iorb<OrbGroups[ip+1]; ++iorb, ++ib)
+      size_t ng_big=spline_r[0]->coefs_size;
+      //pointers to UBspline_3d_d for bcast without increaing mem
+      UBspline_3d_d *dense_r=0, *dense_i=0;
+      for(int ip=0; ip<np; ++ip)
       {
-        if(ip==myComm->rank())
+        for(int iorb=OrbGroups[ip], ib=0; iorb<OrbGroups[ip+1]; ++iorb, ++ib)
         {
-          dense_r=spline_r[ib];
+          //everyone else receives in the buffer
+          int itarget=(ip==me)?ib:norbs_n;
+          dense_r=spline_r[itarget];
           if(bspline->is_complex)
-            dense_i=spline_i[ib];
-        }
-        else
-        {
-          //everyone else
-          dense_r=spline_r[iorb_target];
+            dense_i=spline_i[itarget];
+          bcast_band(dense_r->coefs,ng_big,ip);
           if(bspline->is_complex)
-            dense_i=spline_i[iorb_target];
+            bcast_band(dense_i->coefs,ng_big,ip);
+          bspline->set_spline(dense_r,dense_i,cur_bands[iorb].TwistIndex,iorb,0);
         }
-        mpi::bcast(*myComm,dense_r->coefs,ng_big,ip);
-        if(bspline->is_complex)
-          mpi::bcast(*myComm,dense_i->coefs,ng_big,ip);
-        bspline->set_spline(dense_r,dense_i,cur_bands[iorb].TwistIndex,iorb,0);
       }
     }
+    sync_table();
   }
 
   void initialize_spline_psi_r(int spin, const BandInfoGroup& bandgroup)
@@ -204,19 +204,21 @@ struct SplineMixedAdoptorReader: public BsplineReaderBase
     int N = mybuilder->NumDistinctOrbitals;
     //bspline->create_spline(MeshSize,N,fullgrid);
     bspline->create_spline(MeshSize,coarse_mesh,N,N);
-    int np=std::min(N,myComm->size());
+    int np=std::min(N,num_readers());
     OrbGroups.resize(np+1,0);
     FairDivideLow(N,np,OrbGroups);
-    int ip=myComm->rank();
-    int norbs_n=(ip<np)?OrbGroups[ip+1]-OrbGroups[ip]:0;
+    int ip=reader_rank();
+    int norbs_n=(ip>=0 && ip<np)?OrbGroups[ip+1]-OrbGroups[ip]:0;
+    //the bands of this task followed by the buffer for the bands of the others
+    int nbuf=num_band_buffers();
     UBspline_3d_d* dummy=0;
-    spline_r.resize(norbs_n*2+2,0);
+    spline_r.resize(2*(norbs_n+nbuf),0);
     for(int i=0; i<spline_r.size()/2; ++i)
     {
       spline_r[2*i]=einspline::create(dummy,start,end,MeshSize,bspline->HalfG);
       spline_r[2*i+1]=einspline::create(dummy,start,end,coarse_mesh,bspline->HalfG);
     }
-    spline_i.resize(norbs_n*2+2,0);
+    spline_i.resize(2*(norbs_n+nbuf),0);
     if(bspline->is_complex)
     {
       use_imaginary=true;
@@ -236,6 +238,8 @@ struct SplineMixedAdoptorReader: public BsplineReaderBase
     app_log() << "  Adding a small box" << "\n  LowerBound " << lower << "\n  UpperBound " << upper << std::endl;
     app_log().flush();
     bspline->add_box(spline_r[0],lower,upper);
+    share_spline(bspline->MultiSpline);
+    share_spline(bspline->smallBox);
     int foundspline=0;
     std::string splinefile=make_spline_filename(mybuilder->H5FileName,spin,mybuilder->TwistNum,MeshSize);
     Timer now;
@@ -264,8 +268,8 @@ struct SplineMixedAdoptorReader: public BsplineReaderBase
     {
       app_log() << "Use existing bspline tables in " << splinefile << std::endl;
       now.restart();
-      chunked_bcast(myComm, bspline->MultiSpline);
-      chunked_bcast(myComm, bspline->smallBox);
+      bcast_spline(bspline->MultiSpline);
+      bcast_spline(bspline->smallBox);
       app_log() << "   Bcast Time for the big table = " << now.elapsed() << std::endl;
     }
     else
@@ -329,23 +333,22 @@ struct SplineMixedAdoptorReader: public BsplineReaderBase
 
   /** initialize big spline using parallel read
    *
-   * - initialize a number of bands per MPI task
-   * - send bspline coefficients to the root
-   * - root complete the table including data transpose
-   * - bcast the big table
+   * - initialize a number of bands per reader
+   * - every reader bcasts its bands to the other readers, which copy them to the tables
+   * - only the node heads read and exchange the bands of the tables shared on a node
    * Minimize temporary memory use and buffering.
    */
   void initialize_spline_pio(int spin, const BandInfoGroup& bandgroup)
   {
-    int N = mybuilder->NumDistinctOrbitals;
     int np=OrbGroups.size()-1;
-    bool root=(myComm->rank()==0);
+    int me=reader_rank();
     bool foundit=true;
+    int norbs_n=(me>=0 && me<np)?OrbGroups[me+1]-OrbGroups[me]:0;
     const std::vector<BandInfo>& cur_bands=bandgroup.myBands;
-    if(myComm->rank()<np)
+    if(norbs_n)
     {
-      int iorb_first=OrbGroups[myComm->rank()];
-      int iorb_last =OrbGroups[myComm->rank()+1];
+      int iorb_first=OrbGroups[me];
+      int iorb_last =OrbGroups[me+1];
       hdf_archive h5f(myComm,false);
       h5f.open(mybuilder->H5FileName,H5F_ACC_RDONLY);
       Vector<std::complex<double> > cG(mybuilder->Gvecs[0].size());;
@@ -356,74 +359,47 @@ struct SplineMixedAdoptorReader: public BsplineReaderBase
         foundit &= h5f.read(cG,s);
         fft_spline(cG,ti,ib);
       }
-      if(root)
-      {
-        for(int iorb=OrbGroups[0],ib2=0; iorb<OrbGroups[1]; ++iorb,ib2+=2)
-        {
-          bspline->set_spline(spline_r[ib2],  spline_i[ib2],  cur_bands[iorb].TwistIndex, iorb,1);
-          bspline->set_spline(spline_r[ib2+1],spline_i[ib2+1],cur_bands[iorb].TwistIndex, iorb,0);
-        }
-      }
-    }//root put splines to the big table
-    myComm->barrier();
-    myComm->bcast(foundit);
-    if(!foundit)
+    }
+    int nfound=foundit;
+    myComm->allreduce(nfound);
+    if(nfound<myComm->size())
       APP_ABORT("SplineMixedAdoptorReader Failed to read band(s)");
-    //mpi needs int
-    int ng_big=static_cast<int>(spline_r[0]->coefs_size);
-    int ng_small=static_cast<int>(spline_r[1]->coefs_size);
-    //send back to zero  using synchronous send/recv
-    for(int ip=1; ip<np; ++ip)
+    if(me>=0)
     {
-      int remote=0;
-      if(ip==myComm->rank())
+      size_t ng_big=spline_r[0]->coefs_size;
+      size_t ng_small=spline_r[1]->coefs_size;
+      for(int ip=0; ip<np; ++ip)
       {
-        for(int iorb=OrbGroups[ip],ib2=0; iorb<OrbGroups[ip+1]; ++iorb,ib2+=2)
+        for(int iorb=OrbGroups[ip]; iorb<OrbGroups[ip+1]; ++iorb)
         {
-          mpi::send(*myComm,spline_r[ib2]->coefs,ng_big,remote,iorb);
-          mpi::send(*myComm,spline_r[ib2+1]->coefs,ng_small,remote,iorb+N);
+          //the bands of this task are in place, the others go to the buffer
+          int ib2=2*((ip==me)?iorb-OrbGroups[ip]:norbs_n);
+          bcast_band(spline_r[ib2]->coefs,ng_big,ip);
+          bcast_band(spline_r[ib2+1]->coefs,ng_small,ip);
           if(bspline->is_complex)
           {
-            mpi::send(*myComm,spline_i[ib2]->coefs,ng_big,remote,iorb+2*N);
-            mpi::send(*myComm,spline_i[ib2+1]->coefs,ng_small,remote,iorb+3*N);
+            bcast_band(spline_i[ib2]->coefs,ng_big,ip);
+            bcast_band(spline_i[ib2+1]->coefs,ng_small,ip);
           }
+          bspline->set_spline(spline_r[ib2],  spline_i[ib2],  cur_bands[iorb].TwistIndex, iorb,1);
+          bspline->set_spline(spline_r[ib2+1],spline_i[ib2+1],cur_bands[iorb].TwistIndex, iorb,0);
         }
       }
-      else
-        if(root)
-        {
-          for(int iorb=OrbGroups[ip],ib2=0; iorb<OrbGroups[ip+1]; ++iorb,ib2+=2)
-          {
-            mpi::recv(*myComm,spline_r[ib2]->coefs,ng_big,ip,iorb);
-            mpi::recv(*myComm,spline_r[ib2+1]->coefs,ng_small,ip,iorb+N);
-            if(bspline->is_complex)
-            {
-              mpi::recv(*myComm,spline_i[ib2]->coefs,ng_big,ip,iorb+2*N);
-              mpi::recv(*myComm,spline_i[ib2+1]->coefs,ng_small,ip,iorb+3*N);
-            }
-          }
-          for(int iorb=OrbGroups[ip],ib2=0; iorb<OrbGroups[ip+1]; ++iorb,ib2+=2)
-          {
-            bspline->set_spline(spline_r[ib2],  spline_i[ib2],  cur_bands[iorb].TwistIndex, iorb,1);
-            bspline->set_spline(spline_r[ib2+1],spline_i[ib2+1],cur_bands[iorb].TwistIndex, iorb,0);
-          }
-        }
     }
-    myComm->barrier();
-    chunked_bcast(myComm, bspline->MultiSpline);
-    chunked_bcast(myComm, bspline->smallBox);
+    sync_table();
   }
 
   void initialize_spline_pio_bcast(int spin, const BandInfoGroup& bandgroup)
   {
-    bool root=(myComm->rank()==0);
     int np=OrbGroups.size()-1;
+    int me=reader_rank();
+    int norbs_n=(me>=0 && me<np)?OrbGroups[me+1]-OrbGroups[me]:0;
     bool foundit=true;
     const std::vector<BandInfo>& cur_bands=bandgroup.myBands;
-    if(myComm->rank()<np)
+    if(norbs_n)
     {
-      int iorb_first=OrbGroups[myComm->rank()];
-      int iorb_last =OrbGroups[myComm->rank()+1];
+      int iorb_first=OrbGroups[me];
+      int iorb_last =OrbGroups[me+1];
       hdf_archive h5f(myComm,false);
       h5f.open(mybuilder->H5FileName,H5F_ACC_RDONLY);
       Vector<std::complex<double> > cG(mybuilder->Gvecs[0].size());;
@@ -439,50 +415,39 @@ struct SplineMixedAdoptorReader: public BsplineReaderBase
     myComm->bcast(foundit);
     if(!foundit)
       APP_ABORT("SplineMixedAdoptorReader Failed to read band(s)");
-    int ng_big=static_cast<int>(spline_r[0]->coefs_size);
-    int ng_small=static_cast<int>(spline_r[1]->coefs_size);
-    //pointers to UBspline_3d_d for bcast without increaing mem
-    UBspline_3d_d *dense_r=0, *dense_i=0;
-    UBspline_3d_d *coarse_r=0, *coarse_i=0;
-    int iorb_target=(myComm->rank()<np)?(OrbGroups[myComm->rank()+1]-OrbGroups[myComm->rank()])*2:0;
-    for(int ip=0; ip<np; ++ip)
+    if(me>=0)
     {
-      for(int iorb=OrbGroups[ip], ib2=0; iorb<OrbGroups[ip+1]; ++iorb, ib2+=2)
+      size_t ng_big=spline_r[0]->coefs_size;
+      size_t ng_small=spline_r[1]->coefs_size;
+      //pointers to UBspline_3d_d for bcast without increaing mem
+      UBspline_3d_d *dense_r=0, *dense_i=0;
+      UBspline_3d_d *coarse_r=0, *coarse_i=0;
+      for(int ip=0; ip<np; ++ip)
       {
-        if(ip==myComm->rank())
+        for(int iorb=OrbGroups[ip], ib2=0; iorb<OrbGroups[ip+1]; ++iorb, ib2+=2)
         {
-          dense_r=spline_r[ib2];
-          coarse_r=spline_r[ib2+1];
+          //everyone else receives in the buffer
+          int itarget=(ip==me)?ib2:2*norbs_n;
+          dense_r=spline_r[itarget];
+          coarse_r=spline_r[itarget+1];
           if(bspline->is_complex)
           {
-            dense_i=spline_i[ib2];
-            coarse_i=spline_i[ib2+1];
+            dense_i=spline_i[itarget];
+            coarse_i=spline_i[itarget+1];
           }
-        }
-        else
-        {
-          //everyone else
-          dense_r=spline_r[iorb_target];
-          coarse_r=spline_r[iorb_target+1];
+          bcast_band(dense_r->coefs,ng_big,ip);
+          bcast_band(coarse_r->coefs,ng_small,ip);
           if(bspline->is_complex)
           {
-            dense_i=spline_i[iorb_target];
-            coarse_i=spline_i[iorb_target+1];
+            bcast_band(dense_i->coefs,ng_big,ip);
+            bcast_band(coarse_i->coefs,ng_small,ip);
           }
+          bspline->set_spline(coarse_r,coarse_i,cur_bands[iorb].TwistIndex, iorb,0);
+          bspline->set_spline(dense_r,dense_i,  cur_bands[iorb].TwistIndex, iorb,1);
         }
-        myComm->barrier();
-        mpi::bcast(*myComm,dense_r->coefs,ng_big,ip);
-        mpi::bcast(*myComm,coarse_r->coefs,ng_small,ip);
-        if(bspline->is_complex)
-        {
-          mpi::bcast(*myComm,dense_i->coefs,ng_big,ip);
-          mpi::bcast(*myComm,coarse_i->coefs,ng_small,ip);
-        }
-        myComm->barrier();
-        bspline->set_spline(coarse_r,coarse_i,cur_bands[iorb].TwistIndex, iorb,0);
-        bspline->set_spline(dense_r,dense_i,  cur_bands[iorb].TwistIndex, iorb,1);
       }
     }
+    sync_table();
   }
 };
 
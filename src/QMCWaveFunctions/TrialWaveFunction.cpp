@@ -560,6 +560,60 @@ TrialWaveFunction::RealType TrialWaveFunction::ratioGrad(ParticleSet& P
 #endif
 }
 
+void TrialWaveFunction::mw_ratioGrad(const std::vector<TrialWaveFunction*>& WF_list,
+                                     const std::vector<ParticleSet*>& P_list, int iat,
+                                     std::vector<RealType>& ratios, std::vector<GradType>& grad_new)
+{
+  const int nw=WF_list.size();
+  std::vector<ValueType> r(nw,1.0), r_z(nw);
+  std::vector<OrbitalBase*> wfc_list(nw);
+  for (int iw=0; iw<nw; ++iw)
+    grad_new[iw]=0.0;
+  for (int i=0,ii=VGL_TIMER; i<Z.size(); ++i,ii+=TIMER_SKIP)
+  {
+    myTimers[ii]->start();
+    for (int iw=0; iw<nw; ++iw)
+      wfc_list[iw]=WF_list[iw]->Z[i];
+    Z[i]->mw_ratioGrad(wfc_list,P_list,iat,r_z,grad_new);
+    for (int iw=0; iw<nw; ++iw)
+      r[iw] *= r_z[iw];
+    myTimers[ii]->stop();
+  }
+  for (int iw=0; iw<nw; ++iw)
+  {
+#if defined(QMC_COMPLEX)
+    RealType logr=evaluateLogAndPhase(r[iw],WF_list[iw]->PhaseValue);
+    ratios[iw]=std::exp(logr);
+#else
+    if (r[iw]<0)
+      WF_list[iw]->PhaseDiff=M_PI;
+    ratios[iw]=r[iw];
+#endif
+  }
+}
+
+void TrialWaveFunction::mw_acceptMove(const std::vector<TrialWaveFunction*>& WF_list,
+                                      const std::vector<ParticleSet*>& P_list, int iat)
+{
+  const int nw=WF_list.size();
+  std::vector<OrbitalBase*> wfc_list(nw);
+  for (int i=0; i<Z.size(); ++i)
+  {
+    for (int iw=0; iw<nw; ++iw)
+      wfc_list[iw]=WF_list[iw]->Z[i];
+    Z[i]->mw_acceptMove(wfc_list,P_list,iat);
+  }
+  for (int iw=0; iw<nw; ++iw)
+  {
+    TrialWaveFunction& psi(*WF_list[iw]);
+    psi.PhaseValue += psi.PhaseDiff;
+    psi.PhaseDiff=0.0;
+    psi.LogValue=0;
+    for (int i=0; i<psi.Z.size(); i++)
+      psi.LogValue+= psi.Z[i]->LogValue;
+  }
+}
+
 TrialWaveFunction::RealType TrialWaveFunction::alternateRatioGrad(ParticleSet& P
     ,int iat, GradType& grad_iat )
 {
@@ -894,6 +948,64 @@ void TrialWaveFunction::evaluateRatios(VirtualParticleSet& VP, std::vector<RealT
 #endif
 }
 
+void TrialWaveFunction::evaluateRatios(ParticleSet& P, VirtualParticleSet& VP,
+    const ParticleSet::ParticlePos_t& deltaV, std::vector<RealType>& ratios)
+{
+  const int iat=VP.activePtcl;
+  const int nk=ratios.size();
+  std::vector<ValueType> t(nk),r(nk,1.0);
+  bool fallback=false;
+  for (int i=0,ii=V_TIMER; i<Z.size(); ++i,ii+=TIMER_SKIP)
+  {
+    if(!Z[i]->HaveRatiosForVP)
+    {
+      fallback=true;
+      continue;
+    }
+    myTimers[ii]->start();
+    Z[i]->evaluateRatios(VP,t);
+    for (int k=0; k<nk; ++k)
+      r[k]*=t[k];
+    myTimers[ii]->stop();
+  }
+  if(fallback)
+  {
+    //the remaining components see the moves one at a time
+    for (int k=0; k<nk; ++k)
+    {
+      P.makeMoveOnSphere(iat,deltaV[k]);
+      for (int i=0,ii=V_TIMER; i<Z.size(); ++i,ii+=TIMER_SKIP)
+      {
+        if(Z[i]->HaveRatiosForVP)
+          continue;
+        myTimers[ii]->start();
+        r[k]*=Z[i]->ratio(P,iat);
+        myTimers[ii]->stop();
+      }
+      P.rejectMove(iat);
+    }
+  }
+#if defined(QMC_COMPLEX)
+  RealType pdiff;
+  for(int k=0; k<nk; ++k)
+  {
+    RealType logr=evaluateLogAndPhase(r[k],pdiff);
+    ratios[k]=std::exp(logr)*std::cos(pdiff);
+  }
+#else
+  for(int k=0; k<nk; ++k)
+    ratios[k]=r[k];
+#endif
+}
+
+bool TrialWaveFunction::hasRatiosForVP() const
+{
+  for (int i=0; i<Z.size(); ++i)
+    if(Z[i]->HaveRatiosForVP)
+      return true;
+  return false;
+}
+
 void TrialWaveFunction::evaluateDerivRatios(VirtualParticleSet& VP, const opt_variables_type& optvars,
     std::vector<RealType>& ratios, Matrix<RealType>& dratio)
 {
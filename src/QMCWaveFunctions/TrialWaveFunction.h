@@ -253,6 +253,16 @@ public:
   /** compulte multiple ratios to handle non-local moves and other virtual moves
    */
   void evaluateRatios(VirtualParticleSet& P, std::vector<RealType>& ratios);
+  /** compute multiple ratios of the virtual moves of VP.activePtcl
+   * @param P target ParticleSet, moved knot by knot for the components without HaveRatiosForVP
+   * @param VP virtual moves of VP.activePtcl
+   * @param deltaV displacements of the virtual moves
+   * @param ratios ratios of the virtual moves
+   */
+  void evaluateRatios(ParticleSet& P, VirtualParticleSet& VP,
+      const ParticleSet::ParticlePos_t& deltaV, std::vector<RealType>& ratios);
+  ///return true if any component evaluates the ratios of a VirtualParticleSet
+  bool hasRatiosForVP() const;
   /** compute both ratios and deriatives of ratio with respect to the optimizables*/
   void evaluateDerivRatios(VirtualParticleSet& P, const opt_variables_type& optvars,
       std::vector<RealType>& ratios, Matrix<RealType>& dratio);
@@ -280,6 +290,28 @@ public:
   RealType ratioGrad(ParticleSet& P, int iat, GradType& grad_iat);
   RealType alternateRatioGrad(ParticleSet& P, int iat, GradType& grad_iat);
 
+  /** ratioGrad of the iat-th particle of many walkers
+   * @param WF_list the wavefunctions of the walkers, clones of this
+   * @param P_list the ParticleSets of the walkers with the proposed move of iat
+   * @param iat the index of a particle
+   * @param ratios the ratios of the walkers
+   * @param grad_new the gradients of the walkers
+   *
+   * Each component is called once for all the walkers so that it can batch
+   * its kernels. The timers of this are used.
+   */
+  void mw_ratioGrad(const std::vector<TrialWaveFunction*>& WF_list,
+                    const std::vector<ParticleSet*>& P_list, int iat,
+                    std::vector<RealType>& ratios, std::vector<GradType>& grad_new);
+
+  /** acceptMove of the iat-th particle of many walkers
+   * @param WF_list the wavefunctions of the walkers, clones of this
+   * @param P_list the ParticleSets of the walkers with the accepted move of iat
+   * @param iat the index of the moved particle
+   */
+  void mw_acceptMove(const std::vector<TrialWaveFunction*>& WF_list,
+                     const std::vector<ParticleSet*>& P_list, int iat);
+
   GradType evalGrad(ParticleSet& P, int iat);
   GradType alternateEvalGrad(ParticleSet& P, int iat);
 
@@ -24,6 +24,7 @@
 #include "QMCWaveFunctions/OrbitalBase.h"
 #include "QMCWaveFunctions/TrialWaveFunction.h"
 #include "QMCWaveFunctions/Jastrow/TwoBodyJastrowOrbital.h"
+#include "QMCWaveFunctions/Jastrow/J2OrbitalSoA.h"
 #include "QMCWaveFunctions/Jastrow/BsplineFunctor.h"
 #include "QMCWaveFunctions/Jastrow/BsplineJastrowBuilder.h"
 #include "ParticleBase/ParticleAttribOps.h"
@@ -155,6 +156,214 @@ const char *particles = \
 #endif
 
 
+}
+
+TEST_CASE("BSpline functor batched", "[wavefunction]")
+{
+  BsplineFunctor<double> bf;
+  bf.cutoff_radius = 2.0;
+  bf.resize(4);
+  bf.Parameters[0] = 0.4;
+  bf.Parameters[1] = 0.3;
+  bf.Parameters[2] = 0.1;
+  bf.Parameters[3] = 0.05;
+  bf.reset();
+
+  const int n = 7;
+  double dist[n] = {0.1, 2.5, 0.7, 1.99, 3.0, 1.3, 2.0};
+  double u[n], du[n], d2u[n], scratch[n];
+  int indices[n];
+  bf.evaluateVGL(0, n, dist, u, du, d2u, scratch, indices);
+  double usum = 0.0;
+  for (int i = 0; i < n; i++)
+  {
+    double dudr, d2udr2;
+    double uref = bf.evaluate(dist[i], dudr, d2udr2);
+    REQUIRE(u[i] == Approx(uref));
+    REQUIRE(du[i] == Approx(dudr/dist[i]));
+    REQUIRE(d2u[i] == Approx(d2udr2));
+    usum += uref;
+  }
+  REQUIRE(bf.evaluateV(0, n, dist, scratch) == Approx(usum));
+  REQUIRE(bf.evaluateV(2, 4, dist, scratch) == Approx(u[2]+u[3]));
+}
+
+static void setup_j2_electrons(ParticleSet &elec, bool soa)
+{
+  elec.setName("e");
+  elec.UseSoADistanceTables = soa;
+  std::vector<int> ud(2); ud[0]=ud[1]=2;
+  elec.create(ud);
+  elec.R[0] = ParticleSet::SingleParticlePos_t(0.0, 0.0, 0.0);
+  elec.R[1] = ParticleSet::SingleParticlePos_t(0.8, 0.3, -0.2);
+  elec.R[2] = ParticleSet::SingleParticlePos_t(-0.4, 1.1, 0.5);
+  elec.R[3] = ParticleSet::SingleParticlePos_t(2.6, 0.2, 0.9);
+
+  SpeciesSet &tspecies = elec.getSpeciesSet();
+  int upIdx = tspecies.addSpecies("u");
+  int downIdx = tspecies.addSpecies("d");
+  int chargeIdx = tspecies.addAttribute("charge");
+  tspecies(chargeIdx, upIdx) = -1;
+  tspecies(chargeIdx, downIdx) = -1;
+
+  elec.addTable(elec);
+  elec.update();
+}
+
+TEST_CASE("BSpline SoA Jastrow", "[wavefunction]")
+{
+  Communicate *c;
+  OHMMS::Controller->initialize(0, NULL);
+  c = OHMMS::Controller;
+
+  ParticleSet elec_aos;
+  ParticleSet elec_soa;
+  setup_j2_electrons(elec_aos, false);
+  setup_j2_electrons(elec_soa, true);
+
+  TrialWaveFunction psi_aos = TrialWaveFunction(c);
+  TrialWaveFunction psi_soa = TrialWaveFunction(c);
+
+const char *particles = \
+"<tmp> \
+<jastrow name=\"J2\" type=\"Two-Body\" function=\"Bspline\"> \
+   <correlation rcut=\"2.5\" size=\"4\" speciesA=\"u\" speciesB=\"u\"> \
+      <coefficients id=\"uu\" type=\"Array\"> 0.3 0.2 0.1 0.05</coefficients> \
+    </correlation> \
+   <correlation rcut=\"2.5\" size=\"4\" speciesA=\"u\" speciesB=\"d\"> \
+      <coefficients id=\"ud\" type=\"Array\"> 0.5 0.3 0.15 0.05</coefficients> \
+    </correlation> \
+</jastrow> \
+</tmp> \
+";
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(particles);
+  REQUIRE(okay);
+  xmlNodePtr jas1 = xmlFirstElementChild(doc.getRoot());
+
+  BsplineJastrowBuilder jastrow_aos(elec_aos, psi_aos);
+  REQUIRE(jastrow_aos.put(jas1));
+  BsplineJastrowBuilder jastrow_soa(elec_soa, psi_soa);
+  REQUIRE(jastrow_soa.put(jas1));
+
+  typedef OrbitalBase::RealType RealType;
+  OrbitalBase *j2_aos = psi_aos.getOrbitals()[0];
+  OrbitalBase *j2_soa = psi_soa.getOrbitals()[0];
+  REQUIRE(dynamic_cast<J2OrbitalSoA<BsplineFunctor<RealType> > *>(j2_soa) != NULL);
+
+  PooledData<RealType> buf_aos, buf_soa;
+  elec_aos.G = 0.0;
+  elec_aos.L = 0.0;
+  elec_soa.G = 0.0;
+  elec_soa.L = 0.0;
+  RealType logpsi_aos = j2_aos->registerData(elec_aos, buf_aos);
+  RealType logpsi_soa = j2_soa->registerData(elec_soa, buf_soa);
+  REQUIRE(logpsi_soa == Approx(logpsi_aos));
+  for (int i = 0; i < elec_aos.getTotalNum(); i++)
+  {
+    for (int d = 0; d < OHMMS_DIM; d++)
+      REQUIRE(elec_soa.G[i][d] == Approx(elec_aos.G[i][d]));
+    REQUIRE(elec_soa.L[i] == Approx(elec_aos.L[i]));
+  }
+
+  ParticleSet::SingleParticlePos_t dr(0.3, -0.2, 0.1);
+  for (int iat = 0; iat < elec_aos.getTotalNum(); iat++)
+  {
+    elec_aos.makeMove(iat, dr);
+    elec_soa.makeMove(iat, dr);
+    REQUIRE(j2_soa->ratio(elec_soa, iat) == Approx(j2_aos->ratio(elec_aos, iat)));
+    OrbitalBase::GradType g_aos = j2_aos->evalGrad(elec_aos, iat);
+    OrbitalBase::GradType g_soa = j2_soa->evalGrad(elec_soa, iat);
+    for (int d = 0; d < OHMMS_DIM; d++)
+      REQUIRE(g_soa[d] == Approx(g_aos[d]));
+    g_aos = 0.0;
+    RealType r_aos = j2_aos->ratioGrad(elec_aos, iat, g_aos);
+    // the ratio-only path evaluates the proposed pairs in acceptMove
+    if (iat != 1)
+    {
+      g_soa = 0.0;
+      RealType r_soa = j2_soa->ratioGrad(elec_soa, iat, g_soa);
+      REQUIRE(r_soa == Approx(r_aos));
+      for (int d = 0; d < OHMMS_DIM; d++)
+        REQUIRE(g_soa[d] == Approx(g_aos[d]));
+    }
+    // the order of the drivers, the tables are updated first
+    elec_aos.acceptMove(iat);
+    elec_soa.acceptMove(iat);
+    j2_aos->acceptMove(elec_aos, iat);
+    j2_soa->acceptMove(elec_soa, iat);
+  }
+
+  // a rejected move and several ratios of a particle, as the pseudopotentials
+  // do, before an accepted move of the same particle
+  ParticleSet::SingleParticlePos_t dr2(-0.1, 0.25, 0.05);
+  elec_aos.makeMove(2, dr2);
+  elec_soa.makeMove(2, dr2);
+  REQUIRE(j2_soa->ratio(elec_soa, 2) == Approx(j2_aos->ratio(elec_aos, 2)));
+  elec_aos.rejectMove(2);
+  elec_soa.rejectMove(2);
+  j2_aos->restore(2);
+  j2_soa->restore(2);
+  for (int k = 0; k < 3; k++)
+  {
+    elec_aos.makeMove(0, (k%2) ? dr2 : dr);
+    elec_soa.makeMove(0, (k%2) ? dr2 : dr);
+    REQUIRE(j2_soa->ratio(elec_soa, 0) == Approx(j2_aos->ratio(elec_aos, 0)));
+    elec_aos.rejectMove(0);
+    elec_soa.rejectMove(0);
+    j2_aos->restore(0);
+    j2_soa->restore(0);
+  }
+  elec_aos.makeMove(0, dr2);
+  elec_soa.makeMove(0, dr2);
+  OrbitalBase::GradType g0_aos, g0_soa;
+  REQUIRE(j2_soa->ratioGrad(elec_soa, 0, g0_soa) == Approx(j2_aos->ratioGrad(elec_aos, 0, g0_aos)));
+  elec_aos.acceptMove(0);
+  elec_soa.acceptMove(0);
+  j2_aos->acceptMove(elec_aos, 0);
+  j2_soa->acceptMove(elec_soa, 0);
+
+  REQUIRE(j2_soa->LogValue == Approx(j2_aos->LogValue));
+  std::vector<OrbitalBase::GradType> grad_soa(elec_soa.getTotalNum());
+  for (int iat = 0; iat < elec_aos.getTotalNum(); iat++)
+  {
+    OrbitalBase::GradType g_aos = j2_aos->evalGrad(elec_aos, iat);
+    grad_soa[iat] = j2_soa->evalGrad(elec_soa, iat);
+    for (int d = 0; d < OHMMS_DIM; d++)
+      REQUIRE(grad_soa[iat][d] == Approx(g_aos[d]));
+  }
+
+  // the updated sums agree with the ones from scratch
+  RealType logpsi_pbyp = j2_soa->LogValue;
+  elec_soa.G = 0.0;
+  elec_soa.L = 0.0;
+  REQUIRE(j2_soa->evaluateLog(elec_soa, elec_soa.G, elec_soa.L) == Approx(logpsi_pbyp));
+  for (int iat = 0; iat < elec_soa.getTotalNum(); iat++)
+    for (int d = 0; d < OHMMS_DIM; d++)
+      REQUIRE(elec_soa.G[iat][d] == Approx(grad_soa[iat][d]));
+
+  // after copyFromBuffer the moves update the slot of the walker buffer in place
+  buf_soa.rewind();
+  j2_soa->updateBuffer(elec_soa, buf_soa);
+  buf_soa.rewind();
+  j2_soa->copyFromBuffer(elec_soa, buf_soa);
+  elec_soa.makeMove(0, dr);
+  OrbitalBase::GradType g_new;
+  j2_soa->ratioGrad(elec_soa, 0, g_new);
+  elec_soa.acceptMove(0);
+  j2_soa->acceptMove(elec_soa, 0);
+
+  OrbitalBasePtr j2_clone = j2_soa->makeClone(elec_soa);
+  buf_soa.rewind();
+  j2_clone->copyFromBuffer(elec_soa, buf_soa);
+  for (int iat = 0; iat < elec_soa.getTotalNum(); iat++)
+  {
+    OrbitalBase::GradType g_buf = j2_clone->evalGrad(elec_soa, iat);
+    OrbitalBase::GradType g_ref = j2_soa->evalGrad(elec_soa, iat);
+    for (int d = 0; d < OHMMS_DIM; d++)
+      REQUIRE(g_buf[d] == Approx(g_ref[d]));
+  }
+  delete j2_clone;
 }
 }
 
@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "OhmmsPETE/OhmmsMatrix.h"
+#include "OhmmsPETE/OhmmsVector.h"
+#include "Numerics/DeterminantOperators.h"
+#include "QMCWaveFunctions/Fermion/DelayedUpdate.h"
+
+#include <stdio.h>
+#include <string>
+
+using std::string;
+
+namespace qmcplusplus
+{
+
+TEST_CASE("DelayedUpdate vs Sherman-Morrison", "[wavefunction][fermion]")
+{
+  const int N = 6;
+  const int delay = 3;
+  Matrix<double> A(N,N);
+  for (int i = 0; i < N; i++)
+    for (int j = 0; j < N; j++)
+      A(i,j) = (i == j) ? 2.0 + 0.1*i : 0.3*std::sin(1.0 + i + 2.0*j);
+
+  // psiM convention: transposed inverse in row-major storage
+  Matrix<double> Minv_ref(A);
+  double phase;
+  InvertWithLog(Minv_ref.data(), N, N, phase);
+  Matrix<double> Minv_delay(Minv_ref);
+
+  DelayedUpdate<double> engine;
+  engine.resize(N, delay);
+  engine.initializeInv(Minv_delay);
+
+  Vector<double> psiV(N), invRow(N), workV1(N), workV2(N);
+  // revisit row 1 to exercise the flush of a repeated row
+  const int rows[] = {1, 4, 1, 5, 0, 2, 3};
+  const int nmoves = sizeof(rows)/sizeof(int);
+  for (int m = 0; m < nmoves; m++)
+  {
+    const int r = rows[m];
+    for (int j = 0; j < N; j++)
+      psiV[j] = A(r,j) + 0.2*std::cos(0.5 + m + 0.7*j);
+
+    double ratio_ref = DetRatioByRow(Minv_ref, psiV, r);
+    engine.getInvRow(Minv_delay, r, invRow);
+    double ratio_delay = 0.0;
+    for (int j = 0; j < N; j++)
+    {
+      REQUIRE(invRow[j] == Approx(Minv_ref(r,j)));
+      ratio_delay += invRow[j]*psiV[j];
+    }
+    REQUIRE(ratio_delay == Approx(ratio_ref));
+
+    InverseUpdateByRow(Minv_ref, psiV, workV1, workV2, r, ratio_ref);
+    engine.acceptRow(Minv_delay, r, psiV);
+    REQUIRE(engine.pending() < delay);
+  }
+
+  engine.updateInvMat(Minv_delay);
+  REQUIRE(engine.pending() == 0);
+  for (int i = 0; i < N; i++)
+    for (int j = 0; j < N; j++)
+      REQUIRE(Minv_delay(i,j) == Approx(Minv_ref(i,j)));
+}
+
+}
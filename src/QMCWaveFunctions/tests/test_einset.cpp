@@ -25,6 +25,8 @@
 #include "QMCWaveFunctions/OrbitalBase.h"
 #include "QMCWaveFunctions/TrialWaveFunction.h"
 #include "QMCWaveFunctions/EinsplineSetBuilder.h"
+#include "QMCWaveFunctions/Fermion/SlaterDet.h"
+#include "QMCWaveFunctions/Fermion/DiracDeterminantBase.h"
 
 
 #include <stdio.h>
@@ -127,6 +129,164 @@ const char *particles =
   SPOSetBase *spo = einSet.createSPOSetFromXML(ein1);
   REQUIRE(spo != NULL);
 
+  // multi-walker evaluation of the first electron,
+  // every walker has to match the single-walker evaluation
+  int norb = spo->getOrbitalSetSize();
+  const int nw = 3;
+  const double xw[nw] = {0.3, -1.2, 0.31};
+  std::vector<ParticleSet*> P_list(nw);
+  std::vector<SPOSetBase::ValueVector_t*> psi_list(nw);
+  std::vector<SPOSetBase::GradVector_t*> dpsi_list(nw);
+  std::vector<SPOSetBase::ValueVector_t*> d2psi_list(nw);
+  for (int iw = 0; iw < nw; iw++) {
+    P_list[iw] = new ParticleSet(elec_);
+    P_list[iw]->R[0][0] = xw[iw];
+    P_list[iw]->R[0][1] = 0.2*iw;
+    psi_list[iw] = new SPOSetBase::ValueVector_t(norb);
+    dpsi_list[iw] = new SPOSetBase::GradVector_t(norb);
+    d2psi_list[iw] = new SPOSetBase::ValueVector_t(norb);
+  }
+  SPOSetBase::ValueVector_t psi_ref(norb);
+  SPOSetBase::GradVector_t dpsi_ref(norb);
+  SPOSetBase::ValueVector_t d2psi_ref(norb);
+
+  spo->mw_evaluate(P_list, 0, psi_list);
+  for (int iw = 0; iw < nw; iw++) {
+    spo->evaluate(*P_list[iw], 0, psi_ref);
+    for (int j = 0; j < norb; j++)
+      REQUIRE(std::abs((*psi_list[iw])[j] - psi_ref[j]) < 1e-6);
+  }
+
+  spo->mw_evaluate(P_list, 0, psi_list, dpsi_list, d2psi_list);
+  for (int iw = 0; iw < nw; iw++) {
+    spo->evaluate(*P_list[iw], 0, psi_ref, dpsi_ref, d2psi_ref);
+    for (int j = 0; j < norb; j++) {
+      REQUIRE(std::abs((*psi_list[iw])[j] - psi_ref[j]) < 1e-6);
+      REQUIRE(std::abs((*dpsi_list[iw])[j][0] - dpsi_ref[j][0]) < 1e-6);
+      REQUIRE(std::abs((*dpsi_list[iw])[j][1] - dpsi_ref[j][1]) < 1e-6);
+      REQUIRE(std::abs((*dpsi_list[iw])[j][2] - dpsi_ref[j][2]) < 1e-6);
+      REQUIRE(std::abs((*d2psi_list[iw])[j] - d2psi_ref[j]) < 1e-6);
+    }
+  }
+
+  // Slater determinants of four up and four down electrons moved for the crowd by
+  // the multi-walker functions and walker by walker as the per-walker mover does
+  const int nel = 8;
+  ParticleSet elec8;
+  elec8.setName("elec8");
+  elec8.Lattice = elec_.Lattice;
+  elec8.Lattice.BoxBConds = true;
+  elec8.Lattice.reset();
+  elec8.create(nel);
+  SpeciesSet &tspecies8 = elec8.getSpeciesSet();
+  tspecies8.addSpecies("u");
+  tspecies8.addSpecies("d");
+  int chargeIdx8 = tspecies8.addAttribute("charge");
+  tspecies8(chargeIdx8, upIdx) = -1;
+  tspecies8(chargeIdx8, downIdx) = -1;
+  for (int iat = 0; iat < nel; iat++) {
+    elec8.GroupID[iat] = (iat < nel/2) ? upIdx : downIdx;
+    elec8.R[iat] = ParticleSet::SingleParticlePos_t(0.37*iat, 0.53*(iat%3) + 0.1, 0.29*(iat%5) - 0.2);
+  }
+  elec8.addTable(ions_);
+  elec8.resetGroups();
+
+  // the determinants evaluate the matrices through the transpose buffer of the SPO set
+  spo->t_logpsi.resize(norb, norb);
+
+  std::vector<ParticleSet*> P8_list(nw), P8_ref(nw);
+  std::vector<TrialWaveFunction*> wf_list(nw), wf_ref(nw);
+  std::vector<TrialWaveFunction::BufferType> bufs(2*nw);
+  for (int iw = 0; iw < nw; iw++) {
+    P8_list[iw] = new ParticleSet(elec8);
+    P8_list[iw]->R[0][0] += 0.3*iw;
+    P8_list[iw]->R[5][1] -= 0.2*iw;
+    P8_list[iw]->update();
+    P8_ref[iw] = new ParticleSet(*P8_list[iw]);
+    P8_ref[iw]->update();
+    TrialWaveFunction* wfs[2];
+    ParticleSet* Ps[2] = {P8_list[iw], P8_ref[iw]};
+    for (int i = 0; i < 2; i++) {
+      SlaterDet *slater = new SlaterDet(*Ps[i]);
+      for (int ig = 0; ig < Ps[i]->groups(); ig++) {
+        DiracDeterminantBase *det = new DiracDeterminantBase(spo, Ps[i]->first(ig));
+        det->set(Ps[i]->first(ig), Ps[i]->last(ig) - Ps[i]->first(ig));
+        slater->add(det, ig);
+      }
+      wfs[i] = new TrialWaveFunction(c);
+      wfs[i]->addOrbital(slater, "SlaterDet");
+      // registered as the movers do, which also sizes the row buffers
+      wfs[i]->registerData(*Ps[i], bufs[2*iw+i]);
+    }
+    wf_list[iw] = wfs[0];
+    wf_ref[iw] = wfs[1];
+  }
+
+  std::vector<ParticleSet::SingleParticlePos_t> displs(nw);
+  std::vector<int> valid(nw);
+  std::vector<double> ratios(nw);
+  std::vector<TrialWaveFunction::GradType> grads(nw);
+  for (int iat = 0; iat < nel; iat++) {
+    for (int iw = 0; iw < nw; iw++)
+      displs[iw] = ParticleSet::SingleParticlePos_t(0.15*iw - 0.1, 0.2 - 0.05*iat, 0.1*(iat%3));
+    ParticleSet::mw_makeMoveAndCheck(P8_list, iat, displs, valid);
+    wf_list[0]->mw_ratioGrad(wf_list, P8_list, iat, ratios, grads);
+    // walker 1 rejects its moves, the others accept them
+    std::vector<ParticleSet*> P_accept;
+    std::vector<TrialWaveFunction*> wf_accept;
+    for (int iw = 0; iw < nw; iw++) {
+      REQUIRE(valid[iw] == 1);
+      TrialWaveFunction::GradType grad_ref;
+      P8_ref[iw]->makeMoveAndCheck(iat, displs[iw]);
+      double ratio_ref = wf_ref[iw]->ratioGrad(*P8_ref[iw], iat, grad_ref);
+      REQUIRE(ratios[iw] == Approx(ratio_ref));
+      for (int d = 0; d < 3; d++)
+        REQUIRE(grads[iw][d] == Approx(grad_ref[d]));
+      if (iw == 1) {
+        P8_list[iw]->rejectMove(iat);
+        wf_list[iw]->rejectMove(iat);
+        P8_ref[iw]->rejectMove(iat);
+        wf_ref[iw]->rejectMove(iat);
+      } else {
+        P_accept.push_back(P8_list[iw]);
+        wf_accept.push_back(wf_list[iw]);
+        P8_ref[iw]->acceptMove(iat);
+        wf_ref[iw]->acceptMove(*P8_ref[iw], iat);
+      }
+    }
+    ParticleSet::mw_acceptMove(P_accept, iat);
+    wf_accept[0]->mw_acceptMove(wf_accept, P_accept, iat);
+  }
+  // the buffers are updated at the end of the sweep as the movers do
+  for (int iw = 0; iw < nw; iw++) {
+    double logpsi = wf_list[iw]->updateBuffer(*P8_list[iw], bufs[2*iw]);
+    REQUIRE(logpsi == Approx(wf_ref[iw]->updateBuffer(*P8_ref[iw], bufs[2*iw+1])));
+    for (int iat = 0; iat < nel; iat++) {
+      for (int d = 0; d < 3; d++)
+        REQUIRE(P8_list[iw]->R[iat][d] == Approx(P8_ref[iw]->R[iat][d]));
+      TrialWaveFunction::GradType g = wf_list[iw]->evalGrad(*P8_list[iw], iat);
+      TrialWaveFunction::GradType g_ref = wf_ref[iw]->evalGrad(*P8_ref[iw], iat);
+      for (int d = 0; d < 3; d++)
+        REQUIRE(g[d] == Approx(g_ref[d]));
+    }
+    // the updated log value agrees with the one from scratch
+    P8_list[iw]->update();
+    REQUIRE(wf_list[iw]->evaluateLog(*P8_list[iw]) == Approx(logpsi));
+  }
+
+  for (int iw = 0; iw < nw; iw++) {
+    delete wf_list[iw];
+    delete wf_ref[iw];
+    delete P8_list[iw];
+    delete P8_ref[iw];
+  }
+  for (int iw = 0; iw < nw; iw++) {
+    delete P_list[iw];
+    delete psi_list[iw];
+    delete dpsi_list[iw];
+    delete d2psi_list[iw];
+  }
+
 #if 0
   // Dump values of the orbitals
   int orbSize= spo->getOrbitalSetSize();
@@ -0,0 +1,211 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "Utilities/OhmmsInfo.h"
+#include "Particle/ParticleSet.h"
+#include "Particle/DistanceTableData.h"
+#include "Particle/DistanceTable.h"
+#include "QMCWaveFunctions/MolecularOrbitals/GaussianShellBasisSet.h"
+#include "QMCWaveFunctions/LocalizedBasisSet.h"
+#include "QMCWaveFunctions/LCOrbitalSet.h"
+
+#include <stdio.h>
+#include <string>
+
+using std::string;
+
+namespace qmcplusplus
+{
+
+/// add an s shell and a p shell to a centered basis set
+template<typename COT>
+void add_test_shells(COT& aos)
+{
+  GaussianCombo<double>* s = new GaussianCombo<double>(0,true);
+  s->gset.push_back(GaussianCombo<double>::BasicGaussian(5.0,0.2));
+  s->gset.push_back(GaussianCombo<double>::BasicGaussian(1.2,0.5));
+  s->gset.push_back(GaussianCombo<double>::BasicGaussian(0.3,0.4));
+  GaussianCombo<double>* p = new GaussianCombo<double>(1,true);
+  p->gset.push_back(GaussianCombo<double>::BasicGaussian(2.0,0.6));
+  p->gset.push_back(GaussianCombo<double>::BasicGaussian(0.5,0.3));
+  QuantumNumberType nlms(0);
+  aos.Rnl.push_back(s);
+  aos.RnlID.push_back(nlms);
+  nlms[q_l]=1;
+  aos.Rnl.push_back(p);
+  aos.RnlID.push_back(nlms);
+  aos.LM.resize(4);
+  aos.NL.resize(4);
+  aos.LM[0]=aos.Ylm.index(0,0);
+  aos.NL[0]=0;
+  aos.LM[1]=aos.Ylm.index(1,1);
+  aos.LM[2]=aos.Ylm.index(1,-1);
+  aos.LM[3]=aos.Ylm.index(1,0);
+  aos.NL[1]=aos.NL[2]=aos.NL[3]=1;
+}
+
+TEST_CASE("Gaussian shells SoA", "[wavefunction]")
+{
+  OHMMS::Controller->initialize(0, NULL);
+  OhmmsInfo("testlogfile");
+
+  ParticleSet ions_;
+  ParticleSet elec_;
+
+  ions_.setName("ion");
+  ions_.create(1);
+  ions_.R[0] = 0.0;
+
+  elec_.setName("elec");
+  elec_.create(2);
+  elec_.R[0][0] = 0.3;
+  elec_.R[0][1] = -0.4;
+  elec_.R[0][2] = 0.5;
+  // beyond the screening radius of all the shells
+  elec_.R[1][0] = 40.0;
+  elec_.R[1][1] = 0.0;
+  elec_.R[1][2] = 0.0;
+
+  const DistanceTableData* d_ie = DistanceTable::add(ions_, elec_);
+  elec_.update();
+
+  typedef SphericalBasisSet<GaussianCombo<double> > RefBasisSet;
+  RefBasisSet ref(1);
+  add_test_shells(ref);
+  ref.setTable(d_ie);
+
+  GaussianShellBasisSet<double> soa(1);
+  add_test_shells(soa);
+  soa.setTable(d_ie);
+
+  REQUIRE(soa.getBasisSetSize() == 4);
+  REQUIRE(soa.Rcut.size() == 2);
+  REQUIRE(soa.Rmax < 40.0);
+
+  RefBasisSet::ValueVector_t psi_ref(4), d2psi_ref(4), psi(4), d2psi(4);
+  RefBasisSet::GradVector_t dpsi_ref(4), dpsi(4);
+
+  ref.evaluateForWalkerMove(0, 0, 0, psi_ref, dpsi_ref, d2psi_ref);
+  soa.evaluateForWalkerMove(0, 0, 0, psi, dpsi, d2psi);
+  for (int i = 0; i < 4; i++)
+  {
+    REQUIRE(psi[i] == Approx(psi_ref[i]));
+    REQUIRE(d2psi[i] == Approx(d2psi_ref[i]));
+    for (int j = 0; j < 3; j++)
+      REQUIRE(dpsi[i][j] == Approx(dpsi_ref[i][j]));
+  }
+
+  // the far electron is screened
+  ref.evaluateForWalkerMove(0, 1, 0, psi_ref, dpsi_ref, d2psi_ref);
+  soa.evaluateForWalkerMove(0, 1, 0, psi, dpsi, d2psi);
+  for (int i = 0; i < 4; i++)
+  {
+    REQUIRE(std::abs(psi_ref[i]) < 1e-16);
+    REQUIRE(psi[i] == 0.0);
+    REQUIRE(d2psi[i] == 0.0);
+  }
+
+  RefBasisSet::ValueMatrix_t phi_ref(2,4), phi(2,4);
+  ref.evaluateValues(d_ie, 0, 0, phi_ref);
+  soa.evaluateValues(d_ie, 0, 0, phi);
+  for (int i = 0; i < 4; i++)
+  {
+    REQUIRE(phi(0,i) == Approx(phi_ref(0,i)));
+    REQUIRE(phi(1,i) == 0.0);
+  }
+
+  GaussianShellBasisSet<double>* soa_clone = soa.makeClone();
+  soa_clone->evaluateForWalkerMove(0, 0, 0, psi, dpsi, d2psi);
+  for (int i = 0; i < 4; i++)
+    REQUIRE(psi[i] == Approx(phi_ref(0,i)));
+  delete soa_clone;
+}
+
+TEST_CASE("LCOrbitalSet batched evaluate_notranspose", "[wavefunction]")
+{
+  OHMMS::Controller->initialize(0, NULL);
+  OhmmsInfo("testlogfile");
+
+  ParticleSet ions_;
+  ParticleSet elec_;
+
+  ions_.setName("ion");
+  ions_.getSpeciesSet().addSpecies("H");
+  ions_.create(2);
+  ions_.R[0] = 0.0;
+  ions_.R[1][0] = 1.4;
+  ions_.R[1][1] = 0.0;
+  ions_.R[1][2] = 0.0;
+
+  elec_.setName("elec");
+  elec_.create(3);
+  elec_.R[0][0] = 0.3;
+  elec_.R[0][1] = -0.4;
+  elec_.R[0][2] = 0.5;
+  elec_.R[1][0] = 1.1;
+  elec_.R[1][1] = 0.2;
+  elec_.R[1][2] = -0.1;
+  elec_.R[2][0] = -0.6;
+  elec_.R[2][1] = 0.7;
+  elec_.R[2][2] = 0.3;
+
+  typedef LocalizedBasisSet<GaussianShellBasisSet<double> > BasisSet_t;
+  BasisSet_t* basis = new BasisSet_t(ions_, elec_);
+  GaussianShellBasisSet<double>* aos = new GaussianShellBasisSet<double>(1);
+  add_test_shells(*aos);
+  aos->setBasisSetSize(-1);
+  basis->add(0, aos);
+  basis->setBasisSetSize(-1);
+  REQUIRE(basis->getBasisSetSize() == 8);
+  elec_.update();
+
+  // the batched dgemm and the legacy contraction share the basis set
+  LCOrbitalSet<BasisSet_t,false> batched(basis, 0, "");
+  LCOrbitalSet<BasisSet_t,false> legacy(basis, 0, "legacy_gemv");
+  const int norb = 3;
+  batched.setOrbitalSetSize(norb);
+  legacy.setOrbitalSetSize(norb);
+  batched.C.resize(norb, 8);
+  for (int j = 0; j < norb; j++)
+    for (int k = 0; k < 8; k++)
+      batched.C(j,k) = 0.1*(j+1) - 0.05*k + 0.01*j*k;
+  legacy.C = batched.C;
+
+  SPOSetBase::ValueMatrix_t psi(norb,norb), d2psi(norb,norb);
+  SPOSetBase::GradMatrix_t dpsi(norb,norb);
+  SPOSetBase::ValueMatrix_t psi_ref(norb,norb), d2psi_ref(norb,norb);
+  SPOSetBase::GradMatrix_t dpsi_ref(norb,norb);
+  batched.evaluate_notranspose(elec_, 0, norb, psi, dpsi, d2psi);
+  legacy.evaluate_notranspose(elec_, 0, norb, psi_ref, dpsi_ref, d2psi_ref);
+  for (int i = 0; i < norb; i++)
+    for (int j = 0; j < norb; j++)
+    {
+      REQUIRE(psi(i,j) == Approx(psi_ref(i,j)));
+      REQUIRE(d2psi(i,j) == Approx(d2psi_ref(i,j)));
+      for (int k = 0; k < 3; k++)
+        REQUIRE(dpsi(i,j)[k] == Approx(dpsi_ref(i,j)[k]));
+    }
+
+  // a subset of the particles
+  SPOSetBase::ValueMatrix_t psi2(2,norb), d2psi2(2,norb);
+  SPOSetBase::GradMatrix_t dpsi2(2,norb);
+  batched.evaluate_notranspose(elec_, 1, 3, psi2, dpsi2, d2psi2);
+  for (int i = 0; i < 2; i++)
+    for (int j = 0; j < norb; j++)
+      REQUIRE(psi2(i,j) == Approx(psi_ref(i+1,j)));
+
+  delete basis;
+}
+
+}
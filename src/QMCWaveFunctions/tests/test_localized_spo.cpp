@@ -0,0 +1,172 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "Utilities/OhmmsInfo.h"
+#include "Particle/ParticleSet.h"
+#include "QMCWaveFunctions/LocalizedSPOSet.h"
+#include "simd/inner_product.hpp"
+
+#include <stdio.h>
+#include <string>
+
+using std::string;
+
+namespace qmcplusplus
+{
+
+/// periodic gaussians in a cubic cell as the source of the localized orbitals
+struct PeriodicGaussianSPOSet: public SPOSetBase
+{
+  double Alpha;
+  double L;
+  std::vector<PosType> Centers;
+
+  PeriodicGaussianSPOSet(double alpha, double l, const std::vector<PosType>& c):
+    Alpha(alpha), L(l), Centers(c)
+  {
+    className="PeriodicGaussianSPOSet";
+    OrbitalSetSize=c.size();
+  }
+
+  void resetParameters(const opt_variables_type& optVariables) {}
+  void resetTargetParticleSet(ParticleSet& P) {}
+  void setOrbitalSetSize(int norbs) {}
+
+  void value_grad(const PosType& r, int j, double& v, PosType& g)
+  {
+    v=0.0;
+    g=0.0;
+    for(int i=-1; i<=1; ++i)
+      for(int k=-1; k<=1; ++k)
+        for(int m=-1; m<=1; ++m)
+        {
+          PosType dr=r-Centers[j]-L*PosType(i,k,m);
+          double e=std::exp(-Alpha*dot(dr,dr));
+          v+=e;
+          g-=2.0*Alpha*e*dr;
+        }
+  }
+
+  void evaluate(const ParticleSet& P, int iat, ValueVector_t& psi)
+  {
+    PosType g;
+    for(int j=0; j<OrbitalSetSize; ++j)
+      value_grad(P.R[iat],j,psi[j],g);
+  }
+
+  void evaluate(const ParticleSet& P, int iat, ValueVector_t& psi, GradVector_t& dpsi, ValueVector_t& d2psi)
+  {
+    for(int j=0; j<OrbitalSetSize; ++j)
+      value_grad(P.R[iat],j,psi[j],dpsi[j]);
+  }
+
+  void evaluate(const ParticleSet& P, int iat, ValueVector_t& psi, GradVector_t& dpsi, HessVector_t& ddpsi) {}
+  void evaluate_notranspose(const ParticleSet& P, int first, int last,
+                            ValueMatrix_t& logdet, GradMatrix_t& dlogdet, ValueMatrix_t& d2logdet) {}
+  void evaluate_notranspose(const ParticleSet& P, int first, int last,
+                            ValueMatrix_t& logdet, GradMatrix_t& dlogdet, HessMatrix_t& ddlogdet) {}
+  void evaluate_notranspose(const ParticleSet& P, int first, int last,
+                            ValueMatrix_t& logdet, GradMatrix_t& dlogdet, HessMatrix_t& ddlogdet,
+                            GGGMatrix_t& dddlogdet) {}
+};
+
+TEST_CASE("Localized SPO set", "[wavefunction]")
+{
+  typedef SPOSetBase::PosType PosType;
+  typedef SPOSetBase::GradType GradType;
+  OHMMS::Controller->initialize(0, NULL);
+  OhmmsInfo("testlogfile");
+
+  const double L=10.0;
+  ParticleSet elec;
+  elec.setName("elec");
+  elec.create(2);
+  elec.R[0]=PosType(2.0,2.2,1.8);
+  elec.R[1]=PosType(7.2,5.0,8.3);
+  elec.Lattice.BoxBConds=true;
+  elec.Lattice.R=0.0;
+  elec.Lattice.R(0,0)=L;
+  elec.Lattice.R(1,1)=L;
+  elec.Lattice.R(2,2)=L;
+  elec.Lattice.reset();
+  SpeciesSet& tspecies=elec.getSpeciesSet();
+  int upIdx=tspecies.addSpecies("u");
+  int chargeIdx=tspecies.addAttribute("charge");
+  tspecies(chargeIdx,upIdx)=-1;
+  elec.resetGroups();
+  elec.update();
+
+  std::vector<PosType> centers;
+  centers.push_back(PosType(2.0,2.0,2.0));
+  centers.push_back(PosType(7.0,2.0,2.0));
+  centers.push_back(PosType(2.0,7.0,2.0));
+  centers.push_back(PosType(7.0,7.0,8.0));
+  PeriodicGaussianSPOSet src(4.0,L,centers);
+  const int norb=centers.size();
+
+  LocalizedSPOSet spo;
+  spo.Threshold=1e-6;
+  spo.GridSize=80;
+  spo.NumCells=3;
+  spo.createSplines(elec,src);
+  REQUIRE(spo.size() == norb);
+  //an orbital overlaps less than all the cells
+  REQUIRE(spo.averageActive() < norb);
+
+  SPOSetBase::ValueVector_t psi(norb), psi_ref(norb), d2psi(norb);
+  SPOSetBase::GradVector_t dpsi(norb), dpsi_ref(norb);
+  for(int iat=0; iat<elec.getTotalNum(); ++iat)
+  {
+    src.evaluate(elec,iat,psi_ref,dpsi_ref,d2psi);
+    spo.evaluate(elec,iat,psi,dpsi,d2psi);
+    REQUIRE(spo.ActiveOrbitals != 0);
+    const std::vector<int>& active=*spo.ActiveOrbitals;
+    REQUIRE(active.size() < norb);
+    for(int j=0; j<norb; ++j)
+    {
+      REQUIRE(std::abs(psi[j]-psi_ref[j]) < 2e-3);
+      for(int d=0; d<3; ++d)
+        REQUIRE(std::abs(dpsi[j][d]-dpsi_ref[j][d]) < 2e-2);
+      if(std::find(active.begin(),active.end(),j) == active.end())
+        REQUIRE(psi[j] == 0.0);
+    }
+    //the sparse dot product is the same as the dense one
+    SPOSetBase::ValueVector_t row(norb);
+    for(int j=0; j<norb; ++j)
+      row[j]=0.5+j;
+    REQUIRE(simd::dot(row.data(),psi.data(),active.data(),active.size()) ==
+            Approx(simd::dot(row.data(),psi.data(),norb)));
+    GradType g=simd::dot(row.data(),dpsi.data(),norb);
+    GradType g_sparse=simd::dot(row.data(),dpsi.data(),active.data(),active.size());
+    for(int d=0; d<3; ++d)
+      REQUIRE(g_sparse[d] == Approx(g[d]));
+  }
+
+  //the values only
+  spo.evaluate(elec,0,psi);
+  src.evaluate(elec,0,psi_ref);
+  for(int j=0; j<norb; ++j)
+    REQUIRE(std::abs(psi[j]-psi_ref[j]) < 2e-3);
+
+  //a clone shares the splines
+  SPOSetBase* clone=spo.makeClone();
+  REQUIRE(clone->ActiveOrbitals == 0);
+  clone->evaluate(elec,1,psi_ref);
+  spo.evaluate(elec,1,psi);
+  for(int j=0; j<norb; ++j)
+    REQUIRE(psi_ref[j] == Approx(psi[j]));
+  delete clone;
+}
+
+}
@@ -0,0 +1,183 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "OhmmsPETE/OhmmsMatrix.h"
+#include "Numerics/DeterminantOperators.h"
+#include "QMCWaveFunctions/Fermion/MultiDiracDeterminantBase_help.h"
+#include "QMCWaveFunctions/Fermion/SlaterDetBuilder.h"
+#include "QMCWaveFunctions/TrialWaveFunction.h"
+#include "Particle/ParticleSet.h"
+#include "io/hdf_archive.h"
+
+#include <stdio.h>
+#include <string>
+
+namespace qmcplusplus
+{
+
+TEST_CASE("ExcitationGroup by level", "[wavefunction][fermion]")
+{
+  const int nel = 6;
+  const int norb = 12;
+  Matrix<double> dots(norb,norb);
+  for (int i = 0; i < norb; i++)
+    for (int a = 0; a < norb; a++)
+      dots(i,a) = (i == a) ? 1.0 : 0.2*std::sin(0.3 + 1.7*i + 0.9*a);
+
+  MyDeterminant<double> calc;
+  calc.resize(nel);
+  const int ndets = 7;
+  const double det0 = 0.75;
+  for (int level = 0; level <= 5; level++)
+  {
+    ExcitationGroup<double,double> group;
+    group.resize(level,ndets);
+    std::vector<std::vector<int> > excitations(ndets);
+    for (int k = 0; k < ndets; k++)
+    {
+      // distinct rows i_l and distinct virtual orbitals a_l
+      std::vector<int>& ex = excitations[k];
+      for (int l = 0; l < level; l++)
+        ex.push_back((k+l)%nel);
+      for (int l = 0; l < level; l++)
+        ex.push_back(nel+(3*k+l)%(norb-nel));
+      group.set(k,2*k+1,(k%2)?-1.0:1.0,ex.begin());
+    }
+    std::vector<double> ratios(2*ndets+1,0.0);
+    group.evaluate(dots,det0,ratios.data(),1,calc);
+
+    for (int k = 0; k < ndets; k++)
+    {
+      std::vector<int>& ex = excitations[k];
+      double ref = 1.0;
+      if (level > 0)
+      {
+        Matrix<double> sub(level,level);
+        for (int l = 0; l < level; l++)
+          for (int m = 0; m < level; m++)
+            sub(l,m) = dots(ex[l],ex[level+m]);
+        std::vector<int> pivot(level);
+        ref = Determinant(sub.data(),level,level,pivot.data());
+      }
+      REQUIRE( ratios[2*k+1] == Approx(((k%2)?-1.0:1.0)*det0*ref) );
+      REQUIRE( ratios[2*k] == 0.0 );
+    }
+  }
+}
+
+
+TEST_CASE("packed occupation", "[wavefunction][fermion]")
+{
+  packed_occupation a, b;
+  a.resize(70);
+  b.resize(70, true);
+  REQUIRE(a.count() == 0);
+  REQUIRE(b.count() == 70);
+  a[1] = true;
+  a[65] = true;
+  const packed_occupation& ca = a;
+  REQUIRE(ca[1]);
+  REQUIRE(!ca[2]);
+  REQUIRE(ca[65]);
+  REQUIRE(a.count() == 2);
+  REQUIRE(a < b);
+  REQUIRE(!(b < a));
+
+  // the bits past the size do not take part in the comparisons
+  b.resize(66);
+  b.resize(70);
+  REQUIRE(b.count() == 66);
+  for (int i = 0; i < 66; i++)
+    a[i] = true;
+  REQUIRE(a == b);
+}
+
+TEST_CASE("read packed CI expansion", "[wavefunction][fermion]")
+{
+  OHMMS::Controller->initialize(0, NULL);
+  Communicate *c = OHMMS::Controller;
+
+  // one core orbital and 70 active orbitals, two 64-bit words per string
+  const int ncore = 1;
+  const int nstates = 70;
+  int ndets = 3;
+  int nstate = nstates;
+  int nbits = 2;
+  std::vector<double> ci(ndets);
+  ci[0] = 0.9;
+  ci[1] = -0.3;
+  ci[2] = 0.1;
+  // the reference occupies the first active orbital, the excitation the 67th
+  std::vector<unsigned long> alpha(2*nbits, 0), beta(nbits, 0);
+  alpha[0] = 1UL;
+  alpha[2*1+1] = 1UL << 2;
+  beta[0] = 1UL;
+  std::vector<int> c2node_up(ndets), c2node_dn(ndets, 0);
+  c2node_up[0] = 0;
+  c2node_up[1] = 1;
+  c2node_up[2] = 1;
+
+  hdf_archive hout(0);
+  hout.create("test_msd.h5");
+  hout.push("MultiDet");
+  hout.write(ndets, "NbDet");
+  hout.write(nstate, "nstate");
+  hout.write(nbits, "Nbits");
+  hout.write(ci, "Coeff");
+  hout.write(alpha, "CI_Alpha");
+  hout.write(beta, "CI_Beta");
+  hout.write(c2node_up, "C2node_Alpha");
+  hout.write(c2node_dn, "C2node_Beta");
+  hout.close();
+
+  ParticleSet elec;
+  TrialWaveFunction psi(c);
+  OrbitalBuilderBase::PtclPoolType pool;
+  SlaterDetBuilder builder(elec, psi, pool);
+
+  ci_configuration ref;
+  ref.occup.resize(ncore+nstates);
+  ref.occup[0] = true;
+  ref.occup[ncore] = true;
+  std::vector<ci_configuration> unique_up, unique_dn;
+  std::vector<int> C2node_up, C2node_dn;
+  std::vector<std::string> CItags;
+  std::vector<SlaterDetBuilder::RealType> coeff;
+  // one active electron of each spin, the last coefficient is below zero_cutoff
+  bool okay = builder.readDetListH5("test_msd.h5", ref, ref, ncore, ncore, nstates, 1, 1, 0.2,
+                                    unique_up, unique_dn, C2node_up, C2node_dn, CItags, coeff);
+  REQUIRE(okay);
+
+  REQUIRE(coeff.size() == ndets);
+  REQUIRE(CItags.size() == ndets);
+  REQUIRE(coeff[1] == Approx(-0.3));
+  REQUIRE(coeff[2] == 0.0);
+  REQUIRE(CItags[2] == "CIcoeff_2");
+  REQUIRE(C2node_up[2] == 1);
+  REQUIRE(C2node_dn[2] == 0);
+
+  REQUIRE(unique_up.size() == 2);
+  REQUIRE(unique_dn.size() == 1);
+  REQUIRE(unique_up[0] == ref);
+  REQUIRE(unique_dn[0] == ref);
+  // the core orbital stays occupied, the active bits are shifted past it
+  const packed_occupation& occ = unique_up[1].occup;
+  REQUIRE(occ.size() == ncore+nstates);
+  REQUIRE(occ[0]);
+  REQUIRE(!occ[ncore]);
+  REQUIRE(occ[ncore+66]);
+  REQUIRE(unique_up[1].count() == 2);
+}
+
+}
@@ -0,0 +1,76 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/**@file delayed_update.cpp
+ * @brief Benchmark the delayed (rank-k) inverse update against the Sherman-Morrison update
+ *
+ * Usage: delayed_update [N] [delay] [sweeps]
+ * Every sweep replaces all the N rows of a random matrix in order, as the
+ * particle-by-particle drivers do with DiracDeterminantBase.
+ */
+#include "Utilities/RandomGenerator.h"
+#include "Utilities/Timer.h"
+#include "Numerics/DeterminantOperators.h"
+#include "QMCWaveFunctions/Fermion/DelayedUpdate.h"
+#include <cstdlib>
+#include <iomanip>
+using namespace qmcplusplus;
+
+int main(int argc, char** argv)
+{
+  int N=(argc>1)?atoi(argv[1]):512;
+  int delay=(argc>2)?atoi(argv[2]):16;
+  int nsweeps=(argc>3)?atoi(argv[3]):4;
+  typedef Matrix<double> mat_t;
+  mat_t psiM(N,N), Minv_sm(N,N), Minv_delay(N,N);
+  for(int i=0; i<psiM.size(); ++i)
+    psiM(i)=Random();
+  for(int i=0; i<N; ++i)
+    psiM(i,i)+=N;
+  Minv_sm=psiM;
+  double phase;
+  InvertWithLog(Minv_sm.data(),N,N,phase);
+  Minv_delay=Minv_sm;
+  DelayedUpdate<double> engine;
+  engine.resize(N,delay);
+  engine.initializeInv(Minv_delay);
+  Vector<double> psiV(N), invRow(N), workV1(N), workV2(N);
+  Timer myclock;
+  double dt_sm=0.0, dt_delay=0.0;
+  for(int sweep=0; sweep<nsweeps; ++sweep)
+  {
+    for(int iel=0; iel<N; ++iel)
+    {
+      for(int j=0; j<N; ++j)
+        psiV[j]=psiM(iel,j)+0.1*(Random()-0.5);
+      myclock.restart();
+      double r=DetRatioByRow(Minv_sm,psiV,iel);
+      InverseUpdateByRow(Minv_sm,psiV,workV1,workV2,iel,r);
+      dt_sm += myclock.elapsed();
+      myclock.restart();
+      engine.getInvRow(Minv_delay,iel,invRow);
+      engine.acceptRow(Minv_delay,iel,psiV);
+      dt_delay += myclock.elapsed();
+    }
+    myclock.restart();
+    engine.updateInvMat(Minv_delay);
+    dt_delay += myclock.elapsed();
+  }
+  mat_t dM(N,N);
+  dM=Minv_sm-Minv_delay;
+  std::cout << "N = " << N << " delay = " << delay << " sweeps = " << nsweeps << std::endl;
+  std::cout << "Sherman-Morrison " << std::setw(12) << dt_sm << " s" << std::endl;
+  std::cout << "Delayed update   " << std::setw(12) << dt_delay << " s"
+            << "  speedup = " << dt_sm/dt_delay << std::endl;
+  std::cout << "|Minv_sm - Minv_delay| = " << BLAS::norm2(dM.size(),dM.data()) << std::endl;
+  return 0;
+}
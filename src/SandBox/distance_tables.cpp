@@ -0,0 +1,164 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/**@file distance_tables.cpp
+ * @brief Benchmark the structure-of-arrays distance tables against the default tables
+ *
+ * Usage: distance_tables [nel] [nion] [sweeps] [cell]
+ * with cell = open, ortho or general. Every sweep moves all the electrons
+ * one by one and accepts every other move, as the particle-by-particle drivers do.
+ * The SoA kernel alone, DTD_BConds::computeDistances, is timed against the
+ * AoS loop of SymmetricDTD::move.
+ */
+#include <Configuration.h>
+#include <Particle/ParticleSet.h>
+#include <Particle/DistanceTable.h>
+#include <Particle/DistanceTableData.h>
+#include <Lattice/ParticleBConds.h>
+#include <Utilities/RandomGenerator.h>
+#include <Utilities/Timer.h>
+#include <iomanip>
+using namespace qmcplusplus;
+
+typedef ParticleSet::ParticleLayout_t LatticeType;
+typedef ParticleSet::SingleParticlePos_t PosType;
+typedef ParticleSet::RealType RealType;
+
+/** time nsweeps of particle-by-particle moves
+ * @param elec electrons with the AA and AB tables
+ * @param delta proposed displacements, nsweeps*nel
+ * @param nsweeps number of sweeps
+ * @param tmove time of DistanceTableData::move
+ * @param tupdate time of DistanceTableData::update
+ */
+void run_sweeps(ParticleSet& elec, const std::vector<PosType>& delta, int nsweeps, double& tmove, double& tupdate)
+{
+  Timer myclock;
+  tmove=0.0;
+  tupdate=0.0;
+  const int nel=elec.getTotalNum();
+  for(int sweep=0,k=0; sweep<nsweeps; ++sweep)
+    for(int iel=0; iel<nel; ++iel,++k)
+    {
+      PosType newpos(elec.R[iel]+delta[k]);
+      myclock.restart();
+      for(int i=0; i<elec.DistTables.size(); ++i)
+        elec.DistTables[i]->move(elec,newpos,iel);
+      tmove+=myclock.elapsed();
+      if(iel%2==0)
+      {
+        elec.R[iel]=newpos;
+        myclock.restart();
+        for(int i=0; i<elec.DistTables.size(); ++i)
+          elec.DistTables[i]->update(iel);
+        tupdate+=myclock.elapsed();
+      }
+    }
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo welcome(argc,argv,OHMMS::Controller->rank());
+  Random.init(0,1,11);
+  int nel=(argc>1)?atoi(argv[1]):256;
+  int nion=(argc>2)?atoi(argv[2]):32;
+  int nsweeps=(argc>3)?atoi(argv[3]):20;
+  std::string cell=(argc>4)?argv[4]:"ortho";
+  LatticeType lattice;
+  const RealType L=std::pow(static_cast<RealType>(nel),1.0/3.0)*2.0;
+  if(cell!="open")
+  {
+    lattice.BoxBConds=true;
+    lattice.R.diagonal(L);
+    if(cell=="general")
+      lattice.R(1,0)=0.25*L;
+    lattice.reset();
+  }
+  ParticleSet ions, elec_aos, elec_soa;
+  ions.setName("ion0");
+  ions.Lattice.copy(lattice);
+  ions.create(nion);
+  elec_aos.setName("e");
+  elec_aos.Lattice.copy(lattice);
+  elec_aos.create(nel);
+  elec_soa.setName("e");
+  elec_soa.Lattice.copy(lattice);
+  elec_soa.create(nel);
+  elec_soa.UseSoADistanceTables=true;
+  for(int i=0; i<nion; ++i)
+    for(int d=0; d<OHMMS_DIM; ++d)
+      ions.R[i][d]=L*Random();
+  for(int i=0; i<nel; ++i)
+    for(int d=0; d<OHMMS_DIM; ++d)
+      elec_aos.R[i][d]=L*Random();
+  std::vector<PosType> delta(nsweeps*nel);
+  for(int k=0; k<delta.size(); ++k)
+    for(int d=0; d<OHMMS_DIM; ++d)
+      delta[k][d]=0.2*(Random()-0.5);
+  elec_soa.R=elec_aos.R;
+  elec_aos.addTable(elec_aos);
+  elec_aos.addTable(ions);
+  elec_soa.addTable(elec_soa);
+  elec_soa.addTable(ions);
+  elec_aos.update();
+  elec_soa.update();
+  double tmove_aos, tupdate_aos, tmove_soa, tupdate_soa;
+  run_sweeps(elec_aos,delta,nsweeps,tmove_aos,tupdate_aos);
+  run_sweeps(elec_soa,delta,nsweeps,tmove_soa,tupdate_soa);
+  //maximum difference of the AA distances after the same sequence of moves
+  DistanceTableData* d_aos=elec_aos.DistTables[0];
+  DistanceTableData* d_soa=elec_soa.DistTables[0];
+  RealType maxdiff=0.0;
+  for(int ij=0; ij<nel*(nel-1)/2; ++ij)
+    maxdiff=std::max(maxdiff,std::abs(d_aos->r(ij)-d_soa->r(ij)));
+  //kernel only: the AoS loop of SymmetricDTD::move vs computeDistances
+  Timer myclock;
+  double tkernel_aos=0.0, tkernel_soa=0.0;
+  std::vector<RealType> r_aos(nel);
+  std::vector<PosType> dr_aos(nel);
+  VectorSoaContainer<RealType,OHMMS_DIM> RSoA(nel), dr_soa(nel);
+  DistanceTableData::RowContainer r_soa(getAlignedSize<RealType>(nel));
+  RSoA.copyIn(elec_aos.R);
+  LatticeType ortho;
+  ortho.BoxBConds=true;
+  ortho.R.diagonal(L);
+  ortho.reset();
+  DTD_BConds<RealType,OHMMS_DIM,PPPO> bc(ortho);
+  for(int sweep=0; sweep<nsweeps; ++sweep)
+    for(int iel=0; iel<nel; ++iel)
+    {
+      const PosType rnew(elec_aos.R[iel]);
+      myclock.restart();
+      for(int iat=0; iat<nel; ++iat)
+      {
+        PosType drij(rnew-elec_aos.R[iat]);
+        r_aos[iat]=std::sqrt(bc.apply_bc(drij));
+        dr_aos[iat]=drij;
+      }
+      tkernel_aos+=myclock.elapsed();
+      myclock.restart();
+      bc.computeDistances(rnew,RSoA,r_soa.data(),dr_soa,0,nel);
+      tkernel_soa+=myclock.elapsed();
+    }
+  std::cout << "nel = " << nel << " nion = " << nion << " sweeps = " << nsweeps << " cell = " << cell << std::endl;
+  std::cout << std::setw(24) << " " << std::setw(12) << "AoS" << std::setw(12) << "SoA" << std::setw(12) << "speedup" << std::endl;
+  std::cout << std::setw(24) << "move (AA+AB)" << std::setw(12) << tmove_aos << std::setw(12) << tmove_soa
+            << std::setw(12) << tmove_aos/tmove_soa << std::endl;
+  std::cout << std::setw(24) << "update (AA+AB)" << std::setw(12) << tupdate_aos << std::setw(12) << tupdate_soa
+            << std::setw(12) << tupdate_aos/tupdate_soa << std::endl;
+  std::cout << std::setw(24) << "ortho kernel (AA)" << std::setw(12) << tkernel_aos << std::setw(12) << tkernel_soa
+            << std::setw(12) << tkernel_aos/tkernel_soa << std::endl;
+  std::cout << "max |r_aos - r_soa| = " << maxdiff << std::endl;
+  OHMMS::Controller->finalize();
+  return 0;
+}
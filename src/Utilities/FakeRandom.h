@@ -16,6 +16,10 @@
 
 // Deterministic generator for testing.
 
+#include <cmath>
+#include <cstddef>
+#include <stdint.h>
+
 class FakeRandom
 {
 public:
@@ -23,6 +27,19 @@ public:
   typedef unsigned int uint_type;
   double operator()();
   void set_value(double val);
+  void seed(uint_type aseed) {}
+  void set_key(uint_type k0, uint_type k1=0) {}
+  void set_stream(uint64_t walker_id, uint_type step, uint_type section=0) {}
+
+  /// Box-Muller pairs of the fixed value, as assignGaussRand does
+  template<typename T>
+  void generate_normal(T* a, size_t n)
+  {
+    double temp1 = std::sqrt(-2.0*std::log(1.0-m_val));
+    double temp2 = 2.0*M_PI*m_val;
+    for (size_t i = 0; i < n; i++)
+      a[i] = (i%2 == 0) ? temp1*std::cos(temp2) : temp1*std::sin(temp2);
+  }
 private:
   double m_val;
 };
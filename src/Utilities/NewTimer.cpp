@@ -25,6 +25,7 @@
 #include <map>
 #include <limits>
 #include <cstdio>
+#include <fstream>
 
 namespace qmcplusplus
 {
@@ -121,6 +122,144 @@ void TimerManagerClass::collate_flat_profile(Communicate *comm, FlatProfileData
   }
 }
 
+void TimerManagerClass::collate_thread_profile(Communicate *comm, ThreadProfileData &p)
+{
+  // inclusive time of every thread, summed over the timers of the same name
+  std::vector<std::vector<double> > thread_time;
+  std::vector<std::vector<long> > thread_calls;
+  for(int i=0; i<TimerList.size(); ++i)
+  {
+    NewTimer &timer = *TimerList[i];
+    nameList_t::iterator it(p.nameList.find(timer.get_name()));
+    int ind;
+    if(it == p.nameList.end())
+    {
+      ind=p.nameList.size();
+      p.nameList[timer.get_name()]=ind;
+      thread_time.push_back(std::vector<double>(timer.get_num_threads(),0.0));
+      thread_calls.push_back(std::vector<long>(timer.get_num_threads(),0));
+    }
+    else
+      ind=(*it).second;
+    for(int ip=0; ip<timer.get_num_threads() && ip<thread_time[ind].size(); ++ip)
+    {
+      thread_time[ind][ip]+=timer.get_thread_total(ip);
+      thread_calls[ind][ip]+=timer.get_thread_num_calls(ip);
+    }
+  }
+
+  // per rank: total, min and max over the threads which called the timer and their number
+  const int ntimers=thread_time.size();
+  const int nranks=comm?comm->size():1;
+  const int rank=comm?comm->rank():0;
+  const int nstat=4;
+  std::vector<double> stats(nranks*ntimers*nstat,0.0);
+  for(int ind=0; ind<ntimers; ++ind)
+  {
+    double *s=&stats[(rank*ntimers+ind)*nstat];
+    s[1]=std::numeric_limits<double>::max();
+    for(int ip=0; ip<thread_time[ind].size(); ++ip)
+    {
+      if(thread_calls[ind][ip]==0)
+        continue;
+      s[0]+=thread_time[ind][ip];
+      s[1]=std::min(s[1],thread_time[ind][ip]);
+      s[2]=std::max(s[2],thread_time[ind][ip]);
+      s[3]+=1.0;
+    }
+    if(s[3]==0.0)
+      s[1]=0.0;
+  }
+  // every rank fills its own slots
+  if (comm)
+    comm->allreduce(stats);
+
+  p.threadMin.assign(ntimers,std::numeric_limits<double>::max());
+  p.threadMax.assign(ntimers,0.0);
+  p.threadMean.assign(ntimers,0.0);
+  p.rankMin.assign(ntimers,std::numeric_limits<double>::max());
+  p.rankMax.assign(ntimers,0.0);
+  p.rankMean.assign(ntimers,0.0);
+  for(int ind=0; ind<ntimers; ++ind)
+  {
+    double nthreads=0.0;
+    for(int ir=0; ir<nranks; ++ir)
+    {
+      const double *s=&stats[(ir*ntimers+ind)*nstat];
+      if(s[3]>0.0)
+      {
+        p.threadMin[ind]=std::min(p.threadMin[ind],s[1]);
+        p.threadMax[ind]=std::max(p.threadMax[ind],s[2]);
+        nthreads+=s[3];
+      }
+      p.threadMean[ind]+=s[0];
+      p.rankMin[ind]=std::min(p.rankMin[ind],s[0]);
+      p.rankMax[ind]=std::max(p.rankMax[ind],s[0]);
+      p.rankMean[ind]+=s[0];
+    }
+    if(nthreads==0.0)
+      p.threadMin[ind]=0.0;
+    p.threadMean[ind]/=std::max(nthreads,1.0);
+    p.rankMean[ind]/=nranks;
+  }
+}
+
+void TimerManagerClass::set_timeline_window(int first, int last)
+{
+  timeline_first=first;
+  timeline_last=last;
+  timeline_step=0;
+  timeline_on=false;
+  timeline_origin=cpu_clock();
+  ThreadEvents.resize(omp_get_max_threads());
+  for(int ip=0; ip<ThreadEvents.size(); ++ip)
+    ThreadEvents[ip].clear();
+}
+
+void TimerManagerClass::advance_timeline(int nsteps)
+{
+  timeline_on = timeline_step < timeline_last && timeline_step+nsteps > timeline_first;
+  timeline_step += nsteps;
+}
+
+void TimerManagerClass::write_timeline(Communicate* comm, const std::string& root)
+{
+  if(ThreadEvents.empty())
+    return;
+  timeline_on=false;
+  const int nranks=comm?comm->size():1;
+  const int rank=comm?comm->rank():0;
+  std::string file_name=root;
+  if(nranks>1)
+  {
+    char ptoken[32];
+    sprintf(ptoken,".p%03d",rank);
+    file_name += ptoken;
+  }
+  file_name += ".trace.json";
+  std::ofstream fout(file_name.c_str());
+  fout << "{\"traceEvents\":[";
+  bool first_event=true;
+  char buffer[64];
+  for(int ip=0; ip<ThreadEvents.size(); ++ip)
+  {
+    for(int i=0; i<ThreadEvents[ip].size(); ++i)
+    {
+      const TimelineEvent& e=ThreadEvents[ip][i];
+      // complete events, time stamps in microseconds
+      sprintf(buffer,"%.3f,\"dur\":%.3f",(e.start-timeline_origin)*1e6,(e.end-e.start)*1e6);
+      fout << (first_event?"\n":",\n")
+           << "{\"name\":\"" << timer_id_name[e.id] << "\",\"ph\":\"X\",\"ts\":" << buffer
+           << ",\"pid\":" << rank << ",\"tid\":" << ip << "}";
+      first_event=false;
+    }
+    ThreadEvents[ip].clear();
+  }
+  fout << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+  app_log() << "  Timer timeline of steps [" << timeline_first << "," << timeline_last
+            << ") is written to " << file_name << std::endl;
+}
+
 struct ProfileData
 {
     double time;
@@ -250,6 +389,8 @@ TimerManagerClass::print(Communicate* comm)
   }
   print_flat(comm);
 #endif
+  if((comm && comm->size()>1) || omp_get_max_threads()>1)
+    print_threads(comm);
 #endif
 }
 
@@ -283,6 +424,37 @@ TimerManagerClass::print_flat(Communicate* comm)
 }
 
 
+void
+TimerManagerClass::print_threads(Communicate* comm)
+{
+#if ENABLE_TIMERS
+  ThreadProfileData p;
+
+  collate_thread_profile(comm, p);
+
+  if(comm == NULL || comm->rank() == 0)
+  {
+    // imbalance = max/mean-1 over the threads which called the timer and over the ranks
+    printf("\nThread and rank balance (inclusive time)\n");
+    printf("%-40s  %9s  %9s  %9s  %9s  %9s  %9s  %9s  %9s\n","Timer",
+           "Thr_min","Thr_max","Thr_mean","Thr_imb","Rank_min","Rank_max","Rank_mean","Rank_imb");
+    std::map<std::string,int>::iterator it(p.nameList.begin()), it_end(p.nameList.end());
+    const double eps=std::numeric_limits<double>::epsilon();
+    while(it != it_end)
+    {
+      int i=(*it).second;
+      if(p.rankMax[i]>0.0)
+        printf ("%-40s  %9.4f  %9.4f  %9.4f  %9.4f  %9.4f  %9.4f  %9.4f  %9.4f\n"
+                , (*it).first.c_str()
+                , p.threadMin[i], p.threadMax[i], p.threadMean[i], p.threadMax[i]/(p.threadMean[i]+eps)-1.0
+                , p.rankMin[i], p.rankMax[i], p.rankMean[i], p.rankMax[i]/(p.rankMean[i]+eps)-1.0);
+      ++it;
+    }
+  }
+#endif
+}
+
+
 void pad_string(const std::string &in, std::string &out, int field_len)
 {
     int len = in.size();
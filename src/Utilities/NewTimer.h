@@ -136,9 +136,28 @@ protected:
   bool max_timers_exceeded;
   std::map<timer_id_t, std::string> timer_id_name;
   std::map<std::string, timer_id_t> timer_name_to_id;
+
+  /// an interval recorded by a timer for the timeline
+  struct TimelineEvent
+  {
+    timer_id_t id;
+    double start;
+    double end;
+  };
+  /// timeline events per thread, only filled inside the step window
+  std::vector<std::vector<TimelineEvent> > ThreadEvents;
+  /// step window [timeline_first, timeline_last) of the timeline
+  int timeline_first;
+  int timeline_last;
+  /// steps counted by advance_timeline
+  int timeline_step;
+  /// origin of the timeline
+  double timeline_origin;
+  bool timeline_on;
 public:
   TimerManagerClass():timer_threshold(timer_level_coarse),max_timer_id(1),
-    max_timers_exceeded(false) {}
+    max_timers_exceeded(false),timeline_first(0),timeline_last(0),timeline_step(0),
+    timeline_origin(0.0),timeline_on(false) {}
   void addTimer (NewTimer* t);
   NewTimer *createTimer(const std::string& myname, timer_levels mytimer = timer_level_fine);
 
@@ -177,6 +196,37 @@ public:
   void print (Communicate* comm);
   void print_flat (Communicate* comm);
   void print_stack (Communicate* comm);
+  void print_threads (Communicate* comm);
+
+  /** record a timeline of the timers for the steps [first, last)
+   *
+   * The drivers count the steps with advance_timeline and the timeline
+   * is written in the Chrome trace (JSON) format by write_timeline.
+   */
+  void set_timeline_window(int first, int last);
+
+  /// count nsteps and switch the timeline on inside the window, call outside parallel regions
+  void advance_timeline(int nsteps=1);
+
+  inline bool timeline_active() const
+  {
+    return timeline_on;
+  }
+
+  inline void add_timeline_event(int ip, timer_id_t id, double start, double end)
+  {
+    if (ip < ThreadEvents.size())
+    {
+      TimelineEvent e;
+      e.id = id;
+      e.start = start;
+      e.end = end;
+      ThreadEvents[ip].push_back(e);
+    }
+  }
+
+  /// write root.trace.json, or root.pXXX.trace.json with several ranks
+  void write_timeline(Communicate* comm, const std::string& root);
 
   typedef std::map<std::string, int> nameList_t;
   typedef std::vector<double> timeList_t;
@@ -197,10 +247,23 @@ public:
     callList_t callList;
   };
 
+  /// inclusive time per thread and per rank, over the threads that called the timer
+  struct ThreadProfileData {
+    nameList_t nameList;
+    timeList_t threadMin;
+    timeList_t threadMax;
+    timeList_t threadMean;
+    timeList_t rankMin;
+    timeList_t rankMax;
+    timeList_t rankMean;
+  };
+
   void collate_flat_profile(Communicate *comm, FlatProfileData &p);
 
   void collate_stack_profile(Communicate *comm, StackProfileData &p);
 
+  void collate_thread_profile(Communicate *comm, ThreadProfileData &p);
+
   void output_timing(Communicate *comm, Libxml2Document &doc, xmlNodePtr root);
 
   void get_stack_name_from_id(const StackKey &key, std::string &name);
@@ -221,8 +284,12 @@ protected:
   bool active;
   timer_levels timer_level;
   timer_id_t timer_id;
-#ifdef USE_STACK_TIMERS
+  /// per-thread start, inclusive time and calls, the master thread is also counted by total_time
+  std::vector<double> thread_start_time;
+  std::vector<double> thread_total_time;
+  std::vector<long> thread_num_calls;
   TimerManagerClass *manager;
+#ifdef USE_STACK_TIMERS
   NewTimer *parent;
   StackKey current_stack_key;
 
@@ -238,8 +305,10 @@ public:
   {
     if (active)
     {
+      const int ip = omp_get_thread_num();
 #ifdef USE_STACK_TIMERS
-      #pragma omp master
+      // only the master thread maintains the timer stack
+      if (ip == 0)
       {
         if (manager)
         {
@@ -265,8 +334,14 @@ public:
         }
         start_time = cpu_clock();
       }
+      else if (ip < thread_start_time.size())
+      {
+        thread_start_time[ip] = cpu_clock();
+      }
 #else
       start_time = cpu_clock();
+      if (ip < thread_start_time.size())
+        thread_start_time[ip] = start_time;
 #endif
     }
   }
@@ -275,11 +350,13 @@ public:
   {
     if (active)
     {
+      const int ip = omp_get_thread_num();
 #ifdef USE_STACK_TIMERS
-      #pragma omp master
+      if (ip == 0)
 #endif
       {
-        double elapsed = cpu_clock() - start_time;
+        double now = cpu_clock();
+        double elapsed = now - start_time;
         total_time += elapsed;
         num_calls++;
 
@@ -293,11 +370,44 @@ public:
           manager->pop_timer();
         }
 #endif
+        record_thread(ip, start_time, now);
+      }
+#ifdef USE_STACK_TIMERS
+      else if (ip < thread_total_time.size())
+      {
+        record_thread(ip, thread_start_time[ip], cpu_clock());
       }
+#endif
     }
   }
 #endif
 
+  inline void record_thread(int ip, double tstart, double tend)
+  {
+    if (ip < thread_total_time.size())
+    {
+      thread_total_time[ip] += tend - tstart;
+      thread_num_calls[ip]++;
+    }
+    if (manager && manager->timeline_active())
+      manager->add_timeline_event(ip, timer_id, tstart, tend);
+  }
+
+  inline double get_thread_total(int ip) const
+  {
+    return thread_total_time[ip];
+  }
+
+  inline long get_thread_num_calls(int ip) const
+  {
+    return thread_num_calls[ip];
+  }
+
+  inline int get_num_threads() const
+  {
+    return thread_total_time.size();
+  }
+
 #ifdef USE_STACK_TIMERS
   std::map<StackKey, double>& get_per_stack_total_time()
   {
@@ -355,13 +465,40 @@ public:
   {
     num_calls = 0;
     total_time=0.0;
+    std::fill(thread_total_time.begin(), thread_total_time.end(), 0.0);
+    std::fill(thread_num_calls.begin(), thread_num_calls.end(), 0);
+  }
+
+  /** accumulate time measured outside of start/stop, e.g. by a helper thread
+   *
+   * The time is recorded at the top level of the stack profile.
+   */
+  inline void add_time(double elapsed, long calls=1)
+  {
+    if (active)
+    {
+      total_time += elapsed;
+      num_calls += calls;
+      thread_total_time[0] += elapsed;
+      thread_num_calls[0] += calls;
+#ifdef USE_STACK_TIMERS
+      StackKey key;
+      key.add_id(timer_id);
+      per_stack_total_time[key] += elapsed;
+      per_stack_num_calls[key] += calls;
+#endif
+    }
   }
 
   NewTimer(const std::string& myname, timer_levels mytimer = timer_level_fine) :
     total_time(0.0), num_calls(0), name(myname), active(true), timer_level(mytimer)
     ,timer_id(0)
+    ,thread_start_time(omp_get_max_threads(), 0.0)
+    ,thread_total_time(omp_get_max_threads(), 0.0)
+    ,thread_num_calls(omp_get_max_threads(), 0)
+    ,manager(NULL)
 #ifdef USE_STACK_TIMERS
-  ,manager(NULL), parent(NULL)
+  ,parent(NULL)
 #endif
   { }
 
@@ -381,9 +518,7 @@ public:
 
   void set_manager(TimerManagerClass *mymanager)
   {
-#ifdef USE_STACK_TIMERS
     manager = mymanager;
-#endif
   }
 
 #ifdef USE_STACK_TIMERS
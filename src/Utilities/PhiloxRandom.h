@@ -0,0 +1,308 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file PhiloxRandom.h
+ * @brief Counter-based random number generator Philox4x32-10
+ *
+ * J. K. Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC11.
+ * A block of four 32-bit words is a bijection of a 128-bit counter under a
+ * 64-bit key, so any stream is addressed by its counter without a state to
+ * carry around. The counter of a walker stream is
+ * - word 0 : block index within the stream
+ * - word 1 : MC step
+ * - word 2 : walker ID
+ * - word 3 : QMC section
+ * Word 3 of the default stream of a generator is 0xffffffff, so that it never
+ * overlaps with a walker stream.
+ */
+#ifndef QMCPLUSPLUS_PHILOXRANDOM_H
+#define QMCPLUSPLUS_PHILOXRANDOM_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/** Philox4x32-10 with the interface of BoostRandom
+ *
+ * operator() returns a uniform number [0,1) with 53 random bits, two per block.
+ * generate_normal fills an array with Gaussian numbers using vectorized
+ * Philox blocks and the Box-Muller transformation.
+ */
+template<typename T>
+class PhiloxRandom
+{
+public:
+  /// real result type
+  typedef T result_type;
+  /// unsigned integer type
+  typedef uint32_t uint_type;
+
+  std::string ClassName;
+  std::string EngineName;
+
+  explicit PhiloxRandom(uint_type iseed=911, const std::string& aname="philox4x32")
+    : ClassName("philox"), EngineName(aname), myContext(0), nContexts(1), baseOffset(0)
+  {
+    Key[0]=Key[1]=0;
+    seed(iseed);
+  }
+
+  /** initialize the generator
+   * @param i context index
+   * @param nstr number of contexts
+   * @param iseed_in seed of the default stream
+   * @param offset offset of the seeds
+   *
+   * The key is not changed, see set_key.
+   */
+  void init(int i, int nstr, int iseed_in, uint_type offset=1)
+  {
+    myContext=i;
+    nContexts=nstr;
+    baseOffset=offset;
+    seed(iseed_in);
+  }
+
+  ///get baseOffset
+  inline int offset() const
+  {
+    return baseOffset;
+  }
+  ///assign baseOffset
+  inline int& offset()
+  {
+    return baseOffset;
+  }
+
+  ///set the key shared by all the streams
+  inline void set_key(uint_type k0, uint_type k1=0)
+  {
+    Key[0]=k0;
+    Key[1]=k1;
+    Index=2;
+  }
+
+  ///select the default stream of a seed
+  inline void seed(uint_type aseed)
+  {
+    Counter[0]=0;
+    Counter[1]=0;
+    Counter[2]=aseed;
+    Counter[3]=0xffffffffu;
+    Index=2;
+  }
+
+  /** select the stream of a walker
+   * @param walker_id walker ID, the lower 32 bits are used
+   * @param step MC step
+   * @param section QMC section
+   */
+  inline void set_stream(uint64_t walker_id, uint_type step, uint_type section=0)
+  {
+    Counter[0]=0;
+    Counter[1]=step;
+    Counter[2]=static_cast<uint_type>(walker_id);
+    Counter[3]=section;
+    Index=2;
+  }
+
+  /** return a random number [0,1)
+   */
+  inline result_type rand()
+  {
+    if(Index==2)
+    {
+      uint_type x[4];
+      next_block(x);
+      Uniform[0]=to_uniform(x[0],x[1]);
+      Uniform[1]=to_uniform(x[2],x[3]);
+      Index=0;
+    }
+    return static_cast<result_type>(Uniform[Index++]);
+  }
+
+  /** return a random number [0,1)
+   */
+  inline result_type operator()()
+  {
+    return rand();
+  }
+
+  /** return a random integer
+   */
+  inline uint_type irand()
+  {
+    uint_type x[4];
+    next_block(x);
+    return x[0];
+  }
+
+  /** fill a with n Gaussian random numbers of zero mean and unit variance
+   *
+   * Every block gives a Box-Muller pair. The second number of the last pair
+   * is dropped when n is odd. The buffered uniform numbers are discarded.
+   */
+  template<typename TG>
+  inline void generate_normal(TG* restrict a, size_t n)
+  {
+    const size_t nb_chunk=64;
+    uint_type x0[nb_chunk], x1[nb_chunk], x2[nb_chunk], x3[nb_chunk];
+    double r[nb_chunk], phi[nb_chunk];
+    const size_t nblocks=(n+1)/2;
+    Index=2;
+    for(size_t first=0; first<nblocks; first+=nb_chunk)
+    {
+      const size_t nb=std::min(nb_chunk,nblocks-first);
+      const uint_type c0=Counter[0], c1=Counter[1], c2=Counter[2], c3=Counter[3];
+      const uint_type k0=Key[0], k1=Key[1];
+      #pragma omp simd
+      for(size_t b=0; b<nb; ++b)
+        philox(c0+static_cast<uint_type>(b),c1,c2,c3,k0,k1,x0[b],x1[b],x2[b],x3[b]);
+      advance(nb);
+      #pragma omp simd
+      for(size_t b=0; b<nb; ++b)
+      {
+        //1-u is in (0,1]
+        r[b]=std::sqrt(-2.0*std::log(1.0-to_uniform(x0[b],x1[b])));
+        phi[b]=2.0*M_PI*to_uniform(x2[b],x3[b]);
+      }
+      TG* restrict g=a+2*first;
+      const size_t npairs=(2*(first+nb)<=n)? nb: nb-1;
+      #pragma omp simd
+      for(size_t b=0; b<npairs; ++b)
+      {
+        g[2*b]  =r[b]*std::cos(phi[b]);
+        g[2*b+1]=r[b]*std::sin(phi[b]);
+      }
+      if(npairs<nb)
+        g[2*npairs]=r[npairs]*std::cos(phi[npairs]);
+    }
+  }
+
+  ///key[2], counter[4] and the position in the buffered block
+  inline int state_size() const
+  {
+    return 7;
+  }
+
+  inline void read(std::istream& rin)
+  {
+    std::vector<uint_type> s(state_size());
+    for(int i=0; i<s.size(); ++i)
+      rin >> s[i];
+    load(s);
+  }
+
+  inline void write(std::ostream& rout) const
+  {
+    std::vector<uint_type> s;
+    save(s);
+    for(int i=0; i<s.size(); ++i)
+      rout << s[i] << " ";
+  }
+
+  inline void save(std::vector<uint_type>& curstate) const
+  {
+    curstate.resize(state_size());
+    curstate[0]=Key[0];
+    curstate[1]=Key[1];
+    for(int i=0; i<4; ++i)
+      curstate[2+i]=Counter[i];
+    curstate[6]=Index;
+  }
+
+  /** restore the state saved by save
+   *
+   * The buffered block is regenerated from the previous counter.
+   */
+  inline void load(const std::vector<uint_type>& newstate)
+  {
+    Key[0]=newstate[0];
+    Key[1]=newstate[1];
+    for(int i=0; i<4; ++i)
+      Counter[i]=newstate[2+i];
+    Index=newstate[6];
+    if(Index<2)
+    {
+      uint_type x[4];
+      philox(Counter[0]-1,Counter[1],Counter[2],Counter[3],Key[0],Key[1],x[0],x[1],x[2],x[3]);
+      Uniform[0]=to_uniform(x[0],x[1]);
+      Uniform[1]=to_uniform(x[2],x[3]);
+    }
+  }
+
+  /** Philox4x32-10 bijection of a counter
+   * @param c0,c1,c2,c3 counter
+   * @param k0,k1 key
+   * @param x0,x1,x2,x3 random block
+   */
+  static inline void philox(uint_type c0, uint_type c1, uint_type c2, uint_type c3,
+                            uint_type k0, uint_type k1,
+                            uint_type& x0, uint_type& x1, uint_type& x2, uint_type& x3)
+  {
+    for(int round=0; round<10; ++round)
+    {
+      const uint64_t p0=static_cast<uint64_t>(0xD2511F53u)*c0;
+      const uint64_t p1=static_cast<uint64_t>(0xCD9E8D57u)*c2;
+      const uint_type hi0=static_cast<uint_type>(p0>>32);
+      const uint_type hi1=static_cast<uint_type>(p1>>32);
+      c0=hi1^c1^k0;
+      c1=static_cast<uint_type>(p1);
+      c2=hi0^c3^k1;
+      c3=static_cast<uint_type>(p0);
+      k0+=0x9E3779B9u;
+      k1+=0xBB67AE85u;
+    }
+    x0=c0;
+    x1=c1;
+    x2=c2;
+    x3=c3;
+  }
+
+private:
+  ///context number
+  int myContext;
+  ///number of contexts
+  int nContexts;
+  ///offset of the random seed
+  int baseOffset;
+  ///position in Uniform, 2 if the buffer is empty
+  uint_type Index;
+  ///key of all the streams
+  uint_type Key[2];
+  ///counter of the next block
+  uint_type Counter[4];
+  ///uniform numbers of the last block
+  double Uniform[2];
+
+  ///53-bit uniform number [0,1) of two words
+  static inline double to_uniform(uint_type a, uint_type b)
+  {
+    return ((a>>5)*67108864.0+(b>>6))*(1.0/9007199254740992.0);
+  }
+
+  ///move the counter by n blocks
+  inline void advance(size_t n)
+  {
+    Counter[0]+=static_cast<uint_type>(n);
+  }
+
+  inline void next_block(uint_type* x)
+  {
+    philox(Counter[0],Counter[1],Counter[2],Counter[3],Key[0],Key[1],x[0],x[1],x[2],x[3]);
+    advance(1);
+  }
+};
+#endif
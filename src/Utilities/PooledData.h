@@ -20,6 +20,13 @@
  * @brief Define a serialized buffer to store anonymous data
  *
  * JK: Remove iterator version on 2016-01-04
+ *
+ * myData is aligned to the cache line. A component can register an aligned
+ * slot with addSlot and later work on the slot in place through
+ * lendReference instead of copying its data with get/put. Only
+ * J2OrbitalSoA does so; the other components, including the determinants,
+ * still copy their data, and WalkerControlMPI packs the buffer of each
+ * walker like the rest of the walker.
  */
 #ifndef QMCPLUSPLUS_POOLEDDATA_H
 #define QMCPLUSPLUS_POOLEDDATA_H
@@ -27,6 +34,7 @@
 #include <complex>
 #include <limits>
 #include <iterator>
+#include "simd/allocator.hpp"
 
 using std::complex;
 
@@ -35,10 +43,11 @@ struct PooledData
 {
   typedef T value_type;
   typedef OHMMS_PRECISION_FULL fp_value_type;
-  typedef typename std::vector<T>::size_type size_type;
+  typedef qmcplusplus::aligned_vector<T> container_type;
+  typedef typename container_type::size_type size_type;
 
   size_type Current, Current_DP;
-  std::vector<T> myData;
+  container_type myData;
   /// only active when T!=fp_value_type
   std::vector<fp_value_type> myData_DP;
 
@@ -91,12 +100,12 @@ struct PooledData
   }
 
   ///return the starting iterator
-  inline typename std::vector<T>::iterator begin()
+  inline typename container_type::iterator begin()
   {
     return myData.begin();
   }
   ///return the ending iterator
-  inline typename std::vector<T>::iterator end()
+  inline typename container_type::iterator end()
   {
     return myData.end();
   }
@@ -191,6 +200,35 @@ struct PooledData
     Current_DP += dn;
   }
 
+  /** register an aligned slot of n elements at the end of the buffer
+   * @param n number of elements
+   * @return the address of the slot, valid until the buffer grows again
+   *
+   * Current is padded to a multiple of the cache line before the slot.
+   */
+  inline T* addSlot(size_type n)
+  {
+    Current=qmcplusplus::getAlignedSize<T>(Current);
+    myData.resize(Current+n,T());
+    T* ref=myData.data()+Current;
+    Current+=n;
+    return ref;
+  }
+
+  /** return the slot of n elements registered by addSlot at this position
+   * @param n number of elements
+   * @return the address of the slot in the buffer
+   *
+   * The cursor is moved past the slot, no data is copied.
+   */
+  inline T* lendReference(size_type n)
+  {
+    Current=qmcplusplus::getAlignedSize<T>(Current);
+    T* ref=myData.data()+Current;
+    Current+=n;
+    return ref;
+  }
+
   template<class T1>
   inline void get(T1& x)
   {
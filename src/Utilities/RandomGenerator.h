@@ -17,6 +17,7 @@
  * @brief Declare a global Random Number Generator
  *
  * Selected among
+ * - Philox4x32-10, when QMC_RNG_PHILOX is set
  * - boost::random
  * - sprng
  * - math::random
@@ -50,6 +51,16 @@ extern RandomGenerator_t Random;
 }
 #else
 
+#if defined(QMC_RNG_PHILOX)
+
+#include "Utilities/PhiloxRandom.h"
+namespace qmcplusplus
+{
+typedef PhiloxRandom<OHMMS_PRECISION_FULL> RandomGenerator_t;
+extern RandomGenerator_t Random;
+}
+#else
+
 #ifdef HAVE_LIBBOOST
 
 #include "Utilities/BoostRandom.h"
@@ -78,4 +89,5 @@ extern RandomGenerator_t Random;
 #endif
 #endif
 #endif
+#endif
 
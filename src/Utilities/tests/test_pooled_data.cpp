@@ -0,0 +1,59 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "config.h"
+#include "Utilities/PooledData.h"
+#include <stdint.h>
+#include <vector>
+
+namespace qmcplusplus {
+
+TEST_CASE("pooled data aligned slots", "[utilities]")
+{
+  PooledData<double> buf;
+  buf.add(1.0);
+  double* s1 = buf.addSlot(5);
+  for (int i = 0; i < 5; i++)
+    s1[i] = 10.0+i;
+  buf.add(2.0);
+  double* s2 = buf.addSlot(3);
+  for (int i = 0; i < 3; i++)
+    s2[i] = 20.0+i;
+  buf.add(3.0);
+
+  // the addresses of the last slot and of the walker copy are aligned
+  REQUIRE(reinterpret_cast<uintptr_t>(s2)%QMC_CLINE == 0);
+  PooledData<double> copy(buf);
+  REQUIRE(reinterpret_cast<uintptr_t>(copy.data())%QMC_CLINE == 0);
+
+  // the same sequence lends the slots in place
+  copy.rewind();
+  double x;
+  copy.get(x);
+  REQUIRE(x == 1.0);
+  double* r1 = copy.lendReference(5);
+  REQUIRE(reinterpret_cast<uintptr_t>(r1)%QMC_CLINE == 0);
+  REQUIRE(r1[4] == 14.0);
+  copy.get(x);
+  REQUIRE(x == 2.0);
+  double* r2 = copy.lendReference(3);
+  REQUIRE(r2[0] == 20.0);
+  r2[0] = -1.0;
+  copy.get(x);
+  REQUIRE(x == 3.0);
+  REQUIRE(copy.current() == copy.size());
+  REQUIRE(copy[r2-copy.data()] == -1.0);
+}
+
+}
@@ -15,6 +15,7 @@
 
 #include "Utilities/RandomGenerator.h"
 #include "Utilities/FakeRandom.h"
+#include "Utilities/PhiloxRandom.h"
 #include <stdio.h>
 #include <string>
 #include <vector>
@@ -44,4 +45,99 @@ TEST_CASE("make_seed", "[utilities]")
   REQUIRE(seed1 != seed2);
 }
 
+TEST_CASE("philox known answers", "[utilities]")
+{
+  // Random123 known-answer tests of Philox4x32-10
+  uint32_t x[4];
+  PhiloxRandom<double>::philox(0, 0, 0, 0, 0, 0, x[0], x[1], x[2], x[3]);
+  REQUIRE(x[0] == 0x6627e8d5u);
+  REQUIRE(x[1] == 0xe169c58du);
+  REQUIRE(x[2] == 0xbc57ac4cu);
+  REQUIRE(x[3] == 0x9b00dbd8u);
+  PhiloxRandom<double>::philox(0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u,
+                               0xa4093822u, 0x299f31d0u, x[0], x[1], x[2], x[3]);
+  REQUIRE(x[0] == 0xd16cfe09u);
+  REQUIRE(x[1] == 0x94fdccebu);
+  REQUIRE(x[2] == 0x5001e420u);
+  REQUIRE(x[3] == 0x24126ea1u);
+}
+
+TEST_CASE("philox streams", "[utilities]")
+{
+  PhiloxRandom<double> rng_a, rng_b;
+  rng_a.set_key(17);
+  rng_b.set_key(17);
+  rng_b.init(1, 4, 12345);
+
+  // a walker stream does not depend on the history of the generator
+  rng_b();
+  rng_a.set_stream(42, 7, 1);
+  rng_b.set_stream(42, 7, 1);
+  for (int i = 0; i < 5; i++)
+  {
+    double d = rng_a();
+    REQUIRE(d >= 0.0);
+    REQUIRE(d < 1.0);
+    REQUIRE(d == rng_b());
+  }
+
+  // save and load in the middle of a block
+  std::vector<uint32_t> state;
+  rng_a.save(state);
+  REQUIRE(state.size() == rng_a.state_size());
+  double next = rng_a();
+  rng_b.set_stream(3, 3);
+  rng_b.load(state);
+  REQUIRE(rng_b() == next);
+
+  // the bulk Gaussian numbers of a stream are the same in any chunking
+  const int n = 301;
+  std::vector<double> g(n), g2(n);
+  rng_a.set_stream(5, 11);
+  rng_a.generate_normal(g.data(), n);
+  rng_b.set_stream(5, 11);
+  rng_b.generate_normal(g2.data(), 160);
+  rng_b.generate_normal(g2.data()+160, n-160);
+  double avg = 0.0, avg2 = 0.0;
+  for (int i = 0; i < n; i++)
+  {
+    REQUIRE(g[i] == g2[i]);
+    avg += g[i];
+    avg2 += g[i]*g[i];
+  }
+  avg /= n;
+  avg2 /= n;
+  REQUIRE(std::abs(avg) < 0.2);
+  REQUIRE(std::abs(avg2-1.0) < 0.2);
+}
+
+TEST_CASE("philox walker steps", "[utilities]")
+{
+  // the steps set by the drivers: the warmup steps count down from -1,
+  // the steps of the run and the sub-steps between the branches count up
+  const int steps[] = {-2, -1, 0, 1, 2};
+  const int nsteps = 5;
+  const int ndraw = 4;
+  PhiloxRandom<double> rng;
+  rng.set_key(11);
+  std::vector<double> draws(nsteps*ndraw);
+  for (int s = 0; s < nsteps; s++)
+  {
+    rng.set_stream(7, steps[s], 1);
+    for (int i = 0; i < ndraw; i++)
+      draws[s*ndraw+i] = rng();
+  }
+
+  // two consecutive steps of a walker draw different numbers
+  for (int s = 1; s < nsteps; s++)
+    for (int i = 0; i < ndraw; i++)
+      for (int j = 0; j < ndraw; j++)
+        REQUIRE(draws[s*ndraw+i] != draws[(s-1)*ndraw+j]);
+
+  // and the same step replays the same numbers
+  rng.set_stream(7, steps[3], 1);
+  for (int i = 0; i < ndraw; i++)
+    REQUIRE(rng() == draws[3*ndraw+i]);
+}
+
 }
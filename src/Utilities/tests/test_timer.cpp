@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <string>
 #include <vector>
+#include <fstream>
 
 namespace qmcplusplus {
 
@@ -395,6 +396,69 @@ TEST_CASE("test max exceeded message")
 }
 #endif
 
+TEST_CASE("test_timer_thread_profile", "[utilities]")
+{
+  TimerManagerClass tm;
+  tm.set_timer_threshold(timer_level_fine);
+  FakeTimer t1("timer1");
+  tm.addTimer(&t1);
+  FakeTimer t2("timer1");
+  tm.addTimer(&t2);
+
+  fake_cpu_clock_increment = 1.0;
+  t1.start();
+  t1.stop();
+  for (int i = 0; i < 2; i++)
+  {
+    t2.start();
+    t2.stop();
+  }
+
+  TimerManagerClass::ThreadProfileData p;
+  tm.collate_thread_profile(NULL, p);
+
+#ifdef ENABLE_TIMERS
+  // only the master thread called the timers
+  REQUIRE(p.nameList.size() == 1);
+  int idx1 = p.nameList.at("timer1");
+  REQUIRE(p.threadMin[idx1] == Approx(3.0));
+  REQUIRE(p.threadMax[idx1] == Approx(3.0));
+  REQUIRE(p.threadMean[idx1] == Approx(3.0));
+  REQUIRE(p.rankMin[idx1] == Approx(3.0));
+  REQUIRE(p.rankMax[idx1] == Approx(3.0));
+  REQUIRE(p.rankMean[idx1] == Approx(3.0));
+#endif
+}
+
+TEST_CASE("test_timer_timeline", "[utilities]")
+{
+  OhmmsInfo("testlogfile");
+  TimerManagerClass tm;
+  tm.set_timer_threshold(timer_level_fine);
+  FakeTimer t1("timer1");
+  tm.addTimer(&t1);
+
+  // only the second of three steps is recorded
+  tm.set_timeline_window(1, 2);
+  for (int step = 0; step < 3; step++)
+  {
+    tm.advance_timeline();
+    t1.start();
+    t1.stop();
+  }
+  tm.write_timeline(NULL, "test_timeline");
+
+#ifdef ENABLE_TIMERS
+  std::ifstream fin("test_timeline.trace.json");
+  std::string line;
+  int nevents = 0;
+  while (std::getline(fin, line))
+    if (line.find("\"name\":\"timer1\",\"ph\":\"X\"") != std::string::npos)
+      nevents++;
+  REQUIRE(nevents == 1);
+#endif
+}
+
 #if __cplusplus >=201103l
 // Define a list of timers indexed by an enum
 // First, define an enum with the timers
@@ -34,6 +34,8 @@ extern "C" {
   {
     intptr_t z_stride=multi->z_stride;
 
+    //each thread writes its own x planes of the table
+#pragma omp parallel for
     for(int ix=0; ix<N[0]; ++ix)
       for(int iy=0; iy<N[1]; ++iy)
       {
@@ -51,6 +53,8 @@ extern "C" {
   {
     intptr_t z_stride=multi->z_stride;
 
+    //each thread writes its own x planes of the table
+#pragma omp parallel for
     for(int ix=0; ix<N[0]; ++ix)
       for(int iy=0; iy<N[1]; ++iy)
       {
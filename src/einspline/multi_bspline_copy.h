@@ -50,6 +50,8 @@ extern "C" {
    * @param spline_in input spline
    * @param offset offset to match in/out
    * @param N points for each direction
+   *
+   * The x planes are copied by the OpenMP threads.
    */
   void copy_UBspline_3d_d(multi_UBspline_3d_d* spline
                           , int i, const UBspline_3d_d* spline_in
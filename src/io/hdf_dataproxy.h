@@ -147,7 +147,8 @@ inline bool h5d_write(hid_t grp, const std::string& aname, hsize_t ndims,
 template<typename T>
 inline bool h5d_append(hid_t grp, const std::string& aname, hsize_t& current,
                        hsize_t ndims, const hsize_t* dims, const T* first,
-                       hsize_t chunk_size=1,hid_t xfer_plist=H5P_DEFAULT)
+                       hsize_t chunk_size=1,hid_t xfer_plist=H5P_DEFAULT,
+                       int compression=0)
 {
   //app_log()<<omp_get_thread_num()<<"  h5d_append  group = "<<grp<<"  name = "<<aname.c_str()<< std::endl;
   if(grp<0)
@@ -178,6 +179,9 @@ inline bool h5d_append(hid_t grp, const std::string& aname, hsize_t& current,
     hid_t sl = H5Pset_layout(p, H5D_CHUNKED);
     // set chunk size
     hid_t cs = H5Pset_chunk(p, ndims, chunk_dims);
+    // deflate the chunks, level 1-9
+    if(compression>0)
+      H5Pset_deflate(p, compression);
     // create the dataset
     dataset = H5Dcreate2(grp, aname.c_str(), h5d_type_id, dataspace, H5P_DEFAULT, p, H5P_DEFAULT);
     // create memory dataspace, size of current buffer
@@ -33,6 +33,7 @@ QMCState::QMCState()
   io_node=true;
   mpi_groups=1;
   use_ewald=false;
+  use_single_spo=false;
   qmc_counter=0;
   memory_allocated=0;
 #if defined(QMC_CUDA)
@@ -109,7 +110,7 @@ void QMCState::print_options(std::ostream& os)
   if(save_wfs)
     os << "  save_wfs=1 : save wavefunctions in hdf5. " << std::endl;
   if(async_swap)
-    os << "  async_swap=1 : using async isend/irecv for walker swaps " << std::endl;
+    os << "  async_swap=1 : using nonblocking isend/irecv on persistent buffers for walker swaps " << std::endl;
   else
     os << "  async_swap=0 : using blocking send/recv for walker swaps " << std::endl;
 }
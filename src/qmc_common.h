@@ -22,6 +22,7 @@
 
 namespace qmcplusplus
 {
+
 ///enumeration for main computing devices
 enum {SMP=0, CUDA=1, PHI=2};
 
@@ -43,6 +44,8 @@ struct QMCState
   bool io_node;
   ///true, use Ewald instead of optimal breakup for the Coulomb
   bool use_ewald;
+  ///true, if any SPO set stores the orbitals in single precision
+  bool use_single_spo;
   ///int for compute_device
   int compute_device;
   ///init for <qmc/> section
@@ -0,0 +1,96 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2017 Jeongnim Kim and QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/**@file allocator.hpp
+ *
+ * Define the aligned allocator and the helper functions for the padded storage
+ * used by the structure-of-arrays containers.
+ */
+#ifndef QMCPLUSPLUS_ALIGNED_ALLOCATOR_HPP
+#define QMCPLUSPLUS_ALIGNED_ALLOCATOR_HPP
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+///alignment in bytes, one cache line
+#ifndef QMC_CLINE
+#define QMC_CLINE 64
+#endif
+
+namespace qmcplusplus
+{
+
+/** allocator returning memory aligned to ALIGN bytes
+ * @tparam T data type
+ * @tparam ALIGN alignment in bytes, a power of two multiple of sizeof(void*)
+ */
+template<typename T, size_t ALIGN=QMC_CLINE>
+struct aligned_allocator
+{
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef size_t size_type;
+
+  template<typename U>
+  struct rebind
+  {
+    typedef aligned_allocator<U,ALIGN> other;
+  };
+
+  aligned_allocator() {}
+
+  template<typename U>
+  aligned_allocator(const aligned_allocator<U,ALIGN>&) {}
+
+  inline T* allocate(size_t n)
+  {
+    void* ptr=0;
+    if(posix_memalign(&ptr,ALIGN,n*sizeof(T)))
+      throw std::bad_alloc();
+    return static_cast<T*>(ptr);
+  }
+
+  inline void deallocate(T* ptr, size_t)
+  {
+    free(ptr);
+  }
+};
+
+template<typename T1, typename T2, size_t ALIGN>
+inline bool operator==(const aligned_allocator<T1,ALIGN>&, const aligned_allocator<T2,ALIGN>&)
+{
+  return true;
+}
+
+template<typename T1, typename T2, size_t ALIGN>
+inline bool operator!=(const aligned_allocator<T1,ALIGN>&, const aligned_allocator<T2,ALIGN>&)
+{
+  return false;
+}
+
+///std::vector with the cache-line aligned storage
+template<typename T> using aligned_vector = std::vector<T,aligned_allocator<T> >;
+
+/** return the size padded to a multiple of the cache line
+ * @param n number of elements of T
+ */
+template<typename T>
+inline size_t getAlignedSize(size_t n)
+{
+  const size_t ND=QMC_CLINE/sizeof(T);
+  return ((n+ND-1)/ND)*ND;
+}
+
+}
+#endif
@@ -179,6 +179,21 @@ namespace qmcplusplus {
         return res;
       }
 
+    /** dot product over the selected elements
+     * @param a starting address of an array of type T
+     * @param b starting address of an array of type T2
+     * @param idx indices of the elements
+     * @param n number of the indices
+     * @return \f$\sum_i a[idx[i]]*b[idx[i]]\f$
+     */
+    template<typename T, typename T2>
+      inline T2 dot(const T* restrict a, const T2* restrict b, const int* restrict idx, int n)
+      {
+        T2 res=T2();
+        for(int i=0; i<n; i++) res += a[idx[i]]*b[idx[i]];
+        return res;
+      }
+
     //template<typename T>
     //  inline void gemv(const Matrix<T>& a, const T* restrict v, T* restrict b)
     //  {